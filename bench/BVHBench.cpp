@@ -0,0 +1,110 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for the BVH build and queries.
+ */
+
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "BVH.hpp"
+
+
+static std::vector<Vector3> BenchmarkTriangles(size_t count)
+{
+    std::vector<Vector3> centers = Benchmark::RandomPoints(count, 100, 1);
+    std::vector<Vector3> offsets = Benchmark::RandomPoints(3 * count, 1, 2);
+    std::vector<Vector3> vertices(3 * count);
+    for (size_t i = 0; i < 3 * count; i++)
+        vertices[i] = centers[i / 3] + offsets[i];
+    return vertices;
+}
+
+
+TEST_CASE("BVH build", "[BVH]")
+{
+    const size_t count = 1 << 20;
+    std::vector<Vector3> vertices = BenchmarkTriangles(count);
+    BVH bvh;
+    double seconds = Benchmark::Seconds([&]()
+        {
+            bvh = BVH::FromTriangles(vertices.data(), count);
+        });
+    Benchmark::Report("BVH build (1M triangles)", seconds, count);
+    CHECK(bvh.Nodes.size() > 1);
+}
+
+TEST_CASE("BVH queries", "[BVH]")
+{
+    const size_t count = 1 << 20;
+    const size_t queries = 1 << 16;
+    std::vector<Vector3> vertices = BenchmarkTriangles(count);
+    BVH bvh = BVH::FromTriangles(vertices.data(), count);
+    std::vector<Vector3> origins = Benchmark::RandomPoints(queries, 100, 3);
+    std::vector<Vector3> directions = Benchmark::RandomPoints(queries, 2, 4);
+
+    size_t hits = 0;
+    double seconds = Benchmark::Seconds([&]()
+        {
+            hits = 0;
+            for (size_t i = 0; i < queries; i++)
+            {
+                size_t triangle;
+                double distance;
+                hits += BVH::Raycast(bvh, vertices.data(), origins[i],
+                                     directions[i], INFINITY, triangle,
+                                     distance);
+            }
+        });
+    Benchmark::Report("BVH raycast", seconds, queries);
+    CHECK(hits > 0);
+
+    size_t found = 0;
+    seconds = Benchmark::Seconds([&]()
+        {
+            found = 0;
+            for (size_t i = 0; i < queries; i++)
+            {
+                size_t triangle;
+                Vector3 closest;
+                found += BVH::Nearest(bvh, vertices.data(), origins[i],
+                                      INFINITY, triangle, closest);
+            }
+        });
+    Benchmark::Report("BVH nearest", seconds, queries);
+    CHECK(found == queries);
+
+    std::vector<size_t> overlaps;
+    seconds = Benchmark::Seconds([&]()
+        {
+            overlaps.clear();
+            for (size_t i = 0; i < queries; i++)
+                BVH::Overlap(bvh, vertices.data(),
+                             AABB::Expand(AABB(origins[i], origins[i]), 1),
+                             overlaps);
+        });
+    Benchmark::Report("BVH overlap", seconds, queries);
+    CHECK(overlaps.size() > 0);
+}
@@ -0,0 +1,114 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains timing helpers shared by the benchmarks.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "Random.hpp"
+#include "Vector3.hpp"
+
+
+struct Benchmark
+{
+    /**
+     * Runs a function several times and returns the fastest run.
+     * @param function: The function to time.
+     * @param repeats: The number of runs.
+     * @return: The time of the fastest run in seconds.
+     */
+    template <typename F>
+    static inline double Seconds(F function, int repeats = 3);
+
+    /**
+     * Prints a line with the time taken and the throughput achieved.
+     * @param name: The name of the benchmark.
+     * @param seconds: The time taken.
+     * @param items: The number of items processed in that time.
+     */
+    static inline void Report(const char *name, double seconds, double items);
+
+    /**
+     * Prints a line with the largest error a kernel made.
+     * @param name: The name of the measurement.
+     * @param error: The error.
+     */
+    static inline void ReportError(const char *name, double error);
+
+    /**
+     * Returns an array of pseudo-random points inside a cube.
+     * @param count: The number of points.
+     * @param size: The side length of the cube, which is centered on zero.
+     * @param seed: The random seed.
+     * @return: A new array.
+     */
+    static inline std::vector<Vector3> RandomPoints(size_t count, double size,
+                                                    unsigned int seed);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+template <typename F>
+double Benchmark::Seconds(F function, int repeats)
+{
+    double best = 0;
+    for (int i = 0; i < repeats; i++)
+    {
+        std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        if (i == 0 || elapsed.count() < best)
+            best = elapsed.count();
+    }
+    return best;
+}
+
+void Benchmark::Report(const char *name, double seconds, double items)
+{
+    printf("%-48s %10.3f ms %12.3f M/s\n", name, seconds * 1000,
+           items / seconds / 1000000);
+}
+
+void Benchmark::ReportError(const char *name, double error)
+{
+    printf("%-48s %13.3e max error\n", name, error);
+}
+
+std::vector<Vector3> Benchmark::RandomPoints(size_t count, double size,
+                                             unsigned int seed)
+{
+    return Random::Points(count, size, seed);
+}
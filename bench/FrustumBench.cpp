@@ -0,0 +1,104 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for the Frustum culling kernels, comparing
+ *  them against a plain loop over Vector3::Dot.
+ */
+
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "Frustum.hpp"
+
+
+TEST_CASE("Frustum culling", "[Frustum]")
+{
+    const size_t count = 500000;
+    std::vector<Vector3> points = Benchmark::RandomPoints(count, 1000, 1);
+    std::vector<Vector3> sizes = Benchmark::RandomPoints(count, 4, 2);
+    Vector3Array centers = Vector3Array(points.data(), count);
+    std::vector<double> radii(count);
+    std::vector<AABB> boxes(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3 extents = Vector3(fabs(sizes[i].X), fabs(sizes[i].Y),
+                                  fabs(sizes[i].Z)) + Vector3::One();
+        radii[i] = Vector3::Magnitude(extents);
+        boxes[i] = AABB(points[i] - extents, points[i] + extents);
+    }
+    Frustum frustum = Frustum(Matrix3x3::Identity(), Vector3::Zero(),
+                              M_PI / 3, 16.0 / 9, 0.1, 400);
+    std::vector<unsigned int> visible(count);
+    size_t found = 0;
+
+    double seconds = Benchmark::Seconds([&]()
+        {
+            found = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                bool inside = true;
+                for (int p = 0; p < 6 && inside; p++)
+                    inside = Vector3::Dot(frustum.Normals[p], points[i]) +
+                        frustum.Offsets[p] >= -radii[i];
+                if (inside)
+                    visible[found++] = (unsigned int)i;
+            }
+        });
+    Benchmark::Report("Vector3::Dot sphere loop (500K)", seconds, count);
+    size_t expected = found;
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            found = Frustum::Cull(frustum, centers, radii.data(),
+                                  visible.data(), FastMath());
+        });
+    Benchmark::Report("Frustum cull spheres, conservative (500K)", seconds,
+                      count);
+    CHECK(found == expected);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            found = Frustum::Cull(frustum, centers, radii.data(),
+                                  visible.data());
+        });
+    Benchmark::Report("Frustum cull spheres, exact (500K)", seconds, count);
+    CHECK(found <= expected);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            found = Frustum::Cull(frustum, boxes.data(), count,
+                                  visible.data(), FastMath());
+        });
+    Benchmark::Report("Frustum cull boxes, conservative (500K)", seconds,
+                      count);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            found = Frustum::Cull(frustum, boxes.data(), count,
+                                  visible.data());
+        });
+    Benchmark::Report("Frustum cull boxes, exact (500K)", seconds, count);
+    CHECK(found > 0);
+}
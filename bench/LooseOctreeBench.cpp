@@ -0,0 +1,101 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for the LooseOctree, comparing incremental
+ *  updates against full rebuilds.
+ */
+
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "BVH.hpp"
+#include "LooseOctree.hpp"
+
+
+TEST_CASE("LooseOctree update versus rebuild", "[LooseOctree]")
+{
+    const size_t count = 1 << 18;
+    std::vector<Vector3> centers = Benchmark::RandomPoints(count, 1000, 1);
+    std::vector<Vector3> steps = Benchmark::RandomPoints(count, 0.2, 2);
+    std::vector<double> radii(count);
+    for (size_t i = 0; i < count; i++)
+        radii[i] = 0.5 + fabs(steps[i].X) * 10;
+
+    LooseOctree tree = LooseOctree(Vector3::Zero(), 512, 10);
+    std::vector<size_t> handles(count);
+    double seconds = Benchmark::Seconds([&]()
+        {
+            tree = LooseOctree(Vector3::Zero(), 512, 10);
+            for (size_t i = 0; i < count; i++)
+                handles[i] = LooseOctree::Insert(tree, centers[i], radii[i]);
+        });
+    Benchmark::Report("LooseOctree rebuild (256K objects)", seconds, count);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                centers[i] += steps[i];
+                LooseOctree::Move(tree, handles[i], centers[i], radii[i]);
+            }
+        });
+    Benchmark::Report("LooseOctree move (256K objects)", seconds, count);
+    CHECK(tree.Count == count);
+
+    std::vector<AABB> bounds(count);
+    BVH bvh;
+    seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+                bounds[i] = AABB::Expand(AABB(centers[i], centers[i]),
+                                         radii[i]);
+            bvh = BVH::Build(bounds.data(), count);
+        });
+    Benchmark::Report("BVH rebuild for comparison (256K objects)", seconds,
+                      count);
+
+    const size_t queries = 1 << 14;
+    std::vector<Vector3> points = Benchmark::RandomPoints(queries, 1000, 3);
+    std::vector<size_t> found;
+    seconds = Benchmark::Seconds([&]()
+        {
+            found.clear();
+            for (size_t i = 0; i < queries; i++)
+                LooseOctree::Overlap(tree, points[i], 5, found);
+        });
+    Benchmark::Report("LooseOctree overlap", seconds, queries);
+
+    Vector3 normals[] = { Vector3(1, 0, 0), Vector3(-1, 0, 0),
+        Vector3(0, 1, 0), Vector3(0, -1, 0), Vector3(0, 0, 1),
+        Vector3(0, 0, -1) };
+    double offsets[] = { 100, 100, 100, 100, 100, 100 };
+    seconds = Benchmark::Seconds([&]()
+        {
+            found.clear();
+            LooseOctree::Cull(tree, normals, offsets, 6, found);
+        });
+    Benchmark::Report("LooseOctree cull", seconds, count);
+    CHECK(found.size() > 0);
+}
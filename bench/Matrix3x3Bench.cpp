@@ -0,0 +1,141 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for the Matrix3x3 symmetric eigensolver,
+ *  SVD and polar decomposition, comparing the batch kernels against solving
+ *  one matrix at a time and reporting the accuracy of the SVD.
+ */
+
+#include <vector>
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "Matrix3x3.hpp"
+
+
+TEST_CASE("Matrix3x3 symmetric eigen decomposition", "[Matrix3x3]")
+{
+    // Covariance matrices of a few points each, as in normal estimation
+    const size_t count = 1 << 18;
+    std::vector<Vector3> points = Benchmark::RandomPoints(4 * count, 1, 5);
+    std::vector<Matrix3x3> matrices(count, Matrix3x3::Zero());
+    for (size_t i = 0; i < count; i++)
+        for (size_t k = 0; k < 4; k++)
+        {
+            Vector3 p = points[4 * i + k];
+            matrices[i] += Matrix3x3(p * p.X, p * p.Y, p * p.Z);
+        }
+
+    std::vector<Vector3> values(count);
+    std::vector<Matrix3x3> vectors(count);
+    double seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+                Matrix3x3::EigenSymmetric(matrices[i], values[i], vectors[i]);
+        });
+    Benchmark::Report("Scalar (256K)", seconds, count);
+
+    Vector3 scalar = values[count - 1];
+    seconds = Benchmark::Seconds([&]()
+        {
+            Matrix3x3::EigenSymmetric(matrices.data(), count, values.data(),
+                                      vectors.data());
+        });
+    Benchmark::Report("Batch (256K)", seconds, count);
+    CHECK(values[count - 1].X == Approx(scalar.X));
+}
+
+TEST_CASE("Matrix3x3 SVD and polar decomposition", "[Matrix3x3]")
+{
+    // Deformation gradients: rotations times stretches, some of them
+    // nearly flat and some reflected
+    const size_t count = 1 << 18;
+    std::vector<Vector3> axes = Benchmark::RandomPoints(count, 2, 6);
+    std::vector<Vector3> noise = Benchmark::RandomPoints(3 * count, 1, 7);
+    std::vector<Matrix3x3> matrices(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Matrix3x3 r = Matrix3x3::FromQuaternion(Quaternion(axes[i], 0.5));
+        Matrix3x3 s = Matrix3x3::Identity() + Matrix3x3(
+            noise[3 * i], noise[3 * i + 1], noise[3 * i + 2]);
+        if (i % 16 == 0)
+            s.D22 *= 1e-6;
+        if (i % 16 == 1)
+            s.D11 = -s.D11;
+        matrices[i] = r * s;
+    }
+
+    std::vector<Matrix3x3> u(count), v(count);
+    std::vector<Vector3> sigma(count);
+    double seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+                Matrix3x3::SVD(matrices[i], u[i], sigma[i], v[i]);
+        });
+    Benchmark::Report("SVD, scalar (256K)", seconds, count);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            Matrix3x3::SVD(matrices.data(), count, u.data(), sigma.data(),
+                           v.data());
+        });
+    Benchmark::Report("SVD, batch (256K)", seconds, count);
+
+    // The error relative to the largest singular value
+    double reconstruction = 0, orthogonality = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3 s = sigma[i];
+        Matrix3x3 e = u[i] * Matrix3x3(s.X, 0, 0, 0, s.Y, 0, 0, 0, s.Z) *
+            Matrix3x3::Transpose(v[i]) - matrices[i];
+        Matrix3x3 o = Matrix3x3::Transpose(u[i]) * u[i] -
+            Matrix3x3::Identity();
+        for (int k = 0; k < 9; k++)
+        {
+            double error = fabs(e.data[k / 3][k % 3]) / s.X;
+            reconstruction = error > reconstruction ? error : reconstruction;
+            error = fabs(o.data[k / 3][k % 3]);
+            orthogonality = error > orthogonality ? error : orthogonality;
+        }
+    }
+    Benchmark::ReportError("SVD reconstruction", reconstruction);
+    Benchmark::ReportError("SVD orthogonality of U", orthogonality);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+                Matrix3x3::PolarDecomposition(matrices[i], u[i], v[i]);
+        });
+    Benchmark::Report("Polar decomposition, scalar (256K)", seconds, count);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            Matrix3x3::PolarDecomposition(matrices.data(), count, u.data(),
+                                          v.data());
+        });
+    Benchmark::Report("Polar decomposition, batch (256K)", seconds, count);
+    Matrix3x3 rs = u[count - 1] * v[count - 1];
+    CHECK(rs.D00 == Approx(matrices[count - 1].D00));
+}
@@ -0,0 +1,79 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for the Matrix4x4 affine fast paths.
+ */
+
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "Matrix4x4.hpp"
+
+
+TEST_CASE("Matrix4x4 affine fast paths", "[Matrix4x4]")
+{
+    const size_t count = 1 << 20;
+    std::vector<Vector3> points = Benchmark::RandomPoints(count, 100, 1);
+    std::vector<Vector3> output(count);
+    Matrix4x4 affine = Matrix4x4::FromTRS(Vector3(4, -3, 2),
+        Quaternion(0.1, 0.7, -0.3, 0.6), Vector3(2, 0.5, 3));
+    Matrix4x4 projective = Matrix4x4::Perspective(M_PI / 3, 1.5, 0.5, 100) *
+        affine;
+
+    double seconds = Benchmark::Seconds([&]()
+        {
+            Matrix4x4::MultiplyPoints(projective, points.data(), count,
+                                      output.data());
+        });
+    Benchmark::Report("Matrix4x4 projective points (1M)", seconds, count);
+    seconds = Benchmark::Seconds([&]()
+        {
+            Matrix4x4::MultiplyPoints(affine, points.data(), count,
+                                      output.data());
+        });
+    Benchmark::Report("Matrix4x4 affine points (1M)", seconds, count);
+
+    const size_t inverses = 1 << 18;
+    Matrix4x4 sum = Matrix4x4::Zero();
+    seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < inverses; i++)
+            {
+                projective.D33 += 1e-9;
+                sum += Matrix4x4::Inverse(projective);
+            }
+        });
+    Benchmark::Report("Matrix4x4 general inverse (256K)", seconds, inverses);
+    seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < inverses; i++)
+            {
+                affine.D03 += 1e-9;
+                sum += Matrix4x4::InverseAffine(affine);
+            }
+        });
+    Benchmark::Report("Matrix4x4 affine inverse (256K)", seconds, inverses);
+    CHECK(sum.D00 == sum.D00);
+}
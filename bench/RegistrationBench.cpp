@@ -0,0 +1,145 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for Registration, comparing its
+ *  cross-covariance kernel against a plain two pass loop, the Horn and
+ *  Kabsch solvers, and the cost of each ICP stage.
+ */
+
+#include <stdio.h>
+#include <vector>
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "KDTree.hpp"
+#include "Registration.hpp"
+
+
+TEST_CASE("Registration cross-covariance and solvers", "[Registration]")
+{
+    const size_t count = 1 << 20;
+    std::vector<Vector3> source = Benchmark::RandomPoints(count, 100, 1);
+    std::vector<Vector3> target(count);
+    std::vector<double> weights(count, 1);
+    Registration motion(Quaternion::FromAngleAxis(0.7, Vector3(1, 2, 3)),
+                        Vector3(4, 5, 6));
+    Registration::Apply(motion, source.data(), count, target.data());
+
+    Matrix3x3 h;
+    Vector3 p, q;
+    double seconds = Benchmark::Seconds([&]()
+        {
+            p = q = Vector3(0, 0, 0);
+            for (size_t i = 0; i < count; i++)
+            {
+                p = p + source[i] * weights[i];
+                q = q + target[i] * weights[i];
+            }
+            p = p / (double)count;
+            q = q / (double)count;
+            h = Matrix3x3(0, 0, 0, 0, 0, 0, 0, 0, 0);
+            for (size_t i = 0; i < count; i++)
+            {
+                Vector3 a = (source[i] - p) * weights[i];
+                Vector3 b = target[i] - q;
+                for (int j = 0; j < 3; j++)
+                    for (int k = 0; k < 3; k++)
+                        h.data[j][k] += a.data[j] * b.data[k];
+            }
+        });
+    Benchmark::Report("Two pass covariance (1M)", seconds, count);
+    Matrix3x3 expected = h;
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            Registration::CrossCovariance(source.data(), target.data(),
+                                          weights.data(), count, h, p, q);
+        });
+    Benchmark::Report("CrossCovariance (1M)", seconds, count);
+    double error = 0;
+    for (int j = 0; j < 3; j++)
+        for (int k = 0; k < 3; k++)
+            error = fmax(error, fabs(h.data[j][k] - expected.data[j][k]) /
+                         fabs(expected.D00));
+    Benchmark::ReportError("CrossCovariance vs two pass", error);
+
+    const int solves = 100000;
+    Quaternion rotation;
+    seconds = Benchmark::Seconds([&]()
+        {
+            for (int i = 0; i < solves; i++)
+            {
+                h.D01 += 1e-9;
+                rotation = Registration::HornRotation(h);
+            }
+        });
+    Benchmark::Report("HornRotation (100K)", seconds, solves);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            for (int i = 0; i < solves; i++)
+            {
+                h.D01 += 1e-9;
+                rotation = Registration::KabschRotation(h);
+            }
+        });
+    Benchmark::Report("KabschRotation (100K)", seconds, solves);
+    CHECK(Quaternion::Angle(rotation, motion.Rotation) < 1e-6);
+}
+
+TEST_CASE("Registration ICP stages", "[Registration]")
+{
+    const size_t count = 1 << 18;
+    std::vector<Vector3> targets = Benchmark::RandomPoints(count, 100, 2);
+    KDTree tree = KDTree::Build(targets.data(), count);
+    Registration motion(Quaternion::FromAngleAxis(0.05, Vector3(0, 1, 1)),
+                        Vector3(0.4, 0.2, -0.3));
+    std::vector<Vector3> source(count);
+    Registration::Apply(Registration::Inverse(motion), targets.data(), count,
+                        source.data());
+
+    std::vector<ICPIteration> iterations;
+    Registration result = Registration::ICP(tree, targets.data(),
+                                            source.data(), count,
+                                            Registration(), 30, 5, 1e-9,
+                                            &iterations);
+    ICPIteration total = {};
+    for (size_t i = 0; i < iterations.size(); i++)
+    {
+        total.MatchSeconds += iterations[i].MatchSeconds;
+        total.AccumulateSeconds += iterations[i].AccumulateSeconds;
+        total.SolveSeconds += iterations[i].SolveSeconds;
+    }
+    double n = (double)iterations.size();
+    printf("ICP converged in %d iterations, final RMS error %.3e\n",
+           (int)iterations.size(), iterations.back().Error);
+    Benchmark::Report("ICP match, per iteration (256K)",
+                      total.MatchSeconds / n, count);
+    Benchmark::Report("ICP accumulate, per iteration (256K)",
+                      total.AccumulateSeconds / n, count);
+    Benchmark::Report("ICP solve, per iteration (1 solve)",
+                      total.SolveSeconds / n, 1);
+    CHECK(Quaternion::Angle(result.Rotation, motion.Rotation) < 1e-6);
+}
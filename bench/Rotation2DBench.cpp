@@ -0,0 +1,89 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for Rotation2D, comparing its batch kernels
+ *  against rotating through polar coordinates or a 3x3 matrix.
+ */
+
+#include <vector>
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "Matrix3x3.hpp"
+#include "Rotation2D.hpp"
+
+
+TEST_CASE("Rotation2D batch rotate", "[Rotation2D]")
+{
+    const size_t count = 1 << 20;
+    const double angle = 0.3;
+    std::vector<Vector3> points = Benchmark::RandomPoints(count, 100, 1);
+    std::vector<Vector2> vectors(count), output(count);
+    std::vector<double> x(count), y(count), outputX(count), outputY(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        vectors[i] = Vector2(points[i].X, points[i].Y);
+        x[i] = points[i].X;
+        y[i] = points[i].Y;
+    }
+
+    double seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                double rad, theta;
+                Vector2::ToPolar(vectors[i], rad, theta);
+                output[i] = Vector2::FromPolar(rad, theta + angle);
+            }
+        });
+    Benchmark::Report("Polar round trip (1M)", seconds, count);
+
+    Matrix3x3 m = Matrix3x3::FromQuaternion(
+        Quaternion::FromAngleAxis(angle, Vector3(0, 0, 1)));
+    seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                Vector3 v = m * Vector3(vectors[i].X, vectors[i].Y, 0);
+                output[i] = Vector2(v.X, v.Y);
+            }
+        });
+    Benchmark::Report("Matrix3x3 (1M)", seconds, count);
+
+    Rotation2D r = Rotation2D::FromAngle(angle);
+    seconds = Benchmark::Seconds([&]()
+        {
+            Rotation2D::Rotate(r, vectors.data(), count, output.data());
+        });
+    Benchmark::Report("Rotation2D batch, Vector2 (1M)", seconds, count);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            Rotation2D::Rotate(r, x.data(), y.data(), count, outputX.data(),
+                               outputY.data());
+        });
+    Benchmark::Report("Rotation2D batch, SoA (1M)", seconds, count);
+    CHECK(outputX[0] == Approx(output[0].X));
+}
@@ -0,0 +1,134 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for the Skinning kernels, comparing them
+ *  against blending each vertex with the scalar types.
+ */
+
+#include <vector>
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "Random.hpp"
+#include "Skinning.hpp"
+
+
+TEST_CASE("Skinning kernels", "[Skinning]")
+{
+    // Rates are in vertices per second
+    const size_t bones = 64;
+    const size_t count = 100000;
+    std::vector<Vector3> axes = Benchmark::RandomPoints(bones, 2, 1);
+    std::vector<Vector3> offsets = Benchmark::RandomPoints(bones, 10, 2);
+    std::vector<DualQuaternion> palette(bones);
+    for (size_t i = 0; i < bones; i++)
+        palette[i] = DualQuaternion(Quaternion::Normalized(
+            Quaternion(axes[i], 0.8)), offsets[i]);
+
+    // Vertices mostly follow nearby bones, as in a real mesh
+    std::vector<unsigned int> indices(count * Skinning::Influences);
+    std::vector<double> weights(count * Skinning::Influences);
+    unsigned int seed = 3;
+    for (size_t i = 0; i < count; i++)
+        for (size_t k = 0; k < Skinning::Influences; k++)
+        {
+            size_t j = i * Skinning::Influences + k;
+            size_t step = (size_t)(Random::Value(seed) * 16);
+            indices[j] = (unsigned int)((i * bones / count + step) % bones);
+            weights[j] = k == 0 ? 0.4 : 0.2;
+        }
+    std::vector<Vector3> points = Benchmark::RandomPoints(count, 10, 3);
+    std::vector<Vector3> directions = Benchmark::RandomPoints(count, 2, 4);
+    Vector3Array positions, normals;
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3Array::PushBack(positions, points[i]);
+        Vector3Array::PushBack(normals, directions[i]);
+    }
+
+    std::vector<Vector3> output(count), outputNormals(count);
+    double seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                const unsigned int *index = &indices[i * 4];
+                const double *weight = &weights[i * 4];
+                DualQuaternion blend = palette[index[0]] * weight[0];
+                for (size_t k = 1; k < Skinning::Influences; k++)
+                {
+                    double w = weight[k];
+                    if (Quaternion::Dot(blend.Real,
+                                        palette[index[k]].Real) < 0)
+                        w = -w;
+                    blend += palette[index[k]] * w;
+                }
+                blend = DualQuaternion::Normalized(blend);
+                output[i] = DualQuaternion::TransformPoint(blend, points[i]);
+                outputNormals[i] = DualQuaternion::TransformVector(
+                    blend, directions[i]);
+            }
+        });
+    Benchmark::Report("Dual quaternion, per vertex (100K)", seconds, count);
+
+    Vector3Array skinned, skinnedNormals;
+    seconds = Benchmark::Seconds([&]()
+        {
+            Skinning::SkinDualQuaternion(palette.data(), indices.data(),
+                                         weights.data(), positions, normals,
+                                         skinned, skinnedNormals);
+        });
+    Benchmark::Report("Dual quaternion, batch (100K)", seconds, count);
+    CHECK(Vector3Array::Get(skinned, 0).X == Approx(output[0].X));
+
+    std::vector<Matrix3x3> matrices(bones);
+    for (size_t i = 0; i < bones; i++)
+        matrices[i] = Matrix3x3::FromQuaternion(palette[i].Real);
+    seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                Matrix3x3 m = Matrix3x3::Zero();
+                Vector3 t = Vector3::Zero();
+                for (size_t k = 0; k < Skinning::Influences; k++)
+                {
+                    size_t j = i * Skinning::Influences + k;
+                    m += matrices[indices[j]] * weights[j];
+                    t += offsets[indices[j]] * weights[j];
+                }
+                output[i] = m * points[i] + t;
+                outputNormals[i] = Vector3::Normalized(m * directions[i]);
+            }
+        });
+    Benchmark::Report("Linear blend, per vertex (100K)", seconds, count);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            Skinning::SkinLinear(matrices.data(), offsets.data(),
+                                 indices.data(), weights.data(), positions,
+                                 normals, skinned, skinnedNormals);
+        });
+    Benchmark::Report("Linear blend, batch (100K)", seconds, count);
+    CHECK(Vector3Array::Get(skinned, 0).X == Approx(output[0].X));
+}
@@ -0,0 +1,95 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for the space filling curve encoders and
+ *  the radix sort, along with the effect of spatial order on a query kernel.
+ */
+
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "KDTree.hpp"
+#include "SpaceFillingCurve.hpp"
+
+
+TEST_CASE("Space filling curve encode and sort", "[SpaceFillingCurve]")
+{
+    const size_t count = 1 << 22;
+    std::vector<Vector3> points = Benchmark::RandomPoints(count, 100, 1);
+    AABB bounds = AABB::FromPoints(points.data(), count);
+    std::vector<uint64_t> codes(count);
+    double seconds = Benchmark::Seconds([&]()
+        {
+            SpaceFillingCurve::MortonCodes(points.data(), count, bounds,
+                                           codes.data());
+        });
+    Benchmark::Report("Morton codes (4M points)", seconds, count);
+    seconds = Benchmark::Seconds([&]()
+        {
+            SpaceFillingCurve::HilbertCodes(points.data(), count, bounds,
+                                            codes.data());
+        });
+    Benchmark::Report("Hilbert codes (4M points)", seconds, count);
+
+    std::vector<unsigned int> permutation(count);
+    seconds = Benchmark::Seconds([&]()
+        {
+            SpaceFillingCurve::Order(codes.data(), count,
+                                     permutation.data());
+        });
+    Benchmark::Report("Radix sort order (4M keys)", seconds, count);
+    CHECK(codes[permutation[0]] <= codes[permutation[count - 1]]);
+}
+
+TEST_CASE("Spatial order of queries", "[SpaceFillingCurve]")
+{
+    const size_t count = 1 << 20;
+    std::vector<Vector3> points = Benchmark::RandomPoints(count, 100, 2);
+    KDTree tree = KDTree::Build(points.data(), count);
+    std::vector<Vector3> queries = Benchmark::RandomPoints(count, 100, 3);
+    std::vector<size_t> indices(count);
+    std::vector<double> distances(count);
+    double seconds = Benchmark::Seconds([&]()
+        {
+            KDTree::Nearest(tree, queries.data(), count, 1, indices.data(),
+                            distances.data());
+        });
+    Benchmark::Report("KDTree nearest, arbitrary query order", seconds,
+                      count);
+
+    std::vector<uint64_t> codes(count);
+    std::vector<unsigned int> permutation(count);
+    SpaceFillingCurve::HilbertCodes(queries.data(), count,
+        AABB::FromPoints(queries.data(), count), codes.data());
+    SpaceFillingCurve::Order(codes.data(), count, permutation.data());
+    SpaceFillingCurve::Permute(queries, permutation.data());
+    seconds = Benchmark::Seconds([&]()
+        {
+            KDTree::Nearest(tree, queries.data(), count, 1, indices.data(),
+                            distances.data());
+        });
+    Benchmark::Report("KDTree nearest, Hilbert query order", seconds, count);
+    CHECK(distances[0] >= 0);
+}
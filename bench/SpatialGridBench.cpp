@@ -0,0 +1,58 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for the SpatialGrid rebuild and queries.
+ */
+
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "SpatialGrid.hpp"
+
+
+TEST_CASE("SpatialGrid rebuild and radius", "[SpatialGrid]")
+{
+    const size_t count = 1 << 20;
+    const size_t queries = 1 << 16;
+    std::vector<Vector3> points = Benchmark::RandomPoints(count, 100, 1);
+    SpatialGrid grid = SpatialGrid(1);
+    SpatialGrid::Rebuild(grid, points.data(), count);
+    double seconds = Benchmark::Seconds([&]()
+        {
+            SpatialGrid::Rebuild(grid, points.data(), count);
+        });
+    Benchmark::Report("SpatialGrid rebuild (1M points)", seconds, count);
+    CHECK(grid.CellStart.back() == count);
+
+    std::vector<size_t> offsets;
+    std::vector<size_t> indices;
+    seconds = Benchmark::Seconds([&]()
+        {
+            SpatialGrid::Radius(grid, points.data(), queries, 1, offsets,
+                                indices);
+        });
+    Benchmark::Report("SpatialGrid radius", seconds, queries);
+    CHECK(indices.size() >= queries);
+}
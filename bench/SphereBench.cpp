@@ -0,0 +1,100 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for the Sphere and Plane batch raycasts,
+ *  comparing them against calling the scalar raycasts in a loop.
+ */
+
+#include <memory>
+#include <vector>
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "Plane.hpp"
+#include "Sphere.hpp"
+
+
+TEST_CASE("Sphere and plane batch raycast", "[Sphere]")
+{
+    const size_t count = 1 << 20;
+    std::vector<Vector3> points = Benchmark::RandomPoints(count, 100, 1);
+    std::vector<Vector3> offsets = Benchmark::RandomPoints(count, 1, 2);
+    Vector3Array centers = Vector3Array(points.data(), count);
+    std::vector<double> radii(count);
+    for (size_t i = 0; i < count; i++)
+        radii[i] = offsets[i].X + 1.5;
+    std::unique_ptr<bool[]> hits(new bool[count]);
+    std::vector<double> distances(count);
+    Ray ray = Ray(Vector3(-100, -3, 5), Vector3(1, 0.1, -0.05));
+
+    double seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                Sphere sphere = Sphere(points[i], radii[i]);
+                hits[i] = Sphere::Raycast(sphere, ray, 500, distances[i]);
+            }
+        });
+    Benchmark::Report("Sphere scalar loop (1M)", seconds, count);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            Sphere::Raycast(centers, radii.data(), ray, 500, hits.get(),
+                            distances.data());
+        });
+    Benchmark::Report("Sphere batch, one ray (1M)", seconds, count);
+
+    Vector3Array directions = Vector3Array(offsets.data(), count);
+    Sphere sphere = Sphere(Vector3(0, 0, 0), 20);
+    seconds = Benchmark::Seconds([&]()
+        {
+            Sphere::Raycast(sphere, centers, directions, 500, hits.get(),
+                            distances.data());
+        });
+    Benchmark::Report("Sphere batch, many rays (1M)", seconds, count);
+
+    Vector3Array normals = Vector3Array(count);
+    for (size_t i = 0; i < count; i++)
+        Vector3Array::Set(normals, i, Vector3::Normalized(offsets[i]));
+    seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                Plane plane = Plane(Vector3Array::Get(normals, i), radii[i]);
+                hits[i] = Plane::Raycast(plane, ray, 500, distances[i]);
+            }
+        });
+    Benchmark::Report("Plane scalar loop (1M)", seconds, count);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            Plane::Raycast(normals, radii.data(), ray, 500, hits.get(),
+                           distances.data());
+        });
+    Benchmark::Report("Plane batch, one ray (1M)", seconds, count);
+    double distance;
+    Plane plane = Plane(Vector3Array::Get(normals, 0), radii[0]);
+    CHECK(Plane::Raycast(plane, ray, 500, distance) == hits[0]);
+}
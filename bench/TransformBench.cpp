@@ -0,0 +1,85 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for Transform, comparing its cached matrices
+ *  against rebuilding the rotation matrix for every query.
+ */
+
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "Transform.hpp"
+
+
+TEST_CASE("Transform cached queries", "[Transform]")
+{
+    // Queries cycle through many transforms, so that the rebuilt rotation
+    // matrix cannot be hoisted out of the loop
+    const size_t count = 1 << 20;
+    const size_t transforms = 1 << 10;
+    std::vector<Vector3> points = Benchmark::RandomPoints(count, 100, 1);
+    std::vector<Vector3> axes = Benchmark::RandomPoints(transforms, 2, 2);
+    std::vector<Vector3> output(count);
+    std::vector<Transform> cached(transforms);
+    for (size_t i = 0; i < transforms; i++)
+        cached[i] = Transform(axes[i] * 10, Quaternion(axes[i], 0.5),
+                              Vector3(2, 0.5, 3));
+    for (size_t i = 0; i < transforms; i++)
+        Transform::Update(cached[i]);
+
+    double seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                const Transform &t = cached[i % transforms];
+                Matrix3x3 m = Matrix3x3::FromQuaternion(
+                    Transform::GetRotation(t));
+                Vector3 scale = Transform::GetScale(t);
+                Vector3 p = Vector3(points[i].X * scale.X,
+                    points[i].Y * scale.Y, points[i].Z * scale.Z);
+                output[i] = m * p + Transform::GetPosition(t);
+            }
+        });
+    Benchmark::Report("Rebuilt rotation per point (1M)", seconds, count);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+                output[i] = Transform::TransformPoint(cached[i % transforms],
+                                                      points[i]);
+        });
+    Benchmark::Report("Transform point, cached (1M)", seconds, count);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            size_t block = count / transforms;
+            for (size_t i = 0; i < transforms; i++)
+                Transform::TransformPoints(cached[i],
+                                           points.data() + i * block, block,
+                                           output.data() + i * block);
+        });
+    Benchmark::Report("Transform points, batch (1M)", seconds, count);
+    CHECK(output[0].X == output[0].X);
+}
@@ -0,0 +1,99 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains benchmarks for TransformHierarchy, comparing updates
+ *  done one level at a time against walking every node up to its root.
+ */
+
+#include <vector>
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "Random.hpp"
+#include "TransformHierarchy.hpp"
+
+
+TEST_CASE("TransformHierarchy updates", "[TransformHierarchy]")
+{
+    // Each node's parent is a random earlier node, giving a bushy tree
+    const size_t count = 1 << 20;
+    std::vector<unsigned int> parents(count);
+    std::vector<Quaternion> rotations(count);
+    std::vector<Vector3> positions = Benchmark::RandomPoints(count, 2, 1);
+    std::vector<Vector3> axes = Benchmark::RandomPoints(count, 2, 2);
+    unsigned int seed = 3;
+    parents[0] = TransformHierarchy::None;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i > 0)
+            parents[i] = (unsigned int)(Random::Value(seed) * i);
+        rotations[i] = Quaternion(axes[i], 0.1);
+    }
+    TransformHierarchy h = TransformHierarchy::Build(parents.data(), count,
+        rotations.data(), positions.data());
+
+    std::vector<Quaternion> worldRotations(count);
+    std::vector<Vector3> worldPositions(count);
+    double seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                Quaternion q = rotations[i];
+                Vector3 p = positions[i];
+                for (unsigned int n = parents[i];
+                     n != TransformHierarchy::None; n = parents[n])
+                {
+                    p = rotations[n] * p + positions[n];
+                    q = rotations[n] * q;
+                }
+                worldRotations[i] = q;
+                worldPositions[i] = p;
+            }
+        });
+    Benchmark::Report("Walk to root per node (1M)", seconds, count);
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            TransformHierarchy::SetLocal(h, 0, rotations[0], positions[0]);
+            TransformHierarchy::Update(h);
+        });
+    Benchmark::Report("Full update by level (1M)", seconds, count);
+
+    // Change nodes from the later half of the tree, whose subtrees are small
+    const size_t changed = 1 << 10;
+    size_t updated = 0;
+    seconds = Benchmark::Seconds([&]()
+        {
+            for (size_t i = 0; i < changed; i++)
+            {
+                size_t n = count / 2 + (i * 7919) % (count / 2);
+                TransformHierarchy::SetLocal(h, n, rotations[n],
+                                             positions[n]);
+            }
+            updated = TransformHierarchy::Update(h);
+        });
+    Benchmark::Report("Sparse update, 1K changed (nodes)", seconds, updated);
+    CHECK(worldPositions[count - 1].X == worldPositions[count - 1].X);
+}
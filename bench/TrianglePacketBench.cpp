@@ -0,0 +1,230 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains a small ray caster that renders a torus by testing
+ *  every pixel against every triangle, comparing the scalar triangle test
+ *  against ray and triangle packets. Throughput is in rays per second on
+ *  one core.
+ */
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <vector>
+#include "catch.hpp"
+#include "Benchmark.hpp"
+#include "BVH.hpp"
+#include "TrianglePacket.hpp"
+
+
+static const size_t ImageSize = 128;
+
+
+static std::vector<Vector3> TorusTriangles(size_t rings, size_t sides)
+{
+    std::vector<Vector3> vertices;
+    for (size_t i = 0; i < rings; i++)
+    {
+        for (size_t j = 0; j < sides; j++)
+        {
+            Vector3 p[4];
+            for (int k = 0; k < 4; k++)
+            {
+                double a = 2 * M_PI * (i + k / 2) / rings;
+                double b = 2 * M_PI * (j + k % 2) / sides;
+                double r = 2 + 0.8 * cos(b);
+                p[k] = Vector3(r * cos(a), r * sin(a), 0.8 * sin(b));
+            }
+            Vector3 quad[] = { p[0], p[1], p[3], p[0], p[3], p[2] };
+            vertices.insert(vertices.end(), quad, quad + 6);
+        }
+    }
+    return vertices;
+}
+
+static std::vector<Ray> CameraRays()
+{
+    // A pinhole camera looking down at the torus from an angle
+    std::vector<Ray> rays;
+    Vector3 origin = Vector3(0, -6, 4);
+    Vector3 forward = Vector3::Normalized(-origin);
+    Vector3 right = Vector3(1, 0, 0);
+    Vector3 up = Vector3::Cross(right, forward);
+    for (size_t y = 0; y < ImageSize; y++)
+    {
+        for (size_t x = 0; x < ImageSize; x++)
+        {
+            double u = (x + 0.5) / ImageSize - 0.5;
+            double v = (y + 0.5) / ImageSize - 0.5;
+            rays.push_back(Ray(origin, forward + right * u + up * v));
+        }
+    }
+    return rays;
+}
+
+template <size_t Width>
+static size_t RenderTrianglePackets(
+    const std::vector<TrianglePacket<Width>> &packets,
+    const std::vector<Ray> &rays, std::vector<double> &depth)
+{
+    size_t hits = 0;
+    double distances[Width];
+    for (size_t r = 0; r < rays.size(); r++)
+    {
+        double best = INFINITY;
+        for (size_t p = 0; p < packets.size(); p++)
+        {
+            unsigned int mask = TrianglePacket<Width>::Raycast(
+                packets[p], rays[r], best, distances);
+            for (size_t i = 0; mask != 0; i++, mask >>= 1)
+                if (mask & 1)
+                    best = std::min(best, distances[i]);
+        }
+        depth[r] = best;
+        hits += best < INFINITY;
+    }
+    return hits;
+}
+
+template <size_t Width>
+static size_t RenderRayPackets(const std::vector<Vector3> &vertices,
+                               const std::vector<Ray> &rays,
+                               std::vector<double> &depth)
+{
+    size_t hits = 0;
+    double distances[Width];
+    for (size_t r = 0; r < rays.size(); r += Width)
+    {
+        RayPacket<Width> packet = RayPacket<Width>::Load(&rays[r], Width);
+        double best[Width];
+        for (size_t i = 0; i < Width; i++)
+            best[i] = INFINITY;
+        for (size_t t = 0; t < vertices.size(); t += 3)
+        {
+            unsigned int mask = RayPacket<Width>::Raycast(
+                packet, vertices[t], vertices[t + 1], vertices[t + 2],
+                INFINITY, distances);
+            for (size_t i = 0; mask != 0; i++, mask >>= 1)
+                if (mask & 1)
+                    best[i] = std::min(best[i], distances[i]);
+        }
+        for (size_t i = 0; i < Width; i++)
+        {
+            depth[r + i] = best[i];
+            hits += best[i] < INFINITY;
+        }
+    }
+    return hits;
+}
+
+
+TEST_CASE("Triangle packet ray casting", "[TrianglePacket]")
+{
+    std::vector<Vector3> vertices = TorusTriangles(32, 16);
+    std::vector<Ray> rays = CameraRays();
+    std::vector<double> depth(rays.size()), packetDepth(rays.size());
+    size_t triangleCount = vertices.size() / 3;
+    size_t hits = 0, packetHits = 0;
+
+    double seconds = Benchmark::Seconds([&]()
+        {
+            hits = 0;
+            for (size_t r = 0; r < rays.size(); r++)
+            {
+                double best = INFINITY;
+                for (size_t t = 0; t < triangleCount; t++)
+                {
+                    double d;
+                    if (BVH::RaycastTriangle(rays[r].Origin,
+                                             rays[r].Direction,
+                                             vertices[3 * t],
+                                             vertices[3 * t + 1],
+                                             vertices[3 * t + 2], d))
+                        best = std::min(best, d);
+                }
+                depth[r] = best;
+                hits += best < INFINITY;
+            }
+        });
+    Benchmark::Report("Scalar, 1K triangles (16K rays)", seconds,
+                      rays.size());
+
+    std::vector<TrianglePacket<4>> packets4 =
+        TrianglePacket<4>::FromTriangles(vertices.data(), triangleCount);
+    seconds = Benchmark::Seconds([&]()
+        {
+            packetHits = RenderTrianglePackets(packets4, rays, packetDepth);
+        });
+    Benchmark::Report("Triangle packets of 4 (16K rays)", seconds,
+                      rays.size());
+
+    std::vector<TrianglePacket<8>> packets8 =
+        TrianglePacket<8>::FromTriangles(vertices.data(), triangleCount);
+    seconds = Benchmark::Seconds([&]()
+        {
+            packetHits = RenderTrianglePackets(packets8, rays, packetDepth);
+        });
+    Benchmark::Report("Triangle packets of 8 (16K rays)", seconds,
+                      rays.size());
+
+    std::vector<TrianglePacket<16>> packets16 =
+        TrianglePacket<16>::FromTriangles(vertices.data(), triangleCount);
+    seconds = Benchmark::Seconds([&]()
+        {
+            packetHits = RenderTrianglePackets(packets16, rays, packetDepth);
+        });
+    Benchmark::Report("Triangle packets of 16 (16K rays)", seconds,
+                      rays.size());
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            packetHits = RenderRayPackets<4>(vertices, rays, packetDepth);
+        });
+    Benchmark::Report("Ray packets of 4 (16K rays)", seconds, rays.size());
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            packetHits = RenderRayPackets<8>(vertices, rays, packetDepth);
+        });
+    Benchmark::Report("Ray packets of 8 (16K rays)", seconds, rays.size());
+
+    seconds = Benchmark::Seconds([&]()
+        {
+            packetHits = RenderRayPackets<16>(vertices, rays, packetDepth);
+        });
+    Benchmark::Report("Ray packets of 16 (16K rays)", seconds, rays.size());
+
+    // The scalar test can let a ray through between two triangles, so only
+    // the depths of pixels both renders hit are compared
+    size_t mismatches = 0;
+    for (size_t r = 0; r < rays.size(); r++)
+    {
+        if (depth[r] < INFINITY && packetDepth[r] < INFINITY)
+            mismatches += fabs(depth[r] - packetDepth[r]) > 1e-9;
+    }
+    CHECK(mismatches == 0);
+    CHECK(packetHits >= hits);
+    CHECK(hits > rays.size() / 4);
+}
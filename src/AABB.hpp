@@ -0,0 +1,366 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements an axis aligned bounding box, along with ray slab
+ *  tests against single boxes and arrays of boxes.
+ */
+
+#pragma once
+
+#include <float.h>
+#include <stddef.h>
+#include "DenormalGuard.hpp"
+#include "Matrix3x3.hpp"
+#include "Vector3.hpp"
+
+
+struct AABB
+{
+    Vector3 Min;
+    Vector3 Max;
+
+
+    /**
+     * Constructors.
+     * The default box is empty (Min is +infinity, Max is -infinity), so that
+     * expanding it by any point or box gives that point or box.
+     */
+    inline AABB();
+    inline AABB(Vector3 min, Vector3 max);
+
+
+    /**
+     * Constants for common boxes.
+     */
+    static inline AABB Empty();
+
+
+    /**
+     * Returns the center point of a box.
+     * @param box: The box in question.
+     * @return: A new vector.
+     */
+    static inline Vector3 Center(AABB box);
+
+    /**
+     * Returns true if a point lies inside or on the surface of a box.
+     * @param box: The box in question.
+     * @param point: The point to test.
+     * @return: A boolean.
+     */
+    static inline bool Contains(AABB box, Vector3 point);
+
+    /**
+     * Returns true if "other" lies entirely inside of "box".
+     * @param box: The containing box.
+     * @param other: The box to test.
+     * @return: A boolean.
+     */
+    static inline bool Contains(AABB box, AABB other);
+
+    /**
+     * Returns a box grown to include a point.
+     * @param box: The box to expand.
+     * @param point: The point to include.
+     * @return: A new box.
+     */
+    static inline AABB Expand(AABB box, Vector3 point);
+
+    /**
+     * Returns a box grown by "amount" in every direction.
+     * @param box: The box to expand.
+     * @param amount: The distance to move each face outward.
+     * @return: A new box.
+     */
+    static inline AABB Expand(AABB box, double amount);
+
+    /**
+     * Returns half of the size of a box along each axis.
+     * @param box: The box in question.
+     * @return: A new vector.
+     */
+    static inline Vector3 Extents(AABB box);
+
+    /**
+     * Returns the smallest box containing all of the points.
+     * @param points: The points to bound.
+     * @param count: The number of points.
+     * @return: A new box.
+     */
+    static inline AABB FromPoints(const Vector3 *points, size_t count);
+
+    /**
+     * Returns true if a box contains no points (Min is greater than Max on
+     * any axis).
+     * @param box: The box in question.
+     * @return: A boolean.
+     */
+    static inline bool IsEmpty(AABB box);
+
+    /**
+     * Returns true if two boxes overlap or touch.
+     * @param a: The first box.
+     * @param b: The second box.
+     * @return: A boolean.
+     */
+    static inline bool Overlaps(AABB a, AABB b);
+
+    /**
+     * Intersects a ray with a box using the slab method.
+     * @param box: The box to test.
+     * @param origin: The start of the ray.
+     * @param direction: The direction of the ray (need not be normalized).
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param distance: The ray parameter where the ray enters the box, or
+     * zero if it starts inside.
+     * @return: True if the ray hits the box.
+     */
+    static inline bool Raycast(AABB box, Vector3 origin, Vector3 direction,
+                               double maxDistance, double &distance);
+
+    /**
+     * Intersects one ray with an array of boxes using the slab method. The
+     * loop has no branches, so the compiler is free to vectorize it.
+     * @param boxes: The boxes to test.
+     * @param count: The number of boxes.
+     * @param origin: The start of the ray.
+     * @param direction: The direction of the ray (need not be normalized).
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param hits: The output hit flags, one per box.
+     * @param distances: The output entry distances, one per box. These are
+     * only meaningful where the hit flag is set.
+     */
+    static inline void Raycast(const AABB *boxes, size_t count,
+                               Vector3 origin, Vector3 direction,
+                               double maxDistance, bool *hits,
+                               double *distances);
+
+    /**
+     * Returns the size of a box along each axis.
+     * @param box: The box in question.
+     * @return: A new vector.
+     */
+    static inline Vector3 Size(AABB box);
+
+    /**
+     * Narrows the range [tMin, tMax] of a ray to the part that lies between
+     * two planes along one axis, the building block of the slab method. A
+     * ray parallel to the planes keeps its whole range when it lies between
+     * or on them, and loses it otherwise.
+     * @param min: The lower plane.
+     * @param max: The upper plane.
+     * @param origin: The start of the ray along the axis.
+     * @param inverse: One over the direction of the ray along the axis.
+     * @param tMin: The start of the range, which is updated.
+     * @param tMax: The end of the range, which is updated.
+     */
+    static inline void Slab(double min, double max, double origin,
+                            double inverse, double &tMin, double &tMax);
+
+    /**
+     * Returns the surface area of a box.
+     * @param box: The box in question.
+     * @return: A scalar value.
+     */
+    static inline double SurfaceArea(AABB box);
+
+    /**
+     * Returns the bounds of a box after it has been transformed by a matrix
+     * and then translated. This uses the absolute value of the matrix on the
+     * box extents, rather than transforming all eight corners.
+     * @param box: The box to transform.
+     * @param matrix: The linear part of the transformation.
+     * @param translation: The translation applied after the matrix.
+     * @return: A new box.
+     */
+    static inline AABB Transform(AABB box, Matrix3x3 matrix,
+                                 Vector3 translation);
+
+    /**
+     * Returns the smallest box containing both boxes.
+     * @param a: The first box.
+     * @param b: The second box.
+     * @return: A new box.
+     */
+    static inline AABB Union(AABB a, AABB b);
+};
+
+inline bool operator==(const AABB lhs, const AABB rhs);
+inline bool operator!=(const AABB lhs, const AABB rhs);
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+AABB::AABB() : Min(DBL_MAX, DBL_MAX, DBL_MAX), Max(-DBL_MAX, -DBL_MAX, -DBL_MAX)
+    {}
+AABB::AABB(Vector3 min, Vector3 max) : Min(min), Max(max) {}
+
+
+AABB AABB::Empty() { return AABB(); }
+
+
+Vector3 AABB::Center(AABB box)
+{
+    return (box.Min + box.Max) * 0.5;
+}
+
+bool AABB::Contains(AABB box, Vector3 point)
+{
+    return point.X >= box.Min.X && point.X <= box.Max.X &&
+        point.Y >= box.Min.Y && point.Y <= box.Max.Y &&
+        point.Z >= box.Min.Z && point.Z <= box.Max.Z;
+}
+
+bool AABB::Contains(AABB box, AABB other)
+{
+    return Contains(box, other.Min) && Contains(box, other.Max);
+}
+
+AABB AABB::Expand(AABB box, Vector3 point)
+{
+    return AABB(Vector3::Min(box.Min, point), Vector3::Max(box.Max, point));
+}
+
+AABB AABB::Expand(AABB box, double amount)
+{
+    return AABB(box.Min - amount, box.Max + amount);
+}
+
+Vector3 AABB::Extents(AABB box)
+{
+    return (box.Max - box.Min) * 0.5;
+}
+
+AABB AABB::FromPoints(const Vector3 *points, size_t count)
+{
+    AABB box;
+    for (size_t i = 0; i < count; i++)
+        box = Expand(box, points[i]);
+    return box;
+}
+
+bool AABB::IsEmpty(AABB box)
+{
+    return box.Min.X > box.Max.X || box.Min.Y > box.Max.Y ||
+        box.Min.Z > box.Max.Z;
+}
+
+bool AABB::Overlaps(AABB a, AABB b)
+{
+    return a.Min.X <= b.Max.X && a.Max.X >= b.Min.X &&
+        a.Min.Y <= b.Max.Y && a.Max.Y >= b.Min.Y &&
+        a.Min.Z <= b.Max.Z && a.Max.Z >= b.Min.Z;
+}
+
+bool AABB::Raycast(AABB box, Vector3 origin, Vector3 direction,
+                   double maxDistance, double &distance)
+{
+    bool hit;
+    Raycast(&box, 1, origin, direction, maxDistance, &hit, &distance);
+    return hit;
+}
+
+void AABB::Raycast(const AABB *boxes, size_t count, Vector3 origin,
+                   Vector3 direction, double maxDistance, bool *hits,
+                   double *distances)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect((const double *)boxes, count * 6);
+    double invX = 1 / direction.X;
+    double invY = 1 / direction.Y;
+    double invZ = 1 / direction.Z;
+    for (size_t i = 0; i < count; i++)
+    {
+        double tMin = 0;
+        double tMax = maxDistance;
+        Slab(boxes[i].Min.X, boxes[i].Max.X, origin.X, invX, tMin, tMax);
+        Slab(boxes[i].Min.Y, boxes[i].Max.Y, origin.Y, invY, tMin, tMax);
+        Slab(boxes[i].Min.Z, boxes[i].Max.Z, origin.Z, invZ, tMin, tMax);
+        hits[i] = tMin <= tMax;
+        distances[i] = tMin;
+    }
+}
+
+Vector3 AABB::Size(AABB box)
+{
+    return box.Max - box.Min;
+}
+
+void AABB::Slab(double min, double max, double origin, double inverse,
+                double &tMin, double &tMax)
+{
+    double t1 = (min - origin) * inverse;
+    double t2 = (max - origin) * inverse;
+    // A ray parallel to the slab gives infinities, or 0 * inf = NaN when it
+    // lies in one of the planes. That plane doesn't limit the ray, so take
+    // the opposite infinity from the other plane, and a NaN left over when
+    // it lies in both is ignored by the comparisons below
+    t1 = t1 != t1 ? -t2 : t1;
+    t2 = t2 != t2 ? -t1 : t2;
+    double enter = t1 < t2 ? t1 : t2;
+    double exit = t1 < t2 ? t2 : t1;
+    tMin = enter > tMin ? enter : tMin;
+    tMax = exit < tMax ? exit : tMax;
+}
+
+double AABB::SurfaceArea(AABB box)
+{
+    Vector3 d = box.Max - box.Min;
+    return 2 * (d.X * d.Y + d.Y * d.Z + d.Z * d.X);
+}
+
+AABB AABB::Transform(AABB box, Matrix3x3 matrix, Vector3 translation)
+{
+    Vector3 center = matrix * Center(box) + translation;
+    Vector3 e = Extents(box);
+    Vector3 extents;
+    extents.X = fabs(matrix.D00) * e.X + fabs(matrix.D01) * e.Y +
+        fabs(matrix.D02) * e.Z;
+    extents.Y = fabs(matrix.D10) * e.X + fabs(matrix.D11) * e.Y +
+        fabs(matrix.D12) * e.Z;
+    extents.Z = fabs(matrix.D20) * e.X + fabs(matrix.D21) * e.Y +
+        fabs(matrix.D22) * e.Z;
+    return AABB(center - extents, center + extents);
+}
+
+AABB AABB::Union(AABB a, AABB b)
+{
+    return AABB(Vector3::Min(a.Min, b.Min), Vector3::Max(a.Max, b.Max));
+}
+
+
+bool operator==(const AABB lhs, const AABB rhs)
+{
+    return lhs.Min == rhs.Min && lhs.Max == rhs.Max;
+}
+
+bool operator!=(const AABB lhs, const AABB rhs)
+{
+    return !(lhs == rhs);
+}
@@ -0,0 +1,710 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a bounding volume hierarchy over triangles, built
+ *  with the binned surface area heuristic, along with ray, overlap and
+ *  nearest point queries.
+ */
+
+#pragma once
+
+#include <float.h>
+#include <math.h>
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include "AABB.hpp"
+#include "Parallel.hpp"
+#include "Vector3.hpp"
+
+
+/**
+ * A node of a flattened BVH. The bounds are stored in single precision and
+ * rounded outward, so they always contain the double precision bounds while
+ * keeping each node at 32 bytes. Interior nodes have a Count of zero and
+ * their two children are stored next to each other starting at Offset. Leaf
+ * nodes reference Count entries of BVH::Indices starting at Offset.
+ */
+struct BVHNode
+{
+    float Min[3];
+    float Max[3];
+    unsigned int Offset;
+    unsigned int Count;
+};
+
+
+/**
+ * A bin used while evaluating split candidates during a build.
+ */
+struct BVHBin
+{
+    AABB Bounds;
+    size_t Count;
+
+    inline BVHBin() : Bounds(), Count(0) {}
+};
+
+
+struct BVH
+{
+    std::vector<BVHNode> Nodes;
+    std::vector<unsigned int> Indices;
+
+
+    /**
+     * Build parameters.
+     * Bins is the number of split candidates tested per axis, MaxLeafSize is
+     * the most primitives a leaf may hold, and SahDepth is the depth below
+     * which nodes are split at their median instead (so no tree is ever
+     * deeper than MaxDepth). Ranges with at least ParallelGrain primitives
+     * are processed on multiple threads.
+     */
+    static constexpr int Bins = 16;
+    static constexpr size_t MaxLeafSize = 8;
+    static constexpr int SahDepth = 32;
+    static constexpr int MaxDepth = 64;
+    static constexpr size_t ParallelGrain = 1 << 15;
+
+
+    /**
+     * Builds a BVH over arbitrary primitives from their bounds. The queries
+     * below treat primitive i as triangle i of a triangle list.
+     * @param bounds: The bounds of each primitive.
+     * @param count: The number of primitives.
+     * @return: A new BVH.
+     */
+    static inline BVH Build(const AABB *bounds, size_t count);
+
+    /**
+     * Builds a BVH over a triangle list, where triangle i is made of
+     * vertices 3i, 3i + 1 and 3i + 2.
+     * @param vertices: The triangle vertices.
+     * @param triangleCount: The number of triangles.
+     * @return: A new BVH.
+     */
+    static inline BVH FromTriangles(const Vector3 *vertices,
+                                    size_t triangleCount);
+
+    /**
+     * Finds the point on a triangle list closest to "point".
+     * @param bvh: The BVH built over the triangles.
+     * @param vertices: The triangle vertices.
+     * @param point: The query point.
+     * @param maxDistance: The largest distance to search.
+     * @param triangle: The index of the closest triangle.
+     * @param closest: The closest point on that triangle.
+     * @return: True if a triangle was found within maxDistance.
+     */
+    static inline bool Nearest(const BVH &bvh, const Vector3 *vertices,
+                               Vector3 point, double maxDistance,
+                               size_t &triangle, Vector3 &closest);
+
+    /**
+     * Finds every triangle whose bounds overlap a box.
+     * @param bvh: The BVH built over the triangles.
+     * @param vertices: The triangle vertices.
+     * @param box: The query box.
+     * @param triangles: The output list, which the indices are appended to.
+     */
+    static inline void Overlap(const BVH &bvh, const Vector3 *vertices,
+                               AABB box, std::vector<size_t> &triangles);
+
+    /**
+     * Finds the first triangle hit by a ray.
+     * @param bvh: The BVH built over the triangles.
+     * @param vertices: The triangle vertices.
+     * @param origin: The start of the ray.
+     * @param direction: The direction of the ray (need not be normalized).
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param triangle: The index of the triangle hit.
+     * @param distance: The ray parameter of the hit.
+     * @return: True if the ray hit a triangle.
+     */
+    static inline bool Raycast(const BVH &bvh, const Vector3 *vertices,
+                               Vector3 origin, Vector3 direction,
+                               double maxDistance, size_t &triangle,
+                               double &distance);
+
+
+    /**
+     * Helpers used by the build and the queries.
+     */
+    static inline int BinIndex(double value, double min, double scale);
+    static inline void BinRange(const unsigned int *indices, size_t begin,
+                                size_t end, const AABB *bounds,
+                                const Vector3 *centroids, AABB centers,
+                                Vector3 scale, BVHBin *bins);
+    static inline void BoundRange(const unsigned int *indices, size_t begin,
+                                  size_t end, const AABB *bounds,
+                                  const Vector3 *centroids, AABB &box,
+                                  AABB &centers);
+    static inline void BuildNode(BVH &bvh, const AABB *bounds,
+                                 const Vector3 *centroids, size_t node,
+                                 size_t begin, size_t end, int depth,
+                                 int forks, std::atomic<size_t> &next);
+    static inline Vector3 ClosestPointOnTriangle(Vector3 point, Vector3 a,
+                                                 Vector3 b, Vector3 c);
+    static inline double NodeDistance(const BVHNode &node, Vector3 point);
+    static inline bool NodeOverlaps(const BVHNode &node, AABB box);
+    static inline bool NodeRaycast(const BVHNode &node, Vector3 origin,
+                                   Vector3 inverse, double maxDistance,
+                                   double &distance);
+    static inline bool RaycastTriangle(Vector3 origin, Vector3 direction,
+                                       Vector3 a, Vector3 b, Vector3 c,
+                                       double &distance);
+    static inline void SetBounds(BVHNode &node, AABB box);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+BVH BVH::Build(const AABB *bounds, size_t count)
+{
+    BVH bvh;
+    if (count == 0)
+        return bvh;
+    bvh.Indices.resize(count);
+    std::vector<Vector3> centroids(count);
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          bvh.Indices[i] = (unsigned int)i;
+                          centroids[i] = AABB::Center(bounds[i]);
+                      }
+                  });
+    // A tree over n primitives has at most 2n - 1 nodes, and slot 0 holds
+    // the root so that every pair of siblings starts at an odd index
+    bvh.Nodes.resize(2 * count);
+    std::atomic<size_t> next(1);
+    int forks = 0;
+    while (((size_t)1 << forks) < Parallel::ThreadCount())
+        forks++;
+    BuildNode(bvh, bounds, centroids.data(), 0, 0, count, 0, forks, next);
+    bvh.Nodes.resize(next.load());
+    return bvh;
+}
+
+BVH BVH::FromTriangles(const Vector3 *vertices, size_t triangleCount)
+{
+    std::vector<AABB> bounds(triangleCount);
+    Parallel::For(triangleCount, ParallelGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          AABB box = AABB(vertices[3 * i], vertices[3 * i]);
+                          box = AABB::Expand(box, vertices[3 * i + 1]);
+                          bounds[i] = AABB::Expand(box, vertices[3 * i + 2]);
+                      }
+                  });
+    return Build(bounds.data(), triangleCount);
+}
+
+bool BVH::Nearest(const BVH &bvh, const Vector3 *vertices, Vector3 point,
+                  double maxDistance, size_t &triangle, Vector3 &closest)
+{
+    if (bvh.Nodes.empty())
+        return false;
+    bool found = false;
+    double best = maxDistance * maxDistance;
+    size_t stack[MaxDepth + 2];
+    double stackDistance[MaxDepth + 2];
+    int top = 0;
+    stack[top] = 0;
+    stackDistance[top++] = NodeDistance(bvh.Nodes[0], point);
+    while (top > 0)
+    {
+        top--;
+        if (stackDistance[top] > best)
+            continue;
+        const BVHNode &node = bvh.Nodes[stack[top]];
+        if (node.Count > 0)
+        {
+            for (size_t i = node.Offset; i < node.Offset + node.Count; i++)
+            {
+                size_t t = bvh.Indices[i];
+                Vector3 c = ClosestPointOnTriangle(point, vertices[3 * t],
+                    vertices[3 * t + 1], vertices[3 * t + 2]);
+                double d = Vector3::SqrMagnitude(c - point);
+                if (d < best)
+                {
+                    best = d;
+                    triangle = t;
+                    closest = c;
+                    found = true;
+                }
+            }
+            continue;
+        }
+        size_t first = node.Offset;
+        size_t second = node.Offset + 1;
+        double firstDistance = NodeDistance(bvh.Nodes[first], point);
+        double secondDistance = NodeDistance(bvh.Nodes[second], point);
+        if (firstDistance > secondDistance)
+        {
+            std::swap(first, second);
+            std::swap(firstDistance, secondDistance);
+        }
+        if (secondDistance <= best)
+        {
+            stack[top] = second;
+            stackDistance[top++] = secondDistance;
+        }
+        if (firstDistance <= best)
+        {
+            stack[top] = first;
+            stackDistance[top++] = firstDistance;
+        }
+    }
+    return found;
+}
+
+void BVH::Overlap(const BVH &bvh, const Vector3 *vertices, AABB box,
+                  std::vector<size_t> &triangles)
+{
+    if (bvh.Nodes.empty() || !NodeOverlaps(bvh.Nodes[0], box))
+        return;
+    size_t stack[MaxDepth + 2];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const BVHNode &node = bvh.Nodes[stack[--top]];
+        if (node.Count > 0)
+        {
+            for (size_t i = node.Offset; i < node.Offset + node.Count; i++)
+            {
+                size_t t = bvh.Indices[i];
+                AABB bounds = AABB(vertices[3 * t], vertices[3 * t]);
+                bounds = AABB::Expand(bounds, vertices[3 * t + 1]);
+                bounds = AABB::Expand(bounds, vertices[3 * t + 2]);
+                if (AABB::Overlaps(bounds, box))
+                    triangles.push_back(t);
+            }
+            continue;
+        }
+        if (NodeOverlaps(bvh.Nodes[node.Offset + 1], box))
+            stack[top++] = node.Offset + 1;
+        if (NodeOverlaps(bvh.Nodes[node.Offset], box))
+            stack[top++] = node.Offset;
+    }
+}
+
+bool BVH::Raycast(const BVH &bvh, const Vector3 *vertices, Vector3 origin,
+                  Vector3 direction, double maxDistance, size_t &triangle,
+                  double &distance)
+{
+    if (bvh.Nodes.empty())
+        return false;
+    Vector3 inverse = Vector3(1 / direction.X, 1 / direction.Y,
+                              1 / direction.Z);
+    bool hit = false;
+    double best = maxDistance;
+    size_t stack[MaxDepth + 2];
+    double stackDistance[MaxDepth + 2];
+    int top = 0;
+    if (!NodeRaycast(bvh.Nodes[0], origin, inverse, best, stackDistance[0]))
+        return false;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        top--;
+        if (stackDistance[top] > best)
+            continue;
+        const BVHNode &node = bvh.Nodes[stack[top]];
+        if (node.Count > 0)
+        {
+            for (size_t i = node.Offset; i < node.Offset + node.Count; i++)
+            {
+                size_t t = bvh.Indices[i];
+                double d;
+                if (RaycastTriangle(origin, direction, vertices[3 * t],
+                                    vertices[3 * t + 1], vertices[3 * t + 2],
+                                    d) && d <= best)
+                {
+                    best = d;
+                    triangle = t;
+                    hit = true;
+                }
+            }
+            continue;
+        }
+        size_t first = node.Offset;
+        size_t second = node.Offset + 1;
+        double firstDistance, secondDistance;
+        bool hitFirst = NodeRaycast(bvh.Nodes[first], origin, inverse,
+                                    best, firstDistance);
+        bool hitSecond = NodeRaycast(bvh.Nodes[second], origin, inverse,
+                                     best, secondDistance);
+        if (hitFirst && hitSecond && firstDistance > secondDistance)
+        {
+            std::swap(first, second);
+            std::swap(firstDistance, secondDistance);
+        }
+        else if (!hitFirst)
+        {
+            std::swap(first, second);
+            std::swap(firstDistance, secondDistance);
+            std::swap(hitFirst, hitSecond);
+        }
+        if (hitSecond)
+        {
+            stack[top] = second;
+            stackDistance[top++] = secondDistance;
+        }
+        if (hitFirst)
+        {
+            stack[top] = first;
+            stackDistance[top++] = firstDistance;
+        }
+    }
+    if (hit)
+        distance = best;
+    return hit;
+}
+
+
+int BVH::BinIndex(double value, double min, double scale)
+{
+    int bin = (int)((value - min) * scale);
+    return bin < Bins ? bin : Bins - 1;
+}
+
+void BVH::BinRange(const unsigned int *indices, size_t begin, size_t end,
+                   const AABB *bounds, const Vector3 *centroids,
+                   AABB centers, Vector3 scale, BVHBin *bins)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        unsigned int p = indices[i];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (scale.data[axis] == 0)
+                continue;
+            BVHBin &bin = bins[axis * Bins + BinIndex(
+                centroids[p].data[axis], centers.Min.data[axis],
+                scale.data[axis])];
+            bin.Bounds = AABB::Union(bin.Bounds, bounds[p]);
+            bin.Count++;
+        }
+    }
+}
+
+void BVH::BoundRange(const unsigned int *indices, size_t begin, size_t end,
+                     const AABB *bounds, const Vector3 *centroids, AABB &box,
+                     AABB &centers)
+{
+    for (size_t i = begin; i < end; i++)
+    {
+        box = AABB::Union(box, bounds[indices[i]]);
+        centers = AABB::Expand(centers, centroids[indices[i]]);
+    }
+}
+
+void BVH::BuildNode(BVH &bvh, const AABB *bounds, const Vector3 *centroids,
+                    size_t node, size_t begin, size_t end, int depth,
+                    int forks, std::atomic<size_t> &next)
+{
+    size_t count = end - begin;
+    unsigned int *indices = bvh.Indices.data() + begin;
+
+    // Bound the primitives and their centroids
+    AABB box;
+    AABB centers;
+    size_t chunks = Parallel::Chunks(count, ParallelGrain);
+    if (chunks > 1)
+    {
+        std::vector<AABB> boxes(chunks);
+        std::vector<AABB> centerBoxes(chunks);
+        Parallel::For(count, ParallelGrain,
+                      [&](size_t chunk, size_t b, size_t e)
+                      {
+                          BoundRange(indices, b, e, bounds, centroids,
+                                     boxes[chunk], centerBoxes[chunk]);
+                      });
+        for (size_t i = 0; i < chunks; i++)
+        {
+            box = AABB::Union(box, boxes[i]);
+            centers = AABB::Union(centers, centerBoxes[i]);
+        }
+    }
+    else
+        BoundRange(indices, 0, count, bounds, centroids, box, centers);
+    SetBounds(bvh.Nodes[node], box);
+    bvh.Nodes[node].Offset = (unsigned int)begin;
+    bvh.Nodes[node].Count = (unsigned int)count;
+    if (count == 1)
+        return;
+
+    Vector3 extent = AABB::Size(centers);
+    int largest = extent.X >= extent.Y ? (extent.X >= extent.Z ? 0 : 2) :
+        (extent.Y >= extent.Z ? 1 : 2);
+    size_t mid = 0;
+    if (count <= MaxLeafSize && depth >= SahDepth)
+        return;
+    if (extent.data[largest] == 0)
+    {
+        // Every centroid is the same, so no split can separate them
+        if (count <= MaxLeafSize)
+            return;
+        mid = count / 2;
+    }
+    else if (depth < SahDepth)
+    {
+        // Bin the centroids along each axis
+        Vector3 scale;
+        for (int axis = 0; axis < 3; axis++)
+            scale.data[axis] = extent.data[axis] > 0 ?
+                Bins / extent.data[axis] : 0;
+        std::vector<BVHBin> bins(chunks * 3 * Bins);
+        if (chunks > 1)
+        {
+            Parallel::For(count, ParallelGrain,
+                          [&](size_t chunk, size_t b, size_t e)
+                          {
+                              BinRange(indices, b, e, bounds, centroids,
+                                       centers, scale,
+                                       &bins[chunk * 3 * Bins]);
+                          });
+            for (size_t c = 1; c < chunks; c++)
+                for (int i = 0; i < 3 * Bins; i++)
+                {
+                    BVHBin &bin = bins[c * 3 * Bins + i];
+                    bins[i].Bounds = AABB::Union(bins[i].Bounds, bin.Bounds);
+                    bins[i].Count += bin.Count;
+                }
+        }
+        else
+            BinRange(indices, 0, count, bounds, centroids, centers, scale,
+                     bins.data());
+
+        // Sweep each axis for the split with the lowest surface area cost
+        double bestCost = INFINITY;
+        int bestAxis = -1;
+        int bestSplit = 0;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (scale.data[axis] == 0)
+                continue;
+            const BVHBin *axisBins = &bins[axis * Bins];
+            double leftCost[Bins];
+            size_t leftCount[Bins];
+            AABB accumulated;
+            size_t n = 0;
+            for (int i = 0; i < Bins - 1; i++)
+            {
+                accumulated = AABB::Union(accumulated, axisBins[i].Bounds);
+                n += axisBins[i].Count;
+                leftCount[i] = n;
+                leftCost[i] = n > 0 ? AABB::SurfaceArea(accumulated) * n : 0;
+            }
+            accumulated = AABB();
+            n = 0;
+            for (int i = Bins - 1; i > 0; i--)
+            {
+                accumulated = AABB::Union(accumulated, axisBins[i].Bounds);
+                n += axisBins[i].Count;
+                if (n == 0 || leftCount[i - 1] == 0)
+                    continue;
+                double cost = leftCost[i - 1] +
+                    AABB::SurfaceArea(accumulated) * n;
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = i;
+                }
+            }
+        }
+
+        // A traversal step costs about as much as one primitive test
+        double area = AABB::SurfaceArea(box);
+        if (count <= MaxLeafSize &&
+            (bestAxis < 0 || area <= 0 || count <= 1 + bestCost / area))
+            return;
+        if (bestAxis >= 0)
+        {
+            double min = centers.Min.data[bestAxis];
+            double axisScale = scale.data[bestAxis];
+            mid = std::partition(indices, indices + count,
+                                 [&](unsigned int p)
+                                 {
+                                     return BinIndex(
+                                         centroids[p].data[bestAxis], min,
+                                         axisScale) < bestSplit;
+                                 }) - indices;
+        }
+    }
+    if (mid == 0 || mid == count)
+    {
+        // Fall back to splitting at the median of the largest axis
+        mid = count / 2;
+        std::nth_element(indices, indices + mid, indices + count,
+                         [&](unsigned int a, unsigned int b)
+                         {
+                             return centroids[a].data[largest] <
+                                 centroids[b].data[largest];
+                         });
+    }
+
+    size_t left = next.fetch_add(2);
+    bvh.Nodes[node].Offset = (unsigned int)left;
+    bvh.Nodes[node].Count = 0;
+    if (forks > 0 && count >= ParallelGrain)
+        Parallel::Invoke(
+            [&]()
+            {
+                BuildNode(bvh, bounds, centroids, left, begin, begin + mid,
+                          depth + 1, forks - 1, next);
+            },
+            [&]()
+            {
+                BuildNode(bvh, bounds, centroids, left + 1, begin + mid, end,
+                          depth + 1, forks - 1, next);
+            });
+    else
+    {
+        BuildNode(bvh, bounds, centroids, left, begin, begin + mid,
+                  depth + 1, 0, next);
+        BuildNode(bvh, bounds, centroids, left + 1, begin + mid, end,
+                  depth + 1, 0, next);
+    }
+}
+
+Vector3 BVH::ClosestPointOnTriangle(Vector3 point, Vector3 a, Vector3 b,
+                                    Vector3 c)
+{
+    // Ericson, Real-Time Collision Detection, section 5.1.5
+    Vector3 ab = b - a;
+    Vector3 ac = c - a;
+    Vector3 ap = point - a;
+    double d1 = Vector3::Dot(ab, ap);
+    double d2 = Vector3::Dot(ac, ap);
+    if (d1 <= 0 && d2 <= 0)
+        return a;
+    Vector3 bp = point - b;
+    double d3 = Vector3::Dot(ab, bp);
+    double d4 = Vector3::Dot(ac, bp);
+    if (d3 >= 0 && d4 <= d3)
+        return b;
+    double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0)
+        return a + ab * (d1 / (d1 - d3));
+    Vector3 cp = point - c;
+    double d5 = Vector3::Dot(ab, cp);
+    double d6 = Vector3::Dot(ac, cp);
+    if (d6 >= 0 && d5 <= d6)
+        return c;
+    double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0)
+        return a + ac * (d2 / (d2 - d6));
+    double va = d3 * d6 - d5 * d4;
+    if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    double denom = 1 / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+double BVH::NodeDistance(const BVHNode &node, Vector3 point)
+{
+    double d = 0;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        double v = point.data[axis];
+        if (v < node.Min[axis])
+            d += (node.Min[axis] - v) * (node.Min[axis] - v);
+        else if (v > node.Max[axis])
+            d += (v - node.Max[axis]) * (v - node.Max[axis]);
+    }
+    return d;
+}
+
+bool BVH::NodeOverlaps(const BVHNode &node, AABB box)
+{
+    return node.Min[0] <= box.Max.X && node.Max[0] >= box.Min.X &&
+        node.Min[1] <= box.Max.Y && node.Max[1] >= box.Min.Y &&
+        node.Min[2] <= box.Max.Z && node.Max[2] >= box.Min.Z;
+}
+
+bool BVH::NodeRaycast(const BVHNode &node, Vector3 origin, Vector3 inverse,
+                      double maxDistance, double &distance)
+{
+    double tMin = 0;
+    double tMax = maxDistance;
+    for (int axis = 0; axis < 3; axis++)
+        AABB::Slab(node.Min[axis], node.Max[axis], origin.data[axis],
+                   inverse.data[axis], tMin, tMax);
+    distance = tMin;
+    return tMin <= tMax;
+}
+
+bool BVH::RaycastTriangle(Vector3 origin, Vector3 direction, Vector3 a,
+                          Vector3 b, Vector3 c, double &distance)
+{
+    // Moller and Trumbore, Fast, Minimum Storage Ray/Triangle Intersection
+    Vector3 e1 = b - a;
+    Vector3 e2 = c - a;
+    Vector3 p = Vector3::Cross(direction, e2);
+    double det = Vector3::Dot(e1, p);
+    if (det == 0)
+        return false;
+    double inv = 1 / det;
+    Vector3 s = origin - a;
+    double u = Vector3::Dot(s, p) * inv;
+    if (u < 0 || u > 1)
+        return false;
+    Vector3 q = Vector3::Cross(s, e1);
+    double v = Vector3::Dot(direction, q) * inv;
+    if (v < 0 || u + v > 1)
+        return false;
+    double t = Vector3::Dot(e2, q) * inv;
+    if (t < 0)
+        return false;
+    distance = t;
+    return true;
+}
+
+void BVH::SetBounds(BVHNode &node, AABB box)
+{
+    for (int axis = 0; axis < 3; axis++)
+    {
+        float min = (float)box.Min.data[axis];
+        float max = (float)box.Max.data[axis];
+        if (min > box.Min.data[axis])
+            min = nextafterf(min, -INFINITY);
+        if (max < box.Max.data[axis])
+            max = nextafterf(max, INFINITY);
+        node.Min[axis] = min;
+        node.Max[axis] = max;
+    }
+}
@@ -0,0 +1,252 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a scoped guard which flushes denormal (subnormal)
+ *  floating point values to zero, along with tools for counting how many
+ *  subnormal values a piece of code runs into.
+ */
+
+#pragma once
+
+#include <float.h>
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#   include <xmmintrin.h>
+#   define GMATH_DENORMAL_MXCSR
+#elif defined(__aarch64__)
+#   define GMATH_DENORMAL_FPCR
+#endif
+
+
+/**
+ * Batch kernels in this library construct a DenormalGuard with this value.
+ * Define it as 1 before including the library to make every batch kernel
+ * flush denormals to zero for the duration of the call.
+ */
+#ifndef GMATH_FLUSH_DENORMALS
+#   define GMATH_FLUSH_DENORMALS 0
+#endif
+
+
+struct DenormalGuard
+{
+    unsigned long long Saved;
+    bool Active;
+
+
+    /**
+     * Constructors.
+     * Enables flush-to-zero and denormals-are-zero until the guard goes out
+     * of scope, at which point the previous state is restored. If "enable" is
+     * false, the guard does nothing.
+     */
+    inline DenormalGuard();
+    inline explicit DenormalGuard(bool enable);
+    inline ~DenormalGuard();
+
+    DenormalGuard(const DenormalGuard&) = delete;
+    DenormalGuard& operator=(const DenormalGuard&) = delete;
+
+
+    /**
+     * Returns the number of subnormal values in an array.
+     * @param values: The values to check.
+     * @param count: The number of values.
+     * @return: A count.
+     */
+    static inline size_t CountSubnormals(const double *values, size_t count);
+
+    /**
+     * Records the subnormal values in an array into the running diagnostic
+     * count. This does nothing unless diagnostics have been enabled.
+     * @param values: The values to check.
+     * @param count: The number of values.
+     */
+    static inline void Inspect(const double *values, size_t count);
+
+    /**
+     * Returns true if denormals are currently being flushed to zero on the
+     * calling thread.
+     * @return: A boolean.
+     */
+    static inline bool IsFlushing();
+
+    /**
+     * Returns true if Inspect is currently recording subnormal values.
+     * @return: A boolean.
+     */
+    static inline bool IsRecording();
+
+    /**
+     * Returns true if the value is subnormal (non-zero and smaller in
+     * magnitude than the smallest normal double). The value is classified by
+     * its bits, so the answer is the same while a guard is active.
+     * @param value: The value in question.
+     * @return: A boolean.
+     */
+    static inline bool IsSubnormal(double value);
+
+    /**
+     * Resets the running diagnostic count to zero.
+     */
+    static inline void ResetSubnormalCount();
+
+    /**
+     * Turns the diagnostic mode on or off. While on, every batch kernel adds
+     * the number of subnormal inputs it was given to a shared count.
+     * @param enable: True to start recording, false to stop.
+     */
+    static inline void SetRecording(bool enable);
+
+    /**
+     * Returns the number of subnormal values recorded by Inspect since the
+     * last reset.
+     * @return: A count.
+     */
+    static inline size_t SubnormalCount();
+
+    /**
+     * Returns the shared diagnostic state.
+     */
+    static inline std::atomic<size_t>& Counter();
+    static inline std::atomic<bool>& Recording();
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+DenormalGuard::DenormalGuard() : DenormalGuard(true) {}
+
+DenormalGuard::DenormalGuard(bool enable) : Saved(0), Active(enable)
+{
+    if (!Active)
+        return;
+#if defined(GMATH_DENORMAL_MXCSR)
+    // Bit 15 is flush-to-zero, bit 6 is denormals-are-zero
+    Saved = _mm_getcsr();
+    _mm_setcsr((unsigned int)Saved | 0x8040);
+#elif defined(GMATH_DENORMAL_FPCR)
+    // Bit 24 flushes both denormal inputs and outputs
+    unsigned long long fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    Saved = fpcr;
+    fpcr |= 1ULL << 24;
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#endif
+}
+
+DenormalGuard::~DenormalGuard()
+{
+    if (!Active)
+        return;
+#if defined(GMATH_DENORMAL_MXCSR)
+    _mm_setcsr((unsigned int)Saved);
+#elif defined(GMATH_DENORMAL_FPCR)
+    unsigned long long fpcr = Saved;
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#endif
+}
+
+
+size_t DenormalGuard::CountSubnormals(const double *values, size_t count)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++)
+        n += IsSubnormal(values[i]);
+    return n;
+}
+
+void DenormalGuard::Inspect(const double *values, size_t count)
+{
+    if (!IsRecording())
+        return;
+    size_t n = CountSubnormals(values, count);
+    if (n > 0)
+        Counter().fetch_add(n, std::memory_order_relaxed);
+}
+
+bool DenormalGuard::IsFlushing()
+{
+#if defined(GMATH_DENORMAL_MXCSR)
+    return (_mm_getcsr() & 0x8040) == 0x8040;
+#elif defined(GMATH_DENORMAL_FPCR)
+    unsigned long long fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    return (fpcr & (1ULL << 24)) != 0;
+#else
+    return false;
+#endif
+}
+
+bool DenormalGuard::IsRecording()
+{
+    return Recording().load(std::memory_order_relaxed);
+}
+
+bool DenormalGuard::IsSubnormal(double value)
+{
+    // Comparing the value itself would read it as zero under DAZ, which is
+    // exactly when batch kernels call Inspect
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x7FF0000000000000ULL) == 0 &&
+           (bits & 0x000FFFFFFFFFFFFFULL) != 0;
+}
+
+void DenormalGuard::ResetSubnormalCount()
+{
+    Counter().store(0, std::memory_order_relaxed);
+}
+
+void DenormalGuard::SetRecording(bool enable)
+{
+    Recording().store(enable, std::memory_order_relaxed);
+}
+
+size_t DenormalGuard::SubnormalCount()
+{
+    return Counter().load(std::memory_order_relaxed);
+}
+
+std::atomic<size_t>& DenormalGuard::Counter()
+{
+    static std::atomic<size_t> counter(0);
+    return counter;
+}
+
+std::atomic<bool>& DenormalGuard::Recording()
+{
+    static std::atomic<bool> recording(false);
+    return recording;
+}
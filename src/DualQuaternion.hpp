@@ -0,0 +1,257 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements dual quaternions, which represent a rotation
+ *  followed by a translation and blend between rigid transforms without the
+ *  shrinking seen when matrices are averaged.
+ */
+
+#pragma once
+
+#include <math.h>
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+
+
+struct DualQuaternion
+{
+    /**
+     * The real part holds the rotation. The dual part holds half of the
+     * translation multiplied by the rotation.
+     */
+    Quaternion Real;
+    Quaternion Dual;
+
+
+    /**
+     * Constructors.
+     */
+    inline DualQuaternion();
+    inline DualQuaternion(Quaternion real, Quaternion dual);
+    inline DualQuaternion(Quaternion rotation, Vector3 translation);
+
+
+    /**
+     * Constants for common dual quaternions.
+     */
+    static inline DualQuaternion Identity();
+
+
+    /**
+     * Returns the quaternion conjugate of a dual quaternion, which conjugates
+     * both of its parts. For a unit dual quaternion this is its inverse.
+     * @param dual: The dual quaternion in question.
+     * @return: A new dual quaternion.
+     */
+    static inline DualQuaternion Conjugate(DualQuaternion dual);
+
+    /**
+     * Returns the inverse of a dual quaternion, which undoes its transform.
+     * The real part must not be zero.
+     * @param dual: The dual quaternion in question.
+     * @return: A new dual quaternion.
+     */
+    static inline DualQuaternion Inverse(DualQuaternion dual);
+
+    /**
+     * Returns a dual quaternion scaled so that its real part has a norm of
+     * one, with the dual part made orthogonal to the real part. Blended dual
+     * quaternions must be normalized before they are used as transforms.
+     * @param dual: The dual quaternion in question.
+     * @return: A new dual quaternion.
+     */
+    static inline DualQuaternion Normalized(DualQuaternion dual);
+
+    /**
+     * Returns the rotation or translation of a unit dual quaternion.
+     * @param dual: The dual quaternion in question.
+     * @return: A rotation or translation.
+     */
+    static inline Quaternion ToRotation(DualQuaternion dual);
+    static inline Vector3 ToTranslation(DualQuaternion dual);
+
+    /**
+     * Rotates and then translates a point by a unit dual quaternion.
+     * @param dual: The transform.
+     * @param point: The point to transform.
+     * @return: A new point.
+     */
+    static inline Vector3 TransformPoint(DualQuaternion dual, Vector3 point);
+
+    /**
+     * Rotates a direction or normal by a unit dual quaternion, ignoring the
+     * translation.
+     * @param dual: The transform.
+     * @param vector: The vector to rotate.
+     * @return: A new vector.
+     */
+    static inline Vector3 TransformVector(DualQuaternion dual, Vector3 vector);
+
+
+    /**
+     * Operator overloading.
+     * Multiplying two dual quaternions composes their transforms, applying
+     * the right hand side first.
+     */
+    inline struct DualQuaternion& operator*=(const double rhs);
+    inline struct DualQuaternion& operator+=(const DualQuaternion rhs);
+    inline struct DualQuaternion& operator-=(const DualQuaternion rhs);
+    inline struct DualQuaternion& operator*=(const DualQuaternion rhs);
+};
+
+inline DualQuaternion operator-(DualQuaternion rhs);
+inline DualQuaternion operator*(DualQuaternion lhs, const double rhs);
+inline DualQuaternion operator*(const double lhs, DualQuaternion rhs);
+inline DualQuaternion operator+(DualQuaternion lhs, const DualQuaternion rhs);
+inline DualQuaternion operator-(DualQuaternion lhs, const DualQuaternion rhs);
+inline DualQuaternion operator*(DualQuaternion lhs, const DualQuaternion rhs);
+inline bool operator==(const DualQuaternion lhs, const DualQuaternion rhs);
+inline bool operator!=(const DualQuaternion lhs, const DualQuaternion rhs);
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+DualQuaternion::DualQuaternion() : Real(0, 0, 0, 1), Dual(0, 0, 0, 0) {}
+DualQuaternion::DualQuaternion(Quaternion real, Quaternion dual) : Real(real),
+    Dual(dual) {}
+DualQuaternion::DualQuaternion(Quaternion rotation, Vector3 translation) :
+    Real(rotation), Dual(Quaternion(translation, 0) * rotation * 0.5) {}
+
+
+DualQuaternion DualQuaternion::Identity() { return DualQuaternion(); }
+
+
+DualQuaternion DualQuaternion::Conjugate(DualQuaternion dual)
+{
+    return DualQuaternion(Quaternion::Conjugate(dual.Real),
+                          Quaternion::Conjugate(dual.Dual));
+}
+
+DualQuaternion DualQuaternion::Inverse(DualQuaternion dual)
+{
+    // (r + e d)^-1 = r^-1 - e r^-1 d r^-1
+    Quaternion inverse = Quaternion::Inverse(dual.Real);
+    return DualQuaternion(inverse, -(inverse * dual.Dual * inverse));
+}
+
+DualQuaternion DualQuaternion::Normalized(DualQuaternion dual)
+{
+    double scale = 1 / Quaternion::Norm(dual.Real);
+    Quaternion real = dual.Real * scale;
+    Quaternion d = dual.Dual * scale;
+    return DualQuaternion(real, d - real * Quaternion::Dot(real, d));
+}
+
+Quaternion DualQuaternion::ToRotation(DualQuaternion dual)
+{
+    return dual.Real;
+}
+
+Vector3 DualQuaternion::ToTranslation(DualQuaternion dual)
+{
+    Quaternion t = dual.Dual * Quaternion::Conjugate(dual.Real) * 2;
+    return Vector3(t.X, t.Y, t.Z);
+}
+
+Vector3 DualQuaternion::TransformPoint(DualQuaternion dual, Vector3 point)
+{
+    // The vector part of ToTranslation, written out to skip the scalar part
+    Vector3 r = Vector3(dual.Real.X, dual.Real.Y, dual.Real.Z);
+    Vector3 d = Vector3(dual.Dual.X, dual.Dual.Y, dual.Dual.Z);
+    Vector3 t = (d * dual.Real.W - r * dual.Dual.W +
+                 Vector3::Cross(r, d)) * 2;
+    return dual.Real * point + t;
+}
+
+Vector3 DualQuaternion::TransformVector(DualQuaternion dual, Vector3 vector)
+{
+    return dual.Real * vector;
+}
+
+
+struct DualQuaternion& DualQuaternion::operator*=(const double rhs)
+{
+    Real *= rhs;
+    Dual *= rhs;
+    return *this;
+}
+
+struct DualQuaternion& DualQuaternion::operator+=(const DualQuaternion rhs)
+{
+    Real += rhs.Real;
+    Dual += rhs.Dual;
+    return *this;
+}
+
+struct DualQuaternion& DualQuaternion::operator-=(const DualQuaternion rhs)
+{
+    Real -= rhs.Real;
+    Dual -= rhs.Dual;
+    return *this;
+}
+
+struct DualQuaternion& DualQuaternion::operator*=(const DualQuaternion rhs)
+{
+    // (a + e b)(c + e d) = ac + e (ad + bc), since e^2 = 0
+    Dual = Real * rhs.Dual + Dual * rhs.Real;
+    Real *= rhs.Real;
+    return *this;
+}
+
+DualQuaternion operator-(DualQuaternion rhs) { return rhs * -1; }
+DualQuaternion operator*(DualQuaternion lhs, const double rhs)
+{
+    return lhs *= rhs;
+}
+DualQuaternion operator*(const double lhs, DualQuaternion rhs)
+{
+    return rhs *= lhs;
+}
+DualQuaternion operator+(DualQuaternion lhs, const DualQuaternion rhs)
+{
+    return lhs += rhs;
+}
+DualQuaternion operator-(DualQuaternion lhs, const DualQuaternion rhs)
+{
+    return lhs -= rhs;
+}
+DualQuaternion operator*(DualQuaternion lhs, const DualQuaternion rhs)
+{
+    return lhs *= rhs;
+}
+
+bool operator==(const DualQuaternion lhs, const DualQuaternion rhs)
+{
+    return lhs.Real == rhs.Real && lhs.Dual == rhs.Dual;
+}
+
+bool operator!=(const DualQuaternion lhs, const DualQuaternion rhs)
+{
+    return !(lhs == rhs);
+}
@@ -0,0 +1,250 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements fast polynomial approximations of the inverse
+ *  trigonometric functions, along with a fused sine and cosine. The inverse
+ *  functions are used by the overloads throughout the library which take a
+ *  FastMath value as their last argument.
+ */
+
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <stddef.h>
+
+
+struct FastMath
+{
+    /**
+     * Approximates the arc cosine of a value. Inputs outside of [-1, 1] are
+     * clamped. The maximum absolute error is 1.9e-9 radians.
+     * @param x: The input value.
+     * @return: An angle in radians in the range [0, pi].
+     */
+    static inline double Acos(double x);
+
+    /**
+     * Approximates the arc sine of a value. Inputs outside of [-1, 1] are
+     * clamped. The maximum absolute error is 1.9e-9 radians.
+     * @param x: The input value.
+     * @return: An angle in radians in the range [-pi/2, pi/2].
+     */
+    static inline double Asin(double x);
+
+    /**
+     * Approximates the arc tangent of a value. The maximum absolute error is
+     * 9.0e-10 radians.
+     * @param x: The input value.
+     * @return: An angle in radians in the range [-pi/2, pi/2].
+     */
+    static inline double Atan(double x);
+
+    /**
+     * Approximates the angle of the point (x, y) from the positive X axis.
+     * The maximum absolute error is 9.0e-10 radians, and unlike acos of a
+     * normalized dot product, the error does not grow near 0 and pi. Returns
+     * zero when both inputs are zero.
+     * @param y: The Y coordinate.
+     * @param x: The X coordinate.
+     * @return: An angle in radians in the range [-pi, pi].
+     */
+    static inline double Atan2(double y, double x);
+
+    /**
+     * Calculates the sine and cosine of an angle at the same time, sharing a
+     * single range reduction between them. The result matches sin and cos to
+     * within one or two units in the last place. Angles larger than 1e5 in
+     * magnitude fall back to the standard library.
+     * @param angle: The angle in radians.
+     * @param sine: The output sine.
+     * @param cosine: The output cosine.
+     */
+    static inline void SinCos(double angle, double &sine, double &cosine);
+
+    /**
+     * Calculates the sine and cosine of an array of angles. The main loop has
+     * no branches, so the compiler is free to vectorize it.
+     * @param angles: The angles in radians.
+     * @param sines: The output sines.
+     * @param cosines: The output cosines.
+     * @param count: The number of angles.
+     */
+    static inline void SinCos(const double *angles, double *sines,
+        double *cosines, size_t count);
+
+    /**
+     * Evaluates the minimax polynomial for atan on the range [0, 1].
+     * @param x: The input value in the range [0, 1].
+     * @return: An angle in radians.
+     */
+    static inline double AtanUnit(double x);
+
+    /**
+     * Evaluates sine and cosine for an angle with its quadrant already
+     * removed, then rotates the result back into the quadrant.
+     * @param r: The reduced angle in the range [-pi/4, pi/4].
+     * @param quadrant: The number of quarter turns removed from the angle.
+     * @param sine: The output sine.
+     * @param cosine: The output cosine.
+     */
+    static inline void SinCosReduced(double r, int quadrant, double &sine,
+        double &cosine);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+double FastMath::Acos(double x)
+{
+    // acos(x) = sqrt(1 - x) * P(x) on [0, 1], minimax fit of P
+    double a = fmin(fabs(x), 1.0);
+    double p = 0.00081793678073901078;
+    p = p * a - 0.0044791260431582868;
+    p = p * a + 0.011801190327469525;
+    p = p * a - 0.021341918105797098;
+    p = p * a + 0.032840618168606797;
+    p = p * a - 0.050657493913781527;
+    p = p * a + 0.08903755038860571;
+    p = p * a - 0.21460148678488686;
+    p = p * a + 1.5707963249866097;
+    double r = sqrt(1 - a) * p;
+    return x < 0 ? M_PI - r : r;
+}
+
+double FastMath::Asin(double x)
+{
+    return M_PI_2 - Acos(x);
+}
+
+double FastMath::Atan(double x)
+{
+    double a = fabs(x);
+    double r = a > 1 ? M_PI_2 - AtanUnit(1 / a) : AtanUnit(a);
+    return x < 0 ? -r : r;
+}
+
+double FastMath::Atan2(double y, double x)
+{
+    double ax = fabs(x);
+    double ay = fabs(y);
+    double hi = fmax(ax, ay);
+    if (hi == 0)
+        return 0;
+    double r = AtanUnit(fmin(ax, ay) / hi);
+    if (ay > ax)
+        r = M_PI_2 - r;
+    if (x < 0)
+        r = M_PI - r;
+    return y < 0 ? -r : r;
+}
+
+void FastMath::SinCos(double angle, double &sine, double &cosine)
+{
+    if (!(fabs(angle) <= 1e5))
+    {
+        sine = sin(angle);
+        cosine = cos(angle);
+        return;
+    }
+    double n = nearbyint(angle * M_2_PI);
+    // Cody-Waite reduction, pi/2 split into three parts
+    double r = angle - n * 1.57079632673412561417e+00;
+    r -= n * 6.07710050630396597660e-11;
+    r -= n * 2.02226624871116645580e-21;
+    SinCosReduced(r, (int)n, sine, cosine);
+}
+
+void FastMath::SinCos(const double *angles, double *sines, double *cosines,
+    size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        // Angles the reduction can't handle are redone below, and are
+        // replaced here so that n always fits in an int
+        double angle = fabs(angles[i]) <= 1e5 ? angles[i] : 0;
+        double n = nearbyint(angle * M_2_PI);
+        double r = angle - n * 1.57079632673412561417e+00;
+        r -= n * 6.07710050630396597660e-11;
+        r -= n * 2.02226624871116645580e-21;
+        SinCosReduced(r, (int)n, sines[i], cosines[i]);
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!(fabs(angles[i]) <= 1e5))
+        {
+            sines[i] = sin(angles[i]);
+            cosines[i] = cos(angles[i]);
+        }
+    }
+}
+
+double FastMath::AtanUnit(double x)
+{
+    // atan(x) = x * P(x^2) on [0, 1], minimax fit of P
+    double u = x * x;
+    double p = -0.0015093030886110374;
+    p = p * u + 0.0095673398187690849;
+    p = p * u - 0.028490775080225066;
+    p = p * u + 0.055028099798157953;
+    p = p * u - 0.082137616052144813;
+    p = p * u + 0.10878009886995077;
+    p = p * u - 0.14247222666917073;
+    p = p * u + 0.19996436811457738;
+    p = p * u - 0.33333180376811533;
+    p = p * u + 0.99999998056030026;
+    return x * p;
+}
+
+void FastMath::SinCosReduced(double r, int quadrant, double &sine,
+    double &cosine)
+{
+    // Polynomial kernels on [-pi/4, pi/4] from fdlibm
+    double z = r * r;
+    double ps = 1.58969099521155010221e-10;
+    ps = ps * z - 2.50507602534068634195e-08;
+    ps = ps * z + 2.75573137070700676789e-06;
+    ps = ps * z - 1.98412698298579493134e-04;
+    ps = ps * z + 8.33333333332248946124e-03;
+    ps = ps * z - 1.66666666666666324348e-01;
+    double s = r + r * z * ps;
+    double pc = -1.13596475577881948265e-11;
+    pc = pc * z + 2.08757232129817482790e-09;
+    pc = pc * z - 2.75573143513906633035e-07;
+    pc = pc * z + 2.48015872894767294178e-05;
+    pc = pc * z - 1.38888888888741095749e-03;
+    pc = pc * z + 4.16666666666666019037e-02;
+    double c = 1 - 0.5 * z + z * z * pc;
+    // Odd quadrants swap sine and cosine, the sign follows the quadrant
+    bool swap = (quadrant & 1) != 0;
+    double sv = swap ? c : s;
+    double cv = swap ? s : c;
+    sine = (quadrant & 2) != 0 ? -sv : sv;
+    cosine = ((quadrant + 1) & 2) != 0 ? -cv : cv;
+}
@@ -0,0 +1,570 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a six-plane view frustum, with batch kernels for
+ *  culling arrays of bounding spheres and boxes against it.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+#include "AABB.hpp"
+#include "DenormalGuard.hpp"
+#include "Matrix3x3.hpp"
+#include "Parallel.hpp"
+#include "Vector3.hpp"
+#include "Vector3Array.hpp"
+
+
+struct Frustum
+{
+    /**
+     * The planes are stored in the order left, right, bottom, top, near and
+     * far. Normals are unit length and point inward, so a point p is inside
+     * plane i when Dot(Normals[i], p) + Offsets[i] >= 0.
+     */
+    Vector3 Normals[6];
+    double Offsets[6];
+
+    /**
+     * The corners of the frustum. Bit 0 of the index selects the right plane
+     * over the left, bit 1 the top over the bottom and bit 2 the far over
+     * the near.
+     */
+    Vector3 Corners[8];
+
+    /**
+     * The batch kernels classify BlockSize objects at a time, and ranges
+     * with at least ParallelGrain objects are split across threads.
+     */
+    static constexpr size_t BlockSize = 256;
+    static constexpr size_t ParallelGrain = 1 << 15;
+
+
+    /**
+     * Constructors.
+     * The first builds a frustum from six planes in the order described
+     * above. The normals do not need to be unit length, but the planes must
+     * enclose a closed volume.
+     * The second builds a perspective frustum for a camera. The camera looks
+     * down its local Z axis with Y up, and "rotation" maps those local
+     * directions to world space.
+     */
+    inline Frustum(const Vector3 *normals, const double *offsets);
+    inline Frustum(Matrix3x3 rotation, Vector3 position, double fieldOfView,
+                   double aspect, double nearDistance, double farDistance);
+
+
+    /**
+     * Returns true if a point is inside a frustum.
+     * @param frustum: The frustum.
+     * @param point: The point in question.
+     * @return: A boolean.
+     */
+    static inline bool Contains(const Frustum &frustum, Vector3 point);
+
+    /**
+     * Compacts the indices of the visible spheres in an array into the start
+     * of "visible", preserving their order. The exact version only accepts
+     * spheres which touch the frustum. Passing FastMath() instead only tests
+     * the spheres against each plane, which is cheaper but also accepts some
+     * spheres just outside of the corners and edges.
+     * @param frustum: The frustum.
+     * @param centers: The centers of the spheres.
+     * @param radii: The radius of each sphere.
+     * @param visible: The output array, which must hold one entry per sphere.
+     * @param precision: Pass FastMath() to select this overload.
+     * @return: The number of visible spheres.
+     */
+    static inline size_t Cull(const Frustum &frustum,
+                              const Vector3Array &centers,
+                              const double *radii, unsigned int *visible);
+    static inline size_t Cull(const Frustum &frustum,
+                              const Vector3Array &centers,
+                              const double *radii, unsigned int *visible,
+                              FastMath precision);
+
+    /**
+     * Compacts the indices of the visible boxes in an array into the start
+     * of "visible", preserving their order. As with spheres, passing
+     * FastMath() skips the exact test for boxes which cross a plane.
+     * @param frustum: The frustum.
+     * @param boxes: The boxes.
+     * @param count: The number of boxes.
+     * @param visible: The output array, which must hold one entry per box.
+     * @param precision: Pass FastMath() to select this overload.
+     * @return: The number of visible boxes.
+     */
+    static inline size_t Cull(const Frustum &frustum, const AABB *boxes,
+                              size_t count, unsigned int *visible);
+    static inline size_t Cull(const Frustum &frustum, const AABB *boxes,
+                              size_t count, unsigned int *visible,
+                              FastMath precision);
+
+    /**
+     * Returns the distance from a point to the closest point inside a
+     * frustum, which is zero for points inside it.
+     * @param frustum: The frustum.
+     * @param point: The point in question.
+     * @return: A scalar value.
+     */
+    static inline double Distance(const Frustum &frustum, Vector3 point);
+
+    /**
+     * Returns true if a sphere touches a frustum. Passing FastMath() only
+     * tests the sphere against each plane, as described for Cull.
+     * @param frustum: The frustum.
+     * @param center: The center of the sphere.
+     * @param radius: The radius of the sphere.
+     * @param precision: Pass FastMath() to select this overload.
+     * @return: A boolean.
+     */
+    static inline bool Intersects(const Frustum &frustum, Vector3 center,
+                                  double radius);
+    static inline bool Intersects(const Frustum &frustum, Vector3 center,
+                                  double radius, FastMath precision);
+
+    /**
+     * Returns true if a box touches a frustum. The exact version is a full
+     * separating axis test. Passing FastMath() only tests the box against
+     * each plane, as described for Cull.
+     * @param frustum: The frustum.
+     * @param box: The box in question.
+     * @param precision: Pass FastMath() to select this overload.
+     * @return: A boolean.
+     */
+    static inline bool Intersects(const Frustum &frustum, AABB box);
+    static inline bool Intersects(const Frustum &frustum, AABB box,
+                                  FastMath precision);
+
+    /**
+     * Helpers for the implementation.
+     * The block classifiers take at most BlockSize objects, and write 0 for
+     * objects outside of some plane, 1 for objects crossing a plane and 3
+     * for objects entirely inside.
+     */
+    static inline void ClassifyBoxes(const Frustum &frustum,
+                                     const AABB *boxes, size_t count,
+                                     unsigned char *flags);
+    static inline void ClassifySpheres(const Frustum &frustum,
+                                       const double *x, const double *y,
+                                       const double *z, const double *radii,
+                                       size_t count, unsigned char *flags);
+    template <typename C, typename E>
+    static inline size_t Compact(size_t count, unsigned int *visible,
+                                 C classify, E exact);
+    static inline Vector3 Intersection(Vector3 n0, double d0, Vector3 n1,
+                                       double d1, Vector3 n2, double d2);
+    static inline void SetCorners(Frustum &frustum);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+Frustum::Frustum(const Vector3 *normals, const double *offsets)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        double length = Vector3::Magnitude(normals[i]);
+        Normals[i] = normals[i] / length;
+        Offsets[i] = offsets[i] / length;
+    }
+    SetCorners(*this);
+}
+
+Frustum::Frustum(Matrix3x3 rotation, Vector3 position, double fieldOfView,
+                 double aspect, double nearDistance, double farDistance)
+{
+    Vector3 right = rotation * Vector3::Right();
+    Vector3 up = rotation * Vector3::Up();
+    Vector3 forward = rotation * Vector3::Forward();
+    double tanY = tan(fieldOfView / 2);
+    double tanX = tanY * aspect;
+
+    // Each side plane passes through the camera, so only its normal changes
+    Normals[0] = Vector3::Normalized(right + forward * tanX);
+    Normals[1] = Vector3::Normalized(forward * tanX - right);
+    Normals[2] = Vector3::Normalized(up + forward * tanY);
+    Normals[3] = Vector3::Normalized(forward * tanY - up);
+    Normals[4] = Vector3::Normalized(forward);
+    Normals[5] = -Normals[4];
+    for (int i = 0; i < 4; i++)
+        Offsets[i] = -Vector3::Dot(Normals[i], position);
+    Offsets[4] = -Vector3::Dot(Normals[4], position) - nearDistance;
+    Offsets[5] = Vector3::Dot(Normals[4], position) + farDistance;
+    SetCorners(*this);
+}
+
+
+bool Frustum::Contains(const Frustum &frustum, Vector3 point)
+{
+    for (int i = 0; i < 6; i++)
+        if (Vector3::Dot(frustum.Normals[i], point) + frustum.Offsets[i] < 0)
+            return false;
+    return true;
+}
+
+size_t Frustum::Cull(const Frustum &frustum, const Vector3Array &centers,
+                     const double *radii, unsigned int *visible)
+{
+    return Compact(Vector3Array::Size(centers), visible,
+                   [&](size_t begin, size_t count, unsigned char *flags)
+                   {
+                       ClassifySpheres(frustum, centers.X.data() + begin,
+                                       centers.Y.data() + begin,
+                                       centers.Z.data() + begin,
+                                       radii + begin, count, flags);
+                   },
+                   [&](size_t i)
+                   {
+                       return Distance(frustum, Vector3Array::Get(centers, i))
+                           <= radii[i];
+                   });
+}
+
+size_t Frustum::Cull(const Frustum &frustum, const Vector3Array &centers,
+                     const double *radii, unsigned int *visible, FastMath)
+{
+    return Compact(Vector3Array::Size(centers), visible,
+                   [&](size_t begin, size_t count, unsigned char *flags)
+                   {
+                       ClassifySpheres(frustum, centers.X.data() + begin,
+                                       centers.Y.data() + begin,
+                                       centers.Z.data() + begin,
+                                       radii + begin, count, flags);
+                   },
+                   [](size_t) { return true; });
+}
+
+size_t Frustum::Cull(const Frustum &frustum, const AABB *boxes, size_t count,
+                     unsigned int *visible)
+{
+    return Compact(count, visible,
+                   [&](size_t begin, size_t n, unsigned char *flags)
+                   {
+                       ClassifyBoxes(frustum, boxes + begin, n, flags);
+                   },
+                   [&](size_t i) { return Intersects(frustum, boxes[i]); });
+}
+
+size_t Frustum::Cull(const Frustum &frustum, const AABB *boxes, size_t count,
+                     unsigned int *visible, FastMath)
+{
+    return Compact(count, visible,
+                   [&](size_t begin, size_t n, unsigned char *flags)
+                   {
+                       ClassifyBoxes(frustum, boxes + begin, n, flags);
+                   },
+                   [](size_t) { return true; });
+}
+
+double Frustum::Distance(const Frustum &frustum, Vector3 point)
+{
+    double d[6];
+    bool inside = true;
+    for (int i = 0; i < 6; i++)
+    {
+        d[i] = Vector3::Dot(frustum.Normals[i], point) + frustum.Offsets[i];
+        inside = inside && d[i] >= 0;
+    }
+    if (inside)
+        return 0;
+
+    // The closest point is either inside one of the faces the point is in
+    // front of, or on one of the twelve edges
+    double best = INFINITY;
+    for (int i = 0; i < 6; i++)
+    {
+        if (d[i] >= 0 || -d[i] >= best)
+            continue;
+        Vector3 projected = point - frustum.Normals[i] * d[i];
+        bool onFace = true;
+        for (int j = 0; j < 6 && onFace; j++)
+            onFace = j == i || Vector3::Dot(frustum.Normals[j], projected) +
+                frustum.Offsets[j] >= 0;
+        if (onFace)
+            best = -d[i];
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        for (int bit = 1; bit < 8; bit <<= 1)
+        {
+            if (i & bit)
+                continue;
+            Vector3 a = frustum.Corners[i];
+            Vector3 edge = frustum.Corners[i | bit] - a;
+            double t = Vector3::Dot(point - a, edge) /
+                Vector3::SqrMagnitude(edge);
+            t = t < 0 ? 0 : (t > 1 ? 1 : t);
+            double distance = Vector3::Distance(point, a + edge * t);
+            best = distance < best ? distance : best;
+        }
+    }
+    return best;
+}
+
+bool Frustum::Intersects(const Frustum &frustum, Vector3 center,
+                         double radius)
+{
+    return Intersects(frustum, center, radius, FastMath()) &&
+        Distance(frustum, center) <= radius;
+}
+
+bool Frustum::Intersects(const Frustum &frustum, Vector3 center,
+                         double radius, FastMath)
+{
+    for (int i = 0; i < 6; i++)
+        if (Vector3::Dot(frustum.Normals[i], center) + frustum.Offsets[i] <
+            -radius)
+            return false;
+    return true;
+}
+
+bool Frustum::Intersects(const Frustum &frustum, AABB box)
+{
+    if (!Intersects(frustum, box, FastMath()))
+        return false;
+
+    // The plane normals have been tested, so try the box axes and the cross
+    // products of the box axes with each frustum edge
+    Vector3 center = AABB::Center(box);
+    Vector3 extents = AABB::Extents(box);
+    Vector3 axes[3 + 3 * 12];
+    int count = 0;
+    axes[count++] = Vector3::Right();
+    axes[count++] = Vector3::Up();
+    axes[count++] = Vector3::Forward();
+    for (int a = 0; a < 6; a++)
+    {
+        for (int b = (a | 1) + 1; b < 6; b++)
+        {
+            Vector3 edge = Vector3::Cross(frustum.Normals[a],
+                                          frustum.Normals[b]);
+            axes[count++] = Vector3(0, -edge.Z, edge.Y);
+            axes[count++] = Vector3(edge.Z, 0, -edge.X);
+            axes[count++] = Vector3(-edge.Y, edge.X, 0);
+        }
+    }
+    for (int i = 0; i < count; i++)
+    {
+        Vector3 axis = axes[i];
+        double c = Vector3::Dot(axis, center);
+        double r = extents.X * fabs(axis.X) + extents.Y * fabs(axis.Y) +
+            extents.Z * fabs(axis.Z);
+        double lo = INFINITY;
+        double hi = -INFINITY;
+        for (int j = 0; j < 8; j++)
+        {
+            double p = Vector3::Dot(axis, frustum.Corners[j]);
+            lo = p < lo ? p : lo;
+            hi = p > hi ? p : hi;
+        }
+        if (c + r < lo || c - r > hi)
+            return false;
+    }
+    return true;
+}
+
+bool Frustum::Intersects(const Frustum &frustum, AABB box, FastMath)
+{
+    Vector3 center = AABB::Center(box);
+    Vector3 extents = AABB::Extents(box);
+    for (int i = 0; i < 6; i++)
+    {
+        Vector3 n = frustum.Normals[i];
+        double reach = extents.X * fabs(n.X) + extents.Y * fabs(n.Y) +
+            extents.Z * fabs(n.Z);
+        if (Vector3::Dot(n, center) + frustum.Offsets[i] < -reach)
+            return false;
+    }
+    return true;
+}
+
+
+void Frustum::ClassifyBoxes(const Frustum &frustum, const AABB *boxes,
+                            size_t count, unsigned char *flags)
+{
+    // Working with twice the centers and twice the extents saves the
+    // multiplies needed to halve them. The block is padded so that the
+    // plane loops below have a fixed length, which lets them vectorize.
+    double cx[BlockSize], cy[BlockSize], cz[BlockSize];
+    double sx[BlockSize], sy[BlockSize], sz[BlockSize];
+    DenormalGuard::Inspect((const double *)boxes, 6 * count);
+    for (size_t i = 0; i < count; i++)
+    {
+        cx[i] = boxes[i].Min.X + boxes[i].Max.X;
+        cy[i] = boxes[i].Min.Y + boxes[i].Max.Y;
+        cz[i] = boxes[i].Min.Z + boxes[i].Max.Z;
+        sx[i] = boxes[i].Max.X - boxes[i].Min.X;
+        sy[i] = boxes[i].Max.Y - boxes[i].Min.Y;
+        sz[i] = boxes[i].Max.Z - boxes[i].Min.Z;
+    }
+    for (size_t i = count; i < BlockSize; i++)
+        cx[i] = cy[i] = cz[i] = sx[i] = sy[i] = sz[i] = 0;
+
+    // Track the lowest distance of the farthest and nearest corners
+    double lowestFar[BlockSize], lowestNear[BlockSize];
+    for (size_t i = 0; i < BlockSize; i++)
+        lowestFar[i] = lowestNear[i] = INFINITY;
+    for (int p = 0; p < 6; p++)
+    {
+        double nx = frustum.Normals[p].X;
+        double ny = frustum.Normals[p].Y;
+        double nz = frustum.Normals[p].Z;
+        double ax = fabs(nx);
+        double ay = fabs(ny);
+        double az = fabs(nz);
+        double d = frustum.Offsets[p] * 2;
+        for (size_t i = 0; i < BlockSize; i++)
+        {
+            double distance = nx * cx[i] + ny * cy[i] + nz * cz[i] + d;
+            double reach = ax * sx[i] + ay * sy[i] + az * sz[i];
+            double high = distance + reach;
+            double low = distance - reach;
+            lowestFar[i] = high < lowestFar[i] ? high : lowestFar[i];
+            lowestNear[i] = low < lowestNear[i] ? low : lowestNear[i];
+        }
+    }
+    for (size_t i = 0; i < count; i++)
+        flags[i] = (unsigned char)((lowestFar[i] >= 0) +
+                                   2 * (lowestNear[i] >= 0));
+}
+
+void Frustum::ClassifySpheres(const Frustum &frustum, const double *x,
+                              const double *y, const double *z,
+                              const double *radii, size_t count,
+                              unsigned char *flags)
+{
+    // The block is copied and padded as for boxes
+    double cx[BlockSize], cy[BlockSize], cz[BlockSize];
+    DenormalGuard::Inspect(x, count);
+    DenormalGuard::Inspect(y, count);
+    DenormalGuard::Inspect(z, count);
+    DenormalGuard::Inspect(radii, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        cx[i] = x[i];
+        cy[i] = y[i];
+        cz[i] = z[i];
+    }
+    for (size_t i = count; i < BlockSize; i++)
+        cx[i] = cy[i] = cz[i] = 0;
+
+    // Only the lowest distance to any plane matters
+    double lowest[BlockSize];
+    for (size_t i = 0; i < BlockSize; i++)
+        lowest[i] = INFINITY;
+    for (int p = 0; p < 6; p++)
+    {
+        double nx = frustum.Normals[p].X;
+        double ny = frustum.Normals[p].Y;
+        double nz = frustum.Normals[p].Z;
+        double d = frustum.Offsets[p];
+        for (size_t i = 0; i < BlockSize; i++)
+        {
+            double distance = nx * cx[i] + ny * cy[i] + nz * cz[i] + d;
+            lowest[i] = distance < lowest[i] ? distance : lowest[i];
+        }
+    }
+    for (size_t i = 0; i < count; i++)
+        flags[i] = (unsigned char)((lowest[i] >= -radii[i]) +
+                                   2 * (lowest[i] >= radii[i]));
+}
+
+template <typename C, typename E>
+size_t Frustum::Compact(size_t count, unsigned int *visible, C classify,
+                        E exact)
+{
+    // Each chunk compacts into its own part of the output, and the parts
+    // are moved together afterward
+    size_t chunks = Parallel::Chunks(count, ParallelGrain);
+    std::vector<size_t> chunkBegin(chunks);
+    std::vector<size_t> chunkCount(chunks);
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t chunk, size_t begin, size_t end)
+                  {
+                      DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+                      unsigned char flags[BlockSize];
+                      unsigned int *out = visible + begin;
+                      size_t n = 0;
+                      for (size_t b = begin; b < end; b += BlockSize)
+                      {
+                          size_t size = end - b < BlockSize ?
+                              end - b : BlockSize;
+                          classify(b, size, flags);
+                          for (size_t i = 0; i < size; i++)
+                          {
+                              bool keep = flags[i] == 3 ||
+                                  (flags[i] == 1 && exact(b + i));
+                              out[n] = (unsigned int)(b + i);
+                              n += keep;
+                          }
+                      }
+                      chunkBegin[chunk] = begin;
+                      chunkCount[chunk] = n;
+                  });
+    size_t total = 0;
+    for (size_t c = 0; c < chunks; c++)
+    {
+        // Parts before the first dropped object are already in place, and
+        // the rest move toward the front, which std::copy allows
+        if (total != chunkBegin[c])
+            std::copy(visible + chunkBegin[c],
+                      visible + chunkBegin[c] + chunkCount[c],
+                      visible + total);
+        total += chunkCount[c];
+    }
+    return total;
+}
+
+Vector3 Frustum::Intersection(Vector3 n0, double d0, Vector3 n1, double d1,
+                              Vector3 n2, double d2)
+{
+    Vector3 c12 = Vector3::Cross(n1, n2);
+    Vector3 c20 = Vector3::Cross(n2, n0);
+    Vector3 c01 = Vector3::Cross(n0, n1);
+    return -(c12 * d0 + c20 * d1 + c01 * d2) / Vector3::Dot(n0, c12);
+}
+
+void Frustum::SetCorners(Frustum &frustum)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        int x = i & 1;
+        int y = 2 + ((i >> 1) & 1);
+        int z = 4 + ((i >> 2) & 1);
+        frustum.Corners[i] = Intersection(
+            frustum.Normals[x], frustum.Offsets[x],
+            frustum.Normals[y], frustum.Offsets[y],
+            frustum.Normals[z], frustum.Offsets[z]);
+    }
+}
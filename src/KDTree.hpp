@@ -0,0 +1,423 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a static KD-tree over 3D points, for nearest
+ *  neighbour and radius queries.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "DenormalGuard.hpp"
+#include "Parallel.hpp"
+#include "Vector3.hpp"
+#include "Vector3Array.hpp"
+
+
+/**
+ * The tree is implicit and perfectly balanced: every leaf sits at depth
+ * Levels, node k has children 2k + 1 and 2k + 2, and the nodes on level l
+ * split the points on axis l % 3. Leaf j holds the points in the range
+ * [Count * j / 2^Levels, Count * (j + 1) / 2^Levels). Data is a single block
+ * holding the split value of every interior node followed by the X, Y and Z
+ * coordinates of the points in leaf order, and Indices maps each of those
+ * points back to its index in the input.
+ */
+struct KDTree
+{
+    size_t Count;
+    int Levels;
+    std::vector<double> Data;
+    std::vector<unsigned int> Indices;
+
+
+    /**
+     * Build parameters.
+     * LeafSize is the most points a leaf may hold. Ranges with at least
+     * ParallelGrain points (or queries) are processed on multiple threads.
+     */
+    static constexpr size_t LeafSize = 16;
+    static constexpr size_t ParallelGrain = 1 << 14;
+
+
+    /**
+     * Constructors.
+     */
+    inline KDTree();
+
+
+    /**
+     * Builds a KD-tree over an array of points.
+     * @param points: The points.
+     * @param count: The number of points.
+     * @return: A new KD-tree.
+     */
+    static inline KDTree Build(const Vector3 *points, size_t count);
+
+    /**
+     * Builds a KD-tree over a structure of arrays of points.
+     * @param points: The points.
+     * @return: A new KD-tree.
+     */
+    static inline KDTree Build(const Vector3Array &points);
+
+    /**
+     * Finds the k points closest to a query point. This keeps the results
+     * sorted as it goes, so it is intended for small values of k.
+     * @param tree: The tree to search.
+     * @param point: The query point.
+     * @param k: The number of neighbours to find.
+     * @param indices: The output point indices, closest first.
+     * @param distances: The output distances, closest first.
+     * @return: The number of neighbours found, which is less than k only if
+     * the tree holds fewer than k points.
+     */
+    static inline size_t Nearest(const KDTree &tree, Vector3 point, size_t k,
+                                 size_t *indices, double *distances);
+
+    /**
+     * Finds the k points closest to each of many query points, spread across
+     * threads. Missing neighbours have an index of SIZE_MAX and an infinite
+     * distance.
+     * @param tree: The tree to search.
+     * @param points: The query points.
+     * @param count: The number of query points.
+     * @param k: The number of neighbours to find.
+     * @param indices: The output point indices, k per query.
+     * @param distances: The output distances, k per query.
+     */
+    static inline void Nearest(const KDTree &tree, const Vector3 *points,
+                               size_t count, size_t k, size_t *indices,
+                               double *distances);
+
+    /**
+     * Finds every point within a radius of a query point, in no particular
+     * order.
+     * @param tree: The tree to search.
+     * @param point: The query point.
+     * @param radius: The search radius.
+     * @param indices: The output list, which the indices are appended to.
+     */
+    static inline void Radius(const KDTree &tree, Vector3 point,
+                              double radius, std::vector<size_t> &indices);
+
+    /**
+     * Finds every point within a radius of each of many query points,
+     * spread across threads. The results for query i are
+     * indices[offsets[i]] up to indices[offsets[i + 1]].
+     * @param tree: The tree to search.
+     * @param points: The query points.
+     * @param count: The number of query points.
+     * @param radius: The search radius.
+     * @param offsets: The output offsets, count + 1 of them.
+     * @param indices: The output point indices.
+     */
+    static inline void Radius(const KDTree &tree, const Vector3 *points,
+                              size_t count, double radius,
+                              std::vector<size_t> &offsets,
+                              std::vector<size_t> &indices);
+
+
+    /**
+     * Helpers used by the build and the queries.
+     */
+    static inline KDTree BuildStrided(const double *x, const double *y,
+                                      const double *z, size_t stride,
+                                      size_t count);
+    static inline void BuildNode(KDTree &tree, const double *coordinates[3],
+                                 size_t stride, size_t node, int level,
+                                 int forks);
+    static inline void LeafRange(const KDTree &tree, size_t leaf,
+                                 size_t &begin, size_t &end);
+    static inline void NearestNode(const KDTree &tree, size_t node,
+                                   int level, Vector3 point, size_t k,
+                                   size_t &found, size_t *indices,
+                                   double *distances);
+    static inline void RadiusNode(const KDTree &tree, size_t node, int level,
+                                  Vector3 point, double radiusSqr,
+                                  std::vector<size_t> &indices);
+    static inline void LeafDistances(const KDTree &tree, size_t begin,
+                                     size_t end, Vector3 point,
+                                     double *distances);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+KDTree::KDTree() : Count(0), Levels(0) {}
+
+
+KDTree KDTree::Build(const Vector3 *points, size_t count)
+{
+    if (count == 0)
+        return KDTree();
+    return BuildStrided(&points[0].X, &points[0].Y, &points[0].Z, 3, count);
+}
+
+KDTree KDTree::Build(const Vector3Array &points)
+{
+    size_t count = Vector3Array::Size(points);
+    if (count == 0)
+        return KDTree();
+    return BuildStrided(points.X.data(), points.Y.data(), points.Z.data(), 1,
+                        count);
+}
+
+size_t KDTree::Nearest(const KDTree &tree, Vector3 point, size_t k,
+                       size_t *indices, double *distances)
+{
+    size_t found = 0;
+    if (tree.Count == 0 || k == 0)
+        return 0;
+    NearestNode(tree, 0, 0, point, k, found, indices, distances);
+    for (size_t i = 0; i < found; i++)
+        distances[i] = sqrt(distances[i]);
+    return found;
+}
+
+void KDTree::Nearest(const KDTree &tree, const Vector3 *points, size_t count,
+                     size_t k, size_t *indices, double *distances)
+{
+    Parallel::For(count, ParallelGrain / 16,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+                      DenormalGuard::Inspect((const double *)(points + begin),
+                                             3 * (end - begin));
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          size_t found = Nearest(tree, points[i], k,
+                                                 indices + i * k,
+                                                 distances + i * k);
+                          for (size_t j = found; j < k; j++)
+                          {
+                              indices[i * k + j] = SIZE_MAX;
+                              distances[i * k + j] = INFINITY;
+                          }
+                      }
+                  });
+}
+
+void KDTree::Radius(const KDTree &tree, Vector3 point, double radius,
+                    std::vector<size_t> &indices)
+{
+    if (tree.Count == 0 || radius < 0)
+        return;
+    RadiusNode(tree, 0, 0, point, radius * radius, indices);
+}
+
+void KDTree::Radius(const KDTree &tree, const Vector3 *points, size_t count,
+                    double radius, std::vector<size_t> &offsets,
+                    std::vector<size_t> &indices)
+{
+    size_t grain = ParallelGrain / 16;
+    size_t chunks = Parallel::Chunks(count, grain);
+    std::vector<std::vector<size_t> > chunkIndices(chunks);
+    std::vector<size_t> chunkBegin(chunks);
+    offsets.assign(count + 1, 0);
+    Parallel::For(count, grain,
+                  [&](size_t chunk, size_t begin, size_t end)
+                  {
+                      DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+                      DenormalGuard::Inspect((const double *)(points + begin),
+                                             3 * (end - begin));
+                      chunkBegin[chunk] = begin;
+                      std::vector<size_t> &found = chunkIndices[chunk];
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          size_t before = found.size();
+                          Radius(tree, points[i], radius, found);
+                          offsets[i + 1] = found.size() - before;
+                      }
+                  });
+    for (size_t i = 0; i < count; i++)
+        offsets[i + 1] += offsets[i];
+    indices.resize(offsets[count]);
+    for (size_t c = 0; c < chunks; c++)
+        std::copy(chunkIndices[c].begin(), chunkIndices[c].end(),
+                  indices.begin() + offsets[chunkBegin[c]]);
+}
+
+
+KDTree KDTree::BuildStrided(const double *x, const double *y,
+                            const double *z, size_t stride, size_t count)
+{
+    KDTree tree;
+    tree.Count = count;
+    while ((count + ((size_t)1 << tree.Levels) - 1) >> tree.Levels > LeafSize)
+        tree.Levels++;
+    size_t interior = ((size_t)1 << tree.Levels) - 1;
+    tree.Data.resize(interior + 3 * count);
+    tree.Indices.resize(count);
+    for (size_t i = 0; i < count; i++)
+        tree.Indices[i] = (unsigned int)i;
+
+    const double *coordinates[3] = { x, y, z };
+    int forks = 0;
+    while (((size_t)1 << forks) < Parallel::ThreadCount())
+        forks++;
+    BuildNode(tree, coordinates, stride, 0, 0, forks);
+
+    double *sorted = tree.Data.data() + interior;
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          size_t p = tree.Indices[i] * stride;
+                          sorted[i] = x[p];
+                          sorted[count + i] = y[p];
+                          sorted[2 * count + i] = z[p];
+                      }
+                  });
+    return tree;
+}
+
+void KDTree::BuildNode(KDTree &tree, const double *coordinates[3],
+                       size_t stride, size_t node, int level, int forks)
+{
+    if (level == tree.Levels)
+        return;
+    size_t j = node - (((size_t)1 << level) - 1);
+    size_t begin = tree.Count * j >> level;
+    size_t mid = tree.Count * (2 * j + 1) >> (level + 1);
+    size_t end = tree.Count * (j + 1) >> level;
+    const double *axis = coordinates[level % 3];
+    unsigned int *indices = tree.Indices.data();
+    std::nth_element(indices + begin, indices + mid, indices + end,
+                     [&](unsigned int a, unsigned int b)
+                     {
+                         return axis[a * stride] < axis[b * stride];
+                     });
+    tree.Data[node] = axis[indices[mid] * stride];
+    if (forks > 0 && end - begin >= ParallelGrain)
+        Parallel::Invoke(
+            [&]()
+            {
+                BuildNode(tree, coordinates, stride, 2 * node + 1, level + 1,
+                          forks - 1);
+            },
+            [&]()
+            {
+                BuildNode(tree, coordinates, stride, 2 * node + 2, level + 1,
+                          forks - 1);
+            });
+    else
+    {
+        BuildNode(tree, coordinates, stride, 2 * node + 1, level + 1, 0);
+        BuildNode(tree, coordinates, stride, 2 * node + 2, level + 1, 0);
+    }
+}
+
+void KDTree::LeafRange(const KDTree &tree, size_t leaf, size_t &begin,
+                       size_t &end)
+{
+    begin = tree.Count * leaf >> tree.Levels;
+    end = tree.Count * (leaf + 1) >> tree.Levels;
+}
+
+void KDTree::LeafDistances(const KDTree &tree, size_t begin, size_t end,
+                           Vector3 point, double *distances)
+{
+    // Written over plain arrays so that the compiler can vectorize it
+    size_t interior = ((size_t)1 << tree.Levels) - 1;
+    const double *x = tree.Data.data() + interior;
+    const double *y = x + tree.Count;
+    const double *z = y + tree.Count;
+    for (size_t i = begin; i < end; i++)
+    {
+        double dx = x[i] - point.X;
+        double dy = y[i] - point.Y;
+        double dz = z[i] - point.Z;
+        distances[i - begin] = dx * dx + dy * dy + dz * dz;
+    }
+}
+
+void KDTree::NearestNode(const KDTree &tree, size_t node, int level,
+                         Vector3 point, size_t k, size_t &found,
+                         size_t *indices, double *distances)
+{
+    if (level == tree.Levels)
+    {
+        size_t begin, end;
+        LeafRange(tree, node - (((size_t)1 << level) - 1), begin, end);
+        double leaf[LeafSize];
+        LeafDistances(tree, begin, end, point, leaf);
+        for (size_t i = begin; i < end; i++)
+        {
+            double d = leaf[i - begin];
+            if (found == k && d >= distances[k - 1])
+                continue;
+            // Insert into the sorted results, dropping the farthest if full
+            size_t slot = found < k ? found++ : k - 1;
+            while (slot > 0 && distances[slot - 1] > d)
+            {
+                distances[slot] = distances[slot - 1];
+                indices[slot] = indices[slot - 1];
+                slot--;
+            }
+            distances[slot] = d;
+            indices[slot] = tree.Indices[i];
+        }
+        return;
+    }
+    double diff = point.data[level % 3] - tree.Data[node];
+    size_t first = diff <= 0 ? 2 * node + 1 : 2 * node + 2;
+    size_t second = diff <= 0 ? 2 * node + 2 : 2 * node + 1;
+    NearestNode(tree, first, level + 1, point, k, found, indices, distances);
+    if (found < k || diff * diff < distances[k - 1])
+        NearestNode(tree, second, level + 1, point, k, found, indices,
+                    distances);
+}
+
+void KDTree::RadiusNode(const KDTree &tree, size_t node, int level,
+                        Vector3 point, double radiusSqr,
+                        std::vector<size_t> &indices)
+{
+    if (level == tree.Levels)
+    {
+        size_t begin, end;
+        LeafRange(tree, node - (((size_t)1 << level) - 1), begin, end);
+        double leaf[LeafSize];
+        LeafDistances(tree, begin, end, point, leaf);
+        for (size_t i = begin; i < end; i++)
+            if (leaf[i - begin] <= radiusSqr)
+                indices.push_back(tree.Indices[i]);
+        return;
+    }
+    double diff = point.data[level % 3] - tree.Data[node];
+    if (diff <= 0 || diff * diff <= radiusSqr)
+        RadiusNode(tree, 2 * node + 1, level + 1, point, radiusSqr, indices);
+    if (diff >= 0 || diff * diff <= radiusSqr)
+        RadiusNode(tree, 2 * node + 2, level + 1, point, radiusSqr, indices);
+}
@@ -0,0 +1,509 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a loose octree over spheres, with incremental
+ *  insert, remove and move, along with overlap, ray and frustum queries.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <vector>
+#include "AABB.hpp"
+#include "Frustum.hpp"
+#include "Vector3.hpp"
+
+
+/**
+ * A node of a loose octree. The node owns the cube of half size HalfSize
+ * around Center, but its objects may reach out to twice that half size.
+ * When a node is in the pool of free nodes, First links to the next free
+ * node.
+ */
+struct LooseOctreeNode
+{
+    Vector3 Center;
+    double HalfSize;
+    unsigned int Depth;
+    unsigned int Parent;
+    unsigned int First;
+    unsigned int Children[8];
+};
+
+
+/**
+ * Objects are spheres, identified by the handle returned from Insert. Each
+ * object is stored at the deepest level whose node half size is at least
+ * its radius, in the node whose cube contains its center (or in the root if
+ * it is outside of the world). The objects of a node form a doubly linked
+ * list through Next and Previous, so that objects and nodes can be added
+ * and removed in constant time without any per node allocation. Free nodes
+ * and free object handles are pooled and reused.
+ */
+struct LooseOctree
+{
+    Vector3 Center;
+    double HalfSize;
+    unsigned int MaxDepth;
+    size_t Count;
+    std::vector<LooseOctreeNode> Nodes;
+    unsigned int FreeNode;
+    std::vector<Vector3> Centers;
+    std::vector<double> Radii;
+    std::vector<unsigned int> ObjectNode;
+    std::vector<unsigned int> Next;
+    std::vector<unsigned int> Previous;
+    unsigned int FreeObject;
+
+
+    /**
+     * Marks a missing node or object.
+     */
+    static constexpr unsigned int None = 0xFFFFFFFF;
+
+
+    /**
+     * Constructors.
+     * The world is the cube of half size "halfSize" around "center". Objects
+     * may be placed outside of it, but they are kept in the root node. The
+     * depth is limited to 32 levels.
+     */
+    inline LooseOctree();
+    inline LooseOctree(Vector3 center, double halfSize,
+                       unsigned int maxDepth = 8);
+
+
+    /**
+     * Finds every object whose sphere is on the inside of all of the given
+     * planes, or crosses any of them. A point p is inside plane i when
+     * Dot(normals[i], p) + offsets[i] >= 0.
+     * @param tree: The tree to search.
+     * @param normals: The plane normals, pointing inward.
+     * @param offsets: The plane offsets.
+     * @param planeCount: The number of planes.
+     * @param frustum: A frustum to use for the planes instead.
+     * @param objects: The output list, which the handles are appended to.
+     */
+    static inline void Cull(const LooseOctree &tree, const Vector3 *normals,
+                            const double *offsets, size_t planeCount,
+                            std::vector<size_t> &objects);
+    static inline void Cull(const LooseOctree &tree, const Frustum &frustum,
+                            std::vector<size_t> &objects);
+
+    /**
+     * Adds a sphere to a tree.
+     * @param tree: The tree to add to.
+     * @param center: The center of the sphere.
+     * @param radius: The radius of the sphere.
+     * @return: The handle of the new object.
+     */
+    static inline size_t Insert(LooseOctree &tree, Vector3 center,
+                                double radius);
+
+    /**
+     * Moves an object. If the object stays within the cube of its node and
+     * its radius still belongs on the same level, this only stores the new
+     * values, so slow moving objects cost constant time.
+     * @param tree: The tree containing the object.
+     * @param object: The handle of the object.
+     * @param center: The new center of the sphere.
+     * @param radius: The new radius of the sphere.
+     */
+    static inline void Move(LooseOctree &tree, size_t object, Vector3 center,
+                            double radius);
+
+    /**
+     * Finds every object whose sphere overlaps a query sphere.
+     * @param tree: The tree to search.
+     * @param center: The center of the query sphere.
+     * @param radius: The radius of the query sphere.
+     * @param objects: The output list, which the handles are appended to.
+     */
+    static inline void Overlap(const LooseOctree &tree, Vector3 center,
+                               double radius, std::vector<size_t> &objects);
+
+    /**
+     * Finds the first object whose sphere is hit by a ray.
+     * @param tree: The tree to search.
+     * @param origin: The start of the ray.
+     * @param direction: The direction of the ray (need not be normalized).
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param object: The handle of the object hit.
+     * @param distance: The ray parameter of the hit, or zero if the ray
+     * starts inside the sphere.
+     * @return: True if the ray hit an object.
+     */
+    static inline bool Raycast(const LooseOctree &tree, Vector3 origin,
+                               Vector3 direction, double maxDistance,
+                               size_t &object, double &distance);
+
+    /**
+     * Removes an object from a tree. Its handle may be reused by a later
+     * insert.
+     * @param tree: The tree containing the object.
+     * @param object: The handle of the object.
+     */
+    static inline void Remove(LooseOctree &tree, size_t object);
+
+
+    /**
+     * Helpers used by the updates and the queries.
+     */
+    static inline unsigned int AllocateNode(LooseOctree &tree,
+                                            unsigned int parent,
+                                            int octant);
+    static inline unsigned int FindNode(LooseOctree &tree, Vector3 center,
+                                        double radius);
+    static inline bool InCube(const LooseOctreeNode &node, Vector3 point);
+    static inline void Link(LooseOctree &tree, unsigned int object,
+                            unsigned int node);
+    static inline AABB LooseBounds(const LooseOctreeNode &node);
+    static inline void Unlink(LooseOctree &tree, unsigned int object);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+LooseOctree::LooseOctree() : LooseOctree(Vector3::Zero(), 1) {}
+LooseOctree::LooseOctree(Vector3 center, double halfSize,
+                         unsigned int maxDepth) : Center(center),
+    HalfSize(halfSize), MaxDepth(maxDepth < 32 ? maxDepth : 32), Count(0),
+    FreeNode(None), FreeObject(None)
+{
+    LooseOctreeNode root;
+    root.Center = center;
+    root.HalfSize = halfSize;
+    root.Depth = 0;
+    root.Parent = None;
+    root.First = None;
+    for (int i = 0; i < 8; i++)
+        root.Children[i] = None;
+    Nodes.push_back(root);
+}
+
+
+void LooseOctree::Cull(const LooseOctree &tree, const Vector3 *normals,
+                       const double *offsets, size_t planeCount,
+                       std::vector<size_t> &objects)
+{
+    // Nodes entirely inside every plane accept all of their objects
+    // without testing them
+    unsigned int stack[8 * 64];
+    bool stackInside[8 * 64];
+    int top = 0;
+    stack[top] = 0;
+    stackInside[top++] = false;
+    while (top > 0)
+    {
+        top--;
+        const LooseOctreeNode &node = tree.Nodes[stack[top]];
+        bool inside = stackInside[top];
+        for (unsigned int o = node.First; o != None; o = tree.Next[o])
+        {
+            bool visible = true;
+            for (size_t p = 0; p < planeCount && !inside && visible; p++)
+                visible = Vector3::Dot(normals[p], tree.Centers[o]) +
+                    offsets[p] >= -tree.Radii[o];
+            if (visible)
+                objects.push_back(o);
+        }
+        for (int c = 0; c < 8; c++)
+        {
+            unsigned int child = node.Children[c];
+            if (child == None)
+                continue;
+            bool childInside = inside;
+            bool outside = false;
+            if (!inside)
+            {
+                const LooseOctreeNode &n = tree.Nodes[child];
+                double extent = 2 * n.HalfSize;
+                childInside = true;
+                for (size_t p = 0; p < planeCount && !outside; p++)
+                {
+                    double reach = extent * (fabs(normals[p].X) +
+                        fabs(normals[p].Y) + fabs(normals[p].Z));
+                    double d = Vector3::Dot(normals[p], n.Center) +
+                        offsets[p];
+                    outside = d < -reach;
+                    childInside = childInside && d >= reach;
+                }
+            }
+            if (!outside)
+            {
+                stack[top] = child;
+                stackInside[top++] = childInside;
+            }
+        }
+    }
+}
+
+void LooseOctree::Cull(const LooseOctree &tree, const Frustum &frustum,
+                       std::vector<size_t> &objects)
+{
+    Cull(tree, frustum.Normals, frustum.Offsets, 6, objects);
+}
+
+size_t LooseOctree::Insert(LooseOctree &tree, Vector3 center, double radius)
+{
+    unsigned int object = tree.FreeObject;
+    if (object != None)
+        tree.FreeObject = tree.Next[object];
+    else
+    {
+        object = (unsigned int)tree.Centers.size();
+        tree.Centers.push_back(center);
+        tree.Radii.push_back(radius);
+        tree.ObjectNode.push_back((unsigned int)None);
+        tree.Next.push_back((unsigned int)None);
+        tree.Previous.push_back((unsigned int)None);
+    }
+    tree.Centers[object] = center;
+    tree.Radii[object] = radius;
+    Link(tree, object, FindNode(tree, center, radius));
+    tree.Count++;
+    return object;
+}
+
+void LooseOctree::Move(LooseOctree &tree, size_t object, Vector3 center,
+                       double radius)
+{
+    const LooseOctreeNode &node = tree.Nodes[tree.ObjectNode[object]];
+    bool sameLevel = (radius <= node.HalfSize || node.Depth == 0) &&
+        (radius > node.HalfSize * 0.5 || node.Depth == tree.MaxDepth);
+    bool inRoot = node.Depth == 0 && (sameLevel || !InCube(node, center));
+    if (inRoot || (sameLevel && InCube(node, center)))
+    {
+        tree.Centers[object] = center;
+        tree.Radii[object] = radius;
+        return;
+    }
+    Unlink(tree, (unsigned int)object);
+    tree.Centers[object] = center;
+    tree.Radii[object] = radius;
+    Link(tree, (unsigned int)object, FindNode(tree, center, radius));
+}
+
+void LooseOctree::Overlap(const LooseOctree &tree, Vector3 center,
+                          double radius, std::vector<size_t> &objects)
+{
+    unsigned int stack[8 * 64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const LooseOctreeNode &node = tree.Nodes[stack[--top]];
+        for (unsigned int o = node.First; o != None; o = tree.Next[o])
+        {
+            double reach = radius + tree.Radii[o];
+            if (Vector3::SqrMagnitude(tree.Centers[o] - center) <=
+                reach * reach)
+                objects.push_back(o);
+        }
+        for (int c = 0; c < 8; c++)
+        {
+            unsigned int child = node.Children[c];
+            if (child == None)
+                continue;
+            // Distance from the query center to the loose bounds
+            const LooseOctreeNode &n = tree.Nodes[child];
+            Vector3 d = Vector3::Max(Vector3::Zero(), Vector3(
+                fabs(center.X - n.Center.X), fabs(center.Y - n.Center.Y),
+                fabs(center.Z - n.Center.Z)) - 2 * n.HalfSize);
+            if (Vector3::SqrMagnitude(d) <= radius * radius)
+                stack[top++] = child;
+        }
+    }
+}
+
+bool LooseOctree::Raycast(const LooseOctree &tree, Vector3 origin,
+                          Vector3 direction, double maxDistance,
+                          size_t &object, double &distance)
+{
+    bool hit = false;
+    double best = maxDistance;
+    double a = Vector3::SqrMagnitude(direction);
+    if (a == 0)
+        return false;
+    unsigned int stack[8 * 64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const LooseOctreeNode &node = tree.Nodes[stack[--top]];
+        for (unsigned int o = node.First; o != None; o = tree.Next[o])
+        {
+            Vector3 m = origin - tree.Centers[o];
+            double b = Vector3::Dot(m, direction);
+            double c = Vector3::SqrMagnitude(m) - tree.Radii[o] * tree.Radii[o];
+            double t;
+            if (c <= 0)
+                t = 0;
+            else
+            {
+                double disc = b * b - a * c;
+                if (b > 0 || disc < 0)
+                    continue;
+                t = (-b - sqrt(disc)) / a;
+            }
+            if (t <= best)
+            {
+                best = t;
+                object = o;
+                hit = true;
+            }
+        }
+        for (int c = 0; c < 8; c++)
+        {
+            unsigned int child = node.Children[c];
+            double entry;
+            if (child != None &&
+                AABB::Raycast(LooseBounds(tree.Nodes[child]), origin,
+                              direction, best, entry))
+                stack[top++] = child;
+        }
+    }
+    if (hit)
+        distance = best;
+    return hit;
+}
+
+void LooseOctree::Remove(LooseOctree &tree, size_t object)
+{
+    Unlink(tree, (unsigned int)object);
+    tree.ObjectNode[object] = None;
+    tree.Next[object] = tree.FreeObject;
+    tree.FreeObject = (unsigned int)object;
+    tree.Count--;
+}
+
+
+unsigned int LooseOctree::AllocateNode(LooseOctree &tree,
+                                       unsigned int parent, int octant)
+{
+    unsigned int index = tree.FreeNode;
+    if (index != None)
+        tree.FreeNode = tree.Nodes[index].First;
+    else
+    {
+        index = (unsigned int)tree.Nodes.size();
+        tree.Nodes.push_back(LooseOctreeNode());
+    }
+    const LooseOctreeNode &p = tree.Nodes[parent];
+    LooseOctreeNode &node = tree.Nodes[index];
+    node.HalfSize = p.HalfSize * 0.5;
+    node.Center = p.Center + Vector3(octant & 1 ? node.HalfSize :
+        -node.HalfSize, octant & 2 ? node.HalfSize : -node.HalfSize,
+        octant & 4 ? node.HalfSize : -node.HalfSize);
+    node.Depth = p.Depth + 1;
+    node.Parent = parent;
+    node.First = None;
+    for (int i = 0; i < 8; i++)
+        node.Children[i] = None;
+    tree.Nodes[parent].Children[octant] = index;
+    return index;
+}
+
+unsigned int LooseOctree::FindNode(LooseOctree &tree, Vector3 center,
+                                   double radius)
+{
+    if (!InCube(tree.Nodes[0], center))
+        return 0;
+    unsigned int node = 0;
+    double half = tree.HalfSize * 0.5;
+    for (unsigned int depth = 1; depth <= tree.MaxDepth && half >= radius;
+         depth++, half *= 0.5)
+    {
+        const LooseOctreeNode &n = tree.Nodes[node];
+        int octant = (center.X >= n.Center.X ? 1 : 0) |
+            (center.Y >= n.Center.Y ? 2 : 0) |
+            (center.Z >= n.Center.Z ? 4 : 0);
+        unsigned int child = n.Children[octant];
+        if (child == None)
+            child = AllocateNode(tree, node, octant);
+        node = child;
+    }
+    return node;
+}
+
+bool LooseOctree::InCube(const LooseOctreeNode &node, Vector3 point)
+{
+    return fabs(point.X - node.Center.X) <= node.HalfSize &&
+        fabs(point.Y - node.Center.Y) <= node.HalfSize &&
+        fabs(point.Z - node.Center.Z) <= node.HalfSize;
+}
+
+void LooseOctree::Link(LooseOctree &tree, unsigned int object,
+                       unsigned int node)
+{
+    unsigned int first = tree.Nodes[node].First;
+    tree.ObjectNode[object] = node;
+    tree.Previous[object] = None;
+    tree.Next[object] = first;
+    if (first != None)
+        tree.Previous[first] = object;
+    tree.Nodes[node].First = object;
+}
+
+AABB LooseOctree::LooseBounds(const LooseOctreeNode &node)
+{
+    return AABB::Expand(AABB(node.Center, node.Center), 2 * node.HalfSize);
+}
+
+void LooseOctree::Unlink(LooseOctree &tree, unsigned int object)
+{
+    unsigned int node = tree.ObjectNode[object];
+    unsigned int previous = tree.Previous[object];
+    unsigned int next = tree.Next[object];
+    if (previous != None)
+        tree.Next[previous] = next;
+    else
+        tree.Nodes[node].First = next;
+    if (next != None)
+        tree.Previous[next] = previous;
+
+    // Return empty leaves to the pool, walking up towards the root
+    while (node != 0 && tree.Nodes[node].First == None)
+    {
+        LooseOctreeNode &n = tree.Nodes[node];
+        bool leaf = true;
+        for (int i = 0; i < 8 && leaf; i++)
+            leaf = n.Children[i] == None;
+        if (!leaf)
+            break;
+        unsigned int parent = n.Parent;
+        for (int i = 0; i < 8; i++)
+            if (tree.Nodes[parent].Children[i] == node)
+                tree.Nodes[parent].Children[i] = None;
+        n.First = tree.FreeNode;
+        tree.FreeNode = node;
+        node = parent;
+    }
+}
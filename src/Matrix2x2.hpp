@@ -0,0 +1,334 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a series of math functions for manipulating a
+ *  2x2 matrix.
+ */
+
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <stddef.h>
+#include "DenormalGuard.hpp"
+#include "Rotation2D.hpp"
+#include "Vector2.hpp"
+
+
+struct Matrix2x2
+{
+    union
+    {
+        struct
+        {
+            double D00;
+            double D01;
+            double D10;
+            double D11;
+        };
+        double data[2][2];
+    };
+
+
+    /**
+     * Constructors.
+     */
+    inline Matrix2x2();
+    inline Matrix2x2(double data[]);
+    inline Matrix2x2(Vector2 row0, Vector2 row1);
+    inline Matrix2x2(double d00, double d01, double d10, double d11);
+
+
+    /**
+     * Constants for common Matrix2x2.
+     */
+    static inline Matrix2x2 Identity();
+    static inline Matrix2x2 Zero();
+    static inline Matrix2x2 One();
+
+
+    /**
+     * Returns the determinate of a matrix.
+     * @param matrix: The input matrix.
+     * @return: A scalar value.
+     */
+    static inline double Determinate(Matrix2x2 matrix);
+
+    /**
+     * Converts a rotation to a rotation matrix.
+     * @param rotation: The input rotation.
+     * @return: A new rotation matrix.
+     */
+    static inline Matrix2x2 FromRotation2D(Rotation2D rotation);
+
+    /**
+     * Returns a matrix which scales by the given amount along each axis.
+     * @param scale: The scale along X and Y.
+     * @return: A new matrix.
+     */
+    static inline Matrix2x2 FromScale(Vector2 scale);
+
+    /**
+     * Returns the inverse of a matrix.
+     * @param matrix: The input matrix.
+     * @return: A new matrix.
+     */
+    static inline Matrix2x2 Inverse(Matrix2x2 matrix);
+
+    /**
+     * Returns true if a matrix is invertible.
+     * @param matrix: The input matrix.
+     * @return: A new matrix.
+     */
+    static inline bool IsInvertible(Matrix2x2 matrix);
+
+    /**
+     * Multiplies an array of vectors by a matrix. The input and output may
+     * be the same array.
+     * @param matrix: The matrix to apply.
+     * @param vectors: The vectors to transform.
+     * @param count: The number of vectors.
+     * @param output: The transformed vectors.
+     */
+    static inline void MultiplyVectors(Matrix2x2 matrix,
+                                       const Vector2 *vectors, size_t count,
+                                       Vector2 *output);
+
+    /**
+     * Multiplies two matrices element-wise.
+     * @param a: The left-hand side of the multiplication.
+     * @param b: The right-hand side of the multiplication.
+     * @return: A new matrix.
+     */
+    static inline Matrix2x2 Scale(Matrix2x2 a, Matrix2x2 b);
+
+    /**
+     * Converts a rotation matrix to a rotation. The matrix is assumed to be
+     * a rotation, possibly with some drift, which is normalized away.
+     * @param rotation: The input rotation matrix.
+     * @return: A new rotation.
+     */
+    static inline Rotation2D ToRotation2D(Matrix2x2 rotation);
+
+    /**
+     * Returns the transpose of a matrix.
+     * @param matrix: The input matrix.
+     * @return: A new matrix.
+     */
+    static inline Matrix2x2 Transpose(Matrix2x2 matrix);
+
+    /**
+     * Operator overloading.
+     */
+    inline struct Matrix2x2& operator+=(const double rhs);
+    inline struct Matrix2x2& operator-=(const double rhs);
+    inline struct Matrix2x2& operator*=(const double rhs);
+    inline struct Matrix2x2& operator/=(const double rhs);
+    inline struct Matrix2x2& operator+=(const Matrix2x2 rhs);
+    inline struct Matrix2x2& operator-=(const Matrix2x2 rhs);
+    inline struct Matrix2x2& operator*=(const Matrix2x2 rhs);
+};
+
+inline Matrix2x2 operator-(Matrix2x2 rhs);
+inline Matrix2x2 operator+(Matrix2x2 lhs, const double rhs);
+inline Matrix2x2 operator-(Matrix2x2 lhs, const double rhs);
+inline Matrix2x2 operator*(Matrix2x2 lhs, const double rhs);
+inline Matrix2x2 operator/(Matrix2x2 lhs, const double rhs);
+inline Matrix2x2 operator+(const double lhs, Matrix2x2 rhs);
+inline Matrix2x2 operator-(const double lhs, Matrix2x2 rhs);
+inline Matrix2x2 operator*(const double lhs, Matrix2x2 rhs);
+inline Matrix2x2 operator+(Matrix2x2 lhs, const Matrix2x2 rhs);
+inline Matrix2x2 operator-(Matrix2x2 lhs, const Matrix2x2 rhs);
+inline Matrix2x2 operator*(Matrix2x2 lhs, const Matrix2x2 rhs);
+inline Vector2 operator*(Matrix2x2 lhs, const Vector2 rhs);
+inline bool operator==(const Matrix2x2 lhs, const Matrix2x2 rhs);
+inline bool operator!=(const Matrix2x2 lhs, const Matrix2x2 rhs);
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+Matrix2x2::Matrix2x2() : D00(1), D01(0), D10(0), D11(1) {}
+Matrix2x2::Matrix2x2(double data[]) : D00(data[0]), D01(data[1]),
+    D10(data[2]), D11(data[3]) {}
+Matrix2x2::Matrix2x2(Vector2 row0, Vector2 row1) : D00(row0.X), D01(row0.Y),
+    D10(row1.X), D11(row1.Y) {}
+Matrix2x2::Matrix2x2(double d00, double d01, double d10, double d11) :
+    D00(d00), D01(d01), D10(d10), D11(d11) {}
+
+
+Matrix2x2 Matrix2x2::Identity() { return Matrix2x2(1, 0, 0, 1); }
+Matrix2x2 Matrix2x2::Zero() { return Matrix2x2(0, 0, 0, 0); }
+Matrix2x2 Matrix2x2::One() { return Matrix2x2(1, 1, 1, 1); }
+
+
+double Matrix2x2::Determinate(Matrix2x2 matrix)
+{
+    return matrix.D00 * matrix.D11 - matrix.D01 * matrix.D10;
+}
+
+Matrix2x2 Matrix2x2::FromRotation2D(Rotation2D rotation)
+{
+    return Matrix2x2(rotation.Cos, -rotation.Sin, rotation.Sin, rotation.Cos);
+}
+
+Matrix2x2 Matrix2x2::FromScale(Vector2 scale)
+{
+    return Matrix2x2(scale.X, 0, 0, scale.Y);
+}
+
+Matrix2x2 Matrix2x2::Inverse(Matrix2x2 matrix)
+{
+    Matrix2x2 a = Matrix2x2(matrix.D11, -matrix.D01, -matrix.D10,
+                            matrix.D00);
+    return 1 / Determinate(matrix) * a;
+}
+
+bool Matrix2x2::IsInvertible(Matrix2x2 matrix)
+{
+    return fabs(Determinate(matrix)) > 0.00001;
+}
+
+void Matrix2x2::MultiplyVectors(Matrix2x2 matrix, const Vector2 *vectors,
+                                size_t count, Vector2 *output)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect((const double *)vectors, 2 * count);
+    for (size_t i = 0; i < count; i++)
+    {
+        double x = vectors[i].X;
+        double y = vectors[i].Y;
+        output[i].X = matrix.D00 * x + matrix.D01 * y;
+        output[i].Y = matrix.D10 * x + matrix.D11 * y;
+    }
+}
+
+Matrix2x2 Matrix2x2::Scale(Matrix2x2 a, Matrix2x2 b)
+{
+    return Matrix2x2(a.D00 * b.D00, a.D01 * b.D01, a.D10 * b.D10,
+                     a.D11 * b.D11);
+}
+
+Rotation2D Matrix2x2::ToRotation2D(Matrix2x2 rotation)
+{
+    // Average the two copies of each value held by a rotation matrix
+    return Rotation2D::Normalized(Rotation2D(
+        rotation.D00 + rotation.D11, rotation.D10 - rotation.D01));
+}
+
+Matrix2x2 Matrix2x2::Transpose(Matrix2x2 matrix)
+{
+    return Matrix2x2(matrix.D00, matrix.D10, matrix.D01, matrix.D11);
+}
+
+
+struct Matrix2x2& Matrix2x2::operator+=(const double rhs)
+{
+    D00 += rhs; D01 += rhs;
+    D10 += rhs; D11 += rhs;
+    return *this;
+}
+
+struct Matrix2x2& Matrix2x2::operator-=(const double rhs)
+{
+    D00 -= rhs; D01 -= rhs;
+    D10 -= rhs; D11 -= rhs;
+    return *this;
+}
+
+struct Matrix2x2& Matrix2x2::operator*=(const double rhs)
+{
+    D00 *= rhs; D01 *= rhs;
+    D10 *= rhs; D11 *= rhs;
+    return *this;
+}
+
+struct Matrix2x2& Matrix2x2::operator/=(const double rhs)
+{
+    D00 /= rhs; D01 /= rhs;
+    D10 /= rhs; D11 /= rhs;
+    return *this;
+}
+
+struct Matrix2x2& Matrix2x2::operator+=(const Matrix2x2 rhs)
+{
+    D00 += rhs.D00; D01 += rhs.D01;
+    D10 += rhs.D10; D11 += rhs.D11;
+    return *this;
+}
+
+struct Matrix2x2& Matrix2x2::operator-=(const Matrix2x2 rhs)
+{
+    D00 -= rhs.D00; D01 -= rhs.D01;
+    D10 -= rhs.D10; D11 -= rhs.D11;
+    return *this;
+}
+
+struct Matrix2x2& Matrix2x2::operator*=(const Matrix2x2 rhs)
+{
+    Matrix2x2 m;
+    m.D00 = D00 * rhs.D00 + D01 * rhs.D10;
+    m.D01 = D00 * rhs.D01 + D01 * rhs.D11;
+    m.D10 = D10 * rhs.D00 + D11 * rhs.D10;
+    m.D11 = D10 * rhs.D01 + D11 * rhs.D11;
+    *this = m;
+    return *this;
+}
+
+Matrix2x2 operator-(Matrix2x2 rhs) { return rhs * -1; }
+Matrix2x2 operator+(Matrix2x2 lhs, const double rhs) { return lhs += rhs; }
+Matrix2x2 operator-(Matrix2x2 lhs, const double rhs) { return lhs -= rhs; }
+Matrix2x2 operator*(Matrix2x2 lhs, const double rhs) { return lhs *= rhs; }
+Matrix2x2 operator/(Matrix2x2 lhs, const double rhs) { return lhs /= rhs; }
+Matrix2x2 operator+(const double lhs, Matrix2x2 rhs) { return rhs += lhs; }
+Matrix2x2 operator-(const double lhs, Matrix2x2 rhs) { return rhs -= lhs; }
+Matrix2x2 operator*(const double lhs, Matrix2x2 rhs) { return rhs *= lhs; }
+Matrix2x2 operator+(Matrix2x2 lhs, const Matrix2x2 rhs) { return lhs += rhs; }
+Matrix2x2 operator-(Matrix2x2 lhs, const Matrix2x2 rhs) { return lhs -= rhs; }
+Matrix2x2 operator*(Matrix2x2 lhs, const Matrix2x2 rhs) { return lhs *= rhs; }
+
+Vector2 operator*(Matrix2x2 lhs, const Vector2 rhs)
+{
+    Vector2 v;
+    v.X = lhs.D00 * rhs.X + lhs.D01 * rhs.Y;
+    v.Y = lhs.D10 * rhs.X + lhs.D11 * rhs.Y;
+    return v;
+}
+
+bool operator==(const Matrix2x2 lhs, const Matrix2x2 rhs)
+{
+    return lhs.D00 == rhs.D00 &&
+        lhs.D01 == rhs.D01 &&
+        lhs.D10 == rhs.D10 &&
+        lhs.D11 == rhs.D11;
+}
+
+bool operator!=(const Matrix2x2 lhs, const Matrix2x2 rhs)
+{
+    return !(lhs == rhs);
+}
@@ -34,6 +34,7 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <stddef.h>
 
 
 /**
@@ -147,12 +148,50 @@
             inline Quaternion(double x, double y, double z, double w) : X(x),
                 Y(y), Z(z), W(w) {}
         };
+
+        struct UnitQuaternion
+        {
+            inline UnitQuaternion() : Unit(0, 0, 0, 1) {}
+            inline explicit UnitQuaternion(Quaternion unit) : Unit(unit) {}
+            inline double X() const { return Unit.X; }
+            inline double Y() const { return Unit.Y; }
+            inline double Z() const { return Unit.Z; }
+            inline double W() const { return Unit.W; }
+            inline operator const Quaternion&() const { return Unit; }
+        private:
+            Quaternion Unit;
+        };
 #   endif
 #else
 #   include "Quaternion.hpp"
 #endif
 
 
+/**
+ * Attempt to include a header file if the file exists.
+ * If the file does not exist, create a dummy data structure for that type.
+ * If it cannot be determined if it exists, just attempt to include it.
+ */
+#ifdef __has_include
+#   if __has_include("DenormalGuard.hpp")
+#       include "DenormalGuard.hpp"
+#   elif !defined(GMATH_DENORMALGUARD)
+        #define GMATH_DENORMALGUARD
+        #ifndef GMATH_FLUSH_DENORMALS
+        #define GMATH_FLUSH_DENORMALS 0
+        #endif
+        struct DenormalGuard
+        {
+            inline explicit DenormalGuard(bool) {}
+
+            static inline void Inspect(const double *, size_t) {}
+        };
+#   endif
+#else
+#   include "DenormalGuard.hpp"
+#endif
+
+
 struct Matrix3x3
 {
     union
@@ -172,6 +211,18 @@ struct Matrix3x3
         double data[3][3];
     };
 
+    // The number of Jacobi sweeps EigenSymmetric runs over every matrix
+    static constexpr int JacobiSweeps = 5;
+
+    // The number of matrices the batch kernels work on at a time
+    static constexpr size_t BlockSize = 64;
+
+    // The number of approximate Jacobi sweeps SVD runs over A^T A
+    static constexpr int SVDSweeps = 8;
+
+    // The number of values the SVD kernel keeps for each matrix
+    static constexpr int SVDRows = 24;
+
 
     /**
      * Constructors.
@@ -198,6 +249,44 @@ struct Matrix3x3
      */
     static inline double Determinate(Matrix3x3 matrix);
 
+    /**
+     * Finds the eigenvalues and eigenvectors of a symmetric matrix, such as
+     * a covariance matrix, so that matrix = V * diag(eigenvalues) * V^T.
+     * Only the upper triangle is read. The eigenvalues are sorted in
+     * ascending order, and the eigenvectors are the matching columns of V,
+     * which is always a rotation. A fixed number of cyclic Jacobi sweeps is
+     * run, so repeated eigenvalues need no special handling.
+     * @param matrix: The input symmetric matrix.
+     * @param eigenvalues: Set to the eigenvalues, smallest first.
+     * @param eigenvectors: Set to V.
+     */
+    static inline void EigenSymmetric(Matrix3x3 matrix, Vector3 &eigenvalues,
+                                      Matrix3x3 &eigenvectors);
+
+    /**
+     * Finds the eigenvalues and eigenvectors of a symmetric matrix as above,
+     * returning V as a rotation.
+     * @param matrix: The input symmetric matrix.
+     * @param eigenvalues: Set to the eigenvalues, smallest first.
+     * @param eigenvectors: Set to the rotation V.
+     */
+    static inline void EigenSymmetric(Matrix3x3 matrix, Vector3 &eigenvalues,
+                                      Quaternion &eigenvectors);
+
+    /**
+     * Finds the eigenvalues and eigenvectors of an array of symmetric
+     * matrices as above. The matrices are solved BlockSize at a time with
+     * one matrix per SIMD lane, and the results match the single matrix
+     * version up to rounding.
+     * @param matrices: The input symmetric matrices.
+     * @param count: The number of matrices.
+     * @param eigenvalues: The eigenvalues of each matrix, smallest first.
+     * @param eigenvectors: V for each matrix.
+     */
+    static inline void EigenSymmetric(const Matrix3x3 *matrices, size_t count,
+                                      Vector3 *eigenvalues,
+                                      Matrix3x3 *eigenvectors);
+
     /**
      * Converts a quaternion to a rotation matrix.
      * @param rotation: The input quaternion.
@@ -205,6 +294,14 @@ struct Matrix3x3
      */
     static inline Matrix3x3 FromQuaternion(Quaternion rotation);
 
+    /**
+     * Converts a unit quaternion to a rotation matrix. This skips the
+     * division by the squared norm.
+     * @param rotation: The input unit quaternion.
+     * @return: A new rotation matrix.
+     */
+    static inline Matrix3x3 FromQuaternion(UnitQuaternion rotation);
+
     /**
      * Returns the inverse of a matrix.
      * @param matrix: The input matrix.
@@ -219,6 +316,44 @@ struct Matrix3x3
      */
     static inline bool IsInvertible(Matrix3x3 matrix);
 
+    /**
+     * Splits a matrix into a rotation and a symmetric stretch so that
+     * matrix = rotation * stretch, using the SVD below. The rotation is the
+     * one closest to the matrix, which makes this the way to recover a
+     * rotation from a deformation or from a drifted rotation matrix. If the
+     * matrix reflects, the stretch has a negative eigenvalue instead.
+     * @param matrix: The input matrix.
+     * @param rotation: Set to the rotation U V^T.
+     * @param stretch: Set to the stretch V diag(sigma) V^T.
+     */
+    static inline void PolarDecomposition(Matrix3x3 matrix,
+                                          Matrix3x3 &rotation,
+                                          Matrix3x3 &stretch);
+
+    /**
+     * Splits a matrix into a rotation and a symmetric stretch as above,
+     * returning the rotation as a quaternion.
+     * @param matrix: The input matrix.
+     * @param rotation: Set to the rotation U V^T.
+     * @param stretch: Set to the stretch V diag(sigma) V^T.
+     */
+    static inline void PolarDecomposition(Matrix3x3 matrix,
+                                          Quaternion &rotation,
+                                          Matrix3x3 &stretch);
+
+    /**
+     * Splits an array of matrices into rotations and stretches as above,
+     * solving BlockSize matrices at a time with one matrix per SIMD lane.
+     * @param matrices: The input matrices.
+     * @param count: The number of matrices.
+     * @param rotations: The rotation of each matrix.
+     * @param stretches: The stretch of each matrix.
+     */
+    static inline void PolarDecomposition(const Matrix3x3 *matrices,
+                                          size_t count,
+                                          Matrix3x3 *rotations,
+                                          Matrix3x3 *stretches);
+
     /**
      * Multiplies two matrices element-wise.
      * @param a: The left-hand side of the multiplication.
@@ -227,6 +362,46 @@ struct Matrix3x3
      */
     static inline Matrix3x3 Scale(Matrix3x3 a, Matrix3x3 b);
 
+    /**
+     * Computes the singular value decomposition matrix = U diag(sigma) V^T
+     * without branching, after McAdams et al. A fixed SVDSweeps sweeps of
+     * approximate Jacobi rotations, accumulated in a quaternion, find V.
+     * Givens rotations then take the QR decomposition of A V, whose diagonal
+     * is sigma. U and V are always rotations, so the singular values are
+     * sorted by decreasing magnitude and the last one is negative if the
+     * matrix reflects.
+     * @param matrix: The input matrix.
+     * @param u: Set to the rotation U.
+     * @param sigma: Set to the singular values.
+     * @param v: Set to the rotation V.
+     */
+    static inline void SVD(Matrix3x3 matrix, Matrix3x3 &u, Vector3 &sigma,
+                           Matrix3x3 &v);
+
+    /**
+     * Computes the singular value decomposition as above, returning U and V
+     * as the quaternions the rotations were accumulated in.
+     * @param matrix: The input matrix.
+     * @param u: Set to the rotation U.
+     * @param sigma: Set to the singular values.
+     * @param v: Set to the rotation V.
+     */
+    static inline void SVD(Matrix3x3 matrix, Quaternion &u, Vector3 &sigma,
+                           Quaternion &v);
+
+    /**
+     * Computes the singular value decompositions of an array of matrices as
+     * above, BlockSize matrices at a time with one matrix per SIMD lane. The
+     * results are the same as the single matrix version.
+     * @param matrices: The input matrices.
+     * @param count: The number of matrices.
+     * @param u: The rotation U of each matrix.
+     * @param sigma: The singular values of each matrix.
+     * @param v: The rotation V of each matrix.
+     */
+    static inline void SVD(const Matrix3x3 *matrices, size_t count,
+                           Matrix3x3 *u, Vector3 *sigma, Matrix3x3 *v);
+
     /**
      * Converts a rotation matrix to a quaternion.
      * @param rotation: The input rotation matrix.
@@ -241,6 +416,47 @@ struct Matrix3x3
      */
     static inline Matrix3x3 Transpose(Matrix3x3 matrix);
 
+    /**
+     * Helpers for the implementation.
+     * A Jacobi rotation zeroes the off-diagonal element apq, with r the
+     * remaining index, and applies the same rotation to columns p and q of
+     * V. The block versions work on BlockSize lanes, where a holds the
+     * elements 00, 11, 22, 01, 02 and 12 followed by V in row-major order,
+     * so the element ij of the input is at 2 + i + j for i < j.
+     */
+    static inline void JacobiRotation(double &app, double &aqq, double &apq,
+                                      double &arp, double &arq, Matrix3x3 &v,
+                                      int p, int q);
+    static inline void SortEigenPair(double &wp, double &wq, Matrix3x3 &v,
+                                     int p, int q);
+    static inline void EigenBlock(double a[15][BlockSize]);
+    template <int P, int Q>
+    static inline void JacobiBlock(double a[15][BlockSize]);
+    template <int P, int Q>
+    static inline void SortEigenBlock(double a[15][BlockSize]);
+
+    /**
+     * Helpers for the SVD, which work on Width matrices at a time so that
+     * the single matrix and batch versions share one kernel. The rows of a
+     * hold the elements of A^T A in the same order as above, then B = A V in
+     * row-major order, the quaternions of V and U and the scale of A.
+     */
+    template <size_t Width>
+    static inline void LoadSVDBlock(const Matrix3x3 *matrices, size_t count,
+                                    double a[SVDRows][Width]);
+    template <size_t Width>
+    static inline void SVDBlock(double a[SVDRows][Width]);
+    template <int P, int Q, size_t Width>
+    static inline void SVDJacobiBlock(double a[SVDRows][Width]);
+    template <int P, int Q, size_t Width>
+    static inline void SVDSortBlock(double a[SVDRows][Width]);
+    template <int P, int Q, size_t Width>
+    static inline void QRGivensBlock(double a[SVDRows][Width]);
+    template <size_t Width>
+    static inline void StoreSVDBlock(const double a[SVDRows][Width],
+                                     size_t lane, Quaternion &u,
+                                     Vector3 &sigma, Quaternion &v);
+
     /**
      * Operator overloading.
      */
@@ -314,6 +530,72 @@ double Matrix3x3::Determinate(Matrix3x3 matrix)
     return v1 - v2 + v3;
 }
 
+void Matrix3x3::EigenSymmetric(Matrix3x3 matrix, Vector3 &eigenvalues,
+                               Matrix3x3 &eigenvectors)
+{
+    double a00 = matrix.D00, a11 = matrix.D11, a22 = matrix.D22;
+    double a01 = matrix.D01, a02 = matrix.D02, a12 = matrix.D12;
+    Matrix3x3 v = Identity();
+    for (int sweep = 0; sweep < JacobiSweeps; sweep++)
+    {
+        JacobiRotation(a00, a11, a01, a02, a12, v, 0, 1);
+        JacobiRotation(a00, a22, a02, a01, a12, v, 0, 2);
+        JacobiRotation(a11, a22, a12, a01, a02, v, 1, 2);
+    }
+
+    // A sorting network that keeps V a rotation as it swaps columns
+    SortEigenPair(a00, a11, v, 0, 1);
+    SortEigenPair(a11, a22, v, 1, 2);
+    SortEigenPair(a00, a11, v, 0, 1);
+    eigenvalues = Vector3(a00, a11, a22);
+    eigenvectors = v;
+}
+
+void Matrix3x3::EigenSymmetric(Matrix3x3 matrix, Vector3 &eigenvalues,
+                               Quaternion &eigenvectors)
+{
+    Matrix3x3 v;
+    EigenSymmetric(matrix, eigenvalues, v);
+    eigenvectors = ToQuaternion(v);
+}
+
+void Matrix3x3::EigenSymmetric(const Matrix3x3 *matrices, size_t count,
+                               Vector3 *eigenvalues, Matrix3x3 *eigenvectors)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect((const double *)matrices, 9 * count);
+    double a[15][BlockSize];
+    for (size_t s = 0; s < count; s += BlockSize)
+    {
+        size_t n = count - s < BlockSize ? count - s : BlockSize;
+        const Matrix3x3 *m = matrices + s;
+        for (size_t i = 0; i < n; i++)
+        {
+            a[0][i] = m[i].D00;
+            a[1][i] = m[i].D11;
+            a[2][i] = m[i].D22;
+            a[3][i] = m[i].D01;
+            a[4][i] = m[i].D02;
+            a[5][i] = m[i].D12;
+        }
+        // Padding lanes solve the identity, which is already diagonal
+        for (size_t i = n; i < BlockSize; i++)
+        {
+            a[0][i] = a[1][i] = a[2][i] = 1;
+            a[3][i] = a[4][i] = a[5][i] = 0;
+        }
+
+        EigenBlock(a);
+        for (size_t i = 0; i < n; i++)
+        {
+            eigenvalues[s + i] = Vector3(a[0][i], a[1][i], a[2][i]);
+            Matrix3x3 &e = eigenvectors[s + i];
+            for (int k = 0; k < 9; k++)
+                e.data[k / 3][k % 3] = a[6 + k][i];
+        }
+    }
+}
+
 Matrix3x3 Matrix3x3::FromQuaternion(Quaternion rotation)
 {
     Matrix3x3 m;
@@ -343,6 +625,33 @@ Matrix3x3 Matrix3x3::FromQuaternion(Quaternion rotation)
     return m;
 }
 
+Matrix3x3 Matrix3x3::FromQuaternion(UnitQuaternion rotation)
+{
+    Matrix3x3 m;
+    double sqw = rotation.W() * rotation.W();
+    double sqx = rotation.X() * rotation.X();
+    double sqy = rotation.Y() * rotation.Y();
+    double sqz = rotation.Z() * rotation.Z();
+    m.D00 = sqx - sqy - sqz + sqw;
+    m.D11 = -sqx + sqy - sqz + sqw;
+    m.D22 = -sqx - sqy + sqz + sqw;
+
+    double tmp1 = rotation.X() * rotation.Y();
+    double tmp2 = rotation.Z() * rotation.W();
+    m.D10 = 2.0 * (tmp1 + tmp2);
+    m.D01 = 2.0 * (tmp1 - tmp2);
+
+    tmp1 = rotation.X() * rotation.Z();
+    tmp2 = rotation.Y() * rotation.W();
+    m.D20 = 2.0 * (tmp1 - tmp2);
+    m.D02 = 2.0 * (tmp1 + tmp2);
+    tmp1 = rotation.Y() * rotation.Z();
+    tmp2 = rotation.X() * rotation.W();
+    m.D21 = 2.0 * (tmp1 + tmp2);
+    m.D12 = 2.0 * (tmp1 - tmp2);
+    return m;
+}
+
 Matrix3x3 Matrix3x3::Inverse(Matrix3x3 matrix)
 {
     Matrix3x3 a;
@@ -363,6 +672,61 @@ bool Matrix3x3::IsInvertible(Matrix3x3 matrix)
     return fabs(Determinate(matrix)) > 0.00001;
 }
 
+void Matrix3x3::PolarDecomposition(Matrix3x3 matrix, Matrix3x3 &rotation,
+                                   Matrix3x3 &stretch)
+{
+    Matrix3x3 u, v;
+    Vector3 sigma;
+    SVD(matrix, u, sigma, v);
+    Matrix3x3 vt = Transpose(v);
+    rotation = u * vt;
+    stretch = v * Matrix3x3(sigma.X, 0, 0, 0, sigma.Y, 0, 0, 0, sigma.Z) * vt;
+}
+
+void Matrix3x3::PolarDecomposition(Matrix3x3 matrix, Quaternion &rotation,
+                                   Matrix3x3 &stretch)
+{
+    Quaternion u, v;
+    Vector3 sigma;
+    SVD(matrix, u, sigma, v);
+    Matrix3x3 m = FromQuaternion(v);
+    stretch = m * Matrix3x3(sigma.X, 0, 0, 0, sigma.Y, 0, 0, 0, sigma.Z) *
+        Transpose(m);
+
+    // The product of U and the conjugate of V
+    rotation.X = v.W * u.X - u.W * v.X - u.Y * v.Z + u.Z * v.Y;
+    rotation.Y = v.W * u.Y - u.W * v.Y - u.Z * v.X + u.X * v.Z;
+    rotation.Z = v.W * u.Z - u.W * v.Z - u.X * v.Y + u.Y * v.X;
+    rotation.W = u.W * v.W + u.X * v.X + u.Y * v.Y + u.Z * v.Z;
+}
+
+void Matrix3x3::PolarDecomposition(const Matrix3x3 *matrices, size_t count,
+                                   Matrix3x3 *rotations,
+                                   Matrix3x3 *stretches)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect((const double *)matrices, 9 * count);
+    double a[SVDRows][BlockSize];
+    for (size_t s = 0; s < count; s += BlockSize)
+    {
+        size_t n = count - s < BlockSize ? count - s : BlockSize;
+        LoadSVDBlock<BlockSize>(matrices + s, n, a);
+        SVDBlock<BlockSize>(a);
+        for (size_t i = 0; i < n; i++)
+        {
+            Quaternion u, v;
+            Vector3 sigma;
+            StoreSVDBlock<BlockSize>(a, i, u, sigma, v);
+            Matrix3x3 mu = FromQuaternion(u);
+            Matrix3x3 mv = FromQuaternion(v);
+            Matrix3x3 vt = Transpose(mv);
+            rotations[s + i] = mu * vt;
+            stretches[s + i] = mv * Matrix3x3(sigma.X, 0, 0, 0, sigma.Y, 0,
+                                              0, 0, sigma.Z) * vt;
+        }
+    }
+}
+
 Matrix3x3 Matrix3x3::Scale(Matrix3x3 a, Matrix3x3 b)
 {
     Matrix3x3 m;
@@ -378,6 +742,46 @@ Matrix3x3 Matrix3x3::Scale(Matrix3x3 a, Matrix3x3 b)
     return m;
 }
 
+void Matrix3x3::SVD(Matrix3x3 matrix, Matrix3x3 &u, Vector3 &sigma,
+                    Matrix3x3 &v)
+{
+    Quaternion qu, qv;
+    SVD(matrix, qu, sigma, qv);
+    u = FromQuaternion(qu);
+    v = FromQuaternion(qv);
+}
+
+void Matrix3x3::SVD(Matrix3x3 matrix, Quaternion &u, Vector3 &sigma,
+                    Quaternion &v)
+{
+    // A single lane of the batch kernel, which the compiler unrolls
+    double a[SVDRows][1];
+    LoadSVDBlock<1>(&matrix, 1, a);
+    SVDBlock<1>(a);
+    StoreSVDBlock<1>(a, 0, u, sigma, v);
+}
+
+void Matrix3x3::SVD(const Matrix3x3 *matrices, size_t count, Matrix3x3 *u,
+                    Vector3 *sigma, Matrix3x3 *v)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect((const double *)matrices, 9 * count);
+    double a[SVDRows][BlockSize];
+    for (size_t s = 0; s < count; s += BlockSize)
+    {
+        size_t n = count - s < BlockSize ? count - s : BlockSize;
+        LoadSVDBlock<BlockSize>(matrices + s, n, a);
+        SVDBlock<BlockSize>(a);
+        for (size_t i = 0; i < n; i++)
+        {
+            Quaternion qu, qv;
+            StoreSVDBlock<BlockSize>(a, i, qu, sigma[s + i], qv);
+            u[s + i] = FromQuaternion(qu);
+            v[s + i] = FromQuaternion(qv);
+        }
+    }
+}
+
 Quaternion Matrix3x3::ToQuaternion(Matrix3x3 rotation)
 {
     Quaternion q;
@@ -436,6 +840,440 @@ Matrix3x3 Matrix3x3::Transpose(Matrix3x3 matrix)
 }
 
 
+void Matrix3x3::JacobiRotation(double &app, double &aqq, double &apq,
+                               double &arp, double &arq, Matrix3x3 &v, int p,
+                               int q)
+{
+    if (apq == 0)
+        return;
+    // The smaller root of t^2 + 2 theta t - 1 = 0 is the tangent of the
+    // rotation angle, which is at most 45 degrees
+    double theta = (aqq - app) / (2 * apq);
+    double t = copysign(1 / (fabs(theta) + sqrt(theta * theta + 1)), theta);
+    double c = 1 / sqrt(t * t + 1);
+    double s = t * c;
+    app -= t * apq;
+    aqq += t * apq;
+    apq = 0;
+    double rp = arp;
+    double rq = arq;
+    arp = c * rp - s * rq;
+    arq = s * rp + c * rq;
+    for (int k = 0; k < 3; k++)
+    {
+        double vp = v.data[k][p];
+        double vq = v.data[k][q];
+        v.data[k][p] = c * vp - s * vq;
+        v.data[k][q] = s * vp + c * vq;
+    }
+}
+
+void Matrix3x3::SortEigenPair(double &wp, double &wq, Matrix3x3 &v, int p,
+                              int q)
+{
+    if (wp <= wq)
+        return;
+    double w = wp;
+    wp = wq;
+    wq = w;
+    // Negating one of the swapped columns keeps the determinant at one
+    for (int k = 0; k < 3; k++)
+    {
+        double vp = v.data[k][p];
+        v.data[k][p] = v.data[k][q];
+        v.data[k][q] = -vp;
+    }
+}
+
+void Matrix3x3::EigenBlock(double a[15][BlockSize])
+{
+    for (int k = 0; k < 9; k++)
+    {
+        double diagonal = k % 4 == 0 ? 1 : 0;
+        for (size_t i = 0; i < BlockSize; i++)
+            a[6 + k][i] = diagonal;
+    }
+    for (int sweep = 0; sweep < JacobiSweeps; sweep++)
+    {
+        JacobiBlock<0, 1>(a);
+        JacobiBlock<0, 2>(a);
+        JacobiBlock<1, 2>(a);
+    }
+    SortEigenBlock<0, 1>(a);
+    SortEigenBlock<1, 2>(a);
+    SortEigenBlock<0, 1>(a);
+}
+
+template <int P, int Q>
+void Matrix3x3::JacobiBlock(double a[15][BlockSize])
+{
+    // The same steps as JacobiRotation, with selects in place of branches
+    // and each square root in a loop of its own, as sqrt is not vectorized.
+    // Keeping every lane in one array lets the compiler see that the rows
+    // do not overlap.
+    const int R = 3 - P - Q;
+    double *app = a[P];
+    double *aqq = a[Q];
+    double *apq = a[2 + P + Q];
+    double *arp = a[2 + R + P];
+    double *arq = a[2 + R + Q];
+    double theta[BlockSize], root[BlockSize], rotate[BlockSize];
+    for (size_t i = 0; i < BlockSize; i++)
+    {
+        // Lanes with nothing to rotate divide by one instead of zero and
+        // have their tangent masked to zero below. A select on the divisor
+        // would be turned back into a branch.
+        double rot = apq[i] != 0 ? 1 : 0;
+        double th = (aqq[i] - app[i]) / (2 * apq[i] + (1 - rot));
+        rotate[i] = rot;
+        theta[i] = th;
+        root[i] = th * th + 1;
+    }
+    for (size_t i = 0; i < BlockSize; i++)
+        root[i] = sqrt(root[i]);
+    for (size_t i = 0; i < BlockSize; i++)
+    {
+        double th = theta[i];
+        double t = copysign(1 / (fabs(th) + root[i]), th) * rotate[i];
+        theta[i] = t;
+        root[i] = t * t + 1;
+    }
+    for (size_t i = 0; i < BlockSize; i++)
+        root[i] = sqrt(root[i]);
+
+    double *v0p = a[6 + P], *v0q = a[6 + Q];
+    double *v1p = a[9 + P], *v1q = a[9 + Q];
+    double *v2p = a[12 + P], *v2q = a[12 + Q];
+    for (size_t i = 0; i < BlockSize; i++)
+    {
+        double t = theta[i];
+        double c = 1 / root[i];
+        double s = t * c;
+        app[i] -= t * apq[i];
+        aqq[i] += t * apq[i];
+        apq[i] = 0;
+        double rp = arp[i], rq = arq[i];
+        arp[i] = c * rp - s * rq;
+        arq[i] = s * rp + c * rq;
+        double vp = v0p[i], vq = v0q[i];
+        v0p[i] = c * vp - s * vq;
+        v0q[i] = s * vp + c * vq;
+        vp = v1p[i];
+        vq = v1q[i];
+        v1p[i] = c * vp - s * vq;
+        v1q[i] = s * vp + c * vq;
+        vp = v2p[i];
+        vq = v2q[i];
+        v2p[i] = c * vp - s * vq;
+        v2q[i] = s * vp + c * vq;
+    }
+}
+
+template <int P, int Q>
+void Matrix3x3::SortEigenBlock(double a[15][BlockSize])
+{
+    // Blending by a 0 or 1 weight is exact for finite values, and unlike a
+    // run of selects on the same comparison it is not made into a branch
+    double *wp = a[P], *wq = a[Q];
+    double *v0p = a[6 + P], *v0q = a[6 + Q];
+    double *v1p = a[9 + P], *v1q = a[9 + Q];
+    double *v2p = a[12 + P], *v2q = a[12 + Q];
+    for (size_t i = 0; i < BlockSize; i++)
+    {
+        double p = wp[i], q = wq[i];
+        double swap = p > q ? 1 : 0;
+        double keep = 1 - swap;
+        wp[i] = keep * p + swap * q;
+        wq[i] = keep * q + swap * p;
+        p = v0p[i];
+        q = v0q[i];
+        v0p[i] = keep * p + swap * q;
+        v0q[i] = keep * q - swap * p;
+        p = v1p[i];
+        q = v1q[i];
+        v1p[i] = keep * p + swap * q;
+        v1q[i] = keep * q - swap * p;
+        p = v2p[i];
+        q = v2q[i];
+        v2p[i] = keep * p + swap * q;
+        v2q[i] = keep * q - swap * p;
+    }
+}
+
+template <size_t Width>
+void Matrix3x3::LoadSVDBlock(const Matrix3x3 *matrices, size_t count,
+                             double a[SVDRows][Width])
+{
+    for (size_t i = 0; i < count; i++)
+        for (int k = 0; k < 9; k++)
+            a[6 + k][i] = matrices[i].data[k / 3][k % 3];
+    // Padding lanes decompose the identity
+    for (size_t i = count; i < Width; i++)
+        for (int k = 0; k < 9; k++)
+            a[6 + k][i] = k % 4 == 0 ? 1 : 0;
+}
+
+template <size_t Width>
+void Matrix3x3::SVDBlock(double a[SVDRows][Width])
+{
+    // Dividing by the largest element keeps A^T A well inside the range of
+    // a double
+    double *norm = a[23];
+    double scale[Width];
+    for (size_t i = 0; i < Width; i++)
+        norm[i] = 0;
+    for (int k = 6; k < 15; k++)
+        for (size_t i = 0; i < Width; i++)
+        {
+            double x = fabs(a[k][i]);
+            norm[i] = x > norm[i] ? x : norm[i];
+        }
+    for (size_t i = 0; i < Width; i++)
+        scale[i] = 1 / (norm[i] + (norm[i] > 0 ? 0 : 1));
+    for (int k = 6; k < 15; k++)
+        for (size_t i = 0; i < Width; i++)
+            a[k][i] *= scale[i];
+
+    for (size_t i = 0; i < Width; i++)
+    {
+        double b00 = a[6][i], b01 = a[7][i], b02 = a[8][i];
+        double b10 = a[9][i], b11 = a[10][i], b12 = a[11][i];
+        double b20 = a[12][i], b21 = a[13][i], b22 = a[14][i];
+        a[0][i] = b00 * b00 + b10 * b10 + b20 * b20;
+        a[1][i] = b01 * b01 + b11 * b11 + b21 * b21;
+        a[2][i] = b02 * b02 + b12 * b12 + b22 * b22;
+        a[3][i] = b00 * b01 + b10 * b11 + b20 * b21;
+        a[4][i] = b00 * b02 + b10 * b12 + b20 * b22;
+        a[5][i] = b01 * b02 + b11 * b12 + b21 * b22;
+    }
+    for (int k = 15; k < 23; k++)
+    {
+        double w = k == 18 || k == 22 ? 1 : 0;
+        for (size_t i = 0; i < Width; i++)
+            a[k][i] = w;
+    }
+    for (int sweep = 0; sweep < SVDSweeps; sweep++)
+    {
+        SVDJacobiBlock<0, 1, Width>(a);
+        SVDJacobiBlock<0, 2, Width>(a);
+        SVDJacobiBlock<1, 2, Width>(a);
+    }
+
+    // B = A V, with V from its quaternion
+    for (size_t i = 0; i < Width; i++)
+    {
+        double x = a[15][i], y = a[16][i], z = a[17][i], w = a[18][i];
+        double s = 2 / (x * x + y * y + z * z + w * w);
+        double v00 = 1 - s * (y * y + z * z);
+        double v11 = 1 - s * (x * x + z * z);
+        double v22 = 1 - s * (x * x + y * y);
+        double v01 = s * (x * y - z * w);
+        double v10 = s * (x * y + z * w);
+        double v02 = s * (x * z + y * w);
+        double v20 = s * (x * z - y * w);
+        double v12 = s * (y * z - x * w);
+        double v21 = s * (y * z + x * w);
+        double b0 = a[6][i], b1 = a[7][i], b2 = a[8][i];
+        a[6][i] = b0 * v00 + b1 * v10 + b2 * v20;
+        a[7][i] = b0 * v01 + b1 * v11 + b2 * v21;
+        a[8][i] = b0 * v02 + b1 * v12 + b2 * v22;
+        b0 = a[9][i];
+        b1 = a[10][i];
+        b2 = a[11][i];
+        a[9][i] = b0 * v00 + b1 * v10 + b2 * v20;
+        a[10][i] = b0 * v01 + b1 * v11 + b2 * v21;
+        a[11][i] = b0 * v02 + b1 * v12 + b2 * v22;
+        b0 = a[12][i];
+        b1 = a[13][i];
+        b2 = a[14][i];
+        a[12][i] = b0 * v00 + b1 * v10 + b2 * v20;
+        a[13][i] = b0 * v01 + b1 * v11 + b2 * v21;
+        a[14][i] = b0 * v02 + b1 * v12 + b2 * v22;
+    }
+
+    SVDSortBlock<0, 1, Width>(a);
+    SVDSortBlock<0, 2, Width>(a);
+    SVDSortBlock<1, 2, Width>(a);
+    QRGivensBlock<0, 1, Width>(a);
+    QRGivensBlock<0, 2, Width>(a);
+    QRGivensBlock<1, 2, Width>(a);
+
+    // The quaternions were built unnormalized, see SVDJacobiBlock
+    for (int q = 15; q < 23; q += 4)
+    {
+        for (size_t i = 0; i < Width; i++)
+            scale[i] = a[q][i] * a[q][i] + a[q + 1][i] * a[q + 1][i] +
+                a[q + 2][i] * a[q + 2][i] + a[q + 3][i] * a[q + 3][i];
+        for (size_t i = 0; i < Width; i++)
+            scale[i] = sqrt(scale[i]);
+        for (int k = q; k < q + 4; k++)
+            for (size_t i = 0; i < Width; i++)
+                a[k][i] /= scale[i];
+    }
+}
+
+template <int P, int Q, size_t Width>
+void Matrix3x3::SVDJacobiBlock(double a[SVDRows][Width])
+{
+    // The quaternion (hs, hc) about the remaining axis R has a half angle
+    // close to the one that zeroes apq, as long as that angle is below
+    // pi / 8; beyond it the rotation is clamped to pi / 8. R is negated
+    // when P, Q, R is not cyclic. The quaternion is left unnormalized, and
+    // the rotation is taken from it with a division instead of a square
+    // root, which unlike sqrt is vectorized. Blending by a 0 or 1 weight
+    // keeps the loop free of branches.
+    const int R = 3 - P - Q;
+    const double Gamma = 5.82842712474619;
+    const double CosPi8 = 0.9238795325112867;
+    const double SinPi8 = 0.3826834323650898;
+    const double Sign = Q == (P + 1) % 3 ? 1 : -1;
+    double *app = a[P];
+    double *aqq = a[Q];
+    double *apq = a[2 + P + Q];
+    double *arp = a[2 + R + P];
+    double *arq = a[2 + R + Q];
+    double *qa = a[15 + (R + 1) % 3];
+    double *qb = a[15 + (R + 2) % 3];
+    double *qr = a[15 + R];
+    double *qw = a[18];
+    for (size_t i = 0; i < Width; i++)
+    {
+        double hc = 2 * (app[i] - aqq[i]);
+        double hs = apq[i];
+        double exact = Gamma * hs * hs < hc * hc ? 1 : 0;
+        double clamp = 1 - exact;
+        // An exact lane has |hc| > |hs|, so dividing by |hc| keeps the
+        // quaternion's norm between 1 and 2. Clamped lanes add one to the
+        // divisor rather than select it, as a select would become a branch.
+        double scale = 1 / (fabs(hc) + clamp);
+        hc = exact * (hc * scale) + clamp * CosPi8;
+        hs = exact * (hs * scale) + clamp * SinPi8;
+        double n = 1 / (hc * hc + hs * hs);
+        double c = (hc * hc - hs * hs) * n;
+        double s = 2 * hc * hs * n;
+
+        double pp = app[i], qq = aqq[i], pq = apq[i];
+        app[i] = c * c * pp + 2 * c * s * pq + s * s * qq;
+        aqq[i] = s * s * pp - 2 * c * s * pq + c * c * qq;
+        apq[i] = (c * c - s * s) * pq + c * s * (qq - pp);
+        double rp = arp[i], rq = arq[i];
+        arp[i] = c * rp + s * rq;
+        arq[i] = c * rq - s * rp;
+
+        double k = Sign * hs;
+        double x = qa[i], y = qb[i], z = qr[i], w = qw[i];
+        qa[i] = hc * x + k * y;
+        qb[i] = hc * y - k * x;
+        qr[i] = hc * z + k * w;
+        qw[i] = hc * w - k * z;
+    }
+}
+
+template <int P, int Q, size_t Width>
+void Matrix3x3::SVDSortBlock(double a[SVDRows][Width])
+{
+    // Swaps columns P and Q of B if Q is longer, negating one to keep V a
+    // rotation, which is a quarter turn about the remaining axis R
+    const int R = 3 - P - Q;
+    const double Sign = Q == (P + 1) % 3 ? 1 : -1;
+    double *qa = a[15 + (R + 1) % 3];
+    double *qb = a[15 + (R + 2) % 3];
+    double *qr = a[15 + R];
+    double *qw = a[18];
+    for (size_t i = 0; i < Width; i++)
+    {
+        double bp0 = a[6 + P][i], bp1 = a[9 + P][i], bp2 = a[12 + P][i];
+        double bq0 = a[6 + Q][i], bq1 = a[9 + Q][i], bq2 = a[12 + Q][i];
+        double rhoP = bp0 * bp0 + bp1 * bp1 + bp2 * bp2;
+        double rhoQ = bq0 * bq0 + bq1 * bq1 + bq2 * bq2;
+        double swap = rhoP < rhoQ ? 1 : 0;
+        double keep = 1 - swap;
+        a[6 + P][i] = keep * bp0 + swap * bq0;
+        a[9 + P][i] = keep * bp1 + swap * bq1;
+        a[12 + P][i] = keep * bp2 + swap * bq2;
+        a[6 + Q][i] = keep * bq0 - swap * bp0;
+        a[9 + Q][i] = keep * bq1 - swap * bp1;
+        a[12 + Q][i] = keep * bq2 - swap * bp2;
+
+        double k = Sign * swap;
+        double x = qa[i], y = qb[i], z = qr[i], w = qw[i];
+        qa[i] = x + k * y;
+        qb[i] = y - k * x;
+        qr[i] = z + k * w;
+        qw[i] = w - k * z;
+    }
+}
+
+template <int P, int Q, size_t Width>
+void Matrix3x3::QRGivensBlock(double a[SVDRows][Width])
+{
+    // A Givens rotation of rows P and Q of B that zeroes the element QP,
+    // from the half angle formula. When bpp is negative the formula is
+    // flipped to avoid cancellation. Epsilon only matters for a column too
+    // small to rotate, which it leaves close to alone. The quaternion is
+    // scaled by its larger part as in SVDJacobiBlock.
+    const int R = 3 - P - Q;
+    const double Epsilon = 1e-150;
+    const double Sign = Q == (P + 1) % 3 ? 1 : -1;
+    double *bpp = a[6 + 4 * P];
+    double *bqp = a[6 + 3 * Q + P];
+    double *bp0 = a[6 + 3 * P], *bp1 = a[7 + 3 * P], *bp2 = a[8 + 3 * P];
+    double *bq0 = a[6 + 3 * Q], *bq1 = a[7 + 3 * Q], *bq2 = a[8 + 3 * Q];
+    double *qa = a[19 + (R + 1) % 3];
+    double *qb = a[19 + (R + 2) % 3];
+    double *qr = a[19 + R];
+    double *qw = a[22];
+    double rho[Width];
+    for (size_t i = 0; i < Width; i++)
+        rho[i] = bpp[i] * bpp[i] + bqp[i] * bqp[i];
+    for (size_t i = 0; i < Width; i++)
+        rho[i] = sqrt(rho[i]);
+    for (size_t i = 0; i < Width; i++)
+    {
+        double h = bqp[i];
+        double g = fabs(bpp[i]) + rho[i] + Epsilon;
+        double flip = bpp[i] < 0 ? 1 : 0;
+        double keep = 1 - flip;
+        // g is at least |h|, so the quaternion's norm is between 1 and 2
+        double scale = 1 / g;
+        double hc = (keep * g + flip * h) * scale;
+        double hs = (keep * h + flip * g) * scale;
+        double n = 1 / (hc * hc + hs * hs);
+        double c = (hc * hc - hs * hs) * n;
+        double s = 2 * hc * hs * n;
+        double p = bp0[i], q = bq0[i];
+        bp0[i] = c * p + s * q;
+        bq0[i] = c * q - s * p;
+        p = bp1[i];
+        q = bq1[i];
+        bp1[i] = c * p + s * q;
+        bq1[i] = c * q - s * p;
+        p = bp2[i];
+        q = bq2[i];
+        bp2[i] = c * p + s * q;
+        bq2[i] = c * q - s * p;
+
+        double k = Sign * hs;
+        double x = qa[i], y = qb[i], z = qr[i], w = qw[i];
+        qa[i] = hc * x + k * y;
+        qb[i] = hc * y - k * x;
+        qr[i] = hc * z + k * w;
+        qw[i] = hc * w - k * z;
+    }
+}
+
+template <size_t Width>
+void Matrix3x3::StoreSVDBlock(const double a[SVDRows][Width], size_t lane,
+                              Quaternion &u, Vector3 &sigma, Quaternion &v)
+{
+    double norm = a[23][lane];
+    u = Quaternion(a[19][lane], a[20][lane], a[21][lane], a[22][lane]);
+    sigma = Vector3(a[6][lane] * norm, a[10][lane] * norm,
+                    a[14][lane] * norm);
+    v = Quaternion(a[15][lane], a[16][lane], a[17][lane], a[18][lane]);
+}
+
+
 struct Matrix3x3& Matrix3x3::operator+=(const double rhs)
 {
     D00 += rhs; D01 += rhs; D02 += rhs;
@@ -0,0 +1,673 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a series of math functions for manipulating a
+ *  4x4 matrix, with fast paths for affine matrices (those whose bottom row
+ *  is 0, 0, 0, 1).
+ */
+
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <stddef.h>
+#include "DenormalGuard.hpp"
+#include "Matrix3x3.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+
+
+struct Matrix4x4
+{
+    union
+    {
+        struct
+        {
+            double D00;
+            double D01;
+            double D02;
+            double D03;
+            double D10;
+            double D11;
+            double D12;
+            double D13;
+            double D20;
+            double D21;
+            double D22;
+            double D23;
+            double D30;
+            double D31;
+            double D32;
+            double D33;
+        };
+        double data[4][4];
+    };
+
+
+    /**
+     * Constructors.
+     * The last builds an affine matrix from its upper-left 3x3 block and a
+     * translation.
+     */
+    inline Matrix4x4();
+    inline Matrix4x4(double data[]);
+    inline Matrix4x4(double d00, double d01, double d02, double d03,
+        double d10, double d11, double d12, double d13, double d20,
+        double d21, double d22, double d23, double d30, double d31,
+        double d32, double d33);
+    inline Matrix4x4(Matrix3x3 linear, Vector3 translation);
+
+
+    /**
+     * Constants for common Matrix4x4.
+     */
+    static inline Matrix4x4 Identity();
+    static inline Matrix4x4 Zero();
+    static inline Matrix4x4 One();
+
+
+    /**
+     * Returns the determinate of a matrix. Affine matrices only need the
+     * determinate of their upper-left 3x3 block.
+     * @param matrix: The input matrix.
+     * @return: A scalar value.
+     */
+    static inline double Determinate(Matrix4x4 matrix);
+
+    /**
+     * Converts a quaternion to a rotation matrix.
+     * @param rotation: The input quaternion.
+     * @return: A new rotation matrix.
+     */
+    static inline Matrix4x4 FromQuaternion(Quaternion rotation);
+
+    /**
+     * Converts a unit quaternion to a rotation matrix. This skips the
+     * division by the squared norm.
+     * @param rotation: The input unit quaternion.
+     * @return: A new rotation matrix.
+     */
+    static inline Matrix4x4 FromQuaternion(UnitQuaternion rotation);
+
+    /**
+     * Returns a matrix which scales along each axis.
+     * @param scale: The scale along each axis.
+     * @return: A new matrix.
+     */
+    static inline Matrix4x4 FromScale(Vector3 scale);
+
+    /**
+     * Returns a matrix which translates points.
+     * @param translation: The translation.
+     * @return: A new matrix.
+     */
+    static inline Matrix4x4 FromTranslation(Vector3 translation);
+
+    /**
+     * Returns a matrix which scales, then rotates, then translates.
+     * @param translation: The translation.
+     * @param rotation: The rotation.
+     * @param scale: The scale along each axis.
+     * @return: A new matrix.
+     */
+    static inline Matrix4x4 FromTRS(Vector3 translation, Quaternion rotation,
+                                    Vector3 scale);
+
+    /**
+     * Returns the inverse of a matrix. Affine matrices are inverted through
+     * InverseAffine.
+     * @param matrix: The input matrix.
+     * @return: A new matrix.
+     */
+    static inline Matrix4x4 Inverse(Matrix4x4 matrix);
+
+    /**
+     * Returns the inverse of an affine matrix, by inverting the upper-left
+     * 3x3 block and translating by the negated, transformed translation.
+     * The bottom row is assumed to be 0, 0, 0, 1 without checking it.
+     * @param matrix: The input matrix.
+     * @return: A new matrix.
+     */
+    static inline Matrix4x4 InverseAffine(Matrix4x4 matrix);
+
+    /**
+     * Returns true if the bottom row of a matrix is exactly 0, 0, 0, 1.
+     * @param matrix: The input matrix.
+     * @return: A boolean.
+     */
+    static inline bool IsAffine(Matrix4x4 matrix);
+
+    /**
+     * Returns true if a matrix is invertible.
+     * @param matrix: The input matrix.
+     * @return: A boolean.
+     */
+    static inline bool IsInvertible(Matrix4x4 matrix);
+
+    /**
+     * Multiplies two affine matrices, skipping the bottom row. The bottom
+     * rows are assumed to be 0, 0, 0, 1 without checking them.
+     * @param a: The left-hand side of the multiplication.
+     * @param b: The right-hand side of the multiplication.
+     * @return: A new matrix.
+     */
+    static inline Matrix4x4 MultiplyAffine(Matrix4x4 a, Matrix4x4 b);
+
+    /**
+     * Transforms a point, dividing by the resulting W component.
+     * @param matrix: The transformation.
+     * @param point: The point to transform.
+     * @return: A new point.
+     */
+    static inline Vector3 MultiplyPoint(Matrix4x4 matrix, Vector3 point);
+
+    /**
+     * Transforms a point by an affine matrix, ignoring the bottom row.
+     * @param matrix: The transformation.
+     * @param point: The point to transform.
+     * @return: A new point.
+     */
+    static inline Vector3 MultiplyPoint3x4(Matrix4x4 matrix, Vector3 point);
+
+    /**
+     * Transforms an array of points. If the matrix is affine, the division
+     * by W is skipped for the whole array. The output may be the same array
+     * as the input.
+     * @param matrix: The transformation.
+     * @param points: The points to transform.
+     * @param count: The number of points.
+     * @param output: The output array, which must hold "count" points.
+     */
+    static inline void MultiplyPoints(Matrix4x4 matrix, const Vector3 *points,
+                                      size_t count, Vector3 *output);
+
+    /**
+     * Transforms a direction by the upper-left 3x3 block of a matrix,
+     * ignoring translation.
+     * @param matrix: The transformation.
+     * @param vector: The direction to transform.
+     * @return: A new direction.
+     */
+    static inline Vector3 MultiplyVector(Matrix4x4 matrix, Vector3 vector);
+
+    /**
+     * Transforms an array of directions, as MultiplyVector does. The output
+     * may be the same array as the input.
+     * @param matrix: The transformation.
+     * @param vectors: The directions to transform.
+     * @param count: The number of directions.
+     * @param output: The output array, which must hold "count" directions.
+     */
+    static inline void MultiplyVectors(Matrix4x4 matrix,
+                                       const Vector3 *vectors, size_t count,
+                                       Vector3 *output);
+
+    /**
+     * Returns a perspective projection for a camera looking down its local
+     * Z axis with Y up. Points between the near and far planes are mapped
+     * to depths between -1 and 1.
+     * @param fieldOfView: The vertical field of view in radians.
+     * @param aspect: The width of the view divided by its height.
+     * @param nearDistance: The distance to the near plane.
+     * @param farDistance: The distance to the far plane.
+     * @return: A new matrix.
+     */
+    static inline Matrix4x4 Perspective(double fieldOfView, double aspect,
+                                        double nearDistance,
+                                        double farDistance);
+
+    /**
+     * Multiplies two matrices element-wise.
+     * @param a: The left-hand side of the multiplication.
+     * @param b: The right-hand side of the multiplication.
+     * @return: A new matrix.
+     */
+    static inline Matrix4x4 Scale(Matrix4x4 a, Matrix4x4 b);
+
+    /**
+     * Returns the upper-left 3x3 block of a matrix.
+     * @param matrix: The input matrix.
+     * @return: A new matrix.
+     */
+    static inline Matrix3x3 ToMatrix3x3(Matrix4x4 matrix);
+
+    /**
+     * Returns the translation of an affine matrix.
+     * @param matrix: The input matrix.
+     * @return: A new vector.
+     */
+    static inline Vector3 Translation(Matrix4x4 matrix);
+
+    /**
+     * Returns the transpose of a matrix.
+     * @param matrix: The input matrix.
+     * @return: A new matrix.
+     */
+    static inline Matrix4x4 Transpose(Matrix4x4 matrix);
+
+    /**
+     * Operator overloading.
+     */
+    inline struct Matrix4x4& operator+=(const double rhs);
+    inline struct Matrix4x4& operator-=(const double rhs);
+    inline struct Matrix4x4& operator*=(const double rhs);
+    inline struct Matrix4x4& operator/=(const double rhs);
+    inline struct Matrix4x4& operator+=(const Matrix4x4 rhs);
+    inline struct Matrix4x4& operator-=(const Matrix4x4 rhs);
+    inline struct Matrix4x4& operator*=(const Matrix4x4 rhs);
+};
+
+inline Matrix4x4 operator-(Matrix4x4 rhs);
+inline Matrix4x4 operator+(Matrix4x4 lhs, const double rhs);
+inline Matrix4x4 operator-(Matrix4x4 lhs, const double rhs);
+inline Matrix4x4 operator*(Matrix4x4 lhs, const double rhs);
+inline Matrix4x4 operator/(Matrix4x4 lhs, const double rhs);
+inline Matrix4x4 operator+(const double lhs, Matrix4x4 rhs);
+inline Matrix4x4 operator-(const double lhs, Matrix4x4 rhs);
+inline Matrix4x4 operator*(const double lhs, Matrix4x4 rhs);
+inline Matrix4x4 operator+(Matrix4x4 lhs, const Matrix4x4 rhs);
+inline Matrix4x4 operator-(Matrix4x4 lhs, const Matrix4x4 rhs);
+inline Matrix4x4 operator*(Matrix4x4 lhs, const Matrix4x4 rhs);
+inline bool operator==(const Matrix4x4 lhs, const Matrix4x4 rhs);
+inline bool operator!=(const Matrix4x4 lhs, const Matrix4x4 rhs);
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+Matrix4x4::Matrix4x4() : D00(1), D01(0), D02(0), D03(0), D10(0), D11(1),
+    D12(0), D13(0), D20(0), D21(0), D22(1), D23(0), D30(0), D31(0), D32(0),
+    D33(1) {}
+Matrix4x4::Matrix4x4(double data[]) : D00(data[0]), D01(data[1]),
+    D02(data[2]), D03(data[3]), D10(data[4]), D11(data[5]), D12(data[6]),
+    D13(data[7]), D20(data[8]), D21(data[9]), D22(data[10]), D23(data[11]),
+    D30(data[12]), D31(data[13]), D32(data[14]), D33(data[15]) {}
+Matrix4x4::Matrix4x4(double d00, double d01, double d02, double d03,
+    double d10, double d11, double d12, double d13, double d20, double d21,
+    double d22, double d23, double d30, double d31, double d32, double d33) :
+    D00(d00), D01(d01), D02(d02), D03(d03), D10(d10), D11(d11), D12(d12),
+    D13(d13), D20(d20), D21(d21), D22(d22), D23(d23), D30(d30), D31(d31),
+    D32(d32), D33(d33) {}
+Matrix4x4::Matrix4x4(Matrix3x3 linear, Vector3 translation) :
+    D00(linear.D00), D01(linear.D01), D02(linear.D02), D03(translation.X),
+    D10(linear.D10), D11(linear.D11), D12(linear.D12), D13(translation.Y),
+    D20(linear.D20), D21(linear.D21), D22(linear.D22), D23(translation.Z),
+    D30(0), D31(0), D32(0), D33(1) {}
+
+
+Matrix4x4 Matrix4x4::Identity()
+{
+    return Matrix4x4(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
+}
+
+Matrix4x4 Matrix4x4::Zero()
+{
+    return Matrix4x4(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+}
+
+Matrix4x4 Matrix4x4::One()
+{
+    return Matrix4x4(1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1);
+}
+
+
+double Matrix4x4::Determinate(Matrix4x4 matrix)
+{
+    if (IsAffine(matrix))
+        return Matrix3x3::Determinate(ToMatrix3x3(matrix));
+
+    // Expand along the top two rows using 2x2 minors
+    double s0 = matrix.D00 * matrix.D11 - matrix.D10 * matrix.D01;
+    double s1 = matrix.D00 * matrix.D12 - matrix.D10 * matrix.D02;
+    double s2 = matrix.D00 * matrix.D13 - matrix.D10 * matrix.D03;
+    double s3 = matrix.D01 * matrix.D12 - matrix.D11 * matrix.D02;
+    double s4 = matrix.D01 * matrix.D13 - matrix.D11 * matrix.D03;
+    double s5 = matrix.D02 * matrix.D13 - matrix.D12 * matrix.D03;
+    double c0 = matrix.D20 * matrix.D31 - matrix.D30 * matrix.D21;
+    double c1 = matrix.D20 * matrix.D32 - matrix.D30 * matrix.D22;
+    double c2 = matrix.D20 * matrix.D33 - matrix.D30 * matrix.D23;
+    double c3 = matrix.D21 * matrix.D32 - matrix.D31 * matrix.D22;
+    double c4 = matrix.D21 * matrix.D33 - matrix.D31 * matrix.D23;
+    double c5 = matrix.D22 * matrix.D33 - matrix.D32 * matrix.D23;
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+Matrix4x4 Matrix4x4::FromQuaternion(Quaternion rotation)
+{
+    return Matrix4x4(Matrix3x3::FromQuaternion(rotation), Vector3::Zero());
+}
+
+Matrix4x4 Matrix4x4::FromQuaternion(UnitQuaternion rotation)
+{
+    return Matrix4x4(Matrix3x3::FromQuaternion(rotation), Vector3::Zero());
+}
+
+Matrix4x4 Matrix4x4::FromScale(Vector3 scale)
+{
+    return Matrix4x4(scale.X, 0, 0, 0, 0, scale.Y, 0, 0, 0, 0, scale.Z, 0, 0,
+                     0, 0, 1);
+}
+
+Matrix4x4 Matrix4x4::FromTranslation(Vector3 translation)
+{
+    return Matrix4x4(Matrix3x3::Identity(), translation);
+}
+
+Matrix4x4 Matrix4x4::FromTRS(Vector3 translation, Quaternion rotation,
+                             Vector3 scale)
+{
+    Matrix4x4 m = Matrix4x4(Matrix3x3::FromQuaternion(rotation),
+                            translation);
+    m.D00 *= scale.X; m.D01 *= scale.Y; m.D02 *= scale.Z;
+    m.D10 *= scale.X; m.D11 *= scale.Y; m.D12 *= scale.Z;
+    m.D20 *= scale.X; m.D21 *= scale.Y; m.D22 *= scale.Z;
+    return m;
+}
+
+Matrix4x4 Matrix4x4::Inverse(Matrix4x4 matrix)
+{
+    if (IsAffine(matrix))
+        return InverseAffine(matrix);
+
+    double s0 = matrix.D00 * matrix.D11 - matrix.D10 * matrix.D01;
+    double s1 = matrix.D00 * matrix.D12 - matrix.D10 * matrix.D02;
+    double s2 = matrix.D00 * matrix.D13 - matrix.D10 * matrix.D03;
+    double s3 = matrix.D01 * matrix.D12 - matrix.D11 * matrix.D02;
+    double s4 = matrix.D01 * matrix.D13 - matrix.D11 * matrix.D03;
+    double s5 = matrix.D02 * matrix.D13 - matrix.D12 * matrix.D03;
+    double c0 = matrix.D20 * matrix.D31 - matrix.D30 * matrix.D21;
+    double c1 = matrix.D20 * matrix.D32 - matrix.D30 * matrix.D22;
+    double c2 = matrix.D20 * matrix.D33 - matrix.D30 * matrix.D23;
+    double c3 = matrix.D21 * matrix.D32 - matrix.D31 * matrix.D22;
+    double c4 = matrix.D21 * matrix.D33 - matrix.D31 * matrix.D23;
+    double c5 = matrix.D22 * matrix.D33 - matrix.D32 * matrix.D23;
+    double det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+    Matrix4x4 a;
+    a.D00 = matrix.D11 * c5 - matrix.D12 * c4 + matrix.D13 * c3;
+    a.D01 = -matrix.D01 * c5 + matrix.D02 * c4 - matrix.D03 * c3;
+    a.D02 = matrix.D31 * s5 - matrix.D32 * s4 + matrix.D33 * s3;
+    a.D03 = -matrix.D21 * s5 + matrix.D22 * s4 - matrix.D23 * s3;
+    a.D10 = -matrix.D10 * c5 + matrix.D12 * c2 - matrix.D13 * c1;
+    a.D11 = matrix.D00 * c5 - matrix.D02 * c2 + matrix.D03 * c1;
+    a.D12 = -matrix.D30 * s5 + matrix.D32 * s2 - matrix.D33 * s1;
+    a.D13 = matrix.D20 * s5 - matrix.D22 * s2 + matrix.D23 * s1;
+    a.D20 = matrix.D10 * c4 - matrix.D11 * c2 + matrix.D13 * c0;
+    a.D21 = -matrix.D00 * c4 + matrix.D01 * c2 - matrix.D03 * c0;
+    a.D22 = matrix.D30 * s4 - matrix.D31 * s2 + matrix.D33 * s0;
+    a.D23 = -matrix.D20 * s4 + matrix.D21 * s2 - matrix.D23 * s0;
+    a.D30 = -matrix.D10 * c3 + matrix.D11 * c1 - matrix.D12 * c0;
+    a.D31 = matrix.D00 * c3 - matrix.D01 * c1 + matrix.D02 * c0;
+    a.D32 = -matrix.D30 * s3 + matrix.D31 * s1 - matrix.D32 * s0;
+    a.D33 = matrix.D20 * s3 - matrix.D21 * s1 + matrix.D22 * s0;
+    return 1 / det * a;
+}
+
+Matrix4x4 Matrix4x4::InverseAffine(Matrix4x4 matrix)
+{
+    Matrix3x3 inverse = Matrix3x3::Inverse(ToMatrix3x3(matrix));
+    return Matrix4x4(inverse, -(inverse * Translation(matrix)));
+}
+
+bool Matrix4x4::IsAffine(Matrix4x4 matrix)
+{
+    return matrix.D30 == 0 && matrix.D31 == 0 && matrix.D32 == 0 &&
+        matrix.D33 == 1;
+}
+
+bool Matrix4x4::IsInvertible(Matrix4x4 matrix)
+{
+    return fabs(Determinate(matrix)) > 0.00001;
+}
+
+Matrix4x4 Matrix4x4::MultiplyAffine(Matrix4x4 a, Matrix4x4 b)
+{
+    Matrix4x4 m;
+    m.D00 = a.D00 * b.D00 + a.D01 * b.D10 + a.D02 * b.D20;
+    m.D01 = a.D00 * b.D01 + a.D01 * b.D11 + a.D02 * b.D21;
+    m.D02 = a.D00 * b.D02 + a.D01 * b.D12 + a.D02 * b.D22;
+    m.D03 = a.D00 * b.D03 + a.D01 * b.D13 + a.D02 * b.D23 + a.D03;
+    m.D10 = a.D10 * b.D00 + a.D11 * b.D10 + a.D12 * b.D20;
+    m.D11 = a.D10 * b.D01 + a.D11 * b.D11 + a.D12 * b.D21;
+    m.D12 = a.D10 * b.D02 + a.D11 * b.D12 + a.D12 * b.D22;
+    m.D13 = a.D10 * b.D03 + a.D11 * b.D13 + a.D12 * b.D23 + a.D13;
+    m.D20 = a.D20 * b.D00 + a.D21 * b.D10 + a.D22 * b.D20;
+    m.D21 = a.D20 * b.D01 + a.D21 * b.D11 + a.D22 * b.D21;
+    m.D22 = a.D20 * b.D02 + a.D21 * b.D12 + a.D22 * b.D22;
+    m.D23 = a.D20 * b.D03 + a.D21 * b.D13 + a.D22 * b.D23 + a.D23;
+    return m;
+}
+
+Vector3 Matrix4x4::MultiplyPoint(Matrix4x4 matrix, Vector3 point)
+{
+    Vector3 v = MultiplyPoint3x4(matrix, point);
+    double w = matrix.D30 * point.X + matrix.D31 * point.Y +
+        matrix.D32 * point.Z + matrix.D33;
+    return v / w;
+}
+
+Vector3 Matrix4x4::MultiplyPoint3x4(Matrix4x4 matrix, Vector3 point)
+{
+    Vector3 v;
+    v.X = matrix.D00 * point.X + matrix.D01 * point.Y + matrix.D02 * point.Z +
+        matrix.D03;
+    v.Y = matrix.D10 * point.X + matrix.D11 * point.Y + matrix.D12 * point.Z +
+        matrix.D13;
+    v.Z = matrix.D20 * point.X + matrix.D21 * point.Y + matrix.D22 * point.Z +
+        matrix.D23;
+    return v;
+}
+
+void Matrix4x4::MultiplyPoints(Matrix4x4 matrix, const Vector3 *points,
+                               size_t count, Vector3 *output)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect((const double *)points, 3 * count);
+    if (IsAffine(matrix))
+    {
+        for (size_t i = 0; i < count; i++)
+            output[i] = MultiplyPoint3x4(matrix, points[i]);
+    }
+    else
+    {
+        for (size_t i = 0; i < count; i++)
+            output[i] = MultiplyPoint(matrix, points[i]);
+    }
+}
+
+Vector3 Matrix4x4::MultiplyVector(Matrix4x4 matrix, Vector3 vector)
+{
+    Vector3 v;
+    v.X = matrix.D00 * vector.X + matrix.D01 * vector.Y +
+        matrix.D02 * vector.Z;
+    v.Y = matrix.D10 * vector.X + matrix.D11 * vector.Y +
+        matrix.D12 * vector.Z;
+    v.Z = matrix.D20 * vector.X + matrix.D21 * vector.Y +
+        matrix.D22 * vector.Z;
+    return v;
+}
+
+void Matrix4x4::MultiplyVectors(Matrix4x4 matrix, const Vector3 *vectors,
+                                size_t count, Vector3 *output)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect((const double *)vectors, 3 * count);
+    for (size_t i = 0; i < count; i++)
+        output[i] = MultiplyVector(matrix, vectors[i]);
+}
+
+Matrix4x4 Matrix4x4::Perspective(double fieldOfView, double aspect,
+                                 double nearDistance, double farDistance)
+{
+    double y = 1 / tan(fieldOfView / 2);
+    double x = y / aspect;
+    double depth = farDistance - nearDistance;
+    return Matrix4x4(x, 0, 0, 0, 0, y, 0, 0, 0, 0,
+                     (farDistance + nearDistance) / depth,
+                     -2 * farDistance * nearDistance / depth, 0, 0, 1, 0);
+}
+
+Matrix4x4 Matrix4x4::Scale(Matrix4x4 a, Matrix4x4 b)
+{
+    Matrix4x4 m;
+    m.D00 = a.D00 * b.D00;
+    m.D01 = a.D01 * b.D01;
+    m.D02 = a.D02 * b.D02;
+    m.D03 = a.D03 * b.D03;
+    m.D10 = a.D10 * b.D10;
+    m.D11 = a.D11 * b.D11;
+    m.D12 = a.D12 * b.D12;
+    m.D13 = a.D13 * b.D13;
+    m.D20 = a.D20 * b.D20;
+    m.D21 = a.D21 * b.D21;
+    m.D22 = a.D22 * b.D22;
+    m.D23 = a.D23 * b.D23;
+    m.D30 = a.D30 * b.D30;
+    m.D31 = a.D31 * b.D31;
+    m.D32 = a.D32 * b.D32;
+    m.D33 = a.D33 * b.D33;
+    return m;
+}
+
+Matrix3x3 Matrix4x4::ToMatrix3x3(Matrix4x4 matrix)
+{
+    return Matrix3x3(matrix.D00, matrix.D01, matrix.D02, matrix.D10,
+                     matrix.D11, matrix.D12, matrix.D20, matrix.D21,
+                     matrix.D22);
+}
+
+Vector3 Matrix4x4::Translation(Matrix4x4 matrix)
+{
+    return Vector3(matrix.D03, matrix.D13, matrix.D23);
+}
+
+Matrix4x4 Matrix4x4::Transpose(Matrix4x4 matrix)
+{
+    Matrix4x4 m;
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            m.data[i][j] = matrix.data[j][i];
+    return m;
+}
+
+
+struct Matrix4x4& Matrix4x4::operator+=(const double rhs)
+{
+    D00 += rhs; D01 += rhs; D02 += rhs; D03 += rhs;
+    D10 += rhs; D11 += rhs; D12 += rhs; D13 += rhs;
+    D20 += rhs; D21 += rhs; D22 += rhs; D23 += rhs;
+    D30 += rhs; D31 += rhs; D32 += rhs; D33 += rhs;
+    return *this;
+}
+
+struct Matrix4x4& Matrix4x4::operator-=(const double rhs)
+{
+    D00 -= rhs; D01 -= rhs; D02 -= rhs; D03 -= rhs;
+    D10 -= rhs; D11 -= rhs; D12 -= rhs; D13 -= rhs;
+    D20 -= rhs; D21 -= rhs; D22 -= rhs; D23 -= rhs;
+    D30 -= rhs; D31 -= rhs; D32 -= rhs; D33 -= rhs;
+    return *this;
+}
+
+struct Matrix4x4& Matrix4x4::operator*=(const double rhs)
+{
+    D00 *= rhs; D01 *= rhs; D02 *= rhs; D03 *= rhs;
+    D10 *= rhs; D11 *= rhs; D12 *= rhs; D13 *= rhs;
+    D20 *= rhs; D21 *= rhs; D22 *= rhs; D23 *= rhs;
+    D30 *= rhs; D31 *= rhs; D32 *= rhs; D33 *= rhs;
+    return *this;
+}
+
+struct Matrix4x4& Matrix4x4::operator/=(const double rhs)
+{
+    D00 /= rhs; D01 /= rhs; D02 /= rhs; D03 /= rhs;
+    D10 /= rhs; D11 /= rhs; D12 /= rhs; D13 /= rhs;
+    D20 /= rhs; D21 /= rhs; D22 /= rhs; D23 /= rhs;
+    D30 /= rhs; D31 /= rhs; D32 /= rhs; D33 /= rhs;
+    return *this;
+}
+
+struct Matrix4x4& Matrix4x4::operator+=(const Matrix4x4 rhs)
+{
+    D00 += rhs.D00; D01 += rhs.D01; D02 += rhs.D02; D03 += rhs.D03;
+    D10 += rhs.D10; D11 += rhs.D11; D12 += rhs.D12; D13 += rhs.D13;
+    D20 += rhs.D20; D21 += rhs.D21; D22 += rhs.D22; D23 += rhs.D23;
+    D30 += rhs.D30; D31 += rhs.D31; D32 += rhs.D32; D33 += rhs.D33;
+    return *this;
+}
+
+struct Matrix4x4& Matrix4x4::operator-=(const Matrix4x4 rhs)
+{
+    D00 -= rhs.D00; D01 -= rhs.D01; D02 -= rhs.D02; D03 -= rhs.D03;
+    D10 -= rhs.D10; D11 -= rhs.D11; D12 -= rhs.D12; D13 -= rhs.D13;
+    D20 -= rhs.D20; D21 -= rhs.D21; D22 -= rhs.D22; D23 -= rhs.D23;
+    D30 -= rhs.D30; D31 -= rhs.D31; D32 -= rhs.D32; D33 -= rhs.D33;
+    return *this;
+}
+
+struct Matrix4x4& Matrix4x4::operator*=(const Matrix4x4 rhs)
+{
+    Matrix4x4 m;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            m.data[i][j] = data[i][0] * rhs.data[0][j] +
+                data[i][1] * rhs.data[1][j] + data[i][2] * rhs.data[2][j] +
+                data[i][3] * rhs.data[3][j];
+        }
+    }
+    *this = m;
+    return *this;
+}
+
+Matrix4x4 operator-(Matrix4x4 rhs) { return rhs * -1; }
+Matrix4x4 operator+(Matrix4x4 lhs, const double rhs) { return lhs += rhs; }
+Matrix4x4 operator-(Matrix4x4 lhs, const double rhs) { return lhs -= rhs; }
+Matrix4x4 operator*(Matrix4x4 lhs, const double rhs) { return lhs *= rhs; }
+Matrix4x4 operator/(Matrix4x4 lhs, const double rhs) { return lhs /= rhs; }
+Matrix4x4 operator+(const double lhs, Matrix4x4 rhs) { return rhs += lhs; }
+Matrix4x4 operator-(const double lhs, Matrix4x4 rhs) { return rhs -= lhs; }
+Matrix4x4 operator*(const double lhs, Matrix4x4 rhs) { return rhs *= lhs; }
+Matrix4x4 operator+(Matrix4x4 lhs, const Matrix4x4 rhs) { return lhs += rhs; }
+Matrix4x4 operator-(Matrix4x4 lhs, const Matrix4x4 rhs) { return lhs -= rhs; }
+Matrix4x4 operator*(Matrix4x4 lhs, const Matrix4x4 rhs) { return lhs *= rhs; }
+
+bool operator==(const Matrix4x4 lhs, const Matrix4x4 rhs)
+{
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            if (lhs.data[i][j] != rhs.data[i][j])
+                return false;
+    return true;
+}
+
+bool operator!=(const Matrix4x4 lhs, const Matrix4x4 rhs)
+{
+    return !(lhs == rhs);
+}
@@ -0,0 +1,125 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a minimal thread based parallel-for and fork-join
+ *  helper, used by the spatial structures and batch kernels.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <thread>
+#include <vector>
+
+
+struct Parallel
+{
+    /**
+     * Returns the number of chunks that For will split "count" items into,
+     * given that each chunk should hold at least "grain" items.
+     * @param count: The number of items.
+     * @param grain: The minimum number of items per chunk.
+     * @return: A count, at least one.
+     */
+    static inline size_t Chunks(size_t count, size_t grain);
+
+    /**
+     * Splits the range [0, count) into contiguous chunks and calls
+     * body(chunk, begin, end) for each of them, one chunk per thread. The
+     * first chunk runs on the calling thread, and the call returns once every
+     * chunk has finished.
+     * @param count: The number of items.
+     * @param grain: The minimum number of items per chunk.
+     * @param body: The function to call on each chunk.
+     */
+    template <typename F>
+    static inline void For(size_t count, size_t grain, F body);
+
+    /**
+     * Runs two functions at the same time, "first" on the calling thread and
+     * "second" on a new thread, and returns once both have finished.
+     * @param first: The first function.
+     * @param second: The second function.
+     */
+    template <typename F, typename G>
+    static inline void Invoke(F first, G second);
+
+    /**
+     * Returns the number of hardware threads available, at least one.
+     * @return: A count.
+     */
+    static inline size_t ThreadCount();
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+size_t Parallel::Chunks(size_t count, size_t grain)
+{
+    if (grain == 0)
+        grain = 1;
+    size_t chunks = count / grain;
+    size_t threads = ThreadCount();
+    if (chunks > threads)
+        chunks = threads;
+    return chunks > 0 ? chunks : 1;
+}
+
+template <typename F>
+void Parallel::For(size_t count, size_t grain, F body)
+{
+    size_t chunks = Chunks(count, grain);
+    if (chunks == 1)
+    {
+        body((size_t)0, (size_t)0, count);
+        return;
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(chunks - 1);
+    for (size_t i = 1; i < chunks; i++)
+        threads.emplace_back(body, i, count * i / chunks,
+                             count * (i + 1) / chunks);
+    body((size_t)0, (size_t)0, count / chunks);
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+}
+
+template <typename F, typename G>
+void Parallel::Invoke(F first, G second)
+{
+    std::thread thread(second);
+    first();
+    thread.join();
+}
+
+size_t Parallel::ThreadCount()
+{
+    static const size_t count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
@@ -0,0 +1,330 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements an infinite plane, with distance queries and ray
+ *  intersection tests for single planes and for arrays of planes or rays.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <algorithm>
+#include "DenormalGuard.hpp"
+#include "Ray.hpp"
+#include "Vector3.hpp"
+#include "Vector3Array.hpp"
+
+
+struct Plane
+{
+    /**
+     * A point p lies on the plane when Dot(Normal, p) + Offset == 0. The
+     * normal is unit length, so the same expression gives signed distances,
+     * positive on the side the normal points to. This matches the planes of
+     * a Frustum.
+     */
+    Vector3 Normal;
+    double Offset;
+
+    // The number of intersections computed at a time by the batch kernels
+    static constexpr size_t BlockSize = 256;
+
+
+    /**
+     * Constructors.
+     * The normal passed in must be unit length.
+     */
+    inline Plane();
+    inline Plane(Vector3 normal, double offset);
+
+
+    /**
+     * Returns the point on a plane closest to another point.
+     * @param plane: The plane in question.
+     * @param point: The point in question.
+     * @return: A new point.
+     */
+    static inline Vector3 ClosestPoint(Plane plane, Vector3 point);
+
+    /**
+     * Returns a plane through three points, with its normal facing the side
+     * from which they appear counterclockwise. The points may not be
+     * collinear.
+     * @param a: The first point.
+     * @param b: The second point.
+     * @param c: The third point.
+     * @return: A new plane.
+     */
+    static inline Plane FromPoints(Vector3 a, Vector3 b, Vector3 c);
+
+    /**
+     * Returns a plane through a point with a given normal.
+     * @param point: A point on the plane.
+     * @param normal: The normal, which need not be unit length.
+     * @return: A new plane.
+     */
+    static inline Plane FromPointNormal(Vector3 point, Vector3 normal);
+
+    /**
+     * Intersects a ray with a plane from either side. Rays parallel to the
+     * plane miss it, even when they lie in it.
+     * @param plane: The plane to test.
+     * @param ray: The ray in question.
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param distance: The ray parameter where the ray meets the plane.
+     * @return: True if the ray hits the plane.
+     */
+    static inline bool Raycast(Plane plane, Ray ray, double maxDistance,
+                               double &distance);
+
+    /**
+     * Intersects one ray with an array of planes.
+     * @param normals: The unit normals of the planes.
+     * @param offsets: The offsets of the planes.
+     * @param ray: The ray in question.
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param hits: The output hit flags, one per plane.
+     * @param distances: The output distances, one per plane. These are only
+     * meaningful where the hit flag is set.
+     */
+    static inline void Raycast(const Vector3Array &normals,
+                               const double *offsets, Ray ray,
+                               double maxDistance, bool *hits,
+                               double *distances);
+
+    /**
+     * Intersects an array of rays with one plane.
+     * @param plane: The plane to test.
+     * @param origins: The origins of the rays.
+     * @param directions: The directions of the rays.
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param hits: The output hit flags, one per ray.
+     * @param distances: The output distances, one per ray. These are only
+     * meaningful where the hit flag is set.
+     */
+    static inline void Raycast(Plane plane, const Vector3Array &origins,
+                               const Vector3Array &directions,
+                               double maxDistance, bool *hits,
+                               double *distances);
+
+    /**
+     * Returns the signed distance from a plane to a point.
+     * @param plane: The plane in question.
+     * @param point: The point in question.
+     * @return: A scalar value, negative behind the plane.
+     */
+    static inline double SignedDistance(Plane plane, Vector3 point);
+
+    /**
+     * Computes the signed distances from a plane to an array of points.
+     * @param plane: The plane in question.
+     * @param points: The points in question.
+     * @param distances: The output distances, one per point.
+     */
+    static inline void SignedDistances(Plane plane, const Vector3Array &points,
+                                       double *distances);
+
+    /**
+     * Helpers for the implementation.
+     * The block takes the ray parameters of the hits for BlockSize lanes,
+     * of which the first count are written out.
+     */
+    static inline void RaycastBlock(const double *t, const double *rates,
+                                    size_t count, double maxDistance,
+                                    bool *hits, double *distances);
+};
+
+inline bool operator==(const Plane lhs, const Plane rhs);
+inline bool operator!=(const Plane lhs, const Plane rhs);
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+Plane::Plane() : Normal(0, 1, 0), Offset(0) {}
+Plane::Plane(Vector3 normal, double offset) : Normal(normal), Offset(offset)
+{}
+
+
+Vector3 Plane::ClosestPoint(Plane plane, Vector3 point)
+{
+    return point - plane.Normal * SignedDistance(plane, point);
+}
+
+Plane Plane::FromPoints(Vector3 a, Vector3 b, Vector3 c)
+{
+    return FromPointNormal(a, Vector3::Cross(b - a, c - a));
+}
+
+Plane Plane::FromPointNormal(Vector3 point, Vector3 normal)
+{
+    Vector3 n = Vector3::Normalized(normal);
+    return Plane(n, -Vector3::Dot(n, point));
+}
+
+bool Plane::Raycast(Plane plane, Ray ray, double maxDistance,
+                    double &distance)
+{
+    double rate = Vector3::Dot(plane.Normal, ray.Direction);
+    distance = -SignedDistance(plane, ray.Origin) / rate;
+    return rate != 0 && distance >= 0 && distance <= maxDistance;
+}
+
+void Plane::Raycast(const Vector3Array &normals, const double *offsets,
+                    Ray ray, double maxDistance, bool *hits,
+                    double *distances)
+{
+    size_t count = Vector3Array::Size(normals);
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect(normals.X.data(), count);
+    DenormalGuard::Inspect(normals.Y.data(), count);
+    DenormalGuard::Inspect(normals.Z.data(), count);
+    DenormalGuard::Inspect(offsets, count);
+    double px[BlockSize], py[BlockSize], pz[BlockSize], pw[BlockSize];
+    double t[BlockSize], rates[BlockSize];
+    Vector3 o = ray.Origin;
+    Vector3 d = ray.Direction;
+    for (size_t s = 0; s < count; s += BlockSize)
+    {
+        size_t n = count - s < BlockSize ? count - s : BlockSize;
+        const double *x = normals.X.data() + s;
+        const double *y = normals.Y.data() + s;
+        const double *z = normals.Z.data() + s;
+        const double *w = offsets + s;
+        if (n < BlockSize)
+        {
+            x = Vector3Array::PadBlock(x, n, BlockSize, px);
+            y = Vector3Array::PadBlock(y, n, BlockSize, py);
+            z = Vector3Array::PadBlock(z, n, BlockSize, pz);
+            w = Vector3Array::PadBlock(w, n, BlockSize, pw);
+        }
+        for (size_t i = 0; i < BlockSize; i++)
+        {
+            rates[i] = x[i] * d.X + y[i] * d.Y + z[i] * d.Z;
+            t[i] = -(x[i] * o.X + y[i] * o.Y + z[i] * o.Z + w[i]) / rates[i];
+        }
+        RaycastBlock(t, rates, n, maxDistance, hits + s, distances + s);
+    }
+}
+
+void Plane::Raycast(Plane plane, const Vector3Array &origins,
+                    const Vector3Array &directions, double maxDistance,
+                    bool *hits, double *distances)
+{
+    size_t count = Vector3Array::Size(origins);
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect(origins.X.data(), count);
+    DenormalGuard::Inspect(origins.Y.data(), count);
+    DenormalGuard::Inspect(origins.Z.data(), count);
+    DenormalGuard::Inspect(directions.X.data(), count);
+    DenormalGuard::Inspect(directions.Y.data(), count);
+    DenormalGuard::Inspect(directions.Z.data(), count);
+    double pox[BlockSize], poy[BlockSize], poz[BlockSize];
+    double pdx[BlockSize], pdy[BlockSize], pdz[BlockSize];
+    double t[BlockSize], rates[BlockSize];
+    Vector3 n = plane.Normal;
+    for (size_t s = 0; s < count; s += BlockSize)
+    {
+        size_t m = count - s < BlockSize ? count - s : BlockSize;
+        const double *ox = origins.X.data() + s;
+        const double *oy = origins.Y.data() + s;
+        const double *oz = origins.Z.data() + s;
+        const double *dx = directions.X.data() + s;
+        const double *dy = directions.Y.data() + s;
+        const double *dz = directions.Z.data() + s;
+        if (m < BlockSize)
+        {
+            ox = Vector3Array::PadBlock(ox, m, BlockSize, pox);
+            oy = Vector3Array::PadBlock(oy, m, BlockSize, poy);
+            oz = Vector3Array::PadBlock(oz, m, BlockSize, poz);
+            dx = Vector3Array::PadBlock(dx, m, BlockSize, pdx);
+            dy = Vector3Array::PadBlock(dy, m, BlockSize, pdy);
+            dz = Vector3Array::PadBlock(dz, m, BlockSize, pdz);
+        }
+        for (size_t i = 0; i < BlockSize; i++)
+        {
+            double height = n.X * ox[i] + n.Y * oy[i] + n.Z * oz[i] +
+                plane.Offset;
+            rates[i] = n.X * dx[i] + n.Y * dy[i] + n.Z * dz[i];
+            t[i] = -height / rates[i];
+        }
+        RaycastBlock(t, rates, m, maxDistance, hits + s, distances + s);
+    }
+}
+
+double Plane::SignedDistance(Plane plane, Vector3 point)
+{
+    return Vector3::Dot(plane.Normal, point) + plane.Offset;
+}
+
+void Plane::SignedDistances(Plane plane, const Vector3Array &points,
+                            double *distances)
+{
+    size_t count = Vector3Array::Size(points);
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect(points.X.data(), count);
+    DenormalGuard::Inspect(points.Y.data(), count);
+    DenormalGuard::Inspect(points.Z.data(), count);
+    const double *x = points.X.data();
+    const double *y = points.Y.data();
+    const double *z = points.Z.data();
+    Vector3 n = plane.Normal;
+    for (size_t i = 0; i < count; i++)
+        distances[i] = n.X * x[i] + n.Y * y[i] + n.Z * z[i] + plane.Offset;
+}
+
+void Plane::RaycastBlock(const double *t, const double *rates, size_t count,
+                         double maxDistance, bool *hits, double *distances)
+{
+    // A parallel ray divides by zero, so it is tested for explicitly in
+    // case maxDistance is infinite. The hit flags are built from selects,
+    // which vectorize where boolean logic does not.
+    double hit[BlockSize];
+    for (size_t i = 0; i < BlockSize; i++)
+    {
+        double h = t[i] <= maxDistance ? 1 : 0;
+        h = t[i] >= 0 ? h : 0;
+        hit[i] = rates[i] != 0 ? h : 0;
+    }
+
+    for (size_t i = 0; i < count; i++)
+        hits[i] = hit[i] != 0;
+    std::copy(t, t + count, distances);
+}
+
+
+bool operator==(const Plane lhs, const Plane rhs)
+{
+    return lhs.Normal == rhs.Normal && lhs.Offset == rhs.Offset;
+}
+
+bool operator!=(const Plane lhs, const Plane rhs)
+{
+    return !(lhs == rhs);
+}
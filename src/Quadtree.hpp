@@ -0,0 +1,616 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a linear (pointerless) quadtree over 2D points, for
+ *  range, radius and nearest neighbour queries.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "DenormalGuard.hpp"
+#include "Parallel.hpp"
+#include "SpaceFillingCurve.hpp"
+#include "Vector2.hpp"
+
+
+/**
+ * The points are quantized to a 2^32 by 2^32 grid over the square root cell
+ * and sorted by their Morton code, in which bit 2i is bit i of the X cell
+ * and bit 2i + 1 is bit i of the Y cell. The points of any quadtree node
+ * then form one contiguous range of the sorted arrays, so no nodes are
+ * stored: the queries find child ranges with a binary search on Codes and
+ * stop subdividing once a range holds LeafSize points or fewer. X, Y and
+ * Indices hold the positions and input indices of the points in code order.
+ */
+struct Quadtree
+{
+    Vector2 Origin;
+    double Size;
+    std::vector<uint64_t> Codes;
+    std::vector<double> X;
+    std::vector<double> Y;
+    std::vector<unsigned int> Indices;
+
+
+    /**
+     * Build parameters.
+     * LeafSize is the number of points at which queries stop subdividing.
+     * Ranges with at least ParallelGrain points (or queries) are processed
+     * on multiple threads.
+     */
+    static constexpr size_t LeafSize = 16;
+    static constexpr size_t ParallelGrain = 1 << 14;
+
+
+    /**
+     * Constructors.
+     */
+    inline Quadtree();
+
+
+    /**
+     * Bulk loads a quadtree from an array of points.
+     * @param points: The points.
+     * @param count: The number of points.
+     * @return: A new quadtree.
+     */
+    static inline Quadtree Build(const Vector2 *points, size_t count);
+
+    /**
+     * Restores a quadtree from a buffer written by Serialize.
+     * @param buffer: The buffer to read.
+     * @param size: The size of the buffer in bytes.
+     * @param tree: The output tree.
+     * @return: False if the buffer does not hold a valid quadtree.
+     */
+    static inline bool Deserialize(const unsigned char *buffer, size_t size,
+                                   Quadtree &tree);
+
+    /**
+     * Finds the k points closest to a query point. This keeps the results
+     * sorted as it goes, so it is intended for small values of k.
+     * @param tree: The tree to search.
+     * @param point: The query point.
+     * @param k: The number of neighbours to find.
+     * @param indices: The output point indices, closest first.
+     * @param distances: The output distances, closest first.
+     * @return: The number of neighbours found, which is less than k only if
+     * the tree holds fewer than k points.
+     */
+    static inline size_t Nearest(const Quadtree &tree, Vector2 point,
+                                 size_t k, size_t *indices,
+                                 double *distances);
+
+    /**
+     * Finds the k points closest to each of many query points, spread across
+     * threads. Missing neighbours have an index of SIZE_MAX and an infinite
+     * distance.
+     * @param tree: The tree to search.
+     * @param points: The query points.
+     * @param count: The number of query points.
+     * @param k: The number of neighbours to find.
+     * @param indices: The output point indices, k per query.
+     * @param distances: The output distances, k per query.
+     */
+    static inline void Nearest(const Quadtree &tree, const Vector2 *points,
+                               size_t count, size_t k, size_t *indices,
+                               double *distances);
+
+    /**
+     * Finds every point within a radius of a query point, in no particular
+     * order.
+     * @param tree: The tree to search.
+     * @param point: The query point.
+     * @param radius: The search radius.
+     * @param indices: The output list, which the indices are appended to.
+     */
+    static inline void Radius(const Quadtree &tree, Vector2 point,
+                              double radius, std::vector<size_t> &indices);
+
+    /**
+     * Finds every point within a radius of each of many query points,
+     * spread across threads. The results for query i are
+     * indices[offsets[i]] up to indices[offsets[i + 1]].
+     * @param tree: The tree to search.
+     * @param points: The query points.
+     * @param count: The number of query points.
+     * @param radius: The search radius.
+     * @param offsets: The output offsets, count + 1 of them.
+     * @param indices: The output point indices.
+     */
+    static inline void Radius(const Quadtree &tree, const Vector2 *points,
+                              size_t count, double radius,
+                              std::vector<size_t> &offsets,
+                              std::vector<size_t> &indices);
+
+    /**
+     * Finds every point inside a rectangle (including its edges), in no
+     * particular order.
+     * @param tree: The tree to search.
+     * @param min: The lower corner of the rectangle.
+     * @param max: The upper corner of the rectangle.
+     * @param indices: The output list, which the indices are appended to.
+     */
+    static inline void Range(const Quadtree &tree, Vector2 min, Vector2 max,
+                             std::vector<size_t> &indices);
+
+    /**
+     * Finds every point inside each of many rectangles, spread across
+     * threads. The results for rectangle i are indices[offsets[i]] up to
+     * indices[offsets[i + 1]].
+     * @param tree: The tree to search.
+     * @param mins: The lower corners of the rectangles.
+     * @param maxs: The upper corners of the rectangles.
+     * @param count: The number of rectangles.
+     * @param offsets: The output offsets, count + 1 of them.
+     * @param indices: The output point indices.
+     */
+    static inline void Range(const Quadtree &tree, const Vector2 *mins,
+                             const Vector2 *maxs, size_t count,
+                             std::vector<size_t> &offsets,
+                             std::vector<size_t> &indices);
+
+    /**
+     * Writes a quadtree to a flat buffer in native byte order, which
+     * Deserialize can restore with a few block copies.
+     * @param tree: The tree to write.
+     * @return: A new buffer.
+     */
+    static inline std::vector<unsigned char> Serialize(const Quadtree &tree);
+
+
+    /**
+     * Helpers used by the build and the queries. A node is described by its
+     * range [begin, end) of the sorted arrays, its level, the first code it
+     * covers and the grid cell of its lower corner at that level.
+     */
+    template <typename F>
+    static inline void Batch(size_t count, std::vector<size_t> &offsets,
+                             std::vector<size_t> &indices, F query);
+    static inline void CellBounds(const Quadtree &tree, int level,
+                                  uint64_t cellX, uint64_t cellY,
+                                  Vector2 &min, Vector2 &max);
+    static inline void Children(const Quadtree &tree, size_t begin,
+                                size_t end, int level, uint64_t code,
+                                size_t bounds[5]);
+    static inline bool IsLeaf(size_t begin, size_t end, int level);
+    static inline void NearestNode(const Quadtree &tree, size_t begin,
+                                   size_t end, int level, uint64_t code,
+                                   uint64_t cellX, uint64_t cellY,
+                                   Vector2 point, size_t k, size_t &found,
+                                   size_t *indices, double *distances);
+    static inline void RadiusNode(const Quadtree &tree, size_t begin,
+                                  size_t end, int level, uint64_t code,
+                                  uint64_t cellX, uint64_t cellY,
+                                  Vector2 point, double radius,
+                                  std::vector<size_t> &indices);
+    static inline void RangeNode(const Quadtree &tree, size_t begin,
+                                 size_t end, int level, uint64_t code,
+                                 uint64_t cellX, uint64_t cellY,
+                                 Vector2 min, Vector2 max,
+                                 std::vector<size_t> &indices);
+    static inline double SqrDistance(Vector2 point, Vector2 min,
+                                     Vector2 max);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+Quadtree::Quadtree() : Origin(0, 0), Size(1) {}
+
+
+Quadtree Quadtree::Build(const Vector2 *points, size_t count)
+{
+    Quadtree tree;
+    if (count == 0)
+        return tree;
+
+    // Bound the points with a square
+    Vector2 min = points[0];
+    Vector2 max = points[0];
+    for (size_t i = 1; i < count; i++)
+    {
+        min = Vector2::Min(min, points[i]);
+        max = Vector2::Max(max, points[i]);
+    }
+    tree.Origin = min;
+    tree.Size = fmax(max.X - min.X, max.Y - min.Y);
+    if (tree.Size <= 0)
+        tree.Size = 1;
+
+    // Quantize and encode the points, then sort them by code
+    tree.Codes.resize(count);
+    tree.Indices.resize(count);
+    double scale = 4294967296.0 / tree.Size;
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          double x = (points[i].X - tree.Origin.X) * scale;
+                          double y = (points[i].Y - tree.Origin.Y) * scale;
+                          tree.Codes[i] = SpaceFillingCurve::Morton(
+                              (uint32_t)fmin(x, 4294967295.0),
+                              (uint32_t)fmin(y, 4294967295.0));
+                          tree.Indices[i] = (unsigned int)i;
+                      }
+                  });
+    SpaceFillingCurve::Sort(tree.Codes.data(), tree.Indices.data(), count);
+
+    tree.X.resize(count);
+    tree.Y.resize(count);
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          tree.X[i] = points[tree.Indices[i]].X;
+                          tree.Y[i] = points[tree.Indices[i]].Y;
+                      }
+                  });
+    return tree;
+}
+
+bool Quadtree::Deserialize(const unsigned char *buffer, size_t size,
+                           Quadtree &tree)
+{
+    const size_t header = 2 * sizeof(uint32_t) + sizeof(uint64_t) +
+        3 * sizeof(double);
+    if (size < header)
+        return false;
+    uint32_t magic, version;
+    uint64_t count;
+    double values[3];
+    memcpy(&magic, buffer, sizeof(magic));
+    memcpy(&version, buffer + 4, sizeof(version));
+    memcpy(&count, buffer + 8, sizeof(count));
+    memcpy(values, buffer + 16, sizeof(values));
+    const size_t pointSize = sizeof(uint64_t) + 2 * sizeof(double) +
+        sizeof(unsigned int);
+    if (magic != 0x54514D47 || version != 1 ||
+        count > (size - header) / pointSize ||
+        size != header + count * pointSize)
+        return false;
+    tree.Origin = Vector2(values[0], values[1]);
+    tree.Size = values[2];
+    tree.Codes.resize(count);
+    tree.X.resize(count);
+    tree.Y.resize(count);
+    tree.Indices.resize(count);
+    const unsigned char *p = buffer + header;
+    memcpy(tree.Codes.data(), p, count * sizeof(uint64_t));
+    p += count * sizeof(uint64_t);
+    memcpy(tree.X.data(), p, count * sizeof(double));
+    p += count * sizeof(double);
+    memcpy(tree.Y.data(), p, count * sizeof(double));
+    p += count * sizeof(double);
+    memcpy(tree.Indices.data(), p, count * sizeof(unsigned int));
+    return true;
+}
+
+size_t Quadtree::Nearest(const Quadtree &tree, Vector2 point, size_t k,
+                         size_t *indices, double *distances)
+{
+    size_t found = 0;
+    if (tree.Codes.empty() || k == 0)
+        return 0;
+    NearestNode(tree, 0, tree.Codes.size(), 0, 0, 0, 0, point, k, found,
+                indices, distances);
+    for (size_t i = 0; i < found; i++)
+        distances[i] = sqrt(distances[i]);
+    return found;
+}
+
+void Quadtree::Nearest(const Quadtree &tree, const Vector2 *points,
+                       size_t count, size_t k, size_t *indices,
+                       double *distances)
+{
+    Parallel::For(count, ParallelGrain / 16,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+                      DenormalGuard::Inspect((const double *)(points + begin),
+                                             2 * (end - begin));
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          size_t found = Nearest(tree, points[i], k,
+                                                 indices + i * k,
+                                                 distances + i * k);
+                          for (size_t j = found; j < k; j++)
+                          {
+                              indices[i * k + j] = SIZE_MAX;
+                              distances[i * k + j] = INFINITY;
+                          }
+                      }
+                  });
+}
+
+void Quadtree::Radius(const Quadtree &tree, Vector2 point, double radius,
+                      std::vector<size_t> &indices)
+{
+    if (tree.Codes.empty() || radius < 0)
+        return;
+    RadiusNode(tree, 0, tree.Codes.size(), 0, 0, 0, 0, point, radius,
+               indices);
+}
+
+void Quadtree::Radius(const Quadtree &tree, const Vector2 *points,
+                      size_t count, double radius,
+                      std::vector<size_t> &offsets,
+                      std::vector<size_t> &indices)
+{
+    DenormalGuard::Inspect((const double *)points, 2 * count);
+    Batch(count, offsets, indices,
+          [&](size_t i, std::vector<size_t> &found)
+          {
+              Radius(tree, points[i], radius, found);
+          });
+}
+
+void Quadtree::Range(const Quadtree &tree, Vector2 min, Vector2 max,
+                     std::vector<size_t> &indices)
+{
+    if (tree.Codes.empty())
+        return;
+    RangeNode(tree, 0, tree.Codes.size(), 0, 0, 0, 0, min, max, indices);
+}
+
+void Quadtree::Range(const Quadtree &tree, const Vector2 *mins,
+                     const Vector2 *maxs, size_t count,
+                     std::vector<size_t> &offsets,
+                     std::vector<size_t> &indices)
+{
+    DenormalGuard::Inspect((const double *)mins, 2 * count);
+    DenormalGuard::Inspect((const double *)maxs, 2 * count);
+    Batch(count, offsets, indices,
+          [&](size_t i, std::vector<size_t> &found)
+          {
+              Range(tree, mins[i], maxs[i], found);
+          });
+}
+
+std::vector<unsigned char> Quadtree::Serialize(const Quadtree &tree)
+{
+    uint32_t magic = 0x54514D47;
+    uint32_t version = 1;
+    uint64_t count = tree.Codes.size();
+    double values[3] = { tree.Origin.X, tree.Origin.Y, tree.Size };
+    std::vector<unsigned char> buffer(16 + sizeof(values) + count *
+        (sizeof(uint64_t) + 2 * sizeof(double) + sizeof(unsigned int)));
+    unsigned char *p = buffer.data();
+    memcpy(p, &magic, sizeof(magic));
+    memcpy(p + 4, &version, sizeof(version));
+    memcpy(p + 8, &count, sizeof(count));
+    memcpy(p + 16, values, sizeof(values));
+    p += 16 + sizeof(values);
+    memcpy(p, tree.Codes.data(), count * sizeof(uint64_t));
+    p += count * sizeof(uint64_t);
+    memcpy(p, tree.X.data(), count * sizeof(double));
+    p += count * sizeof(double);
+    memcpy(p, tree.Y.data(), count * sizeof(double));
+    p += count * sizeof(double);
+    memcpy(p, tree.Indices.data(), count * sizeof(unsigned int));
+    return buffer;
+}
+
+
+template <typename F>
+void Quadtree::Batch(size_t count, std::vector<size_t> &offsets,
+                     std::vector<size_t> &indices, F query)
+{
+    size_t grain = ParallelGrain / 16;
+    size_t chunks = Parallel::Chunks(count, grain);
+    std::vector<std::vector<size_t> > chunkIndices(chunks);
+    std::vector<size_t> chunkBegin(chunks);
+    offsets.assign(count + 1, 0);
+    Parallel::For(count, grain,
+                  [&](size_t chunk, size_t begin, size_t end)
+                  {
+                      DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+                      chunkBegin[chunk] = begin;
+                      std::vector<size_t> &found = chunkIndices[chunk];
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          size_t before = found.size();
+                          query(i, found);
+                          offsets[i + 1] = found.size() - before;
+                      }
+                  });
+    for (size_t i = 0; i < count; i++)
+        offsets[i + 1] += offsets[i];
+    indices.resize(offsets[count]);
+    for (size_t c = 0; c < chunks; c++)
+        std::copy(chunkIndices[c].begin(), chunkIndices[c].end(),
+                  indices.begin() + offsets[chunkBegin[c]]);
+}
+
+void Quadtree::CellBounds(const Quadtree &tree, int level, uint64_t cellX,
+                          uint64_t cellY, Vector2 &min, Vector2 &max)
+{
+    // Padded slightly, so that rounding in the quantization can never
+    // leave a point outside of the bounds of its cell
+    double size = ldexp(tree.Size, -level);
+    double pad = tree.Size * 1e-12;
+    min = Vector2(tree.Origin.X + cellX * size - pad,
+                  tree.Origin.Y + cellY * size - pad);
+    max = Vector2(min.X + size + 2 * pad, min.Y + size + 2 * pad);
+}
+
+void Quadtree::Children(const Quadtree &tree, size_t begin, size_t end,
+                        int level, uint64_t code, size_t bounds[5])
+{
+    const uint64_t *codes = tree.Codes.data();
+    int shift = 62 - 2 * level;
+    bounds[0] = begin;
+    for (uint64_t q = 1; q < 4; q++)
+        bounds[q] = std::lower_bound(codes + bounds[q - 1], codes + end,
+                                     code + (q << shift)) - codes;
+    bounds[4] = end;
+}
+
+bool Quadtree::IsLeaf(size_t begin, size_t end, int level)
+{
+    return end - begin <= LeafSize || level == 32;
+}
+
+void Quadtree::NearestNode(const Quadtree &tree, size_t begin, size_t end,
+                           int level, uint64_t code, uint64_t cellX,
+                           uint64_t cellY, Vector2 point, size_t k,
+                           size_t &found, size_t *indices, double *distances)
+{
+    if (IsLeaf(begin, end, level))
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            double dx = tree.X[i] - point.X;
+            double dy = tree.Y[i] - point.Y;
+            double d = dx * dx + dy * dy;
+            if (found == k && d >= distances[k - 1])
+                continue;
+            // Insert into the sorted results, dropping the farthest if full
+            size_t slot = found < k ? found++ : k - 1;
+            while (slot > 0 && distances[slot - 1] > d)
+            {
+                distances[slot] = distances[slot - 1];
+                indices[slot] = indices[slot - 1];
+                slot--;
+            }
+            distances[slot] = d;
+            indices[slot] = tree.Indices[i];
+        }
+        return;
+    }
+    // Visit the children closest first
+    size_t bounds[5];
+    Children(tree, begin, end, level, code, bounds);
+    double childDistance[4];
+    int order[4] = { 0, 1, 2, 3 };
+    for (int q = 0; q < 4; q++)
+    {
+        Vector2 min, max;
+        CellBounds(tree, level + 1, 2 * cellX + (q & 1), 2 * cellY + (q >> 1),
+                   min, max);
+        childDistance[q] = SqrDistance(point, min, max);
+    }
+    std::sort(order, order + 4, [&](int a, int b)
+              {
+                  return childDistance[a] < childDistance[b];
+              });
+    for (int i = 0; i < 4; i++)
+    {
+        int q = order[i];
+        if (bounds[q] == bounds[q + 1] ||
+            (found == k && childDistance[q] >= distances[k - 1]))
+            continue;
+        NearestNode(tree, bounds[q], bounds[q + 1], level + 1,
+                    code + ((uint64_t)q << (62 - 2 * level)),
+                    2 * cellX + (q & 1), 2 * cellY + (q >> 1), point, k,
+                    found, indices, distances);
+    }
+}
+
+void Quadtree::RadiusNode(const Quadtree &tree, size_t begin, size_t end,
+                          int level, uint64_t code, uint64_t cellX,
+                          uint64_t cellY, Vector2 point, double radius,
+                          std::vector<size_t> &indices)
+{
+    Vector2 min, max;
+    CellBounds(tree, level, cellX, cellY, min, max);
+    double radiusSqr = radius * radius;
+    if (SqrDistance(point, min, max) > radiusSqr)
+        return;
+    if (IsLeaf(begin, end, level))
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            double dx = tree.X[i] - point.X;
+            double dy = tree.Y[i] - point.Y;
+            if (dx * dx + dy * dy <= radiusSqr)
+                indices.push_back(tree.Indices[i]);
+        }
+        return;
+    }
+    size_t bounds[5];
+    Children(tree, begin, end, level, code, bounds);
+    for (int q = 0; q < 4; q++)
+        if (bounds[q] < bounds[q + 1])
+            RadiusNode(tree, bounds[q], bounds[q + 1], level + 1,
+                       code + ((uint64_t)q << (62 - 2 * level)),
+                       2 * cellX + (q & 1), 2 * cellY + (q >> 1), point,
+                       radius, indices);
+}
+
+void Quadtree::RangeNode(const Quadtree &tree, size_t begin, size_t end,
+                         int level, uint64_t code, uint64_t cellX,
+                         uint64_t cellY, Vector2 min, Vector2 max,
+                         std::vector<size_t> &indices)
+{
+    Vector2 cellMin, cellMax;
+    CellBounds(tree, level, cellX, cellY, cellMin, cellMax);
+    if (cellMin.X > max.X || cellMax.X < min.X || cellMin.Y > max.Y ||
+        cellMax.Y < min.Y)
+        return;
+    bool inside = cellMin.X >= min.X && cellMax.X <= max.X &&
+        cellMin.Y >= min.Y && cellMax.Y <= max.Y;
+    if (inside)
+    {
+        for (size_t i = begin; i < end; i++)
+            indices.push_back(tree.Indices[i]);
+        return;
+    }
+    if (IsLeaf(begin, end, level))
+    {
+        for (size_t i = begin; i < end; i++)
+            if (tree.X[i] >= min.X && tree.X[i] <= max.X &&
+                tree.Y[i] >= min.Y && tree.Y[i] <= max.Y)
+                indices.push_back(tree.Indices[i]);
+        return;
+    }
+    size_t bounds[5];
+    Children(tree, begin, end, level, code, bounds);
+    for (int q = 0; q < 4; q++)
+        if (bounds[q] < bounds[q + 1])
+            RangeNode(tree, bounds[q], bounds[q + 1], level + 1,
+                      code + ((uint64_t)q << (62 - 2 * level)),
+                      2 * cellX + (q & 1), 2 * cellY + (q >> 1), min, max,
+                      indices);
+}
+
+double Quadtree::SqrDistance(Vector2 point, Vector2 min, Vector2 max)
+{
+    double dx = fmax(fmax(min.X - point.X, point.X - max.X), 0.0);
+    double dy = fmax(fmax(min.Y - point.Y, point.Y - max.Y), 0.0);
+    return dx * dx + dy * dy;
+}
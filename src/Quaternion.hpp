@@ -34,11 +34,79 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <stddef.h>
 #include <iostream>
 
 #define SMALL_DOUBLE 0.0000000001
 
 
+/**
+ * Attempt to include a header file if the file exists.
+ * If the file does not exist, create a dummy data structure for that type.
+ * If it cannot be determined if it exists, just attempt to include it.
+ */
+#ifdef __has_include
+#   if __has_include("FastMath.hpp")
+#       include "FastMath.hpp"
+#   elif !defined(GMATH_FASTMATH)
+        #define GMATH_FASTMATH
+        struct FastMath
+        {
+            static inline double Acos(double x)
+            {
+                return acos(fmin(fmax(x, -1.0), 1.0));
+            }
+
+            static inline double Asin(double x)
+            {
+                return asin(fmin(fmax(x, -1.0), 1.0));
+            }
+
+            static inline double Atan(double x) { return atan(x); }
+
+            static inline double Atan2(double y, double x)
+            {
+                return atan2(y, x);
+            }
+
+            static inline void SinCos(double angle, double &sine,
+                double &cosine)
+            {
+                sine = sin(angle);
+                cosine = cos(angle);
+            }
+        };
+#   endif
+#else
+#   include "FastMath.hpp"
+#endif
+
+
+/**
+ * Attempt to include a header file if the file exists.
+ * If the file does not exist, create a dummy data structure for that type.
+ * If it cannot be determined if it exists, just attempt to include it.
+ */
+#ifdef __has_include
+#   if __has_include("DenormalGuard.hpp")
+#       include "DenormalGuard.hpp"
+#   elif !defined(GMATH_DENORMALGUARD)
+        #define GMATH_DENORMALGUARD
+        #ifndef GMATH_FLUSH_DENORMALS
+        #define GMATH_FLUSH_DENORMALS 0
+        #endif
+        struct DenormalGuard
+        {
+            inline explicit DenormalGuard(bool) {}
+
+            static inline void Inspect(const double *, size_t) {}
+        };
+#   endif
+#else
+#   include "DenormalGuard.hpp"
+#endif
+
+
 /**
  * Attempt to include a header file if the file exists.
  * If the file does not exist, create a dummy data structure for that type.
@@ -118,6 +186,9 @@
 #endif
 
 
+struct UnitQuaternion;
+
+
 struct Quaternion
 {
     union
@@ -157,6 +228,17 @@ struct Quaternion
      */
     static inline double Angle(Quaternion a, Quaternion b);
 
+    /**
+     * Returns the angle between two quaternions, using a fast approximation
+     * of acos. The quaternions must be normalized.
+     * @param a: The first quaternion.
+     * @param b: The second quaternion.
+     * @param precision: Pass FastMath() to select this overload.
+     * @return: A scalar value.
+     */
+    static inline double Angle(Quaternion a, Quaternion b,
+        FastMath precision);
+
     /**
      * Returns the conjugate of a quaternion.
      * @param rotation: The quaternion in question.
@@ -172,6 +254,46 @@ struct Quaternion
      */
     static inline double Dot(Quaternion lhs, Quaternion rhs);
 
+    /**
+     * Approximates spherical linear interpolation between a and b, using a
+     * normalized lerp with a polynomial correction of t. The variable t is
+     * clamped to the range [0-1], and like Slerp, the rotation follows the
+     * shortest path. The quaternions must be normalized.
+     * Maximum error compared to SlerpUnclamped, by angle between a and b:
+     *     0 to 30 degrees:   6.2e-5 radians
+     *     30 to 60 degrees:  6.2e-5 radians
+     *     60 to 90 degrees:  6.0e-5 radians
+     *     90 to 120 degrees: 5.9e-5 radians
+     *     120 to 150 degrees: 5.7e-5 radians
+     *     150 to 180 degrees: 7.7e-5 radians
+     * @param a: The starting rotation.
+     * @param b: The ending rotation.
+     * @param t: The interpolation value.
+     * @return: A new quaternion.
+     */
+    static inline Quaternion FastSlerp(Quaternion a, Quaternion b, double t);
+
+    /**
+     * Approximates spherical linear interpolation for arrays of quaternions.
+     * Each result is FastSlerp(a[i], b[i], t[i]).
+     * @param a: The starting rotations.
+     * @param b: The ending rotations.
+     * @param t: The interpolation values.
+     * @param result: The output rotations.
+     * @param count: The number of rotations.
+     */
+    static inline void FastSlerp(const Quaternion *a, const Quaternion *b,
+        const double *t, Quaternion *result, size_t count);
+
+    /**
+     * Returns the interpolation value which makes a normalized lerp follow
+     * the same path as a slerp.
+     * @param t: The slerp interpolation value [0-1].
+     * @param d: The absolute dot product of the two rotations.
+     * @return: A scalar value.
+     */
+    static inline double FastSlerpFactor(double t, double d);
+
     /**
      * Creates a new quaternion from the angle-axis representation of
      * a rotation.
@@ -312,6 +434,17 @@ struct Quaternion
     static inline void ToAngleAxis(Quaternion rotation, double &angle,
         Vector3 &axis);
 
+    /**
+     * Outputs the angle axis representation of the provided quaternion, using
+     * a fast approximation of acos.
+     * @param rotation: The input quaternion.
+     * @param angle: The output angle.
+     * @param axis: The output axis.
+     * @param precision: Pass FastMath() to select this overload.
+     */
+    static inline void ToAngleAxis(Quaternion rotation, double &angle,
+        Vector3 &axis, FastMath precision);
+
     /**
      * Returns the Euler angle representation of a rotation. The resulting
      * vector contains the rotations about the z, x and y axis, in that order.
@@ -320,6 +453,16 @@ struct Quaternion
      */
     static inline Vector3 ToEuler(Quaternion rotation);
 
+    /**
+     * Returns the Euler angle representation of a rotation, using fast
+     * approximations of asin and atan2. The resulting vector contains the
+     * rotations about the z, x and y axis, in that order.
+     * @param rotation: The quaternion to convert.
+     * @param precision: Pass FastMath() to select this overload.
+     * @return: A new vector.
+     */
+    static inline Vector3 ToEuler(Quaternion rotation, FastMath precision);
+
     /**
      * Operator overloading.
      */
@@ -330,6 +473,15 @@ struct Quaternion
     inline struct Quaternion& operator+=(const Quaternion rhs);
     inline struct Quaternion& operator-=(const Quaternion rhs);
     inline struct Quaternion& operator*=(const Quaternion rhs);
+
+    /**
+     * Helpers for the implementation.
+     * Both ToEuler overloads share this body, taking asin and atan2 from
+     * Trig, which is either Math (the standard library) or FastMath.
+     */
+    struct Math;
+    template <typename Trig>
+    static inline Vector3 ToEuler(Quaternion rotation);
 };
 
 inline Quaternion operator-(Quaternion rhs);
@@ -349,6 +501,115 @@ inline bool operator==(const Quaternion lhs, const Quaternion rhs);
 inline bool operator!=(const Quaternion lhs, const Quaternion rhs);
 
 
+/**
+ * A quaternion which is known to have a norm of one. These are returned by
+ * the UnitQuaternion factory functions, such as Normalized, and skip
+ * the normalization work which a general quaternion needs. The components
+ * are read only, and only operations which keep the norm at one return a
+ * UnitQuaternion; anything else converts to a plain Quaternion first.
+ */
+struct UnitQuaternion
+{
+    /**
+     * Constructors.
+     * The quaternion passed in must already have a norm of one.
+     */
+    inline UnitQuaternion();
+    inline explicit UnitQuaternion(Quaternion unit);
+
+
+    /**
+     * Read access to the components, and conversion to a general quaternion.
+     */
+    inline double X() const;
+    inline double Y() const;
+    inline double Z() const;
+    inline double W() const;
+    inline operator const Quaternion&() const;
+
+
+    /**
+     * Constants for common unit quaternions.
+     */
+    static inline UnitQuaternion Identity();
+
+
+    /**
+     * Returns the inverse of a rotation, which for a unit quaternion is its
+     * conjugate.
+     * @param rotation: The quaternion in question.
+     * @return: A new unit quaternion.
+     */
+    static inline UnitQuaternion Inverse(UnitQuaternion rotation);
+
+    /**
+     * Creates a new unit quaternion from the angle-axis representation of
+     * a rotation.
+     * @param angle: The rotation angle in radians.
+     * @param axis: The vector about which the rotation occurs.
+     * @return: A new unit quaternion.
+     */
+    static inline UnitQuaternion FromAngleAxis(double angle, Vector3 axis);
+
+    /**
+     * Create a new unit quaternion from the euler angle representation of
+     * a rotation. The z, x and y values represent rotations about those
+     * axis in that respective order.
+     * @param rotation: The x, y and z rotations.
+     * @return: A new unit quaternion.
+     */
+    static inline UnitQuaternion FromEuler(Vector3 rotation);
+
+    /**
+     * Returns a unit quaternion with the same rotation as a general one.
+     * @param rotation: The quaternion in question, which must not be zero.
+     * @return: A new unit quaternion.
+     */
+    static inline UnitQuaternion Normalized(Quaternion rotation);
+
+    /**
+     * Returns the rotation renormalized if rounding error has let its norm
+     * drift away from one, and unchanged otherwise.
+     * @param rotation: The quaternion in question.
+     * @return: A new unit quaternion.
+     */
+    static inline UnitQuaternion Renormalized(UnitQuaternion rotation);
+
+    /**
+     * Returns a new unit quaternion interpolated between a and b, using
+     * spherical linear interpolation. The variable t is clamped to the range
+     * [0-1]. No renormalization is needed.
+     * @param a: The starting rotation.
+     * @param b: The ending rotation.
+     * @param t: The interpolation value.
+     * @return: A new unit quaternion.
+     */
+    static inline UnitQuaternion Slerp(UnitQuaternion a, UnitQuaternion b,
+        double t);
+
+    /**
+     * Returns a new unit quaternion interpolated between a and b, using
+     * spherical linear interpolation. No renormalization is needed.
+     * @param a: The starting rotation.
+     * @param b: The ending rotation.
+     * @param t: The interpolation value.
+     * @return: A new unit quaternion.
+     */
+    static inline UnitQuaternion SlerpUnclamped(UnitQuaternion a,
+        UnitQuaternion b, double t);
+
+private:
+    Quaternion Unit;
+};
+
+/**
+ * The product of two unit quaternions. Rounding lets the norm drift slowly
+ * over long chains of products, which Renormalized corrects. Debug builds
+ * check every product for drift and renormalize it when found.
+ */
+inline UnitQuaternion operator*(UnitQuaternion lhs, const UnitQuaternion rhs);
+
+
 
 /*******************************************************************************
  * Implementation
@@ -372,6 +633,12 @@ double Quaternion::Angle(Quaternion a, Quaternion b)
     return acos(fmin(fabs(dot), 1)) * 2;
 }
 
+double Quaternion::Angle(Quaternion a, Quaternion b, FastMath)
+{
+    double dot = Dot(a, b);
+    return FastMath::Acos(fabs(dot)) * 2;
+}
+
 Quaternion Quaternion::Conjugate(Quaternion rotation)
 {
     return Quaternion(-rotation.X, -rotation.Y, -rotation.Z, rotation.W);
@@ -382,15 +649,55 @@ double Quaternion::Dot(Quaternion lhs, Quaternion rhs)
     return lhs.X * rhs.X + lhs.Y * rhs.Y + lhs.Z * rhs.Z + lhs.W * rhs.W;
 }
 
+Quaternion Quaternion::FastSlerp(Quaternion a, Quaternion b, double t)
+{
+    t = fmin(fmax(t, 0.0), 1.0);
+    double dot = Dot(a, b);
+    double u = FastSlerpFactor(t, fabs(dot));
+    double n2 = 1 - u;
+    double n1 = dot < 0 ? -u : u;
+    Quaternion quaternion;
+    quaternion.X = (n2 * a.X) + (n1 * b.X);
+    quaternion.Y = (n2 * a.Y) + (n1 * b.Y);
+    quaternion.Z = (n2 * a.Z) + (n1 * b.Z);
+    quaternion.W = (n2 * a.W) + (n1 * b.W);
+    return Normalized(quaternion);
+}
+
+void Quaternion::FastSlerp(const Quaternion *a, const Quaternion *b,
+    const double *t, Quaternion *result, size_t count)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect(&a[0].X, count * 4);
+    DenormalGuard::Inspect(&b[0].X, count * 4);
+    for (size_t i = 0; i < count; i++)
+        result[i] = FastSlerp(a[i], b[i], t[i]);
+}
+
+double Quaternion::FastSlerpFactor(double t, double d)
+{
+    // Least squares fit of the exact factor sin(t*w)/(sin(t*w)+sin((1-t)*w))
+    double c0 = 0.8596484428 + d * (-1.144823916 + d * (0.4031990563 -
+        d * 0.1218047366));
+    double c1 = 0.8034824263 + d * (-1.891076256 + d * (1.266791569 -
+        d * 0.1555512269));
+    double c2 = 1.244238992 + d * (-5.291879243 + d * (8.183779293 -
+        d * 4.334351263));
+    double h = (t - 0.5) * (t - 0.5);
+    return t + t * (t - 0.5) * (t - 1) * (c0 + h * (c1 + h * c2));
+}
+
 Quaternion Quaternion::FromAngleAxis(double angle, Vector3 axis)
 {
     Quaternion q;
+    double sine, cosine;
+    FastMath::SinCos(angle / 2, sine, cosine);
     double m = sqrt(axis.X * axis.X + axis.Y * axis.Y + axis.Z * axis.Z);
-    double s = sin(angle / 2) / m;
+    double s = sine / m;
     q.X = axis.X * s;
     q.Y = axis.Y * s;
     q.Z = axis.Z * s;
-    q.W = cos(angle / 2);
+    q.W = cosine;
     return q;
 }
 
@@ -401,12 +708,10 @@ Quaternion Quaternion::FromEuler(Vector3 rotation)
 
 Quaternion Quaternion::FromEuler(double x, double y, double z)
 {
-    double cx = cos(x * 0.5);
-	double cy = cos(y * 0.5);
-	double cz = cos(z * 0.5);
-	double sx = sin(x * 0.5);
-	double sy = sin(y * 0.5);
-	double sz = sin(z * 0.5);
+    double cx, cy, cz, sx, sy, sz;
+    FastMath::SinCos(x * 0.5, sx, cx);
+    FastMath::SinCos(y * 0.5, sy, cy);
+    FastMath::SinCos(z * 0.5, sz, cz);
     Quaternion q;
 	q.X = cx * sy * sz + cy * cz * sx;
 	q.Y = cx * cz * sy - cy * sx * sz;
@@ -588,41 +893,32 @@ void Quaternion::ToAngleAxis(Quaternion rotation, double &angle, Vector3 &axis)
     }
 }
 
-Vector3 Quaternion::ToEuler(Quaternion rotation)
+void Quaternion::ToAngleAxis(Quaternion rotation, double &angle, Vector3 &axis,
+    FastMath)
 {
-    double sqw = rotation.W * rotation.W;
-    double sqx = rotation.X * rotation.X;
-    double sqy = rotation.Y * rotation.Y;
-    double sqz = rotation.Z * rotation.Z;
-    // If normalized is one, otherwise is correction factor
-    double unit = sqx + sqy + sqz + sqw;
-    double test = rotation.X * rotation.W - rotation.Y * rotation.Z;
-    Vector3 v;
-    // Singularity at north pole
-    if (test > 0.4995f * unit)
-    {
-        v.Y = 2 * atan2(rotation.Y, rotation.X);
-        v.X = M_PI_2;
-        v.Z = 0;
-        return v;
-    }
-    // Singularity at south pole
-    if (test < -0.4995f * unit)
-    {
-        v.Y = -2 * atan2(rotation.Y, rotation.X);
-        v.X = -M_PI_2;
-        v.Z = 0;
-        return v;
+    if (rotation.W > 1)
+        rotation = Normalized(rotation);
+    angle = 2 * FastMath::Acos(rotation.W);
+    double s = sqrt(1 - rotation.W * rotation.W);
+    if (s < 0.00001) {
+        axis.X = 1;
+        axis.Y = 0;
+        axis.Z = 0;
+    } else {
+        axis.X = rotation.X / s;
+        axis.Y = rotation.Y / s;
+        axis.Z = rotation.Z / s;
     }
-    // Yaw
-    v.Y = atan2(2 * rotation.W * rotation.Y + 2 * rotation.Z * rotation.X,
-        1 - 2 * (rotation.X * rotation.X + rotation.Y * rotation.Y));
-    // Pitch
-    v.X = asin(2 * (rotation.W * rotation.X - rotation.Y * rotation.Z));
-    // Roll
-    v.Z = atan2(2 * rotation.W * rotation.Z + 2 * rotation.X * rotation.Y,
-        1 - 2 * (rotation.Z * rotation.Z + rotation.X * rotation.X));
-    return v;
+}
+
+Vector3 Quaternion::ToEuler(Quaternion rotation)
+{
+    return ToEuler<Math>(rotation);
+}
+
+Vector3 Quaternion::ToEuler(Quaternion rotation, FastMath)
+{
+    return ToEuler<FastMath>(rotation);
 }
 
 struct Quaternion& Quaternion::operator+=(const double rhs)
@@ -690,6 +986,53 @@ struct Quaternion& Quaternion::operator*=(const Quaternion rhs)
     return *this;
 }
 
+struct Quaternion::Math
+{
+    static inline double Asin(double x) { return asin(x); }
+    static inline double Atan2(double y, double x) { return atan2(y, x); }
+};
+
+template <typename Trig>
+Vector3 Quaternion::ToEuler(Quaternion rotation)
+{
+    double sqw = rotation.W * rotation.W;
+    double sqx = rotation.X * rotation.X;
+    double sqy = rotation.Y * rotation.Y;
+    double sqz = rotation.Z * rotation.Z;
+    // If normalized is one, otherwise is correction factor
+    double unit = sqx + sqy + sqz + sqw;
+    double test = rotation.X * rotation.W - rotation.Y * rotation.Z;
+    Vector3 v;
+    // Singularity at north pole
+    if (test > 0.4995f * unit)
+    {
+        v.Y = 2 * Trig::Atan2(rotation.Y, rotation.X);
+        v.X = M_PI_2;
+        v.Z = 0;
+        return v;
+    }
+    // Singularity at south pole
+    if (test < -0.4995f * unit)
+    {
+        v.Y = -2 * Trig::Atan2(rotation.Y, rotation.X);
+        v.X = -M_PI_2;
+        v.Z = 0;
+        return v;
+    }
+    // Yaw
+    v.Y = Trig::Atan2(2 * rotation.W * rotation.Y +
+        2 * rotation.Z * rotation.X,
+        1 - 2 * (rotation.X * rotation.X + rotation.Y * rotation.Y));
+    // Pitch
+    v.X = Trig::Asin(2 * (rotation.W * rotation.X -
+        rotation.Y * rotation.Z));
+    // Roll
+    v.Z = Trig::Atan2(2 * rotation.W * rotation.Z +
+        2 * rotation.X * rotation.Y,
+        1 - 2 * (rotation.Z * rotation.Z + rotation.X * rotation.X));
+    return v;
+}
+
 Quaternion operator-(Quaternion rhs) { return rhs * -1; }
 Quaternion operator+(Quaternion lhs, const double rhs) { return lhs += rhs; }
 Quaternion operator-(Quaternion lhs, const double rhs) { return lhs -= rhs; }
@@ -733,3 +1076,95 @@ bool operator!=(const Quaternion lhs, const Quaternion rhs)
 {
     return !(lhs == rhs);
 }
+
+
+UnitQuaternion::UnitQuaternion() : Unit(0, 0, 0, 1) {}
+UnitQuaternion::UnitQuaternion(Quaternion unit) : Unit(unit) {}
+
+
+double UnitQuaternion::X() const { return Unit.X; }
+double UnitQuaternion::Y() const { return Unit.Y; }
+double UnitQuaternion::Z() const { return Unit.Z; }
+double UnitQuaternion::W() const { return Unit.W; }
+UnitQuaternion::operator const Quaternion&() const { return Unit; }
+
+
+UnitQuaternion UnitQuaternion::Identity() { return UnitQuaternion(); }
+
+
+UnitQuaternion UnitQuaternion::Inverse(UnitQuaternion rotation)
+{
+    return UnitQuaternion(Quaternion::Conjugate(rotation));
+}
+
+UnitQuaternion UnitQuaternion::FromAngleAxis(double angle, Vector3 axis)
+{
+    return UnitQuaternion(Quaternion::FromAngleAxis(angle, axis));
+}
+
+UnitQuaternion UnitQuaternion::FromEuler(Vector3 rotation)
+{
+    return UnitQuaternion(Quaternion::FromEuler(rotation));
+}
+
+UnitQuaternion UnitQuaternion::Normalized(Quaternion rotation)
+{
+    return UnitQuaternion(Quaternion::Normalized(rotation));
+}
+
+UnitQuaternion UnitQuaternion::Renormalized(UnitQuaternion rotation)
+{
+    double sqrNorm = Quaternion::Dot(rotation, rotation);
+    if (fabs(sqrNorm - 1) > SMALL_DOUBLE)
+        return UnitQuaternion(rotation.Unit / sqrt(sqrNorm));
+    return rotation;
+}
+
+UnitQuaternion UnitQuaternion::Slerp(UnitQuaternion a, UnitQuaternion b,
+    double t)
+{
+    if (t < 0) return a;
+    else if (t > 1) return b;
+    return SlerpUnclamped(a, b, t);
+}
+
+UnitQuaternion UnitQuaternion::SlerpUnclamped(UnitQuaternion a,
+    UnitQuaternion b, double t)
+{
+    double n1;
+    double n2;
+    double n3 = Quaternion::Dot(a, b);
+    bool flag = false;
+    if (n3 < 0)
+    {
+        flag = true;
+        n3 = -n3;
+    }
+    if (n3 > 0.999999)
+    {
+        // Too close for the spherical weights, fall back to a lerp
+        n2 = 1 - t;
+        n1 = flag ? -t : t;
+        return Normalized(a.Unit * n2 + b.Unit * n1);
+    }
+    double n4 = acos(n3);
+    double n5 = 1 / sin(n4);
+    n2 = sin((1 - t) * n4) * n5;
+    n1 = flag ? -sin(t * n4) * n5 : sin(t * n4) * n5;
+    Quaternion quaternion;
+    quaternion.X = (n2 * a.Unit.X) + (n1 * b.Unit.X);
+    quaternion.Y = (n2 * a.Unit.Y) + (n1 * b.Unit.Y);
+    quaternion.Z = (n2 * a.Unit.Z) + (n1 * b.Unit.Z);
+    quaternion.W = (n2 * a.Unit.W) + (n1 * b.Unit.W);
+    return UnitQuaternion(quaternion);
+}
+
+
+UnitQuaternion operator*(UnitQuaternion lhs, const UnitQuaternion rhs)
+{
+    UnitQuaternion product((const Quaternion&)lhs * (const Quaternion&)rhs);
+#ifndef NDEBUG
+    product = UnitQuaternion::Renormalized(product);
+#endif
+    return product;
+}
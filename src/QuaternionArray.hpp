@@ -0,0 +1,167 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a structure of arrays container for quaternions,
+ *  which keeps each component in its own contiguous array for batch kernels.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+#include "Quaternion.hpp"
+
+
+struct QuaternionArray
+{
+    std::vector<double> X;
+    std::vector<double> Y;
+    std::vector<double> Z;
+    std::vector<double> W;
+
+
+    /**
+     * Constructors.
+     */
+    inline QuaternionArray();
+    inline explicit QuaternionArray(size_t count);
+    inline QuaternionArray(const Quaternion *quaternions, size_t count);
+
+
+    /**
+     * Returns the quaternion stored at an index.
+     * @param array: The array to read from.
+     * @param index: The index of the quaternion.
+     * @return: A new quaternion.
+     */
+    static inline Quaternion Get(const QuaternionArray &array, size_t index);
+
+    /**
+     * Appends a quaternion to the end of an array.
+     * @param array: The array to append to.
+     * @param value: The quaternion to append.
+     */
+    static inline void PushBack(QuaternionArray &array, Quaternion value);
+
+    /**
+     * Changes the number of quaternions in an array. New quaternions are the
+     * identity.
+     * @param array: The array to resize.
+     * @param count: The new number of quaternions.
+     */
+    static inline void Resize(QuaternionArray &array, size_t count);
+
+    /**
+     * Stores a quaternion at an index.
+     * @param array: The array to write to.
+     * @param index: The index of the quaternion.
+     * @param value: The quaternion to store.
+     */
+    static inline void Set(QuaternionArray &array, size_t index,
+                           Quaternion value);
+
+    /**
+     * Returns the number of quaternions in an array.
+     * @param array: The array in question.
+     * @return: A count.
+     */
+    static inline size_t Size(const QuaternionArray &array);
+
+    /**
+     * Copies every quaternion in an array out to an array of Quaternion.
+     * @param array: The array to copy from.
+     * @param quaternions: The output quaternions, which must hold
+     * Size(array).
+     */
+    static inline void ToQuaternions(const QuaternionArray &array,
+                                     Quaternion *quaternions);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+QuaternionArray::QuaternionArray() {}
+QuaternionArray::QuaternionArray(size_t count) : X(count), Y(count),
+    Z(count), W(count, 1.0) {}
+QuaternionArray::QuaternionArray(const Quaternion *quaternions, size_t count) :
+    X(count), Y(count), Z(count), W(count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        X[i] = quaternions[i].X;
+        Y[i] = quaternions[i].Y;
+        Z[i] = quaternions[i].Z;
+        W[i] = quaternions[i].W;
+    }
+}
+
+
+Quaternion QuaternionArray::Get(const QuaternionArray &array, size_t index)
+{
+    return Quaternion(array.X[index], array.Y[index], array.Z[index],
+                      array.W[index]);
+}
+
+void QuaternionArray::PushBack(QuaternionArray &array, Quaternion value)
+{
+    array.X.push_back(value.X);
+    array.Y.push_back(value.Y);
+    array.Z.push_back(value.Z);
+    array.W.push_back(value.W);
+}
+
+void QuaternionArray::Resize(QuaternionArray &array, size_t count)
+{
+    array.X.resize(count);
+    array.Y.resize(count);
+    array.Z.resize(count);
+    array.W.resize(count, 1.0);
+}
+
+void QuaternionArray::Set(QuaternionArray &array, size_t index,
+                          Quaternion value)
+{
+    array.X[index] = value.X;
+    array.Y[index] = value.Y;
+    array.Z[index] = value.Z;
+    array.W[index] = value.W;
+}
+
+size_t QuaternionArray::Size(const QuaternionArray &array)
+{
+    return array.X.size();
+}
+
+void QuaternionArray::ToQuaternions(const QuaternionArray &array,
+                                    Quaternion *quaternions)
+{
+    for (size_t i = 0; i < array.X.size(); i++)
+        quaternions[i] = Quaternion(array.X[i], array.Y[i], array.Z[i],
+                                    array.W[i]);
+}
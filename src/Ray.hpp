@@ -0,0 +1,120 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a ray, a half-line used for picking and for
+ *  sweeping points through a scene.
+ */
+
+#pragma once
+
+#include <math.h>
+#include "Vector3.hpp"
+
+
+struct Ray
+{
+    /**
+     * Points along the ray are Origin + Direction * t for t >= 0. The
+     * direction need not be normalized, in which case distances along the
+     * ray are measured in multiples of its length.
+     */
+    Vector3 Origin;
+    Vector3 Direction;
+
+
+    /**
+     * Constructors.
+     */
+    inline Ray();
+    inline Ray(Vector3 origin, Vector3 direction);
+
+
+    /**
+     * Returns the point on a ray closest to another point.
+     * @param ray: The ray in question.
+     * @param point: The point in question.
+     * @return: A new point.
+     */
+    static inline Vector3 ClosestPoint(Ray ray, Vector3 point);
+
+    /**
+     * Returns the distance from a point to the closest point on a ray.
+     * @param ray: The ray in question.
+     * @param point: The point in question.
+     * @return: A scalar value.
+     */
+    static inline double Distance(Ray ray, Vector3 point);
+
+    /**
+     * Returns the point at a given distance along a ray.
+     * @param ray: The ray in question.
+     * @param distance: The ray parameter.
+     * @return: A new point.
+     */
+    static inline Vector3 GetPoint(Ray ray, double distance);
+};
+
+inline bool operator==(const Ray lhs, const Ray rhs);
+inline bool operator!=(const Ray lhs, const Ray rhs);
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+Ray::Ray() : Origin(0, 0, 0), Direction(0, 0, 1) {}
+Ray::Ray(Vector3 origin, Vector3 direction) : Origin(origin),
+    Direction(direction) {}
+
+
+Vector3 Ray::ClosestPoint(Ray ray, Vector3 point)
+{
+    double t = Vector3::Dot(point - ray.Origin, ray.Direction) /
+        Vector3::SqrMagnitude(ray.Direction);
+    return GetPoint(ray, t > 0 ? t : 0);
+}
+
+double Ray::Distance(Ray ray, Vector3 point)
+{
+    return Vector3::Distance(ClosestPoint(ray, point), point);
+}
+
+Vector3 Ray::GetPoint(Ray ray, double distance)
+{
+    return ray.Origin + ray.Direction * distance;
+}
+
+
+bool operator==(const Ray lhs, const Ray rhs)
+{
+    return lhs.Origin == rhs.Origin && lhs.Direction == rhs.Direction;
+}
+
+bool operator!=(const Ray lhs, const Ray rhs)
+{
+    return !(lhs == rhs);
+}
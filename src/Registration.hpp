@@ -0,0 +1,601 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements rigid registration of point sets: the Horn and
+ *  Kabsch solvers for paired points, and iterative closest point (ICP) on
+ *  top of them for unpaired scans.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <chrono>
+#include <vector>
+#include "DenormalGuard.hpp"
+#include "Matrix3x3.hpp"
+#include "Parallel.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+
+
+/**
+ * The cost of one ICP iteration, split by stage so that the number of
+ * points, the index and the rejection distance can be tuned.
+ */
+struct ICPIteration
+{
+    // The root mean square distance between the pairs that were kept
+    double Error;
+
+    // The number of pairs within the rejection distance
+    size_t Pairs;
+
+    // The seconds spent moving the source and finding and rejecting pairs
+    double MatchSeconds;
+
+    // The seconds spent accumulating the cross-covariance of the pairs
+    double AccumulateSeconds;
+
+    // The seconds spent solving for and applying the new rotation
+    double SolveSeconds;
+};
+
+
+/**
+ * A rigid motion which maps a point p to Rotation * p + Translation.
+ */
+struct Registration
+{
+    Quaternion Rotation;
+    Vector3 Translation;
+
+
+    // The number of accumulators CrossCovariance keeps for each sum
+    static constexpr size_t Lanes = 4;
+
+    // The number of Jacobi sweeps HornRotation runs over its 4x4 matrix
+    static constexpr int HornSweeps = 8;
+
+    // Batch kernels process at least this many points per thread
+    static constexpr size_t ParallelGrain = 1 << 15;
+
+
+    /**
+     * Constructors.
+     */
+    inline Registration();
+    inline Registration(Quaternion rotation, Vector3 translation);
+
+
+    /**
+     * Returns a point moved by a registration.
+     * @param registration: The registration to apply.
+     * @param point: The point to move.
+     * @return: A new point.
+     */
+    static inline Vector3 Apply(Registration registration, Vector3 point);
+
+    /**
+     * Moves an array of points by a registration, spread across threads.
+     * The input and output may be the same array.
+     * @param registration: The registration to apply.
+     * @param points: The points to move.
+     * @param count: The number of points.
+     * @param output: The moved points.
+     */
+    static inline void Apply(Registration registration, const Vector3 *points,
+                             size_t count, Vector3 *output);
+
+    /**
+     * Returns the registration which applies a and then b.
+     * @param a: The first registration.
+     * @param b: The second registration.
+     * @return: A new registration.
+     */
+    static inline Registration Compose(Registration a, Registration b);
+
+    /**
+     * Accumulates the weighted centroids of paired source and target points
+     * and their cross-covariance H = sum w (p - p0)(q - q0)^T in one pass,
+     * spread across threads. The sums are taken relative to the first pair
+     * so that point sets far from the origin keep their precision.
+     * @param source: The source points.
+     * @param target: The target point paired with each source point.
+     * @param weights: The weight of each pair, or nullptr to weigh every pair
+     * equally. Weights must not be negative.
+     * @param count: The number of pairs.
+     * @param covariance: Set to the cross-covariance, with source
+     * coordinates along the rows.
+     * @param sourceCentroid: Set to the weighted source centroid p0.
+     * @param targetCentroid: Set to the weighted target centroid q0.
+     * @return: The total weight. If it is zero, the outputs are zero.
+     */
+    static inline double CrossCovariance(const Vector3 *source,
+                                         const Vector3 *target,
+                                         const double *weights, size_t count,
+                                         Matrix3x3 &covariance,
+                                         Vector3 &sourceCentroid,
+                                         Vector3 &targetCentroid);
+
+    /**
+     * Returns the rigid motion which best maps source points onto their
+     * paired targets in the least squares sense, using Horn's method.
+     * @param source: The source points.
+     * @param target: The target point paired with each source point.
+     * @param weights: The weight of each pair, or nullptr.
+     * @param count: The number of pairs.
+     * @return: A new registration.
+     */
+    static inline Registration Horn(const Vector3 *source,
+                                    const Vector3 *target,
+                                    const double *weights, size_t count);
+
+    /**
+     * Returns the rotation which best maps the source onto the target given
+     * their cross-covariance, found as the eigenvector of the largest
+     * eigenvalue of Horn's symmetric 4x4 matrix.
+     * @param covariance: The cross-covariance from CrossCovariance.
+     * @return: A unit quaternion.
+     */
+    static inline Quaternion HornRotation(Matrix3x3 covariance);
+
+    /**
+     * Aligns a source scan with a target scan by iterative closest point.
+     * Each iteration pairs every moved source point with its nearest target,
+     * drops pairs further apart than maxDistance and solves for a better
+     * motion with Horn's method. It stops once the error changes by no more
+     * than tolerance or no pairs are left.
+     * The index is any type with a static member
+     * Nearest(index, points, count, k, indices, distances) which finds the k
+     * nearest neighbours of many points at once, such as KDTree.
+     * @param index: The nearest neighbour index built over the targets.
+     * @param targets: The target points the index was built over.
+     * @param source: The source points.
+     * @param count: The number of source points.
+     * @param initial: The initial estimate of the motion.
+     * @param maxIterations: The most iterations to run.
+     * @param maxDistance: The largest distance at which a pair is kept.
+     * @param tolerance: The smallest change in error which continues.
+     * @param iterations: If not nullptr, the error and timing of every
+     * iteration are appended to it.
+     * @return: The registration which maps the source onto the targets.
+     */
+    template <typename Index>
+    static inline Registration ICP(const Index &index, const Vector3 *targets,
+                                   const Vector3 *source, size_t count,
+                                   Registration initial, int maxIterations,
+                                   double maxDistance, double tolerance,
+                                   std::vector<ICPIteration> *iterations =
+                                       nullptr);
+
+    /**
+     * Returns the inverse of a registration.
+     * @param registration: The registration in question.
+     * @return: A new registration.
+     */
+    static inline Registration Inverse(Registration registration);
+
+    /**
+     * Returns the rigid motion which best maps source points onto their
+     * paired targets in the least squares sense, using the Kabsch method.
+     * @param source: The source points.
+     * @param target: The target point paired with each source point.
+     * @param weights: The weight of each pair, or nullptr.
+     * @param count: The number of pairs.
+     * @return: A new registration.
+     */
+    static inline Registration Kabsch(const Vector3 *source,
+                                      const Vector3 *target,
+                                      const double *weights, size_t count);
+
+    /**
+     * Returns the rotation which best maps the source onto the target given
+     * their cross-covariance, found as the rotation factor of the polar
+     * decomposition of H^T. It is a proper rotation even when the points are
+     * coplanar or the best orthogonal fit is a reflection.
+     * @param covariance: The cross-covariance from CrossCovariance.
+     * @return: A unit quaternion.
+     */
+    static inline Quaternion KabschRotation(Matrix3x3 covariance);
+
+
+    /**
+     * Helpers for the implementation.
+     */
+    template <bool Weighted>
+    static inline void AccumulateRange(const Vector3 *source,
+                                       const Vector3 *target,
+                                       const double *weights, size_t begin,
+                                       size_t end, Vector3 p0, Vector3 q0,
+                                       double sums[16]);
+    static inline double Elapsed(
+        std::chrono::steady_clock::time_point &start);
+    static inline Registration FromCentroids(Quaternion rotation,
+                                              Vector3 sourceCentroid,
+                                              Vector3 targetCentroid);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+Registration::Registration() : Rotation(0, 0, 0, 1), Translation(0, 0, 0) {}
+Registration::Registration(Quaternion rotation, Vector3 translation)
+    : Rotation(rotation), Translation(translation) {}
+
+
+Vector3 Registration::Apply(Registration registration, Vector3 point)
+{
+    return registration.Rotation * point + registration.Translation;
+}
+
+void Registration::Apply(Registration registration, const Vector3 *points,
+                         size_t count, Vector3 *output)
+{
+    Matrix3x3 m = Matrix3x3::FromQuaternion(registration.Rotation);
+    Vector3 t = registration.Translation;
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+                      DenormalGuard::Inspect((const double *)(points + begin),
+                                             3 * (end - begin));
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          Vector3 p = points[i];
+                          output[i] = Vector3(
+                              m.D00 * p.X + m.D01 * p.Y + m.D02 * p.Z + t.X,
+                              m.D10 * p.X + m.D11 * p.Y + m.D12 * p.Z + t.Y,
+                              m.D20 * p.X + m.D21 * p.Y + m.D22 * p.Z + t.Z);
+                      }
+                  });
+}
+
+Registration Registration::Compose(Registration a, Registration b)
+{
+    return Registration(b.Rotation * a.Rotation,
+                        b.Rotation * a.Translation + b.Translation);
+}
+
+double Registration::CrossCovariance(const Vector3 *source,
+                                     const Vector3 *target,
+                                     const double *weights, size_t count,
+                                     Matrix3x3 &covariance,
+                                     Vector3 &sourceCentroid,
+                                     Vector3 &targetCentroid)
+{
+    covariance = Matrix3x3(0, 0, 0, 0, 0, 0, 0, 0, 0);
+    sourceCentroid = Vector3(0, 0, 0);
+    targetCentroid = Vector3(0, 0, 0);
+    if (count == 0)
+        return 0;
+
+    // Sum the weight, the weighted points and their weighted products
+    // relative to the first pair, one set of sums per chunk
+    Vector3 p0 = source[0];
+    Vector3 q0 = target[0];
+    size_t chunks = Parallel::Chunks(count, ParallelGrain);
+    std::vector<double> partial(chunks * 16);
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t chunk, size_t begin, size_t end)
+                  {
+                      DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+                      DenormalGuard::Inspect((const double *)(source + begin),
+                                             3 * (end - begin));
+                      DenormalGuard::Inspect((const double *)(target + begin),
+                                             3 * (end - begin));
+                      double *sums = partial.data() + chunk * 16;
+                      if (weights != nullptr)
+                          AccumulateRange<true>(source, target, weights,
+                                                begin, end, p0, q0, sums);
+                      else
+                          AccumulateRange<false>(source, target, weights,
+                                                 begin, end, p0, q0, sums);
+                  });
+    double sums[16] = {};
+    for (size_t i = 0; i < chunks; i++)
+        for (int k = 0; k < 16; k++)
+            sums[k] += partial[i * 16 + k];
+
+    // Shift the products from the first pair to the centroids
+    double total = sums[0];
+    if (total == 0)
+        return 0;
+    double p[3], q[3];
+    for (int i = 0; i < 3; i++)
+    {
+        p[i] = sums[1 + i] / total;
+        q[i] = sums[4 + i] / total;
+    }
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            covariance.data[i][j] = sums[7 + 3 * i + j] - total * p[i] * q[j];
+    sourceCentroid = p0 + Vector3(p[0], p[1], p[2]);
+    targetCentroid = q0 + Vector3(q[0], q[1], q[2]);
+    return total;
+}
+
+Registration Registration::Horn(const Vector3 *source, const Vector3 *target,
+                                const double *weights, size_t count)
+{
+    Matrix3x3 h;
+    Vector3 p, q;
+    if (CrossCovariance(source, target, weights, count, h, p, q) == 0)
+        return Registration();
+    return FromCentroids(HornRotation(h), p, q);
+}
+
+Quaternion Registration::HornRotation(Matrix3x3 covariance)
+{
+    // Horn's matrix N, ordered W, X, Y, Z, whose largest eigenvector is the
+    // rotation maximizing sum q^T R p
+    const Matrix3x3 &s = covariance;
+    double n[4][4] = {
+        { s.D00 + s.D11 + s.D22, s.D12 - s.D21, s.D20 - s.D02,
+          s.D01 - s.D10 },
+        { s.D12 - s.D21, s.D00 - s.D11 - s.D22, s.D01 + s.D10,
+          s.D20 + s.D02 },
+        { s.D20 - s.D02, s.D01 + s.D10, s.D11 - s.D00 - s.D22,
+          s.D12 + s.D21 },
+        { s.D01 - s.D10, s.D20 + s.D02, s.D12 + s.D21,
+          s.D22 - s.D00 - s.D11 }
+    };
+    double v[4][4] = { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 },
+                       { 0, 0, 0, 1 } };
+
+    // Cyclic Jacobi, which converges quadratically, so a fixed number of
+    // sweeps reaches full precision
+    for (int sweep = 0; sweep < HornSweeps; sweep++)
+        for (int a = 0; a < 3; a++)
+            for (int b = a + 1; b < 4; b++)
+            {
+                double apq = n[a][b];
+                if (apq == 0)
+                    continue;
+                double theta = (n[b][b] - n[a][a]) / (2 * apq);
+                double t = 1 / (fabs(theta) + sqrt(theta * theta + 1));
+                if (theta < 0)
+                    t = -t;
+                double c = 1 / sqrt(t * t + 1);
+                double sn = t * c;
+                n[a][a] -= t * apq;
+                n[b][b] += t * apq;
+                n[a][b] = n[b][a] = 0;
+                for (int r = 0; r < 4; r++)
+                {
+                    if (r != a && r != b)
+                    {
+                        double ra = n[r][a];
+                        double rb = n[r][b];
+                        n[r][a] = n[a][r] = c * ra - sn * rb;
+                        n[r][b] = n[b][r] = sn * ra + c * rb;
+                    }
+                    double va = v[r][a];
+                    double vb = v[r][b];
+                    v[r][a] = c * va - sn * vb;
+                    v[r][b] = sn * va + c * vb;
+                }
+            }
+
+    int largest = 0;
+    for (int i = 1; i < 4; i++)
+        if (n[i][i] > n[largest][largest])
+            largest = i;
+    return Quaternion::Normalized(Quaternion(v[1][largest], v[2][largest],
+                                             v[3][largest], v[0][largest]));
+}
+
+template <typename Index>
+Registration Registration::ICP(const Index &index, const Vector3 *targets,
+                               const Vector3 *source, size_t count,
+                               Registration initial, int maxIterations,
+                               double maxDistance, double tolerance,
+                               std::vector<ICPIteration> *iterations)
+{
+    Registration current = initial;
+    std::vector<Vector3> moved(count);
+    std::vector<Vector3> matched(count);
+    std::vector<size_t> indices(count);
+    std::vector<double> distances(count);
+    std::vector<double> weights(count);
+    double previous = INFINITY;
+    for (int iteration = 0; iteration < maxIterations; iteration++)
+    {
+        ICPIteration stats;
+        std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+
+        // Pair each moved source point with its nearest target, giving the
+        // pairs which are too far apart no weight
+        Apply(current, source, count, moved.data());
+        Index::Nearest(index, moved.data(), count, 1, indices.data(),
+                       distances.data());
+        size_t chunks = Parallel::Chunks(count, ParallelGrain);
+        std::vector<double> errors(chunks);
+        std::vector<size_t> pairs(chunks);
+        Parallel::For(count, ParallelGrain,
+                      [&](size_t chunk, size_t begin, size_t end)
+                      {
+                          double error = 0;
+                          size_t kept = 0;
+                          for (size_t i = begin; i < end; i++)
+                          {
+                              double d = distances[i];
+                              bool keep = d <= maxDistance;
+                              matched[i] = keep ? targets[indices[i]] :
+                                  moved[i];
+                              weights[i] = keep ? 1 : 0;
+                              error += keep ? d * d : 0;
+                              kept += keep;
+                          }
+                          errors[chunk] = error;
+                          pairs[chunk] = kept;
+                      });
+        double error = 0;
+        stats.Pairs = 0;
+        for (size_t i = 0; i < chunks; i++)
+        {
+            error += errors[i];
+            stats.Pairs += pairs[i];
+        }
+        stats.Error = stats.Pairs > 0 ? sqrt(error / stats.Pairs) : 0;
+        stats.MatchSeconds = Elapsed(start);
+
+        Matrix3x3 h;
+        Vector3 p, q;
+        double total = CrossCovariance(moved.data(), matched.data(),
+                                       weights.data(), count, h, p, q);
+        stats.AccumulateSeconds = Elapsed(start);
+
+        if (total > 0)
+        {
+            Registration step = FromCentroids(HornRotation(h), p, q);
+            current = Compose(current, step);
+            current.Rotation = Quaternion::Normalized(current.Rotation);
+        }
+        stats.SolveSeconds = Elapsed(start);
+        if (iterations != nullptr)
+            iterations->push_back(stats);
+        if (total == 0 || fabs(previous - stats.Error) <= tolerance)
+            break;
+        previous = stats.Error;
+    }
+    return current;
+}
+
+Registration Registration::Inverse(Registration registration)
+{
+    Quaternion inverse = Quaternion::Conjugate(registration.Rotation);
+    return Registration(inverse, -(inverse * registration.Translation));
+}
+
+Registration Registration::Kabsch(const Vector3 *source,
+                                  const Vector3 *target,
+                                  const double *weights, size_t count)
+{
+    Matrix3x3 h;
+    Vector3 p, q;
+    if (CrossCovariance(source, target, weights, count, h, p, q) == 0)
+        return Registration();
+    return FromCentroids(KabschRotation(h), p, q);
+}
+
+Quaternion Registration::KabschRotation(Matrix3x3 covariance)
+{
+    // With H = U S V^T the best rotation is V U^T, the rotation factor of
+    // H^T = V S U^T, and the SVD's signed last singular value keeps it proper
+    Quaternion rotation;
+    Matrix3x3 stretch;
+    Matrix3x3::PolarDecomposition(Matrix3x3::Transpose(covariance), rotation,
+                                  stretch);
+    return rotation;
+}
+
+
+template <bool Weighted>
+void Registration::AccumulateRange(const Vector3 *source,
+                                   const Vector3 *target,
+                                   const double *weights, size_t begin,
+                                   size_t end, Vector3 p0, Vector3 q0,
+                                   double sums[16])
+{
+    // Sum 0 is the weight, 1 to 3 and 4 to 6 the weighted source and target
+    // and 7 to 15 the products. Every sum keeps one accumulator per lane so
+    // that the lanes can be added as vectors without reassociating them
+    double acc[16][Lanes] = {};
+    size_t i = begin;
+    for (; i + Lanes <= end; i += Lanes)
+        for (size_t l = 0; l < Lanes; l++)
+        {
+            double w = Weighted ? weights[i + l] : 1;
+            double px = source[i + l].X - p0.X;
+            double py = source[i + l].Y - p0.Y;
+            double pz = source[i + l].Z - p0.Z;
+            double qx = target[i + l].X - q0.X;
+            double qy = target[i + l].Y - q0.Y;
+            double qz = target[i + l].Z - q0.Z;
+            double wx = w * px;
+            double wy = w * py;
+            double wz = w * pz;
+            acc[0][l] += w;
+            acc[1][l] += wx;
+            acc[2][l] += wy;
+            acc[3][l] += wz;
+            acc[4][l] += w * qx;
+            acc[5][l] += w * qy;
+            acc[6][l] += w * qz;
+            acc[7][l] += wx * qx;
+            acc[8][l] += wx * qy;
+            acc[9][l] += wx * qz;
+            acc[10][l] += wy * qx;
+            acc[11][l] += wy * qy;
+            acc[12][l] += wy * qz;
+            acc[13][l] += wz * qx;
+            acc[14][l] += wz * qy;
+            acc[15][l] += wz * qz;
+        }
+    for (; i < end; i++)
+    {
+        double w = Weighted ? weights[i] : 1;
+        Vector3 p = source[i] - p0;
+        Vector3 q = target[i] - q0;
+        acc[0][0] += w;
+        for (int j = 0; j < 3; j++)
+        {
+            acc[1 + j][0] += w * p.data[j];
+            acc[4 + j][0] += w * q.data[j];
+            for (int k = 0; k < 3; k++)
+                acc[7 + 3 * j + k][0] += w * p.data[j] * q.data[k];
+        }
+    }
+    for (int k = 0; k < 16; k++)
+    {
+        double sum = 0;
+        for (size_t l = 0; l < Lanes; l++)
+            sum += acc[k][l];
+        sums[k] = sum;
+    }
+}
+
+double Registration::Elapsed(std::chrono::steady_clock::time_point &start)
+{
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - start;
+    start = now;
+    return elapsed.count();
+}
+
+Registration Registration::FromCentroids(Quaternion rotation,
+                                          Vector3 sourceCentroid,
+                                          Vector3 targetCentroid)
+{
+    return Registration(rotation,
+                        targetCentroid - rotation * sourceCentroid);
+}
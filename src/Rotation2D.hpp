@@ -0,0 +1,331 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a 2D rotation stored as a unit complex number, the
+ *  2D counterpart of a unit quaternion.
+ */
+
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <stddef.h>
+#include "DenormalGuard.hpp"
+#include "FastMath.hpp"
+#include "Vector2.hpp"
+
+
+struct Rotation2D
+{
+    /**
+     * The cosine and sine of the rotation angle, which are the real and
+     * imaginary parts of the complex number. Rotations are counterclockwise.
+     */
+    double Cos;
+    double Sin;
+
+
+    /**
+     * Constructors.
+     * The cosine and sine passed in must have a sum of squares of one.
+     */
+    inline Rotation2D();
+    inline Rotation2D(double cosine, double sine);
+
+
+    /**
+     * Constants for common rotations.
+     */
+    static inline Rotation2D Identity();
+
+
+    /**
+     * Returns the angle between two rotations.
+     * @param a: The first rotation.
+     * @param b: The second rotation.
+     * @return: A scalar value in the range [0, pi].
+     */
+    static inline double Angle(Rotation2D a, Rotation2D b);
+
+    /**
+     * Returns a rotation by an angle.
+     * @param angle: The angle in radians.
+     * @return: A new rotation.
+     */
+    static inline Rotation2D FromAngle(double angle);
+
+    /**
+     * Returns a rotation which rotates the direction of one vector onto
+     * another. Neither vector may be zero.
+     * @param fromVector: The starting direction.
+     * @param toVector: The ending direction.
+     * @return: A new rotation.
+     */
+    static inline Rotation2D FromToRotation(Vector2 fromVector,
+                                           Vector2 toVector);
+
+    /**
+     * Returns the inverse of a rotation, which is its complex conjugate.
+     * @param rotation: The rotation in question.
+     * @return: A new rotation.
+     */
+    static inline Rotation2D Inverse(Rotation2D rotation);
+
+    /**
+     * Returns a rotation rescaled to have a norm of one, removing drift
+     * built up by long chains of multiplications.
+     * @param rotation: The rotation in question.
+     * @return: A new rotation.
+     */
+    static inline Rotation2D Normalized(Rotation2D rotation);
+
+    /**
+     * Rotates a vector.
+     * @param rotation: The rotation to apply.
+     * @param vector: The vector to rotate.
+     * @return: A new vector.
+     */
+    static inline Vector2 Rotate(Rotation2D rotation, Vector2 vector);
+
+    /**
+     * Rotates an array of vectors by one rotation, reusing its cosine and
+     * sine for every vector. The input and output may be the same array.
+     * @param rotation: The rotation to apply.
+     * @param vectors: The vectors to rotate.
+     * @param count: The number of vectors.
+     * @param output: The rotated vectors.
+     */
+    static inline void Rotate(Rotation2D rotation, const Vector2 *vectors,
+                              size_t count, Vector2 *output);
+
+    /**
+     * Rotates arrays of X and Y coordinates by one rotation. The inputs and
+     * outputs may be the same arrays.
+     * @param rotation: The rotation to apply.
+     * @param x: The X coordinates to rotate.
+     * @param y: The Y coordinates to rotate.
+     * @param count: The number of vectors.
+     * @param outputX: The rotated X coordinates.
+     * @param outputY: The rotated Y coordinates.
+     */
+    static inline void Rotate(Rotation2D rotation, const double *x,
+                              const double *y, size_t count, double *outputX,
+                              double *outputY);
+
+    /**
+     * Returns a rotation spherically interpolated between a and b by t,
+     * taking the shorter way around. If t is outside the range [0, 1], it is
+     * clamped.
+     * @param a: The starting rotation.
+     * @param b: The ending rotation.
+     * @param t: The interpolation value.
+     * @return: A new rotation.
+     */
+    static inline Rotation2D Slerp(Rotation2D a, Rotation2D b, double t);
+
+    /**
+     * Returns a rotation spherically interpolated between a and b by t,
+     * taking the shorter way around. t is not clamped.
+     * @param a: The starting rotation.
+     * @param b: The ending rotation.
+     * @param t: The interpolation value.
+     * @return: A new rotation.
+     */
+    static inline Rotation2D SlerpUnclamped(Rotation2D a, Rotation2D b,
+                                            double t);
+
+    /**
+     * Returns the angle of a rotation.
+     * @param rotation: The rotation in question.
+     * @return: An angle in radians in the range [-pi, pi].
+     */
+    static inline double ToAngle(Rotation2D rotation);
+
+    /**
+     * Returns the angle of a rotation using FastMath::Atan2.
+     * @param rotation: The rotation in question.
+     * @param precision: Pass FastMath() to select this overload.
+     * @return: An angle in radians in the range [-pi, pi].
+     */
+    static inline double ToAngle(Rotation2D rotation, FastMath precision);
+
+
+    /**
+     * Operator overloading.
+     * Multiplying two rotations adds their angles.
+     */
+    inline struct Rotation2D& operator*=(const Rotation2D rhs);
+};
+
+inline Rotation2D operator*(Rotation2D lhs, const Rotation2D rhs);
+inline Vector2 operator*(Rotation2D lhs, const Vector2 rhs);
+inline bool operator==(const Rotation2D lhs, const Rotation2D rhs);
+inline bool operator!=(const Rotation2D lhs, const Rotation2D rhs);
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+Rotation2D::Rotation2D() : Cos(1), Sin(0) {}
+Rotation2D::Rotation2D(double cosine, double sine) : Cos(cosine), Sin(sine) {}
+
+
+Rotation2D Rotation2D::Identity() { return Rotation2D(1, 0); }
+
+
+double Rotation2D::Angle(Rotation2D a, Rotation2D b)
+{
+    // The angle of b a* found from its sine and cosine, which unlike acos
+    // of their dot product keeps its precision for small angles
+    double cosine = a.Cos * b.Cos + a.Sin * b.Sin;
+    double sine = a.Cos * b.Sin - a.Sin * b.Cos;
+    return fabs(atan2(sine, cosine));
+}
+
+Rotation2D Rotation2D::FromAngle(double angle)
+{
+    Rotation2D rotation;
+    FastMath::SinCos(angle, rotation.Sin, rotation.Cos);
+    return rotation;
+}
+
+Rotation2D Rotation2D::FromToRotation(Vector2 fromVector, Vector2 toVector)
+{
+    double cosine = Vector2::Dot(fromVector, toVector);
+    double sine = fromVector.X * toVector.Y - fromVector.Y * toVector.X;
+    return Normalized(Rotation2D(cosine, sine));
+}
+
+Rotation2D Rotation2D::Inverse(Rotation2D rotation)
+{
+    return Rotation2D(rotation.Cos, -rotation.Sin);
+}
+
+Rotation2D Rotation2D::Normalized(Rotation2D rotation)
+{
+    double norm = sqrt(rotation.Cos * rotation.Cos +
+                       rotation.Sin * rotation.Sin);
+    if (norm == 0)
+        return Rotation2D();
+    return Rotation2D(rotation.Cos / norm, rotation.Sin / norm);
+}
+
+Vector2 Rotation2D::Rotate(Rotation2D rotation, Vector2 vector)
+{
+    return Vector2(rotation.Cos * vector.X - rotation.Sin * vector.Y,
+                   rotation.Sin * vector.X + rotation.Cos * vector.Y);
+}
+
+void Rotation2D::Rotate(Rotation2D rotation, const Vector2 *vectors,
+                        size_t count, Vector2 *output)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect((const double *)vectors, 2 * count);
+    double c = rotation.Cos;
+    double s = rotation.Sin;
+    for (size_t i = 0; i < count; i++)
+    {
+        double x = vectors[i].X;
+        double y = vectors[i].Y;
+        output[i].X = c * x - s * y;
+        output[i].Y = s * x + c * y;
+    }
+}
+
+void Rotation2D::Rotate(Rotation2D rotation, const double *x,
+                        const double *y, size_t count, double *outputX,
+                        double *outputY)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect(x, count);
+    DenormalGuard::Inspect(y, count);
+    double c = rotation.Cos;
+    double s = rotation.Sin;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        double u = x[i];
+        double v = y[i];
+        outputX[i] = c * u - s * v;
+        outputY[i] = s * u + c * v;
+    }
+}
+
+Rotation2D Rotation2D::Slerp(Rotation2D a, Rotation2D b, double t)
+{
+    if (t < 0) return a;
+    else if (t > 1) return b;
+    return SlerpUnclamped(a, b, t);
+}
+
+Rotation2D Rotation2D::SlerpUnclamped(Rotation2D a, Rotation2D b, double t)
+{
+    // The signed angle from a to b is already the shorter one
+    double cosine = a.Cos * b.Cos + a.Sin * b.Sin;
+    double sine = a.Cos * b.Sin - a.Sin * b.Cos;
+    return a * FromAngle(atan2(sine, cosine) * t);
+}
+
+double Rotation2D::ToAngle(Rotation2D rotation)
+{
+    return atan2(rotation.Sin, rotation.Cos);
+}
+
+double Rotation2D::ToAngle(Rotation2D rotation, FastMath)
+{
+    return FastMath::Atan2(rotation.Sin, rotation.Cos);
+}
+
+
+struct Rotation2D& Rotation2D::operator*=(const Rotation2D rhs)
+{
+    double cosine = Cos * rhs.Cos - Sin * rhs.Sin;
+    Sin = Sin * rhs.Cos + Cos * rhs.Sin;
+    Cos = cosine;
+    return *this;
+}
+
+Rotation2D operator*(Rotation2D lhs, const Rotation2D rhs)
+{
+    return lhs *= rhs;
+}
+
+Vector2 operator*(Rotation2D lhs, const Vector2 rhs)
+{
+    return Rotation2D::Rotate(lhs, rhs);
+}
+
+bool operator==(const Rotation2D lhs, const Rotation2D rhs)
+{
+    return lhs.Cos == rhs.Cos && lhs.Sin == rhs.Sin;
+}
+
+bool operator!=(const Rotation2D lhs, const Rotation2D rhs)
+{
+    return !(lhs == rhs);
+}
@@ -0,0 +1,417 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements batch kernels which deform mesh vertices by a
+ *  weighted blend of bone transforms.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <algorithm>
+#include "DenormalGuard.hpp"
+#include "DualQuaternion.hpp"
+#include "Matrix3x3.hpp"
+#include "Parallel.hpp"
+#include "Vector3.hpp"
+#include "Vector3Array.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#   define GMATH_PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_M_X64) || defined(_M_IX86)
+#   include <xmmintrin.h>
+#   define GMATH_PREFETCH(address) \
+        _mm_prefetch((const char *)(address), _MM_HINT_T0)
+#else
+#   define GMATH_PREFETCH(address)
+#endif
+
+
+struct Skinning
+{
+    // The number of bones which influence each vertex
+    static constexpr size_t Influences = 4;
+
+    // The number of vertices blended at a time by the batch kernels
+    static constexpr size_t BlockSize = 128;
+
+    // The smallest number of vertices worth giving to another thread
+    static constexpr size_t ParallelGrain = 1 << 13;
+
+    // How many vertices ahead the bone matrices are prefetched
+    static constexpr size_t PrefetchDistance = 16;
+
+
+    /**
+     * Deforms vertices by blending the dual quaternions of the bones which
+     * influence them. Unlike blending matrices, this keeps the volume of
+     * joints which twist or bend sharply.
+     * @param bones: The transform of each bone, as unit dual quaternions.
+     * @param indices: Influences bone indices for each vertex.
+     * @param weights: Influences weights for each vertex. Unused influences
+     *                 should have a weight of zero.
+     * @param positions: The rest positions of the vertices.
+     * @param normals: The rest normals of the vertices.
+     * @param skinnedPositions: Set to the deformed positions.
+     * @param skinnedNormals: Set to the deformed normals.
+     */
+    static inline void SkinDualQuaternion(const DualQuaternion *bones,
+                                          const unsigned int *indices,
+                                          const double *weights,
+                                          const Vector3Array &positions,
+                                          const Vector3Array &normals,
+                                          Vector3Array &skinnedPositions,
+                                          Vector3Array &skinnedNormals);
+
+    /**
+     * Deforms vertices by a weighted sum of the bone transforms which
+     * influence them. Normals are transformed by the blended matrix and
+     * renormalized, which is exact for bones without non-uniform scale.
+     * @param matrices: The rotation and scale of each bone.
+     * @param translations: The translation of each bone.
+     * @param indices: Influences bone indices for each vertex.
+     * @param weights: Influences weights for each vertex. Unused influences
+     *                 should have a weight of zero.
+     * @param positions: The rest positions of the vertices.
+     * @param normals: The rest normals of the vertices.
+     * @param skinnedPositions: Set to the deformed positions.
+     * @param skinnedNormals: Set to the deformed normals.
+     */
+    static inline void SkinLinear(const Matrix3x3 *matrices,
+                                  const Vector3 *translations,
+                                  const unsigned int *indices,
+                                  const double *weights,
+                                  const Vector3Array &positions,
+                                  const Vector3Array &normals,
+                                  Vector3Array &skinnedPositions,
+                                  Vector3Array &skinnedNormals);
+
+    /**
+     * Helpers for the implementation.
+     * The blocks take pointers to their first vertex.
+     */
+    static inline void DualQuaternionBlock(const DualQuaternion *bones,
+                                           const unsigned int *indices,
+                                           const double *weights,
+                                           const Vector3Array &positions,
+                                           const Vector3Array &normals,
+                                           Vector3Array &skinnedPositions,
+                                           Vector3Array &skinnedNormals,
+                                           size_t begin, size_t count);
+    static inline void LinearBlock(const Matrix3x3 *matrices,
+                                   const Vector3 *translations,
+                                   const unsigned int *indices,
+                                   const double *weights,
+                                   const Vector3Array &positions,
+                                   const Vector3Array &normals,
+                                   Vector3Array &skinnedPositions,
+                                   Vector3Array &skinnedNormals,
+                                   size_t begin, size_t count);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+void Skinning::SkinDualQuaternion(const DualQuaternion *bones,
+                                  const unsigned int *indices,
+                                  const double *weights,
+                                  const Vector3Array &positions,
+                                  const Vector3Array &normals,
+                                  Vector3Array &skinnedPositions,
+                                  Vector3Array &skinnedNormals)
+{
+    size_t count = Vector3Array::Size(positions);
+    Vector3Array::Resize(skinnedPositions, count);
+    Vector3Array::Resize(skinnedNormals, count);
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect(weights, count * Influences);
+    Parallel::For(count, ParallelGrain,
+        [&](size_t, size_t begin, size_t end)
+        {
+            DenormalGuard chunkGuard(GMATH_FLUSH_DENORMALS);
+            for (size_t b = begin; b < end; b += BlockSize)
+                DualQuaternionBlock(bones, indices, weights, positions,
+                                    normals, skinnedPositions, skinnedNormals,
+                                    b, end - b < BlockSize ? end - b :
+                                    BlockSize);
+        });
+}
+
+void Skinning::SkinLinear(const Matrix3x3 *matrices,
+                          const Vector3 *translations,
+                          const unsigned int *indices, const double *weights,
+                          const Vector3Array &positions,
+                          const Vector3Array &normals,
+                          Vector3Array &skinnedPositions,
+                          Vector3Array &skinnedNormals)
+{
+    size_t count = Vector3Array::Size(positions);
+    Vector3Array::Resize(skinnedPositions, count);
+    Vector3Array::Resize(skinnedNormals, count);
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect(weights, count * Influences);
+    Parallel::For(count, ParallelGrain,
+        [&](size_t, size_t begin, size_t end)
+        {
+            DenormalGuard chunkGuard(GMATH_FLUSH_DENORMALS);
+            for (size_t b = begin; b < end; b += BlockSize)
+                LinearBlock(matrices, translations, indices, weights,
+                            positions, normals, skinnedPositions,
+                            skinnedNormals, b, end - b < BlockSize ? end - b :
+                            BlockSize);
+        });
+}
+
+void Skinning::DualQuaternionBlock(const DualQuaternion *bones,
+                                   const unsigned int *indices,
+                                   const double *weights,
+                                   const Vector3Array &positions,
+                                   const Vector3Array &normals,
+                                   Vector3Array &skinnedPositions,
+                                   Vector3Array &skinnedNormals,
+                                   size_t begin, size_t count)
+{
+    // The blend is accumulated in padded local arrays so that every loop
+    // but the gathers has a fixed length and vectorizes. Padding lanes hold
+    // the identity with a weight of zero.
+    double rx[BlockSize], ry[BlockSize], rz[BlockSize], rw[BlockSize];
+    double dx[BlockSize], dy[BlockSize], dz[BlockSize], dw[BlockSize];
+    double g[8][BlockSize], w[BlockSize];
+    for (size_t i = 0; i < BlockSize; i++)
+    {
+        rx[i] = ry[i] = rz[i] = dx[i] = dy[i] = dz[i] = dw[i] = 0;
+        rw[i] = i < count ? 0 : 1;
+    }
+
+    indices += begin * Influences;
+    weights += begin * Influences;
+    for (size_t k = 0; k < Influences; k++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            const DualQuaternion &bone = bones[indices[i * Influences + k]];
+            g[0][i] = bone.Real.X;
+            g[1][i] = bone.Real.Y;
+            g[2][i] = bone.Real.Z;
+            g[3][i] = bone.Real.W;
+            g[4][i] = bone.Dual.X;
+            g[5][i] = bone.Dual.Y;
+            g[6][i] = bone.Dual.Z;
+            g[7][i] = bone.Dual.W;
+            w[i] = weights[i * Influences + k];
+        }
+        for (size_t i = count; i < BlockSize; i++)
+        {
+            for (size_t c = 0; c < 8; c++)
+                g[c][i] = 0;
+            w[i] = 0;
+        }
+
+        // q and -q are the same rotation, so each bone is flipped onto the
+        // same side as the blend so far before it is added
+        for (size_t i = 0; i < BlockSize; i++)
+        {
+            double dot = rx[i] * g[0][i] + ry[i] * g[1][i] +
+                rz[i] * g[2][i] + rw[i] * g[3][i];
+            double s = dot < 0 ? -w[i] : w[i];
+            rx[i] += s * g[0][i];
+            ry[i] += s * g[1][i];
+            rz[i] += s * g[2][i];
+            rw[i] += s * g[3][i];
+            dx[i] += s * g[4][i];
+            dy[i] += s * g[5][i];
+            dz[i] += s * g[6][i];
+            dw[i] += s * g[7][i];
+        }
+    }
+
+    // Reuse the gather space for the rest pose
+    double *px = g[0], *py = g[1], *pz = g[2];
+    double *nx = g[3], *ny = g[4], *nz = g[5];
+    for (size_t i = 0; i < count; i++)
+    {
+        px[i] = positions.X[begin + i];
+        py[i] = positions.Y[begin + i];
+        pz[i] = positions.Z[begin + i];
+        nx[i] = normals.X[begin + i];
+        ny[i] = normals.Y[begin + i];
+        nz[i] = normals.Z[begin + i];
+    }
+    DenormalGuard::Inspect(px, count);
+    DenormalGuard::Inspect(py, count);
+    DenormalGuard::Inspect(pz, count);
+
+    // Normalize the blend; the dual part only needs the same scale since
+    // its component along the real part drops out below. The square roots
+    // get their own loop, as their error handling keeps a loop from
+    // vectorizing.
+    for (size_t i = 0; i < BlockSize; i++)
+        w[i] = rx[i] * rx[i] + ry[i] * ry[i] + rz[i] * rz[i] + rw[i] * rw[i];
+    for (size_t i = 0; i < BlockSize; i++)
+        w[i] = 1 / sqrt(w[i]);
+
+    for (size_t i = 0; i < BlockSize; i++)
+    {
+        double qx = rx[i] * w[i], qy = ry[i] * w[i];
+        double qz = rz[i] * w[i], qw = rw[i] * w[i];
+        double ex = dx[i] * w[i], ey = dy[i] * w[i];
+        double ez = dz[i] * w[i], ew = dw[i] * w[i];
+
+        // The translation is the vector part of 2 d r*
+        double tx = 2 * (qw * ex - ew * qx + qy * ez - qz * ey);
+        double ty = 2 * (qw * ey - ew * qy + qz * ex - qx * ez);
+        double tz = 2 * (qw * ez - ew * qz + qx * ey - qy * ex);
+
+        // v' = v + 2 q x (q x v + w v)
+        double cx = qy * pz[i] - qz * py[i] + qw * px[i];
+        double cy = qz * px[i] - qx * pz[i] + qw * py[i];
+        double cz = qx * py[i] - qy * px[i] + qw * pz[i];
+        px[i] += 2 * (qy * cz - qz * cy) + tx;
+        py[i] += 2 * (qz * cx - qx * cz) + ty;
+        pz[i] += 2 * (qx * cy - qy * cx) + tz;
+        cx = qy * nz[i] - qz * ny[i] + qw * nx[i];
+        cy = qz * nx[i] - qx * nz[i] + qw * ny[i];
+        cz = qx * ny[i] - qy * nx[i] + qw * nz[i];
+        nx[i] += 2 * (qy * cz - qz * cy);
+        ny[i] += 2 * (qz * cx - qx * cz);
+        nz[i] += 2 * (qx * cy - qy * cx);
+    }
+
+    std::copy(px, px + count, skinnedPositions.X.begin() + begin);
+    std::copy(py, py + count, skinnedPositions.Y.begin() + begin);
+    std::copy(pz, pz + count, skinnedPositions.Z.begin() + begin);
+    std::copy(nx, nx + count, skinnedNormals.X.begin() + begin);
+    std::copy(ny, ny + count, skinnedNormals.Y.begin() + begin);
+    std::copy(nz, nz + count, skinnedNormals.Z.begin() + begin);
+}
+
+void Skinning::LinearBlock(const Matrix3x3 *matrices,
+                           const Vector3 *translations,
+                           const unsigned int *indices, const double *weights,
+                           const Vector3Array &positions,
+                           const Vector3Array &normals,
+                           Vector3Array &skinnedPositions,
+                           Vector3Array &skinnedNormals,
+                           size_t begin, size_t count)
+{
+    // The blended matrix and translation of each vertex are spread into
+    // padded local arrays, so that the transform loop has a fixed length
+    // and vectorizes. Padding lanes hold the identity.
+    double m[12][BlockSize], w[BlockSize];
+    double px[BlockSize], py[BlockSize], pz[BlockSize];
+    double nx[BlockSize], ny[BlockSize], nz[BlockSize];
+    indices += begin * Influences;
+    weights += begin * Influences;
+    for (size_t i = 0; i < count; i++)
+    {
+        // Palettes too big for the cache are read in the order that the
+        // vertices use them, so fetch the bones a little ahead
+        if (i + PrefetchDistance < count)
+            for (size_t k = 0; k < Influences; k++)
+            {
+                unsigned int ahead =
+                    indices[(i + PrefetchDistance) * Influences + k];
+                GMATH_PREFETCH(&matrices[ahead]);
+                GMATH_PREFETCH(&translations[ahead]);
+            }
+        const unsigned int *bone = indices + i * Influences;
+        const double *weight = weights + i * Influences;
+        Matrix3x3 blend = matrices[bone[0]] * weight[0];
+        Vector3 offset = translations[bone[0]] * weight[0];
+        for (size_t k = 1; k < Influences; k++)
+        {
+            blend += matrices[bone[k]] * weight[k];
+            offset += translations[bone[k]] * weight[k];
+        }
+        m[0][i] = blend.D00;
+        m[1][i] = blend.D01;
+        m[2][i] = blend.D02;
+        m[3][i] = blend.D10;
+        m[4][i] = blend.D11;
+        m[5][i] = blend.D12;
+        m[6][i] = blend.D20;
+        m[7][i] = blend.D21;
+        m[8][i] = blend.D22;
+        m[9][i] = offset.X;
+        m[10][i] = offset.Y;
+        m[11][i] = offset.Z;
+    }
+    for (size_t c = 0; c < 12; c++)
+        for (size_t i = count; i < BlockSize; i++)
+            m[c][i] = c == 0 || c == 4 || c == 8 ? 1 : 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        px[i] = positions.X[begin + i];
+        py[i] = positions.Y[begin + i];
+        pz[i] = positions.Z[begin + i];
+        nx[i] = normals.X[begin + i];
+        ny[i] = normals.Y[begin + i];
+        nz[i] = normals.Z[begin + i];
+    }
+    DenormalGuard::Inspect(px, count);
+    DenormalGuard::Inspect(py, count);
+    DenormalGuard::Inspect(pz, count);
+    for (size_t i = count; i < BlockSize; i++)
+    {
+        px[i] = py[i] = pz[i] = ny[i] = nz[i] = 0;
+        nx[i] = 1;
+    }
+
+    for (size_t i = 0; i < BlockSize; i++)
+    {
+        double x = px[i], y = py[i], z = pz[i];
+        px[i] = m[0][i] * x + m[1][i] * y + m[2][i] * z + m[9][i];
+        py[i] = m[3][i] * x + m[4][i] * y + m[5][i] * z + m[10][i];
+        pz[i] = m[6][i] * x + m[7][i] * y + m[8][i] * z + m[11][i];
+        x = nx[i];
+        y = ny[i];
+        z = nz[i];
+        nx[i] = m[0][i] * x + m[1][i] * y + m[2][i] * z;
+        ny[i] = m[3][i] * x + m[4][i] * y + m[5][i] * z;
+        nz[i] = m[6][i] * x + m[7][i] * y + m[8][i] * z;
+        w[i] = nx[i] * nx[i] + ny[i] * ny[i] + nz[i] * nz[i];
+    }
+    for (size_t i = 0; i < BlockSize; i++)
+        w[i] = 1 / sqrt(w[i]);
+    for (size_t i = 0; i < BlockSize; i++)
+    {
+        nx[i] *= w[i];
+        ny[i] *= w[i];
+        nz[i] *= w[i];
+    }
+
+    std::copy(px, px + count, skinnedPositions.X.begin() + begin);
+    std::copy(py, py + count, skinnedPositions.Y.begin() + begin);
+    std::copy(pz, pz + count, skinnedPositions.Z.begin() + begin);
+    std::copy(nx, nx + count, skinnedNormals.X.begin() + begin);
+    std::copy(ny, ny + count, skinnedNormals.Y.begin() + begin);
+    std::copy(nz, nz + count, skinnedNormals.Z.begin() + begin);
+}
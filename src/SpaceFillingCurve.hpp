@@ -0,0 +1,505 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements Morton (Z-order) and Hilbert codes for 2D and 3D
+ *  points, along with a parallel radix sort and permutation functions for
+ *  putting arrays into spatial order.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "AABB.hpp"
+#include "Parallel.hpp"
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+#include "Vector3Array.hpp"
+
+
+struct SpaceFillingCurve
+{
+    /**
+     * Ranges with at least ParallelGrain items are processed on multiple
+     * threads.
+     */
+    static constexpr size_t ParallelGrain = 1 << 15;
+
+
+    /**
+     * Returns the Hilbert code of a cell on a 2^32 by 2^32 grid.
+     * @param x: The cell on the X axis.
+     * @param y: The cell on the Y axis.
+     * @return: A 64 bit code.
+     */
+    static inline uint64_t Hilbert(uint32_t x, uint32_t y);
+
+    /**
+     * Returns the Hilbert code of a cell on a 2^21 by 2^21 by 2^21 grid.
+     * Higher bits of the cell coordinates are ignored.
+     * @param x: The cell on the X axis.
+     * @param y: The cell on the Y axis.
+     * @param z: The cell on the Z axis.
+     * @return: A 63 bit code.
+     */
+    static inline uint64_t Hilbert(uint32_t x, uint32_t y, uint32_t z);
+
+    /**
+     * Computes the Hilbert codes of points within a rectangle.
+     * @param points: The points.
+     * @param count: The number of points.
+     * @param min: The lower corner of the rectangle.
+     * @param max: The upper corner of the rectangle.
+     * @param codes: The output codes, one per point.
+     */
+    static inline void HilbertCodes(const Vector2 *points, size_t count,
+                                    Vector2 min, Vector2 max,
+                                    uint64_t *codes);
+
+    /**
+     * Computes the Hilbert codes of points within a box.
+     * @param points: The points.
+     * @param count: The number of points.
+     * @param bounds: The box the points lie in.
+     * @param codes: The output codes, one per point.
+     */
+    static inline void HilbertCodes(const Vector3 *points, size_t count,
+                                    AABB bounds, uint64_t *codes);
+
+    /**
+     * Returns the Morton code of a cell on a 2^32 by 2^32 grid. Bit 2i of
+     * the code is bit i of x, and bit 2i + 1 is bit i of y.
+     * @param x: The cell on the X axis.
+     * @param y: The cell on the Y axis.
+     * @return: A 64 bit code.
+     */
+    static inline uint64_t Morton(uint32_t x, uint32_t y);
+
+    /**
+     * Returns the Morton code of a cell on a 2^21 by 2^21 by 2^21 grid. Bit
+     * 3i of the code is bit i of x, bit 3i + 1 is bit i of y and bit 3i + 2
+     * is bit i of z. Higher bits of the cell coordinates are ignored.
+     * @param x: The cell on the X axis.
+     * @param y: The cell on the Y axis.
+     * @param z: The cell on the Z axis.
+     * @return: A 63 bit code.
+     */
+    static inline uint64_t Morton(uint32_t x, uint32_t y, uint32_t z);
+
+    /**
+     * Computes the Morton codes of points within a rectangle.
+     * @param points: The points.
+     * @param count: The number of points.
+     * @param min: The lower corner of the rectangle.
+     * @param max: The upper corner of the rectangle.
+     * @param codes: The output codes, one per point.
+     */
+    static inline void MortonCodes(const Vector2 *points, size_t count,
+                                   Vector2 min, Vector2 max, uint64_t *codes);
+
+    /**
+     * Computes the Morton codes of points within a box.
+     * @param points: The points.
+     * @param count: The number of points.
+     * @param bounds: The box the points lie in.
+     * @param codes: The output codes, one per point.
+     */
+    static inline void MortonCodes(const Vector3 *points, size_t count,
+                                   AABB bounds, uint64_t *codes);
+
+    /**
+     * Computes the order that sorts an array of keys, without changing the
+     * keys. Equal keys keep their input order.
+     * @param keys: The keys.
+     * @param count: The number of keys.
+     * @param permutation: The output order, where permutation[i] is the
+     * index of the key that belongs at position i.
+     */
+    static inline void Order(const uint64_t *keys, size_t count,
+                             unsigned int *permutation);
+
+    /**
+     * Gathers an array into a new order, so that output[i] is
+     * input[permutation[i]].
+     * @param input: The values to reorder.
+     * @param permutation: The order, as computed by Order.
+     * @param count: The number of values.
+     * @param output: The output values, which must not overlap the input.
+     */
+    template <typename T>
+    static inline void Permute(const T *input,
+                               const unsigned int *permutation, size_t count,
+                               T *output);
+
+    /**
+     * Reorders a vector in place (through a temporary copy).
+     * @param values: The values to reorder.
+     * @param permutation: The order, as computed by Order.
+     */
+    template <typename T>
+    static inline void Permute(std::vector<T> &values,
+                               const unsigned int *permutation);
+
+    /**
+     * Reorders every component of a structure of arrays in place.
+     * @param values: The vectors to reorder.
+     * @param permutation: The order, as computed by Order.
+     */
+    static inline void Permute(Vector3Array &values,
+                               const unsigned int *permutation);
+
+    /**
+     * Sorts keys in place with a parallel least significant digit radix
+     * sort, moving the values along with them. Digits on which every key
+     * agrees are skipped. Equal keys keep their input order.
+     * @param keys: The keys to sort.
+     * @param values: The values to move with the keys.
+     * @param count: The number of keys.
+     */
+    static inline void Sort(uint64_t *keys, unsigned int *values,
+                            size_t count);
+
+
+    /**
+     * Helpers used by the encoders.
+     */
+    static inline uint32_t Quantize(double value, double min, double scale,
+                                    uint32_t cells);
+    static inline uint64_t Spread2(uint32_t value);
+    static inline uint64_t Spread3(uint32_t value);
+    static inline uint32_t SuffixParity(uint32_t value);
+    static inline void Transpose(uint32_t &x, uint32_t &y);
+    static inline void Transpose(uint32_t &x, uint32_t &y, uint32_t &z);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+uint64_t SpaceFillingCurve::Hilbert(uint32_t x, uint32_t y)
+{
+    Transpose(x, y);
+    // The transposed form puts the first axis in the highest bit of each
+    // group, so interleave it with the axes reversed
+    return Morton(y, x);
+}
+
+uint64_t SpaceFillingCurve::Hilbert(uint32_t x, uint32_t y, uint32_t z)
+{
+    x &= 0x1FFFFF;
+    y &= 0x1FFFFF;
+    z &= 0x1FFFFF;
+    Transpose(x, y, z);
+    return Morton(z, y, x);
+}
+
+void SpaceFillingCurve::HilbertCodes(const Vector2 *points, size_t count,
+                                     Vector2 min, Vector2 max,
+                                     uint64_t *codes)
+{
+    double scaleX = max.X > min.X ? 4294967296.0 / (max.X - min.X) : 0;
+    double scaleY = max.Y > min.Y ? 4294967296.0 / (max.Y - min.Y) : 0;
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                          codes[i] = Hilbert(
+                              Quantize(points[i].X, min.X, scaleX,
+                                       0xFFFFFFFF),
+                              Quantize(points[i].Y, min.Y, scaleY,
+                                       0xFFFFFFFF));
+                  });
+}
+
+void SpaceFillingCurve::HilbertCodes(const Vector3 *points, size_t count,
+                                     AABB bounds, uint64_t *codes)
+{
+    Vector3 size = AABB::Size(bounds);
+    Vector3 scale = Vector3(size.X > 0 ? 2097152.0 / size.X : 0,
+                            size.Y > 0 ? 2097152.0 / size.Y : 0,
+                            size.Z > 0 ? 2097152.0 / size.Z : 0);
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                          codes[i] = Hilbert(
+                              Quantize(points[i].X, bounds.Min.X, scale.X,
+                                       0x1FFFFF),
+                              Quantize(points[i].Y, bounds.Min.Y, scale.Y,
+                                       0x1FFFFF),
+                              Quantize(points[i].Z, bounds.Min.Z, scale.Z,
+                                       0x1FFFFF));
+                  });
+}
+
+uint64_t SpaceFillingCurve::Morton(uint32_t x, uint32_t y)
+{
+    return Spread2(x) | (Spread2(y) << 1);
+}
+
+uint64_t SpaceFillingCurve::Morton(uint32_t x, uint32_t y, uint32_t z)
+{
+    return Spread3(x) | (Spread3(y) << 1) | (Spread3(z) << 2);
+}
+
+void SpaceFillingCurve::MortonCodes(const Vector2 *points, size_t count,
+                                    Vector2 min, Vector2 max,
+                                    uint64_t *codes)
+{
+    double scaleX = max.X > min.X ? 4294967296.0 / (max.X - min.X) : 0;
+    double scaleY = max.Y > min.Y ? 4294967296.0 / (max.Y - min.Y) : 0;
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                          codes[i] = Morton(
+                              Quantize(points[i].X, min.X, scaleX,
+                                       0xFFFFFFFF),
+                              Quantize(points[i].Y, min.Y, scaleY,
+                                       0xFFFFFFFF));
+                  });
+}
+
+void SpaceFillingCurve::MortonCodes(const Vector3 *points, size_t count,
+                                    AABB bounds, uint64_t *codes)
+{
+    Vector3 size = AABB::Size(bounds);
+    Vector3 scale = Vector3(size.X > 0 ? 2097152.0 / size.X : 0,
+                            size.Y > 0 ? 2097152.0 / size.Y : 0,
+                            size.Z > 0 ? 2097152.0 / size.Z : 0);
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                          codes[i] = Morton(
+                              Quantize(points[i].X, bounds.Min.X, scale.X,
+                                       0x1FFFFF),
+                              Quantize(points[i].Y, bounds.Min.Y, scale.Y,
+                                       0x1FFFFF),
+                              Quantize(points[i].Z, bounds.Min.Z, scale.Z,
+                                       0x1FFFFF));
+                  });
+}
+
+void SpaceFillingCurve::Order(const uint64_t *keys, size_t count,
+                              unsigned int *permutation)
+{
+    std::vector<uint64_t> sorted(keys, keys + count);
+    for (size_t i = 0; i < count; i++)
+        permutation[i] = (unsigned int)i;
+    Sort(sorted.data(), permutation, count);
+}
+
+template <typename T>
+void SpaceFillingCurve::Permute(const T *input,
+                                const unsigned int *permutation, size_t count,
+                                T *output)
+{
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                          output[i] = input[permutation[i]];
+                  });
+}
+
+template <typename T>
+void SpaceFillingCurve::Permute(std::vector<T> &values,
+                                const unsigned int *permutation)
+{
+    std::vector<T> output(values.size());
+    Permute(values.data(), permutation, values.size(), output.data());
+    values.swap(output);
+}
+
+void SpaceFillingCurve::Permute(Vector3Array &values,
+                                const unsigned int *permutation)
+{
+    Permute(values.X, permutation);
+    Permute(values.Y, permutation);
+    Permute(values.Z, permutation);
+}
+
+void SpaceFillingCurve::Sort(uint64_t *keys, unsigned int *values,
+                             size_t count)
+{
+    const size_t radix = 256;
+    size_t chunks = Parallel::Chunks(count, ParallelGrain);
+    std::vector<size_t> histogram(chunks * radix);
+    std::vector<uint64_t> keyBuffer(count);
+    std::vector<unsigned int> valueBuffer(count);
+    uint64_t *keysIn = keys;
+    uint64_t *keysOut = keyBuffer.data();
+    unsigned int *valuesIn = values;
+    unsigned int *valuesOut = valueBuffer.data();
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        // Count the digits in each chunk
+        std::fill(histogram.begin(), histogram.end(), 0);
+        Parallel::For(count, ParallelGrain,
+                      [&](size_t chunk, size_t begin, size_t end)
+                      {
+                          size_t *h = histogram.data() + chunk * radix;
+                          for (size_t i = begin; i < end; i++)
+                              h[(keysIn[i] >> shift) & 0xFF]++;
+                      });
+
+        // Skip the pass if every key has the same digit
+        bool trivial = false;
+        for (size_t d = 0; d < radix && !trivial; d++)
+        {
+            size_t total = 0;
+            for (size_t c = 0; c < chunks; c++)
+                total += histogram[c * radix + d];
+            trivial = total == count;
+        }
+        if (trivial)
+            continue;
+
+        // Turn the counts into the first output slot of each chunk and
+        // digit, then scatter
+        size_t slot = 0;
+        for (size_t d = 0; d < radix; d++)
+            for (size_t c = 0; c < chunks; c++)
+            {
+                size_t n = histogram[c * radix + d];
+                histogram[c * radix + d] = slot;
+                slot += n;
+            }
+        Parallel::For(count, ParallelGrain,
+                      [&](size_t chunk, size_t begin, size_t end)
+                      {
+                          size_t *h = histogram.data() + chunk * radix;
+                          for (size_t i = begin; i < end; i++)
+                          {
+                              size_t s = h[(keysIn[i] >> shift) & 0xFF]++;
+                              keysOut[s] = keysIn[i];
+                              valuesOut[s] = valuesIn[i];
+                          }
+                      });
+        std::swap(keysIn, keysOut);
+        std::swap(valuesIn, valuesOut);
+    }
+    if (keysIn != keys)
+    {
+        std::copy(keysIn, keysIn + count, keys);
+        std::copy(valuesIn, valuesIn + count, values);
+    }
+}
+
+
+uint32_t SpaceFillingCurve::Quantize(double value, double min, double scale,
+                                     uint32_t cells)
+{
+    double q = (value - min) * scale;
+    if (!(q > 0))
+        return 0;
+    return q < cells ? (uint32_t)q : cells;
+}
+
+uint64_t SpaceFillingCurve::Spread2(uint32_t value)
+{
+    uint64_t v = value;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v << 2)) & 0x3333333333333333ULL;
+    v = (v | (v << 1)) & 0x5555555555555555ULL;
+    return v;
+}
+
+uint64_t SpaceFillingCurve::Spread3(uint32_t value)
+{
+    uint64_t v = value & 0x1FFFFF;
+    v = (v | (v << 32)) & 0x001F00000000FFFFULL;
+    v = (v | (v << 16)) & 0x001F0000FF0000FFULL;
+    v = (v | (v << 8)) & 0x100F00F00F00F00FULL;
+    v = (v | (v << 4)) & 0x10C30C30C30C30C3ULL;
+    v = (v | (v << 2)) & 0x1249249249249249ULL;
+    return v;
+}
+
+uint32_t SpaceFillingCurve::SuffixParity(uint32_t value)
+{
+    // Bit i of the result is the parity of the bits of value above bit i
+    uint32_t v = value >> 1;
+    v ^= v >> 1;
+    v ^= v >> 2;
+    v ^= v >> 4;
+    v ^= v >> 8;
+    v ^= v >> 16;
+    return v;
+}
+
+void SpaceFillingCurve::Transpose(uint32_t &x, uint32_t &y)
+{
+    // Skilling, Programming the Hilbert Curve, AxestoTranspose. The branches
+    // of the original are replaced with masks, since they are unpredictable:
+    // if bit q of an axis is set the low bits of x are inverted, otherwise
+    // they are exchanged with the low bits of that axis
+    for (uint32_t q = 1U << 31; q > 1; q >>= 1)
+    {
+        uint32_t p = q - 1;
+        x ^= p & (0U - ((x & q) != 0));
+        uint32_t set = 0U - ((y & q) != 0);
+        uint32_t t = (x ^ y) & p & ~set;
+        x ^= (p & set) | t;
+        y ^= t;
+    }
+    y ^= x;
+    uint32_t t = SuffixParity(y);
+    x ^= t;
+    y ^= t;
+}
+
+void SpaceFillingCurve::Transpose(uint32_t &x, uint32_t &y, uint32_t &z)
+{
+    // The same as above, for three axes of 21 bits
+    for (uint32_t q = 1U << 20; q > 1; q >>= 1)
+    {
+        uint32_t p = q - 1;
+        x ^= p & (0U - ((x & q) != 0));
+        uint32_t set = 0U - ((y & q) != 0);
+        uint32_t t = (x ^ y) & p & ~set;
+        x ^= (p & set) | t;
+        y ^= t;
+        set = 0U - ((z & q) != 0);
+        t = (x ^ z) & p & ~set;
+        x ^= (p & set) | t;
+        z ^= t;
+    }
+    y ^= x;
+    z ^= y;
+    uint32_t t = SuffixParity(z);
+    x ^= t;
+    y ^= t;
+    z ^= t;
+}
@@ -0,0 +1,416 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a uniform spatial hash grid over 3D points, meant to
+ *  be rebuilt every frame for neighbour and radius queries.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "DenormalGuard.hpp"
+#include "Parallel.hpp"
+#include "Vector3.hpp"
+#include "Vector3Array.hpp"
+
+
+/**
+ * Points are hashed by the cell they fall in to one of TableSize buckets,
+ * then counting sorted by bucket. The points of bucket b are stored at
+ * positions CellStart[b] up to CellStart[b + 1] of Indices (their index in
+ * the input) and Points (their positions, in the same order). Several cells
+ * may share a bucket, so a bucket can hold points that are not in the cell
+ * that was asked for.
+ */
+struct SpatialGrid
+{
+    double CellSize;
+    size_t TableSize;
+    std::vector<unsigned int> CellStart;
+    std::vector<unsigned int> Indices;
+    Vector3Array Points;
+    std::vector<unsigned int> Keys;
+    std::vector<unsigned int> GroupKeys;
+    std::vector<unsigned int> GroupIndices;
+    std::vector<unsigned int> GroupStart;
+    std::vector<unsigned int> Histogram;
+
+
+    /**
+     * Ranges with at least ParallelGrain points (or queries) are processed on
+     * multiple threads.
+     */
+    static constexpr size_t ParallelGrain = 1 << 15;
+
+    /**
+     * Rebuild sorts in two passes: first by the group of 1 << GroupBits
+     * consecutive buckets that a point's bucket lies in, and then each group
+     * by bucket on its own.
+     */
+    static constexpr size_t GroupBits = 12;
+
+
+    /**
+     * Constructors.
+     */
+    inline SpatialGrid();
+    inline explicit SpatialGrid(double cellSize);
+
+
+    /**
+     * Returns the bucket that a cell hashes to.
+     * @param grid: The grid in question.
+     * @param x: The cell coordinate on the X axis.
+     * @param y: The cell coordinate on the Y axis.
+     * @param z: The cell coordinate on the Z axis.
+     * @return: A bucket index.
+     */
+    static inline size_t Bucket(const SpatialGrid &grid, int64_t x, int64_t y,
+                                int64_t z);
+
+    /**
+     * Returns the cell coordinate of a value along one axis.
+     * @param grid: The grid in question.
+     * @param value: The position along the axis.
+     * @return: A cell coordinate.
+     */
+    static inline int64_t Cell(const SpatialGrid &grid, double value);
+
+    /**
+     * Calls visit(index, position) for every point in the cell containing
+     * "point" and the 26 cells around it. When the radius of interest is no
+     * larger than the cell size, this visits every neighbour (along with
+     * some points that are farther away).
+     * @param grid: The grid to search.
+     * @param point: The query point.
+     * @param visit: The function to call on each point.
+     */
+    template <typename F>
+    static inline void ForEachNeighbour(const SpatialGrid &grid,
+                                        Vector3 point, F visit);
+
+    /**
+     * Finds every point within a radius of a query point, in no particular
+     * order.
+     * @param grid: The grid to search.
+     * @param point: The query point.
+     * @param radius: The search radius.
+     * @param indices: The output list, which the indices are appended to.
+     */
+    static inline void Radius(const SpatialGrid &grid, Vector3 point,
+                              double radius, std::vector<size_t> &indices);
+
+    /**
+     * Finds every point within a radius of each of many query points,
+     * spread across threads. The results for query i are
+     * indices[offsets[i]] up to indices[offsets[i + 1]].
+     * @param grid: The grid to search.
+     * @param points: The query points.
+     * @param count: The number of query points.
+     * @param radius: The search radius.
+     * @param offsets: The output offsets, count + 1 of them.
+     * @param indices: The output point indices.
+     */
+    static inline void Radius(const SpatialGrid &grid, const Vector3 *points,
+                              size_t count, double radius,
+                              std::vector<size_t> &offsets,
+                              std::vector<size_t> &indices);
+
+    /**
+     * Rebuilds a grid from a new set of points in O(n) time, using a
+     * parallel counting sort. Storage from the previous build is reused.
+     * @param grid: The grid to rebuild.
+     * @param points: The points.
+     * @param count: The number of points.
+     */
+    static inline void Rebuild(SpatialGrid &grid, const Vector3 *points,
+                               size_t count);
+
+
+    /**
+     * Helpers used by the queries.
+     */
+    template <typename F>
+    static inline void ForEachBucket(const SpatialGrid &grid, int64_t x0,
+                                     int64_t y0, int64_t z0, int64_t x1,
+                                     int64_t y1, int64_t z1, F visit);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+SpatialGrid::SpatialGrid() : SpatialGrid(1) {}
+SpatialGrid::SpatialGrid(double cellSize) : CellSize(cellSize), TableSize(1),
+    CellStart(2, 0) {}
+
+
+size_t SpatialGrid::Bucket(const SpatialGrid &grid, int64_t x, int64_t y,
+                           int64_t z)
+{
+    // Teschner et al., Optimized Spatial Hashing for Collision Detection
+    uint64_t h = ((uint64_t)x * 73856093) ^ ((uint64_t)y * 19349663) ^
+        ((uint64_t)z * 83492791);
+    return (size_t)(h & (grid.TableSize - 1));
+}
+
+int64_t SpatialGrid::Cell(const SpatialGrid &grid, double value)
+{
+    return (int64_t)floor(value / grid.CellSize);
+}
+
+template <typename F>
+void SpatialGrid::ForEachNeighbour(const SpatialGrid &grid, Vector3 point,
+                                   F visit)
+{
+    int64_t x = Cell(grid, point.X);
+    int64_t y = Cell(grid, point.Y);
+    int64_t z = Cell(grid, point.Z);
+    ForEachBucket(grid, x - 1, y - 1, z - 1, x + 1, y + 1, z + 1,
+                  [&](size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                          visit((size_t)grid.Indices[i],
+                                Vector3Array::Get(grid.Points, i));
+                  });
+}
+
+void SpatialGrid::Radius(const SpatialGrid &grid, Vector3 point,
+                         double radius, std::vector<size_t> &indices)
+{
+    if (radius < 0)
+        return;
+    double radiusSqr = radius * radius;
+    const double *x = grid.Points.X.data();
+    const double *y = grid.Points.Y.data();
+    const double *z = grid.Points.Z.data();
+    ForEachBucket(grid, Cell(grid, point.X - radius),
+                  Cell(grid, point.Y - radius), Cell(grid, point.Z - radius),
+                  Cell(grid, point.X + radius), Cell(grid, point.Y + radius),
+                  Cell(grid, point.Z + radius),
+                  [&](size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          double dx = x[i] - point.X;
+                          double dy = y[i] - point.Y;
+                          double dz = z[i] - point.Z;
+                          if (dx * dx + dy * dy + dz * dz <= radiusSqr)
+                              indices.push_back(grid.Indices[i]);
+                      }
+                  });
+}
+
+void SpatialGrid::Radius(const SpatialGrid &grid, const Vector3 *points,
+                         size_t count, double radius,
+                         std::vector<size_t> &offsets,
+                         std::vector<size_t> &indices)
+{
+    size_t grain = ParallelGrain / 16;
+    size_t chunks = Parallel::Chunks(count, grain);
+    std::vector<std::vector<size_t> > chunkIndices(chunks);
+    std::vector<size_t> chunkBegin(chunks);
+    offsets.assign(count + 1, 0);
+    Parallel::For(count, grain,
+                  [&](size_t chunk, size_t begin, size_t end)
+                  {
+                      DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+                      DenormalGuard::Inspect((const double *)(points + begin),
+                                             3 * (end - begin));
+                      chunkBegin[chunk] = begin;
+                      std::vector<size_t> &found = chunkIndices[chunk];
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          size_t before = found.size();
+                          Radius(grid, points[i], radius, found);
+                          offsets[i + 1] = found.size() - before;
+                      }
+                  });
+    for (size_t i = 0; i < count; i++)
+        offsets[i + 1] += offsets[i];
+    indices.resize(offsets[count]);
+    for (size_t c = 0; c < chunks; c++)
+        std::copy(chunkIndices[c].begin(), chunkIndices[c].end(),
+                  indices.begin() + offsets[chunkBegin[c]]);
+}
+
+void SpatialGrid::Rebuild(SpatialGrid &grid, const Vector3 *points,
+                          size_t count)
+{
+    size_t tableSize = 1;
+    while (tableSize < count)
+        tableSize <<= 1;
+    grid.TableSize = tableSize;
+    size_t groupSize = std::min(tableSize, (size_t)1 << GroupBits);
+    size_t groups = tableSize / groupSize;
+    size_t chunks = Parallel::Chunks(count, ParallelGrain);
+    grid.Keys.resize(count);
+    grid.GroupKeys.resize(count);
+    grid.GroupIndices.resize(count);
+    grid.Indices.resize(count);
+    Vector3Array::Resize(grid.Points, count);
+    grid.CellStart.resize(tableSize + 1);
+    grid.GroupStart.assign(groups + 1, 0);
+    grid.Histogram.assign(chunks * groups, 0);
+
+    // Count the points in each group of buckets, separately for each chunk
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t chunk, size_t begin, size_t end)
+                  {
+                      unsigned int *histogram =
+                          grid.Histogram.data() + chunk * groups;
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          unsigned int key = (unsigned int)Bucket(grid,
+                              Cell(grid, points[i].X),
+                              Cell(grid, points[i].Y),
+                              Cell(grid, points[i].Z));
+                          grid.Keys[i] = key;
+                          histogram[key >> GroupBits]++;
+                      }
+                  });
+
+    // Turn the counts into the offset of each chunk within each group, and
+    // then the groups into their first output slot
+    Parallel::For(groups, ParallelGrain / 16,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      unsigned int *totals = grid.GroupStart.data() + 1;
+                      for (size_t c = 0; c < chunks; c++)
+                      {
+                          unsigned int *histogram =
+                              grid.Histogram.data() + c * groups;
+                          for (size_t g = begin; g < end; g++)
+                          {
+                              unsigned int n = histogram[g];
+                              histogram[g] = totals[g];
+                              totals[g] += n;
+                          }
+                      }
+                  });
+    for (size_t g = 0; g < groups; g++)
+        grid.GroupStart[g + 1] += grid.GroupStart[g];
+
+    // Scatter the keys into their groups, keeping their input order
+    Parallel::For(count, ParallelGrain,
+                  [&](size_t chunk, size_t begin, size_t end)
+                  {
+                      unsigned int *slots =
+                          grid.Histogram.data() + chunk * groups;
+                      for (size_t i = begin; i < end; i++)
+                      {
+                          unsigned int key = grid.Keys[i];
+                          unsigned int slot = grid.GroupStart[key >>
+                              GroupBits] + slots[key >> GroupBits]++;
+                          grid.GroupKeys[slot] = key;
+                          grid.GroupIndices[slot] = (unsigned int)i;
+                      }
+                  });
+
+    // Counting sort each group on its own, so the buckets being counted and
+    // written fit in cache
+    size_t groupGrain = count > 0 ? ParallelGrain * groups / count : 1;
+    Parallel::For(groups, groupGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      for (size_t g = begin; g < end; g++)
+                      {
+                          unsigned int *starts =
+                              grid.CellStart.data() + g * groupSize;
+                          std::fill(starts, starts + groupSize, 0);
+                          size_t first = grid.GroupStart[g];
+                          size_t last = grid.GroupStart[g + 1];
+                          for (size_t i = first; i < last; i++)
+                              starts[grid.GroupKeys[i] & (groupSize - 1)]++;
+                          unsigned int total = (unsigned int)first;
+                          for (size_t b = 0; b < groupSize; b++)
+                          {
+                              unsigned int n = starts[b];
+                              starts[b] = total;
+                              total += n;
+                          }
+                          for (size_t i = first; i < last; i++)
+                          {
+                              unsigned int slot =
+                                  starts[grid.GroupKeys[i] &
+                                         (groupSize - 1)]++;
+                              unsigned int index = grid.GroupIndices[i];
+                              grid.Indices[slot] = index;
+                              grid.Points.X[slot] = points[index].X;
+                              grid.Points.Y[slot] = points[index].Y;
+                              grid.Points.Z[slot] = points[index].Z;
+                          }
+                          // Scattering moved each start to the next bucket's
+                          for (size_t b = groupSize - 1; b > 0; b--)
+                              starts[b] = starts[b - 1];
+                          starts[0] = (unsigned int)first;
+                      }
+                  });
+    grid.CellStart[tableSize] = (unsigned int)count;
+}
+
+
+template <typename F>
+void SpatialGrid::ForEachBucket(const SpatialGrid &grid, int64_t x0,
+                                int64_t y0, int64_t z0, int64_t x1,
+                                int64_t y1, int64_t z1, F visit)
+{
+    // Different cells can hash to the same bucket, so each bucket is only
+    // visited the first time it comes up
+    double cells = (double)(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+    if (cells >= grid.TableSize)
+    {
+        for (size_t b = 0; b < grid.TableSize; b++)
+            if (grid.CellStart[b] < grid.CellStart[b + 1])
+                visit((size_t)grid.CellStart[b], (size_t)grid.CellStart[b + 1]);
+        return;
+    }
+    size_t buckets[27];
+    std::vector<size_t> many;
+    size_t *list = buckets;
+    if (cells > 27)
+    {
+        many.resize((size_t)cells);
+        list = many.data();
+    }
+    size_t n = 0;
+    for (int64_t x = x0; x <= x1; x++)
+        for (int64_t y = y0; y <= y1; y++)
+            for (int64_t z = z0; z <= z1; z++)
+                list[n++] = Bucket(grid, x, y, z);
+    std::sort(list, list + n);
+    n = std::unique(list, list + n) - list;
+    for (size_t i = 0; i < n; i++)
+        if (grid.CellStart[list[i]] < grid.CellStart[list[i] + 1])
+            visit((size_t)grid.CellStart[list[i]],
+                  (size_t)grid.CellStart[list[i] + 1]);
+}
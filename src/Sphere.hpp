@@ -0,0 +1,341 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a sphere, with ray intersection tests for single
+ *  spheres and for arrays of spheres or rays.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <algorithm>
+#include "DenormalGuard.hpp"
+#include "Ray.hpp"
+#include "Vector3.hpp"
+#include "Vector3Array.hpp"
+
+
+struct Sphere
+{
+    Vector3 Center;
+    double Radius;
+
+    // The number of intersections computed at a time by the batch kernels
+    static constexpr size_t BlockSize = 256;
+
+
+    /**
+     * Constructors.
+     */
+    inline Sphere();
+    inline Sphere(Vector3 center, double radius);
+
+
+    /**
+     * Returns true if a point is inside or on the surface of a sphere.
+     * @param sphere: The sphere in question.
+     * @param point: The point in question.
+     * @return: A boolean.
+     */
+    static inline bool Contains(Sphere sphere, Vector3 point);
+
+    /**
+     * Returns the signed distance from the surface of a sphere to a point,
+     * which is negative inside the sphere.
+     * @param sphere: The sphere in question.
+     * @param point: The point in question.
+     * @return: A scalar value.
+     */
+    static inline double Distance(Sphere sphere, Vector3 point);
+
+    /**
+     * Returns true if two spheres overlap or touch.
+     * @param a: The first sphere.
+     * @param b: The second sphere.
+     * @return: A boolean.
+     */
+    static inline bool Overlaps(Sphere a, Sphere b);
+
+    /**
+     * Intersects a ray with a sphere. The entry point is found without the
+     * cancellation of the textbook quadratic formula, so rays from far away
+     * still hit small spheres accurately.
+     * @param sphere: The sphere to test.
+     * @param ray: The ray, whose direction must not be zero.
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param distance: The ray parameter where the ray enters the sphere,
+     * or zero if it starts inside.
+     * @return: True if the ray hits the sphere.
+     */
+    static inline bool Raycast(Sphere sphere, Ray ray, double maxDistance,
+                               double &distance);
+
+    /**
+     * Intersects one ray with an array of spheres.
+     * @param centers: The centers of the spheres.
+     * @param radii: The radii of the spheres.
+     * @param ray: The ray, whose direction must not be zero.
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param hits: The output hit flags, one per sphere.
+     * @param distances: The output entry distances, one per sphere. These
+     * are only meaningful where the hit flag is set.
+     */
+    static inline void Raycast(const Vector3Array &centers,
+                               const double *radii, Ray ray,
+                               double maxDistance, bool *hits,
+                               double *distances);
+
+    /**
+     * Intersects an array of rays with one sphere.
+     * @param sphere: The sphere to test.
+     * @param origins: The origins of the rays.
+     * @param directions: The directions of the rays, none of them zero.
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param hits: The output hit flags, one per ray.
+     * @param distances: The output entry distances, one per ray. These are
+     * only meaningful where the hit flag is set.
+     */
+    static inline void Raycast(Sphere sphere, const Vector3Array &origins,
+                               const Vector3Array &directions,
+                               double maxDistance, bool *hits,
+                               double *distances);
+
+    /**
+     * Helpers for the implementation.
+     * The block takes the terms of the intersection equation for BlockSize
+     * lanes, of which the first count are written out.
+     */
+    static inline void RaycastBlock(const double *b, const double *c,
+                                    const double *disc, double *root,
+                                    size_t count, double maxDistance,
+                                    bool *hits, double *distances);
+};
+
+inline bool operator==(const Sphere lhs, const Sphere rhs);
+inline bool operator!=(const Sphere lhs, const Sphere rhs);
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+Sphere::Sphere() : Center(0, 0, 0), Radius(1) {}
+Sphere::Sphere(Vector3 center, double radius) : Center(center),
+    Radius(radius) {}
+
+
+bool Sphere::Contains(Sphere sphere, Vector3 point)
+{
+    return Vector3::SqrMagnitude(point - sphere.Center) <=
+        sphere.Radius * sphere.Radius;
+}
+
+double Sphere::Distance(Sphere sphere, Vector3 point)
+{
+    return Vector3::Distance(point, sphere.Center) - sphere.Radius;
+}
+
+bool Sphere::Overlaps(Sphere a, Sphere b)
+{
+    double r = a.Radius + b.Radius;
+    return Vector3::SqrMagnitude(a.Center - b.Center) <= r * r;
+}
+
+bool Sphere::Raycast(Sphere sphere, Ray ray, double maxDistance,
+                     double &distance)
+{
+    // The same terms as RaycastBlock, which explains them
+    Vector3 f = ray.Origin - sphere.Center;
+    Vector3 d = ray.Direction;
+    double rr = sphere.Radius * sphere.Radius;
+    double b = Vector3::Dot(f, d);
+    double c = Vector3::SqrMagnitude(f) - rr;
+    if (c <= 0)
+    {
+        distance = 0;
+        return true;
+    }
+    double disc = Vector3::SqrMagnitude(d) * rr -
+        Vector3::SqrMagnitude(Vector3::Cross(f, d));
+    if (disc < 0 || b >= 0)
+        return false;
+    distance = c / (sqrt(disc) - b);
+    return distance <= maxDistance;
+}
+
+void Sphere::Raycast(const Vector3Array &centers, const double *radii,
+                     Ray ray, double maxDistance, bool *hits,
+                     double *distances)
+{
+    size_t count = Vector3Array::Size(centers);
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect(centers.X.data(), count);
+    DenormalGuard::Inspect(centers.Y.data(), count);
+    DenormalGuard::Inspect(centers.Z.data(), count);
+    DenormalGuard::Inspect(radii, count);
+    double px[BlockSize], py[BlockSize], pz[BlockSize], pr[BlockSize];
+    double b[BlockSize], c[BlockSize], disc[BlockSize], root[BlockSize];
+    Vector3 o = ray.Origin;
+    Vector3 d = ray.Direction;
+    double a = Vector3::SqrMagnitude(d);
+    for (size_t s = 0; s < count; s += BlockSize)
+    {
+        size_t n = count - s < BlockSize ? count - s : BlockSize;
+        const double *x = centers.X.data() + s;
+        const double *y = centers.Y.data() + s;
+        const double *z = centers.Z.data() + s;
+        const double *r = radii + s;
+        if (n < BlockSize)
+        {
+            x = Vector3Array::PadBlock(x, n, BlockSize, px);
+            y = Vector3Array::PadBlock(y, n, BlockSize, py);
+            z = Vector3Array::PadBlock(z, n, BlockSize, pz);
+            r = Vector3Array::PadBlock(r, n, BlockSize, pr);
+        }
+
+        // See RaycastBlock for the terms
+        for (size_t i = 0; i < BlockSize; i++)
+        {
+            double fx = o.X - x[i], fy = o.Y - y[i], fz = o.Z - z[i];
+            double rr = r[i] * r[i];
+            double lx = fy * d.Z - fz * d.Y;
+            double ly = fz * d.X - fx * d.Z;
+            double lz = fx * d.Y - fy * d.X;
+            b[i] = fx * d.X + fy * d.Y + fz * d.Z;
+            c[i] = fx * fx + fy * fy + fz * fz - rr;
+            disc[i] = a * rr - (lx * lx + ly * ly + lz * lz);
+        }
+        RaycastBlock(b, c, disc, root, n, maxDistance, hits + s,
+                     distances + s);
+    }
+}
+
+void Sphere::Raycast(Sphere sphere, const Vector3Array &origins,
+                     const Vector3Array &directions, double maxDistance,
+                     bool *hits, double *distances)
+{
+    size_t count = Vector3Array::Size(origins);
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect(origins.X.data(), count);
+    DenormalGuard::Inspect(origins.Y.data(), count);
+    DenormalGuard::Inspect(origins.Z.data(), count);
+    DenormalGuard::Inspect(directions.X.data(), count);
+    DenormalGuard::Inspect(directions.Y.data(), count);
+    DenormalGuard::Inspect(directions.Z.data(), count);
+    double pox[BlockSize], poy[BlockSize], poz[BlockSize];
+    double pdx[BlockSize], pdy[BlockSize], pdz[BlockSize];
+    double b[BlockSize], c[BlockSize], disc[BlockSize], root[BlockSize];
+    Vector3 center = sphere.Center;
+    double rr = sphere.Radius * sphere.Radius;
+    for (size_t s = 0; s < count; s += BlockSize)
+    {
+        size_t n = count - s < BlockSize ? count - s : BlockSize;
+        const double *ox = origins.X.data() + s;
+        const double *oy = origins.Y.data() + s;
+        const double *oz = origins.Z.data() + s;
+        const double *dx = directions.X.data() + s;
+        const double *dy = directions.Y.data() + s;
+        const double *dz = directions.Z.data() + s;
+        if (n < BlockSize)
+        {
+            ox = Vector3Array::PadBlock(ox, n, BlockSize, pox);
+            oy = Vector3Array::PadBlock(oy, n, BlockSize, poy);
+            oz = Vector3Array::PadBlock(oz, n, BlockSize, poz);
+            dx = Vector3Array::PadBlock(dx, n, BlockSize, pdx);
+            dy = Vector3Array::PadBlock(dy, n, BlockSize, pdy);
+            dz = Vector3Array::PadBlock(dz, n, BlockSize, pdz);
+        }
+
+        // See RaycastBlock for the terms
+        for (size_t i = 0; i < BlockSize; i++)
+        {
+            double fx = ox[i] - center.X;
+            double fy = oy[i] - center.Y;
+            double fz = oz[i] - center.Z;
+            double a = dx[i] * dx[i] + dy[i] * dy[i] + dz[i] * dz[i];
+            double lx = fy * dz[i] - fz * dy[i];
+            double ly = fz * dx[i] - fx * dz[i];
+            double lz = fx * dy[i] - fy * dx[i];
+            b[i] = fx * dx[i] + fy * dy[i] + fz * dz[i];
+            c[i] = fx * fx + fy * fy + fz * fz - rr;
+            disc[i] = a * rr - (lx * lx + ly * ly + lz * lz);
+        }
+        RaycastBlock(b, c, disc, root, n, maxDistance, hits + s,
+                     distances + s);
+    }
+}
+
+void Sphere::RaycastBlock(const double *b, const double *c,
+                          const double *disc, double *root, size_t count,
+                          double maxDistance, bool *hits, double *distances)
+{
+    // With f the ray origin relative to the center, d the direction and r
+    // the radius, the hits solve a t^2 + 2 b t + c = 0 where a = d.d,
+    // b = f.d and c = f.f - r^2. The discriminant b^2 - a c is passed in as
+    // a r^2 - |f x d|^2, and the cross product holds only the part of f
+    // perpendicular to the ray, so unlike b^2 - a c it does not cancel
+    // when the ray starts far from a small sphere.
+    //
+    // The square roots get their own loop, as their error handling keeps a
+    // loop from vectorizing. Lanes that miss skip them.
+    for (size_t i = 0; i < BlockSize; i++)
+        root[i] = disc[i] > 0 ? sqrt(disc[i]) : 0;
+
+    // The nearer root is c / q with q = -b + sqrt(disc), which is stable
+    // when the ray points toward the sphere (b < 0). The hit flags are
+    // built from selects, which vectorize where boolean logic does not.
+    // Full blocks write their distances straight to the output.
+    double t[BlockSize], hit[BlockSize];
+    double *output = count == BlockSize ? distances : t;
+    for (size_t i = 0; i < BlockSize; i++)
+    {
+        double q = root[i] - b[i];
+        double entry = c[i] / q;
+        double h = entry <= maxDistance ? 1 : 0;
+        h = b[i] < 0 ? h : 0;
+        h = disc[i] >= 0 ? h : 0;
+        output[i] = c[i] <= 0 ? 0 : entry;
+        hit[i] = c[i] <= 0 ? 1 : h;
+    }
+
+    for (size_t i = 0; i < count; i++)
+        hits[i] = hit[i] != 0;
+    if (count < BlockSize)
+        std::copy(t, t + count, distances);
+}
+
+
+bool operator==(const Sphere lhs, const Sphere rhs)
+{
+    return lhs.Center == rhs.Center && lhs.Radius == rhs.Radius;
+}
+
+bool operator!=(const Sphere lhs, const Sphere rhs)
+{
+    return !(lhs == rhs);
+}
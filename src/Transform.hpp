@@ -0,0 +1,417 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a transform stored as a position, rotation and
+ *  scale, which caches the matrices derived from its rotation and scale
+ *  until either of them changes.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include "DenormalGuard.hpp"
+#include "Matrix3x3.hpp"
+#include "Matrix4x4.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+
+
+/**
+ * A transform scales, then rotates, then translates. It caches the matrices
+ * that apply it, each of which is rebuilt on first use after the rotation or
+ * scale changes, so the position, rotation and scale are only written
+ * through SetPosition, SetRotation and SetScale. Reading a transform from
+ * several threads at once is only safe after Update has been called on it.
+ */
+struct Transform
+{
+    /**
+     * Constructors.
+     */
+    inline Transform();
+    inline Transform(Vector3 position, Quaternion rotation = Quaternion(),
+                     Vector3 scale = Vector3(1, 1, 1));
+
+
+    /**
+     * Returns the transform which applies "child" and then "parent". If the
+     * parent has a non-uniform scale and the child is rotated relative to
+     * it, the combination contains a shear which a position, rotation and
+     * scale cannot hold; the result then keeps the product of the scales,
+     * as most scene graphs do.
+     * @param parent: The outer transform.
+     * @param child: The inner transform.
+     * @return: A new transform.
+     */
+    static inline Transform Compose(const Transform &parent,
+                                    const Transform &child);
+
+    /**
+     * Returns the inverse of a transform. As with Compose, this is exact
+     * unless the scale is non-uniform and the transform is rotated.
+     * @param transform: The input transform.
+     * @return: A new transform.
+     */
+    static inline Transform Inverse(const Transform &transform);
+
+    /**
+     * Marks every cached matrix as out of date.
+     * @param transform: The transform to update.
+     */
+    static inline void Invalidate(Transform &transform);
+
+    /**
+     * Maps a point from the space a transform leads to back to the space it
+     * was applied in, using the cached inverse matrix.
+     * @param transform: The transform.
+     * @param point: The point to transform.
+     * @return: A new point.
+     */
+    static inline Vector3 InverseTransformPoint(const Transform &transform,
+                                                Vector3 point);
+
+    /**
+     * Returns the cached matrices, rebuilding them first if needed.
+     * GetLinear returns rotation times scale, GetInverse its inverse and
+     * GetNormal its inverse-transpose.
+     * @param transform: The transform.
+     * @return: A matrix.
+     */
+    static inline const Matrix3x3& GetInverse(const Transform &transform);
+    static inline const Matrix3x3& GetLinear(const Transform &transform);
+    static inline const Matrix3x3& GetNormal(const Transform &transform);
+    static inline const Matrix3x3& GetRotationMatrix(
+        const Transform &transform);
+
+    /**
+     * Returns the position, rotation or scale of a transform.
+     * @param transform: The transform.
+     * @return: The value.
+     */
+    static inline Vector3 GetPosition(const Transform &transform);
+    static inline Quaternion GetRotation(const Transform &transform);
+    static inline Vector3 GetScale(const Transform &transform);
+
+    /**
+     * Sets the position, rotation or scale of a transform.
+     * @param transform: The transform to change.
+     * @param value: The new value.
+     */
+    static inline void SetPosition(Transform &transform, Vector3 value);
+    static inline void SetRotation(Transform &transform, Quaternion value);
+    static inline void SetScale(Transform &transform, Vector3 value);
+
+    /**
+     * Returns the affine matrix of a transform.
+     * @param transform: The transform.
+     * @return: A new matrix.
+     */
+    static inline Matrix4x4 ToMatrix4x4(const Transform &transform);
+
+    /**
+     * Applies the rotation and scale of a transform to a direction, ignoring
+     * the position.
+     * @param transform: The transform.
+     * @param direction: The direction to transform.
+     * @return: A new direction.
+     */
+    static inline Vector3 TransformDirection(const Transform &transform,
+                                             Vector3 direction);
+
+    /**
+     * Applies a transform to an array of directions. The output may be the
+     * same array as the input.
+     * @param transform: The transform.
+     * @param directions: The directions to transform.
+     * @param count: The number of directions.
+     * @param output: The output array, which must hold "count" directions.
+     */
+    static inline void TransformDirections(const Transform &transform,
+                                           const Vector3 *directions,
+                                           size_t count, Vector3 *output);
+
+    /**
+     * Transforms a surface normal by the inverse-transpose of the rotation
+     * and scale, so that it stays perpendicular to the transformed surface.
+     * The result is not normalized, since non-uniform scale changes its
+     * length.
+     * @param transform: The transform.
+     * @param normal: The normal to transform.
+     * @return: A new normal.
+     */
+    static inline Vector3 TransformNormal(const Transform &transform,
+                                          Vector3 normal);
+
+    /**
+     * Transforms an array of normals, as TransformNormal does. The output
+     * may be the same array as the input.
+     * @param transform: The transform.
+     * @param normals: The normals to transform.
+     * @param count: The number of normals.
+     * @param output: The output array, which must hold "count" normals.
+     */
+    static inline void TransformNormals(const Transform &transform,
+                                        const Vector3 *normals, size_t count,
+                                        Vector3 *output);
+
+    /**
+     * Applies a transform to a point.
+     * @param transform: The transform.
+     * @param point: The point to transform.
+     * @return: A new point.
+     */
+    static inline Vector3 TransformPoint(const Transform &transform,
+                                         Vector3 point);
+
+    /**
+     * Applies a transform to an array of points. The output may be the same
+     * array as the input.
+     * @param transform: The transform.
+     * @param points: The points to transform.
+     * @param count: The number of points.
+     * @param output: The output array, which must hold "count" points.
+     */
+    static inline void TransformPoints(const Transform &transform,
+                                       const Vector3 *points, size_t count,
+                                       Vector3 *output);
+
+    /**
+     * Rebuilds every out of date cached matrix.
+     * @param transform: The transform to update.
+     */
+    static inline void Update(const Transform &transform);
+
+private:
+    Vector3 Position;
+    Quaternion Rotation;
+    Vector3 Scale;
+    mutable Matrix3x3 RotationMatrix;
+    mutable Matrix3x3 LinearMatrix;
+    mutable Matrix3x3 InverseMatrix;
+    mutable Matrix3x3 NormalMatrix;
+    mutable unsigned char Dirty;
+
+    // The bits of Dirty, one for each cached matrix
+    static constexpr unsigned char RotationDirty = 1;
+    static constexpr unsigned char LinearDirty = 2;
+    static constexpr unsigned char InverseDirty = 4;
+    static constexpr unsigned char NormalDirty = 8;
+    static constexpr unsigned char AllDirty = 15;
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+Transform::Transform() : Position(0, 0, 0), Rotation(), Scale(1, 1, 1),
+    Dirty(AllDirty) {}
+Transform::Transform(Vector3 position, Quaternion rotation, Vector3 scale) :
+    Position(position), Rotation(rotation), Scale(scale), Dirty(AllDirty) {}
+
+
+Transform Transform::Compose(const Transform &parent, const Transform &child)
+{
+    return Transform(TransformPoint(parent, child.Position),
+                     parent.Rotation * child.Rotation,
+                     Vector3(parent.Scale.X * child.Scale.X,
+                             parent.Scale.Y * child.Scale.Y,
+                             parent.Scale.Z * child.Scale.Z));
+}
+
+Transform Transform::Inverse(const Transform &transform)
+{
+    return Transform(-(GetInverse(transform) * transform.Position),
+                     Quaternion::Inverse(transform.Rotation),
+                     Vector3(1 / transform.Scale.X, 1 / transform.Scale.Y,
+                             1 / transform.Scale.Z));
+}
+
+void Transform::Invalidate(Transform &transform)
+{
+    transform.Dirty = AllDirty;
+}
+
+Vector3 Transform::InverseTransformPoint(const Transform &transform,
+                                         Vector3 point)
+{
+    return GetInverse(transform) * (point - transform.Position);
+}
+
+const Matrix3x3& Transform::GetInverse(const Transform &transform)
+{
+    if (transform.Dirty & InverseDirty)
+    {
+        // The transpose of the rotation with each row divided by the scale
+        Matrix3x3 m = Matrix3x3::Transpose(GetRotationMatrix(transform));
+        Vector3 s = transform.Scale;
+        m.D00 /= s.X; m.D01 /= s.X; m.D02 /= s.X;
+        m.D10 /= s.Y; m.D11 /= s.Y; m.D12 /= s.Y;
+        m.D20 /= s.Z; m.D21 /= s.Z; m.D22 /= s.Z;
+        transform.InverseMatrix = m;
+        transform.Dirty &= ~InverseDirty;
+    }
+    return transform.InverseMatrix;
+}
+
+const Matrix3x3& Transform::GetLinear(const Transform &transform)
+{
+    if (transform.Dirty & LinearDirty)
+    {
+        // The rotation with each column multiplied by the scale
+        Matrix3x3 m = GetRotationMatrix(transform);
+        Vector3 s = transform.Scale;
+        m.D00 *= s.X; m.D01 *= s.Y; m.D02 *= s.Z;
+        m.D10 *= s.X; m.D11 *= s.Y; m.D12 *= s.Z;
+        m.D20 *= s.X; m.D21 *= s.Y; m.D22 *= s.Z;
+        transform.LinearMatrix = m;
+        transform.Dirty &= ~LinearDirty;
+    }
+    return transform.LinearMatrix;
+}
+
+const Matrix3x3& Transform::GetNormal(const Transform &transform)
+{
+    if (transform.Dirty & NormalDirty)
+    {
+        // The rotation with each column divided by the scale
+        Matrix3x3 m = GetRotationMatrix(transform);
+        Vector3 s = transform.Scale;
+        m.D00 /= s.X; m.D01 /= s.Y; m.D02 /= s.Z;
+        m.D10 /= s.X; m.D11 /= s.Y; m.D12 /= s.Z;
+        m.D20 /= s.X; m.D21 /= s.Y; m.D22 /= s.Z;
+        transform.NormalMatrix = m;
+        transform.Dirty &= ~NormalDirty;
+    }
+    return transform.NormalMatrix;
+}
+
+const Matrix3x3& Transform::GetRotationMatrix(const Transform &transform)
+{
+    if (transform.Dirty & RotationDirty)
+    {
+        transform.RotationMatrix = Matrix3x3::FromQuaternion(
+            transform.Rotation);
+        transform.Dirty &= ~RotationDirty;
+    }
+    return transform.RotationMatrix;
+}
+
+Vector3 Transform::GetPosition(const Transform &transform)
+{
+    return transform.Position;
+}
+
+Quaternion Transform::GetRotation(const Transform &transform)
+{
+    return transform.Rotation;
+}
+
+Vector3 Transform::GetScale(const Transform &transform)
+{
+    return transform.Scale;
+}
+
+void Transform::SetPosition(Transform &transform, Vector3 value)
+{
+    transform.Position = value;
+}
+
+void Transform::SetRotation(Transform &transform, Quaternion value)
+{
+    transform.Rotation = value;
+    transform.Dirty = AllDirty;
+}
+
+void Transform::SetScale(Transform &transform, Vector3 value)
+{
+    transform.Scale = value;
+    transform.Dirty |= LinearDirty | InverseDirty | NormalDirty;
+}
+
+Matrix4x4 Transform::ToMatrix4x4(const Transform &transform)
+{
+    return Matrix4x4(GetLinear(transform), transform.Position);
+}
+
+Vector3 Transform::TransformDirection(const Transform &transform,
+                                      Vector3 direction)
+{
+    return GetLinear(transform) * direction;
+}
+
+void Transform::TransformDirections(const Transform &transform,
+                                    const Vector3 *directions, size_t count,
+                                    Vector3 *output)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect((const double *)directions, 3 * count);
+    Matrix3x3 m = GetLinear(transform);
+    for (size_t i = 0; i < count; i++)
+        output[i] = m * directions[i];
+}
+
+Vector3 Transform::TransformNormal(const Transform &transform, Vector3 normal)
+{
+    return GetNormal(transform) * normal;
+}
+
+void Transform::TransformNormals(const Transform &transform,
+                                 const Vector3 *normals, size_t count,
+                                 Vector3 *output)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect((const double *)normals, 3 * count);
+    Matrix3x3 m = GetNormal(transform);
+    for (size_t i = 0; i < count; i++)
+        output[i] = m * normals[i];
+}
+
+Vector3 Transform::TransformPoint(const Transform &transform, Vector3 point)
+{
+    return GetLinear(transform) * point + transform.Position;
+}
+
+void Transform::TransformPoints(const Transform &transform,
+                                const Vector3 *points, size_t count,
+                                Vector3 *output)
+{
+    DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+    DenormalGuard::Inspect((const double *)points, 3 * count);
+    Matrix3x3 m = GetLinear(transform);
+    Vector3 position = transform.Position;
+    for (size_t i = 0; i < count; i++)
+        output[i] = m * points[i] + position;
+}
+
+void Transform::Update(const Transform &transform)
+{
+    GetLinear(transform);
+    GetInverse(transform);
+    GetNormal(transform);
+}
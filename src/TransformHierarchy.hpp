@@ -0,0 +1,455 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a flattened store for rigid transform hierarchies.
+ *  Nodes are kept in breadth-first order in structure of arrays form, and
+ *  world transforms are brought up to date one depth level at a time,
+ *  visiting only the subtrees below nodes which have changed.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+#include "DenormalGuard.hpp"
+#include "Parallel.hpp"
+#include "Quaternion.hpp"
+#include "QuaternionArray.hpp"
+#include "Vector3.hpp"
+#include "Vector3Array.hpp"
+
+
+struct TransformHierarchy
+{
+    /**
+     * Every array below is indexed in breadth-first order, so each depth
+     * level is contiguous and the children of each node are contiguous,
+     * appearing in the same order as their parents. Order and Index convert
+     * between these positions and the node numbers given to Build.
+     */
+    std::vector<unsigned int> Parents;
+    std::vector<unsigned int> ChildStart;
+    std::vector<unsigned int> LevelStart;
+    std::vector<unsigned int> Order;
+    std::vector<unsigned int> Index;
+    QuaternionArray LocalRotations;
+    Vector3Array LocalPositions;
+    QuaternionArray WorldRotations;
+    Vector3Array WorldPositions;
+
+    // Nodes changed since the last update, and a flag for each node
+    std::vector<unsigned int> Pending;
+    std::vector<unsigned char> Marked;
+
+    // The parent of a root node
+    static constexpr unsigned int None = 0xFFFFFFFF;
+
+    // The number of nodes composed at a time by the batch kernel
+    static constexpr size_t BlockSize = 128;
+
+    // The smallest number of nodes worth giving to another thread
+    static constexpr size_t ParallelGrain = 1 << 14;
+
+
+    /**
+     * Constructors.
+     */
+    inline TransformHierarchy();
+
+
+    /**
+     * Builds a hierarchy and computes its world transforms. The parents must
+     * form a forest, with no node being its own ancestor. Rotations are
+     * assumed to be unit quaternions.
+     * @param parents: The parent of each node, or None for roots.
+     * @param count: The number of nodes.
+     * @param rotations: The rotation of each node relative to its parent.
+     * @param positions: The position of each node relative to its parent.
+     * @return: A new hierarchy.
+     */
+    static inline TransformHierarchy Build(const unsigned int *parents,
+                                           size_t count,
+                                           const Quaternion *rotations,
+                                           const Vector3 *positions);
+
+    /**
+     * Returns the world transform of a node as of the last update.
+     * @param hierarchy: The hierarchy.
+     * @param node: The node number given to Build.
+     * @return: A rotation or position.
+     */
+    static inline Vector3 GetWorldPosition(const TransformHierarchy &hierarchy,
+                                           size_t node);
+    static inline Quaternion GetWorldRotation(
+        const TransformHierarchy &hierarchy, size_t node);
+
+    /**
+     * Returns the number of depth levels in a hierarchy.
+     * @param hierarchy: The hierarchy.
+     * @return: A count.
+     */
+    static inline size_t Levels(const TransformHierarchy &hierarchy);
+
+    /**
+     * Changes the local transform of a node. Its world transform, and those
+     * of every node below it, are recomputed by the next update.
+     * @param hierarchy: The hierarchy.
+     * @param node: The node number given to Build.
+     * @param rotation: The new rotation relative to the parent.
+     * @param position: The new position relative to the parent.
+     */
+    static inline void SetLocal(TransformHierarchy &hierarchy, size_t node,
+                                Quaternion rotation, Vector3 position);
+
+    /**
+     * Recomputes the world transforms of every changed node and everything
+     * below them. Each depth level is composed in parallel once the level
+     * above it is complete.
+     * @param hierarchy: The hierarchy.
+     * @return: The number of nodes recomputed.
+     */
+    static inline size_t Update(TransformHierarchy &hierarchy);
+
+    /**
+     * Helpers for the implementation.
+     * The ranges are pairs of begin and end positions within one level.
+     */
+    static inline void ComposeBlock(TransformHierarchy &hierarchy,
+                                    size_t begin, size_t count);
+    static inline void ComposeRange(TransformHierarchy &hierarchy,
+                                    size_t begin, size_t end);
+    static inline size_t ComposeRanges(TransformHierarchy &hierarchy,
+                                       const std::vector<unsigned int>
+                                       &ranges);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+TransformHierarchy::TransformHierarchy() : LevelStart(1, 0) {}
+
+
+TransformHierarchy TransformHierarchy::Build(const unsigned int *parents,
+                                             size_t count,
+                                             const Quaternion *rotations,
+                                             const Vector3 *positions)
+{
+    // Bucket the children of each node, keeping them in their given order
+    std::vector<unsigned int> childStart(count + 1, 0);
+    for (size_t i = 0; i < count; i++)
+        if (parents[i] != None)
+            childStart[parents[i] + 1]++;
+    for (size_t i = 0; i < count; i++)
+        childStart[i + 1] += childStart[i];
+    std::vector<unsigned int> children(childStart[count]);
+    std::vector<unsigned int> slot(childStart.begin(), childStart.end() - 1);
+    for (size_t i = 0; i < count; i++)
+        if (parents[i] != None)
+            children[slot[parents[i]]++] = (unsigned int)i;
+
+    // Breadth-first walk from every root
+    TransformHierarchy h;
+    h.Order.reserve(count);
+    for (size_t i = 0; i < count; i++)
+        if (parents[i] == None)
+            h.Order.push_back((unsigned int)i);
+    h.Index.assign(count, (unsigned int)None);
+    h.Parents.resize(count);
+    h.ChildStart.resize(count + 1);
+    h.LevelStart.assign(1, 0);
+    size_t levelEnd = h.Order.size();
+    for (size_t i = 0; i < h.Order.size(); i++)
+    {
+        if (i == levelEnd)
+        {
+            h.LevelStart.push_back((unsigned int)i);
+            levelEnd = h.Order.size();
+        }
+        unsigned int node = h.Order[i];
+        h.Index[node] = (unsigned int)i;
+        h.Parents[i] = parents[node] == None ? None : h.Index[parents[node]];
+        h.ChildStart[i] = (unsigned int)h.Order.size();
+        for (unsigned int c = childStart[node]; c < childStart[node + 1]; c++)
+            h.Order.push_back(children[c]);
+    }
+    h.ChildStart[count] = (unsigned int)count;
+    h.LevelStart.push_back((unsigned int)count);
+    if (count == 0)
+        h.LevelStart.pop_back();
+
+    QuaternionArray::Resize(h.LocalRotations, count);
+    Vector3Array::Resize(h.LocalPositions, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        QuaternionArray::Set(h.LocalRotations, i, rotations[h.Order[i]]);
+        Vector3Array::Set(h.LocalPositions, i, positions[h.Order[i]]);
+    }
+    QuaternionArray::Resize(h.WorldRotations, count);
+    Vector3Array::Resize(h.WorldPositions, count);
+    h.Marked.assign(count, 0);
+
+    // Marking the roots brings every node up to date
+    for (size_t i = 0; i < count && h.Parents[i] == None; i++)
+    {
+        h.Pending.push_back((unsigned int)i);
+        h.Marked[i] = 1;
+    }
+    Update(h);
+    return h;
+}
+
+Vector3 TransformHierarchy::GetWorldPosition(
+    const TransformHierarchy &hierarchy, size_t node)
+{
+    return Vector3Array::Get(hierarchy.WorldPositions,
+                             hierarchy.Index[node]);
+}
+
+Quaternion TransformHierarchy::GetWorldRotation(
+    const TransformHierarchy &hierarchy, size_t node)
+{
+    return QuaternionArray::Get(hierarchy.WorldRotations,
+                                hierarchy.Index[node]);
+}
+
+size_t TransformHierarchy::Levels(const TransformHierarchy &hierarchy)
+{
+    return hierarchy.LevelStart.size() - 1;
+}
+
+void TransformHierarchy::SetLocal(TransformHierarchy &hierarchy, size_t node,
+                                  Quaternion rotation, Vector3 position)
+{
+    unsigned int i = hierarchy.Index[node];
+    QuaternionArray::Set(hierarchy.LocalRotations, i, rotation);
+    Vector3Array::Set(hierarchy.LocalPositions, i, position);
+    if (!hierarchy.Marked[i])
+    {
+        hierarchy.Marked[i] = 1;
+        hierarchy.Pending.push_back(i);
+    }
+}
+
+size_t TransformHierarchy::Update(TransformHierarchy &hierarchy)
+{
+    std::vector<unsigned int> &pending = hierarchy.Pending;
+    std::sort(pending.begin(), pending.end());
+
+    // The dirty nodes of each level are the children of the dirty nodes of
+    // the level above, which form contiguous ranges, merged with the nodes
+    // marked on that level
+    std::vector<unsigned int> inherited;
+    std::vector<unsigned int> dirty;
+    size_t next = 0;
+    size_t updated = 0;
+    for (size_t level = 0; level < Levels(hierarchy); level++)
+    {
+        unsigned int end = hierarchy.LevelStart[level + 1];
+        if (inherited.empty() && next == pending.size())
+            break;
+        dirty.clear();
+        size_t r = 0;
+        while (r < inherited.size() ||
+               (next < pending.size() && pending[next] < end))
+        {
+            unsigned int b, e;
+            if (r < inherited.size() && (next == pending.size() ||
+                pending[next] >= end || inherited[r] <= pending[next]))
+            {
+                b = inherited[r];
+                e = inherited[r + 1];
+                r += 2;
+            }
+            else
+            {
+                b = pending[next++];
+                e = b + 1;
+            }
+            if (!dirty.empty() && b <= dirty.back())
+                dirty.back() = std::max(dirty.back(), e);
+            else
+            {
+                dirty.push_back(b);
+                dirty.push_back(e);
+            }
+        }
+        updated += ComposeRanges(hierarchy, dirty);
+
+        inherited.clear();
+        for (size_t i = 0; i < dirty.size(); i += 2)
+        {
+            unsigned int b = hierarchy.ChildStart[dirty[i]];
+            unsigned int e = hierarchy.ChildStart[dirty[i + 1]];
+            if (b == e)
+                continue;
+            if (!inherited.empty() && inherited.back() == b)
+                inherited.back() = e;
+            else
+            {
+                inherited.push_back(b);
+                inherited.push_back(e);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < pending.size(); i++)
+        hierarchy.Marked[pending[i]] = 0;
+    pending.clear();
+    return updated;
+}
+
+
+void TransformHierarchy::ComposeBlock(TransformHierarchy &hierarchy,
+                                      size_t begin, size_t count)
+{
+    // Gather the parents into padded local arrays first, so that the
+    // compose loop has a fixed length and no indirection, and vectorizes
+    double qx[BlockSize], qy[BlockSize], qz[BlockSize], qw[BlockSize];
+    double px[BlockSize], py[BlockSize], pz[BlockSize];
+    double lx[BlockSize], ly[BlockSize], lz[BlockSize], lw[BlockSize];
+    double vx[BlockSize], vy[BlockSize], vz[BlockSize];
+    const unsigned int *parents = hierarchy.Parents.data() + begin;
+    QuaternionArray &world = hierarchy.WorldRotations;
+    Vector3Array &position = hierarchy.WorldPositions;
+    const QuaternionArray &local = hierarchy.LocalRotations;
+    const Vector3Array &offset = hierarchy.LocalPositions;
+    for (size_t i = 0; i < count; i++)
+    {
+        unsigned int p = parents[i];
+        qx[i] = world.X[p];
+        qy[i] = world.Y[p];
+        qz[i] = world.Z[p];
+        qw[i] = world.W[p];
+        px[i] = position.X[p];
+        py[i] = position.Y[p];
+        pz[i] = position.Z[p];
+        lx[i] = local.X[begin + i];
+        ly[i] = local.Y[begin + i];
+        lz[i] = local.Z[begin + i];
+        lw[i] = local.W[begin + i];
+        vx[i] = offset.X[begin + i];
+        vy[i] = offset.Y[begin + i];
+        vz[i] = offset.Z[begin + i];
+    }
+    DenormalGuard::Inspect(lx, count);
+    DenormalGuard::Inspect(ly, count);
+    DenormalGuard::Inspect(lz, count);
+    DenormalGuard::Inspect(lw, count);
+    DenormalGuard::Inspect(vx, count);
+    DenormalGuard::Inspect(vy, count);
+    DenormalGuard::Inspect(vz, count);
+    for (size_t i = count; i < BlockSize; i++)
+    {
+        qx[i] = qy[i] = qz[i] = px[i] = py[i] = pz[i] = 0;
+        lx[i] = ly[i] = lz[i] = vx[i] = vy[i] = vz[i] = 0;
+        qw[i] = lw[i] = 1;
+    }
+
+    for (size_t i = 0; i < BlockSize; i++)
+    {
+        // Rotate the local position by the parent, then add the parent
+        double tx = 2 * (qy[i] * vz[i] - qz[i] * vy[i]);
+        double ty = 2 * (qz[i] * vx[i] - qx[i] * vz[i]);
+        double tz = 2 * (qx[i] * vy[i] - qy[i] * vx[i]);
+        px[i] += vx[i] + qw[i] * tx + qy[i] * tz - qz[i] * ty;
+        py[i] += vy[i] + qw[i] * ty + qz[i] * tx - qx[i] * tz;
+        pz[i] += vz[i] + qw[i] * tz + qx[i] * ty - qy[i] * tx;
+
+        // The parent rotation times the local rotation
+        double x = qx[i] * lw[i] + qw[i] * lx[i] + qy[i] * lz[i] -
+            qz[i] * ly[i];
+        double y = qw[i] * ly[i] - qx[i] * lz[i] + qy[i] * lw[i] +
+            qz[i] * lx[i];
+        double z = qw[i] * lz[i] + qx[i] * ly[i] - qy[i] * lx[i] +
+            qz[i] * lw[i];
+        double w = qw[i] * lw[i] - qx[i] * lx[i] - qy[i] * ly[i] -
+            qz[i] * lz[i];
+        qx[i] = x;
+        qy[i] = y;
+        qz[i] = z;
+        qw[i] = w;
+    }
+
+    std::copy(qx, qx + count, world.X.begin() + begin);
+    std::copy(qy, qy + count, world.Y.begin() + begin);
+    std::copy(qz, qz + count, world.Z.begin() + begin);
+    std::copy(qw, qw + count, world.W.begin() + begin);
+    std::copy(px, px + count, position.X.begin() + begin);
+    std::copy(py, py + count, position.Y.begin() + begin);
+    std::copy(pz, pz + count, position.Z.begin() + begin);
+}
+
+void TransformHierarchy::ComposeRange(TransformHierarchy &hierarchy,
+                                      size_t begin, size_t end)
+{
+    if (hierarchy.Parents[begin] == None)
+    {
+        // Ranges never mix levels, so this range is all roots
+        for (size_t i = begin; i < end; i++)
+        {
+            QuaternionArray::Set(hierarchy.WorldRotations, i,
+                QuaternionArray::Get(hierarchy.LocalRotations, i));
+            Vector3Array::Set(hierarchy.WorldPositions, i,
+                Vector3Array::Get(hierarchy.LocalPositions, i));
+        }
+        return;
+    }
+    for (size_t b = begin; b < end; b += BlockSize)
+        ComposeBlock(hierarchy, b, end - b < BlockSize ? end - b : BlockSize);
+}
+
+size_t TransformHierarchy::ComposeRanges(TransformHierarchy &hierarchy,
+                                         const std::vector<unsigned int>
+                                         &ranges)
+{
+    // Number the dirty nodes of the level consecutively and split that
+    // numbering between threads
+    size_t count = ranges.size() / 2;
+    std::vector<size_t> before(count + 1, 0);
+    for (size_t r = 0; r < count; r++)
+        before[r + 1] = before[r] + ranges[2 * r + 1] - ranges[2 * r];
+    Parallel::For(before[count], ParallelGrain,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      DenormalGuard guard(GMATH_FLUSH_DENORMALS);
+                      size_t r = std::upper_bound(before.begin(),
+                          before.end(), begin) - before.begin() - 1;
+                      while (begin < end)
+                      {
+                          size_t first = ranges[2 * r] + begin - before[r];
+                          size_t last = ranges[2 * r] +
+                              std::min(end, before[r + 1]) - before[r];
+                          ComposeRange(hierarchy, first, last);
+                          begin = before[r + 1];
+                          r++;
+                      }
+                  });
+    return before[count];
+}
@@ -0,0 +1,409 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements packets of rays and triangles stored as structures
+ *  of arrays, for intersecting one ray with several triangles or several
+ *  rays with one triangle at a time.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <utility>
+#include <vector>
+#include "Ray.hpp"
+#include "Vector3.hpp"
+
+
+/**
+ * Both packets test a ray against a triangle with the signed volumes of the
+ * ray and each edge, which are Moller and Trumbore's barycentric
+ * coordinates before their division by the determinant. The vertices of
+ * every triangle are sorted before testing and each volume is computed with
+ * its edge running from the lower vertex to the higher one, so it depends
+ * only on the ray and the edge itself. The triangles on either side of a
+ * shared edge therefore compute bitwise equal volumes, whether or not the
+ * compiler fuses them into FMAs, and a ray can never slip between them.
+ * Hits on an edge or vertex count for every triangle touching it.
+ * Triangles are hit from either side, and degenerate triangles are never
+ * hit.
+ *
+ * Packets are 4, 8 or 16 wide. Their kernels are fixed length loops over
+ * the lanes, which the compiler vectorizes.
+ */
+template <size_t Width>
+struct RayPacket
+{
+    static_assert(Width == 4 || Width == 8 || Width == 16,
+                  "Packets are 4, 8 or 16 wide");
+
+    double OriginX[Width], OriginY[Width], OriginZ[Width];
+    double DirectionX[Width], DirectionY[Width], DirectionZ[Width];
+
+
+    /**
+     * Returns a packet holding up to Width rays. Unused lanes hold rays of
+     * zero length, which never hit anything.
+     * @param rays: The rays to load.
+     * @param count: The number of rays, at most Width.
+     * @return: A new packet.
+     */
+    static inline RayPacket Load(const Ray *rays, size_t count);
+
+    /**
+     * Intersects every ray of a packet with one triangle.
+     * @param packet: The rays to test.
+     * @param a: The first vertex of the triangle.
+     * @param b: The second vertex of the triangle.
+     * @param c: The third vertex of the triangle.
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param distances: The output ray parameters, Width of them. These are
+     * only meaningful for lanes that hit.
+     * @return: A mask with bit i set if ray i hits the triangle.
+     */
+    static inline unsigned int Raycast(const RayPacket &packet, Vector3 a,
+                                       Vector3 b, Vector3 c,
+                                       double maxDistance,
+                                       double *distances);
+};
+
+
+template <size_t Width>
+struct TrianglePacket
+{
+    static_assert(Width == 4 || Width == 8 || Width == 16,
+                  "Packets are 4, 8 or 16 wide");
+
+    /**
+     * The vertices of each triangle, sorted as by
+     * PacketIntersection::SortVertices, and its unnormalized normal
+     * Cross(B - A, C - A).
+     */
+    double AX[Width], AY[Width], AZ[Width];
+    double BX[Width], BY[Width], BZ[Width];
+    double CX[Width], CY[Width], CZ[Width];
+    double NX[Width], NY[Width], NZ[Width];
+
+
+    /**
+     * Returns the packets holding a triangle list, where triangle i is made
+     * of vertices 3i, 3i + 1 and 3i + 2. Triangle i lands in lane i % Width
+     * of packet i / Width.
+     * @param vertices: The triangle vertices.
+     * @param triangleCount: The number of triangles.
+     * @return: A new array of packets.
+     */
+    static inline std::vector<TrianglePacket> FromTriangles(
+        const Vector3 *vertices, size_t triangleCount);
+
+    /**
+     * Returns a packet holding up to Width triangles from a triangle list.
+     * Unused lanes hold degenerate triangles, which are never hit.
+     * @param vertices: The triangle vertices, three per triangle.
+     * @param count: The number of triangles, at most Width.
+     * @return: A new packet.
+     */
+    static inline TrianglePacket Load(const Vector3 *vertices, size_t count);
+
+    /**
+     * Intersects one ray with every triangle of a packet.
+     * @param packet: The triangles to test.
+     * @param ray: The ray in question.
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param distances: The output ray parameters, Width of them. These are
+     * only meaningful for lanes that hit.
+     * @return: A mask with bit i set if the ray hits triangle i.
+     */
+    static inline unsigned int Raycast(const TrianglePacket &packet, Ray ray,
+                                       double maxDistance,
+                                       double *distances);
+};
+
+
+/**
+ * The lane by lane intersection shared by both packets.
+ */
+struct PacketIntersection
+{
+    /**
+     * Returns the signed volume Dot(d, Cross(p, q)) of a ray and an edge.
+     * @param px, py, pz: The first endpoint relative to the ray origin.
+     * @param qx, qy, qz: The second endpoint relative to the ray origin.
+     * @param dx, dy, dz: The ray direction.
+     * @return: A scalar value.
+     */
+    static inline double EdgeVolume(double px, double py, double pz,
+                                    double qx, double qy, double qz,
+                                    double dx, double dy, double dz);
+
+    /**
+     * Intersects one ray with one triangle without dividing, so that a
+     * packet loop inlining it vectorizes cheaply. The ray parameter of the
+     * hit is numerator / denominator. The vertices must be sorted by
+     * SortVertices before they are made relative to the ray origin.
+     * @param ax, ay, az: The first vertex relative to the ray origin.
+     * @param bx, by, bz: The second vertex relative to the ray origin.
+     * @param cx, cy, cz: The third vertex relative to the ray origin.
+     * @param dx, dy, dz: The ray direction.
+     * @param nx, ny, nz: The unnormalized triangle normal.
+     * @param maxDistance: The largest ray parameter to accept.
+     * @param numerator: The output numerator of the ray parameter.
+     * @param denominator: The output denominator of the ray parameter.
+     * @return: One if the ray hits the triangle, otherwise zero.
+     */
+    static inline double Lane(double ax, double ay, double az, double bx,
+                              double by, double bz, double cx, double cy,
+                              double cz, double dx, double dy, double dz,
+                              double nx, double ny, double nz,
+                              double maxDistance, double &numerator,
+                              double &denominator);
+
+    /**
+     * Turns the hit flags of a packet into a mask, and divides out the ray
+     * parameters of the lanes that hit.
+     * @param hits: The hit flags from Lane.
+     * @param numerators: The numerators from Lane.
+     * @param denominators: The denominators from Lane.
+     * @param distances: The output ray parameters, Width of them.
+     * @return: A mask with bit i set if lane i hits.
+     */
+    template <size_t Width>
+    static inline unsigned int Mask(const double *hits,
+                                    const double *numerators,
+                                    const double *denominators,
+                                    double *distances);
+
+    /**
+     * Sorts the vertices of a triangle in lexicographic order of their X,
+     * Y and Z coordinates. This may flip the triangle's winding, which the
+     * intersection test does not depend on.
+     * @param a: The first vertex.
+     * @param b: The second vertex.
+     * @param c: The third vertex.
+     */
+    static inline void SortVertices(Vector3 &a, Vector3 &b, Vector3 &c);
+
+
+    /**
+     * Helpers for the implementation.
+     */
+    static inline bool Precedes(Vector3 p, Vector3 q);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+template <size_t Width>
+RayPacket<Width> RayPacket<Width>::Load(const Ray *rays, size_t count)
+{
+    RayPacket packet;
+    for (size_t i = 0; i < Width; i++)
+    {
+        Ray ray = i < count ? rays[i] : Ray(Vector3(0, 0, 0),
+                                            Vector3(0, 0, 0));
+        packet.OriginX[i] = ray.Origin.X;
+        packet.OriginY[i] = ray.Origin.Y;
+        packet.OriginZ[i] = ray.Origin.Z;
+        packet.DirectionX[i] = ray.Direction.X;
+        packet.DirectionY[i] = ray.Direction.Y;
+        packet.DirectionZ[i] = ray.Direction.Z;
+    }
+    return packet;
+}
+
+template <size_t Width>
+unsigned int RayPacket<Width>::Raycast(const RayPacket &packet, Vector3 a,
+                                       Vector3 b, Vector3 c,
+                                       double maxDistance, double *distances)
+{
+    double hits[Width], numerators[Width], denominators[Width];
+    PacketIntersection::SortVertices(a, b, c);
+    Vector3 n = Vector3::Cross(b - a, c - a);
+    for (size_t i = 0; i < Width; i++)
+    {
+        double ox = packet.OriginX[i];
+        double oy = packet.OriginY[i];
+        double oz = packet.OriginZ[i];
+        hits[i] = PacketIntersection::Lane(
+            a.X - ox, a.Y - oy, a.Z - oz, b.X - ox, b.Y - oy, b.Z - oz,
+            c.X - ox, c.Y - oy, c.Z - oz, packet.DirectionX[i],
+            packet.DirectionY[i], packet.DirectionZ[i], n.X, n.Y, n.Z,
+            maxDistance, numerators[i], denominators[i]);
+    }
+    return PacketIntersection::Mask<Width>(hits, numerators, denominators,
+                                           distances);
+}
+
+
+template <size_t Width>
+std::vector<TrianglePacket<Width>> TrianglePacket<Width>::FromTriangles(
+    const Vector3 *vertices, size_t triangleCount)
+{
+    std::vector<TrianglePacket> packets((triangleCount + Width - 1) / Width);
+    for (size_t p = 0; p < packets.size(); p++)
+    {
+        size_t first = p * Width;
+        size_t count = triangleCount - first < Width ?
+            triangleCount - first : Width;
+        packets[p] = Load(vertices + 3 * first, count);
+    }
+    return packets;
+}
+
+template <size_t Width>
+TrianglePacket<Width> TrianglePacket<Width>::Load(const Vector3 *vertices,
+                                                  size_t count)
+{
+    TrianglePacket packet;
+    for (size_t i = 0; i < Width; i++)
+    {
+        Vector3 a = i < count ? vertices[3 * i] : Vector3(0, 0, 0);
+        Vector3 b = i < count ? vertices[3 * i + 1] : Vector3(0, 0, 0);
+        Vector3 c = i < count ? vertices[3 * i + 2] : Vector3(0, 0, 0);
+        PacketIntersection::SortVertices(a, b, c);
+        packet.AX[i] = a.X;
+        packet.AY[i] = a.Y;
+        packet.AZ[i] = a.Z;
+        packet.BX[i] = b.X;
+        packet.BY[i] = b.Y;
+        packet.BZ[i] = b.Z;
+        packet.CX[i] = c.X;
+        packet.CY[i] = c.Y;
+        packet.CZ[i] = c.Z;
+        Vector3 n = Vector3::Cross(b - a, c - a);
+        packet.NX[i] = n.X;
+        packet.NY[i] = n.Y;
+        packet.NZ[i] = n.Z;
+    }
+    return packet;
+}
+
+template <size_t Width>
+unsigned int TrianglePacket<Width>::Raycast(const TrianglePacket &packet,
+                                            Ray ray, double maxDistance,
+                                            double *distances)
+{
+    double hits[Width], numerators[Width], denominators[Width];
+    Vector3 o = ray.Origin;
+    Vector3 d = ray.Direction;
+    for (size_t i = 0; i < Width; i++)
+    {
+        hits[i] = PacketIntersection::Lane(
+            packet.AX[i] - o.X, packet.AY[i] - o.Y, packet.AZ[i] - o.Z,
+            packet.BX[i] - o.X, packet.BY[i] - o.Y, packet.BZ[i] - o.Z,
+            packet.CX[i] - o.X, packet.CY[i] - o.Y, packet.CZ[i] - o.Z,
+            d.X, d.Y, d.Z, packet.NX[i], packet.NY[i], packet.NZ[i],
+            maxDistance, numerators[i], denominators[i]);
+    }
+    return PacketIntersection::Mask<Width>(hits, numerators, denominators,
+                                           distances);
+}
+
+
+double PacketIntersection::EdgeVolume(double px, double py, double pz,
+                                      double qx, double qy, double qz,
+                                      double dx, double dy, double dz)
+{
+    return dx * (py * qz - pz * qy) + dy * (pz * qx - px * qz) +
+        dz * (px * qy - py * qx);
+}
+
+double PacketIntersection::Lane(double ax, double ay, double az, double bx,
+                                double by, double bz, double cx, double cy,
+                                double cz, double dx, double dy, double dz,
+                                double nx, double ny, double nz,
+                                double maxDistance, double &numerator,
+                                double &denominator)
+{
+    // The signed volumes of the ray with edges bc, ca and ab, which are
+    // the unnormalized barycentric coordinates of a, b and c. The ray
+    // passes through the triangle when they share a sign. Since a < b < c,
+    // edge ca is computed as ac and negated, which is exact
+    double u = EdgeVolume(bx, by, bz, cx, cy, cz, dx, dy, dz);
+    double v = -EdgeVolume(ax, ay, az, cx, cy, cz, dx, dy, dz);
+    double w = EdgeVolume(ax, ay, az, bx, by, bz, dx, dy, dz);
+    double low = u < v ? u : v;
+    low = low < w ? low : w;
+    double high = u > v ? u : v;
+    high = high > w ? high : w;
+
+    // The ray parameter is Dot(n, a) / Dot(n, d), which is tested against
+    // the range [0, maxDistance] with the signs folded into the numerator.
+    // A ray parallel to the plane has a zero denominator and misses.
+    numerator = nx * ax + ny * ay + nz * az;
+    denominator = nx * dx + ny * dy + nz * dz;
+    double scaled = denominator < 0 ? -numerator : numerator;
+    double range = denominator < 0 ? -denominator : denominator;
+
+    // The flag is built from selects, which vectorize where boolean logic
+    // does not
+    double hit = low >= 0 ? 1 : 0;
+    hit = high <= 0 ? 1 : hit;
+    hit = range != 0 ? hit : 0;
+    hit = scaled >= 0 ? hit : 0;
+    return scaled <= maxDistance * range ? hit : 0;
+}
+
+template <size_t Width>
+unsigned int PacketIntersection::Mask(const double *hits,
+                                      const double *numerators,
+                                      const double *denominators,
+                                      double *distances)
+{
+    unsigned int mask = 0;
+    for (size_t i = 0; i < Width; i++)
+    {
+        if (hits[i] != 0)
+        {
+            mask |= 1u << i;
+            distances[i] = numerators[i] / denominators[i];
+        }
+    }
+    return mask;
+}
+
+void PacketIntersection::SortVertices(Vector3 &a, Vector3 &b, Vector3 &c)
+{
+    if (Precedes(b, a))
+        std::swap(a, b);
+    if (Precedes(c, b))
+        std::swap(b, c);
+    if (Precedes(b, a))
+        std::swap(a, b);
+}
+
+
+bool PacketIntersection::Precedes(Vector3 p, Vector3 q)
+{
+    if (p.X != q.X)
+        return p.X < q.X;
+    if (p.Y != q.Y)
+        return p.Y < q.Y;
+    return p.Z < q.Z;
+}
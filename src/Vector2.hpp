@@ -36,6 +36,48 @@
 #include <math.h>
 
 
+/**
+ * Attempt to include a header file if the file exists.
+ * If the file does not exist, create a dummy data structure for that type.
+ * If it cannot be determined if it exists, just attempt to include it.
+ */
+#ifdef __has_include
+#   if __has_include("FastMath.hpp")
+#       include "FastMath.hpp"
+#   elif !defined(GMATH_FASTMATH)
+        #define GMATH_FASTMATH
+        struct FastMath
+        {
+            static inline double Acos(double x)
+            {
+                return acos(fmin(fmax(x, -1.0), 1.0));
+            }
+
+            static inline double Asin(double x)
+            {
+                return asin(fmin(fmax(x, -1.0), 1.0));
+            }
+
+            static inline double Atan(double x) { return atan(x); }
+
+            static inline double Atan2(double y, double x)
+            {
+                return atan2(y, x);
+            }
+
+            static inline void SinCos(double angle, double &sine,
+                double &cosine)
+            {
+                sine = sin(angle);
+                cosine = cos(angle);
+            }
+        };
+#   endif
+#else
+#   include "FastMath.hpp"
+#endif
+
+
 struct Vector2
 {
     union
@@ -77,6 +119,17 @@ struct Vector2
      */
     static inline double Angle(Vector2 a, Vector2 b);
 
+    /**
+     * Returns the angle between two vectors in radians, using a fast
+     * approximation of atan2(|a x b|, a . b). This stays accurate for nearly
+     * parallel vectors, where acos of the dot product does not.
+     * @param a: The first vector.
+     * @param b: The second vector.
+     * @param precision: Pass FastMath() to select this overload.
+     * @return: A scalar value.
+     */
+    static inline double Angle(Vector2 a, Vector2 b, FastMath precision);
+
     /**
      * Returns a vector with its magnitude clamped to maxLength.
      * @param vector: The target vector.
@@ -277,6 +330,17 @@ struct Vector2
      */
     static inline void ToPolar(Vector2 vector, double &rad, double &theta);
 
+    /**
+     * Calculates the polar coordinate space representation of a vector, using
+     * a fast approximation of atan2.
+     * @param vector: The vector to convert.
+     * @param rad: The magnitude of the vector.
+     * @param theta: The angle from the X axis.
+     * @param precision: Pass FastMath() to select this overload.
+     */
+    static inline void ToPolar(Vector2 vector, double &rad, double &theta,
+                               FastMath precision);
+
 
     /**
      * Operator overloading.
@@ -331,6 +395,12 @@ double Vector2::Angle(Vector2 a, Vector2 b)
     return acos(v);
 }
 
+double Vector2::Angle(Vector2 a, Vector2 b, FastMath)
+{
+    double cross = a.X * b.Y - a.Y * b.X;
+    return FastMath::Atan2(fabs(cross), Dot(a, b));
+}
+
 Vector2 Vector2::ClampMagnitude(Vector2 vector, double maxLength)
 {
     double length = Magnitude(vector);
@@ -356,9 +426,11 @@ double Vector2::Dot(Vector2 lhs, Vector2 rhs)
 
 Vector2 Vector2::FromPolar(double rad, double theta)
 {
+    double sinTheta, cosTheta;
+    FastMath::SinCos(theta, sinTheta, cosTheta);
     Vector2 v;
-    v.X = rad * cos(theta);
-    v.Y = rad * sin(theta);
+    v.X = rad * cosTheta;
+    v.Y = rad * sinTheta;
     return v;
 }
 
@@ -456,8 +528,10 @@ Vector2 Vector2::RotateTowards(Vector2 current, Vector2 target,
     if (!(1 - fabs(axis) < 0.00001))
         axis = 1;
     current = Normalized(current);
-    Vector2 newVector = current * cos(maxRadiansDelta) +
-        Vector2(-current.Y, current.X) * sin(maxRadiansDelta) * axis;
+    double sinDelta, cosDelta;
+    FastMath::SinCos(maxRadiansDelta, sinDelta, cosDelta);
+    Vector2 newVector = current * cosDelta +
+        Vector2(-current.Y, current.X) * sinDelta * axis;
     return newVector * newMag;
 }
 
@@ -483,8 +557,10 @@ Vector2 Vector2::SlerpUnclamped(Vector2 a, Vector2 b, double t)
     dot = fmax(dot, -1.0);
     dot = fmin(dot, 1.0);
     double theta = acos(dot) * t;
+    double sinTheta, cosTheta;
+    FastMath::SinCos(theta, sinTheta, cosTheta);
     Vector2 relativeVec = Normalized(b - a * dot);
-    Vector2 newVec = a * cos(theta) + relativeVec * sin(theta);
+    Vector2 newVec = a * cosTheta + relativeVec * sinTheta;
     return newVec * (magA + (magB - magA) * t);
 }
 
@@ -499,6 +575,13 @@ void Vector2::ToPolar(Vector2 vector, double &rad, double &theta)
     theta = atan2(vector.Y, vector.X);
 }
 
+void Vector2::ToPolar(Vector2 vector, double &rad, double &theta,
+                      FastMath)
+{
+    rad = Magnitude(vector);
+    theta = FastMath::Atan2(vector.Y, vector.X);
+}
+
 
 struct Vector2& Vector2::operator+=(const double rhs)
 {
@@ -36,6 +36,51 @@
 #include <math.h>
 
 
+/**
+ * Attempt to include a header file if the file exists.
+ * If the file does not exist, create a dummy data structure for that type.
+ * If it cannot be determined if it exists, just attempt to include it.
+ */
+#ifdef __has_include
+#   if __has_include("FastMath.hpp")
+#       include "FastMath.hpp"
+#   elif !defined(GMATH_FASTMATH)
+        #define GMATH_FASTMATH
+        struct FastMath
+        {
+            static inline double Acos(double x)
+            {
+                return acos(fmin(fmax(x, -1.0), 1.0));
+            }
+
+            static inline double Asin(double x)
+            {
+                return asin(fmin(fmax(x, -1.0), 1.0));
+            }
+
+            static inline double Atan(double x) { return atan(x); }
+
+            static inline double Atan2(double y, double x)
+            {
+                return atan2(y, x);
+            }
+
+            static inline void SinCos(double angle, double &sine,
+                double &cosine)
+            {
+                sine = sin(angle);
+                cosine = cos(angle);
+            }
+        };
+#   endif
+#else
+#   include "FastMath.hpp"
+#endif
+
+
+struct UnitVector3;
+
+
 struct Vector3
 {
     union
@@ -81,6 +126,25 @@ struct Vector3
      */
     static inline double Angle(Vector3 a, Vector3 b);
 
+    /**
+     * Returns the angle between two unit vectors in radians.
+     * @param a: The first unit vector.
+     * @param b: The second unit vector.
+     * @return: A scalar value.
+     */
+    static inline double Angle(UnitVector3 a, UnitVector3 b);
+
+    /**
+     * Returns the angle between two vectors in radians, using a fast
+     * approximation of atan2(|a x b|, a . b). This stays accurate for nearly
+     * parallel vectors, where acos of the dot product does not.
+     * @param a: The first vector.
+     * @param b: The second vector.
+     * @param precision: Pass FastMath() to select this overload.
+     * @return: A scalar value.
+     */
+    static inline double Angle(Vector3 a, Vector3 b, FastMath precision);
+
     /**
      * Returns a vector with its magnitude clamped to maxLength.
      * @param vector: The target vector.
@@ -97,6 +161,14 @@ struct Vector3
      */
     static inline double Component(Vector3 a, Vector3 b);
 
+    /**
+     * Returns the component of a in the direction of b (scalar projection).
+     * @param a: The target vector.
+     * @param b: The unit vector being compared against.
+     * @return: A scalar value.
+     */
+    static inline double Component(Vector3 a, UnitVector3 b);
+
     /**
      * Returns the cross product of two vectors.
      * @param lhs: The left side of the multiplication.
@@ -187,7 +259,8 @@ struct Vector3
                                double maxDistanceDelta);
 
     /**
-     * Returns a new vector with magnitude of one.
+     * Returns a new vector with magnitude of one. The zero vector is returned
+     * unchanged. Use TryNormalize to get a UnitVector3.
      * @param v: The vector in question.
      * @return: A new vector.
      */
@@ -221,6 +294,14 @@ struct Vector3
      */
     static inline Vector3 Project(Vector3 a, Vector3 b);
 
+    /**
+     * Returns the vector projection of a onto b.
+     * @param a: The target vector.
+     * @param b: The unit vector being projected onto.
+     * @return: A new vector.
+     */
+    static inline Vector3 Project(Vector3 a, UnitVector3 b);
+
     /**
      * Returns a vector projected onto a plane orthogonal to "planeNormal".
      * This can be visualized as the shadow of the vector onto the plane, if
@@ -231,6 +312,15 @@ struct Vector3
      */
     static inline Vector3 ProjectOnPlane(Vector3 vector, Vector3 planeNormal);
 
+    /**
+     * Returns a vector projected onto a plane orthogonal to "planeNormal".
+     * @param vector: The vector to project.
+     * @param planeNormal: The unit normal of the plane onto which to project.
+     * @param: A new vector.
+     */
+    static inline Vector3 ProjectOnPlane(Vector3 vector,
+                                         UnitVector3 planeNormal);
+
     /**
      * Returns a vector reflected off the plane orthogonal to the normal.
      * The input vector is pointed inward, at the plane, and the return vector
@@ -242,6 +332,15 @@ struct Vector3
      */
     static inline Vector3 Reflect(Vector3 vector, Vector3 planeNormal);
 
+    /**
+     * Returns a vector reflected off the plane orthogonal to the normal.
+     * @param vector: The vector traveling inward at the plane.
+     * @param planeNormal: The unit normal of the plane off of which to
+     * reflect.
+     * @return: A new vector pointing outward from the plane.
+     */
+    static inline Vector3 Reflect(Vector3 vector, UnitVector3 planeNormal);
+
     /**
      * Returns the vector rejection of a on b.
      * @param a: The target vector.
@@ -250,6 +349,14 @@ struct Vector3
      */
     static inline Vector3 Reject(Vector3 a, Vector3 b);
 
+    /**
+     * Returns the vector rejection of a on b.
+     * @param a: The target vector.
+     * @param b: The unit vector being projected onto.
+     * @return: A new vector.
+     */
+    static inline Vector3 Reject(Vector3 a, UnitVector3 b);
+
     /**
      * Rotates vector "current" towards vector "target" by "maxRadiansDelta".
      * This treats the vectors as directions and will linearly interpolate
@@ -316,6 +423,29 @@ struct Vector3
     static inline void ToSpherical(Vector3 vector, double &rad, double &theta,
                             double &phi);
 
+    /**
+     * Calculates the spherical coordinate space representation of a vector,
+     * using fast approximations of the inverse trigonometric functions.
+     * This uses the ISO convention (radius r, inclination theta, azimuth phi).
+     * @param vector: The vector to convert.
+     * @param rad: The magnitude of the vector.
+     * @param theta: The angle in the XY plane from the X axis.
+     * @param phi: The angle from the positive Z axis to the vector.
+     * @param precision: Pass FastMath() to select this overload.
+     */
+    static inline void ToSpherical(Vector3 vector, double &rad, double &theta,
+                            double &phi, FastMath precision);
+
+    /**
+     * Normalizes a vector into a UnitVector3, unless it is the zero vector,
+     * which has no direction.
+     * @param v: The vector in question.
+     * @param unit: Set to the normalized vector, or left unchanged if v is
+     * zero.
+     * @return: True if v was normalized.
+     */
+    static inline bool TryNormalize(Vector3 v, UnitVector3 &unit);
+
 
     /**
      * Operator overloading.
@@ -344,6 +474,47 @@ inline bool operator!=(const Vector3 lhs, const Vector3 rhs);
 
 
 
+/**
+ * A vector which is known to have a magnitude of one. These are returned by
+ * Vector3::TryNormalize, and the overloads which take them skip the magnitude
+ * calculations a general vector needs. The components are read only, and
+ * any arithmetic converts to a plain Vector3 first.
+ */
+struct UnitVector3
+{
+    /**
+     * Constructors.
+     * The vector passed in must already have a magnitude of one.
+     */
+    inline UnitVector3();
+    inline explicit UnitVector3(Vector3 unit);
+
+
+    /**
+     * Read access to the components, and conversion to a general vector.
+     */
+    inline double X() const;
+    inline double Y() const;
+    inline double Z() const;
+    inline operator const Vector3&() const;
+
+
+    /**
+     * Constants for common unit vectors.
+     */
+    static inline UnitVector3 Right();
+    static inline UnitVector3 Left();
+    static inline UnitVector3 Up();
+    static inline UnitVector3 Down();
+    static inline UnitVector3 Forward();
+    static inline UnitVector3 Backward();
+
+private:
+    Vector3 Unit;
+};
+
+
+
 /*******************************************************************************
  * Implementation
  */
@@ -373,6 +544,19 @@ double Vector3::Angle(Vector3 a, Vector3 b)
     return acos(v);
 }
 
+double Vector3::Angle(UnitVector3 a, UnitVector3 b)
+{
+    double v = Dot(a, b);
+    v = fmax(v, -1.0);
+    v = fmin(v, 1.0);
+    return acos(v);
+}
+
+double Vector3::Angle(Vector3 a, Vector3 b, FastMath)
+{
+    return FastMath::Atan2(Magnitude(Cross(a, b)), Dot(a, b));
+}
+
 Vector3 Vector3::ClampMagnitude(Vector3 vector, double maxLength)
 {
     double length = Magnitude(vector);
@@ -386,6 +570,11 @@ double Vector3::Component(Vector3 a, Vector3 b)
     return Dot(a, b) / Magnitude(b);
 }
 
+double Vector3::Component(Vector3 a, UnitVector3 b)
+{
+    return Dot(a, b);
+}
+
 Vector3 Vector3::Cross(Vector3 lhs, Vector3 rhs)
 {
     double x = lhs.Y * rhs.Z - lhs.Z * rhs.Y;
@@ -406,10 +595,13 @@ double Vector3::Dot(Vector3 lhs, Vector3 rhs)
 
 Vector3 Vector3::FromSpherical(double rad, double theta, double phi)
 {
+    double sinTheta, cosTheta, sinPhi, cosPhi;
+    FastMath::SinCos(theta, sinTheta, cosTheta);
+    FastMath::SinCos(phi, sinPhi, cosPhi);
     Vector3 v;
-    v.X = rad * sin(theta) * cos(phi);
-    v.Y = rad * sin(theta) * sin(phi);
-    v.Z = rad * cos(theta);
+    v.X = rad * sinTheta * cosPhi;
+    v.Y = rad * sinTheta * sinPhi;
+    v.Z = rad * cosTheta;
     return v;
 }
 
@@ -472,6 +664,16 @@ Vector3 Vector3::Orthogonal(Vector3 v)
 void Vector3::OrthoNormalize(Vector3 &normal, Vector3 &tangent,
                              Vector3 &binormal)
 {
+    UnitVector3 n, t;
+    if (TryNormalize(normal, n) && TryNormalize(ProjectOnPlane(tangent, n), t))
+    {
+        binormal = ProjectOnPlane(binormal, t);
+        binormal = ProjectOnPlane(binormal, n);
+        binormal = Normalized(binormal);
+        normal = n;
+        tangent = t;
+        return;
+    }
     normal = Normalized(normal);
     tangent = ProjectOnPlane(tangent, normal);
     tangent = Normalized(tangent);
@@ -486,21 +688,41 @@ Vector3 Vector3::Project(Vector3 a, Vector3 b)
     return Dot(a, b) / (m * m) * b;
 }
 
+Vector3 Vector3::Project(Vector3 a, UnitVector3 b)
+{
+    return Dot(a, b) * b;
+}
+
 Vector3 Vector3::ProjectOnPlane(Vector3 vector, Vector3 planeNormal)
 {
     return Reject(vector, planeNormal);
 }
 
+Vector3 Vector3::ProjectOnPlane(Vector3 vector, UnitVector3 planeNormal)
+{
+    return Reject(vector, planeNormal);
+}
+
 Vector3 Vector3::Reflect(Vector3 vector, Vector3 planeNormal)
 {
     return vector - 2 * Project(vector, planeNormal);
 }
 
+Vector3 Vector3::Reflect(Vector3 vector, UnitVector3 planeNormal)
+{
+    return vector - 2 * Dot(vector, planeNormal) * planeNormal;
+}
+
 Vector3 Vector3::Reject(Vector3 a, Vector3 b)
 {
     return a - Project(a, b);
 }
 
+Vector3 Vector3::Reject(Vector3 a, UnitVector3 b)
+{
+    return a - Dot(a, b) * b;
+}
+
 Vector3 Vector3::RotateTowards(Vector3 current, Vector3 target,
                                double maxRadiansDelta,
                                double maxMagnitudeDelta)
@@ -525,8 +747,9 @@ Vector3 Vector3::RotateTowards(Vector3 current, Vector3 target,
     else
         axis /= magAxis;
     current = Normalized(current);
-    Vector3 newVector = current * cos(maxRadiansDelta) +
-        Cross(axis, current) * sin(maxRadiansDelta);
+    double sinDelta, cosDelta;
+    FastMath::SinCos(maxRadiansDelta, sinDelta, cosDelta);
+    Vector3 newVector = current * cosDelta + Cross(axis, current) * sinDelta;
     return newVector * newMag;
 }
 
@@ -552,8 +775,10 @@ Vector3 Vector3::SlerpUnclamped(Vector3 a, Vector3 b, double t)
     dot = fmax(dot, -1.0);
     dot = fmin(dot, 1.0);
     double theta = acos(dot) * t;
+    double sinTheta, cosTheta;
+    FastMath::SinCos(theta, sinTheta, cosTheta);
     Vector3 relativeVec = Normalized(b - a * dot);
-    Vector3 newVec = a * cos(theta) + relativeVec * sin(theta);
+    Vector3 newVec = a * cosTheta + relativeVec * sinTheta;
     return newVec * (magA + (magB - magA) * t);
 }
 
@@ -573,6 +798,24 @@ void Vector3::ToSpherical(Vector3 vector, double &rad, double &theta,
     phi = atan2(vector.Y, vector.X);
 }
 
+void Vector3::ToSpherical(Vector3 vector, double &rad, double &theta,
+                          double &phi, FastMath)
+{
+    rad = Magnitude(vector);
+    double planar = sqrt(vector.X * vector.X + vector.Y * vector.Y);
+    theta = FastMath::Atan2(planar, vector.Z);
+    phi = FastMath::Atan2(vector.Y, vector.X);
+}
+
+bool Vector3::TryNormalize(Vector3 v, UnitVector3 &unit)
+{
+    double mag = Magnitude(v);
+    if (mag == 0)
+        return false;
+    unit = UnitVector3(v / mag);
+    return true;
+}
+
 
 struct Vector3& Vector3::operator+=(const double rhs)
 {
@@ -643,3 +886,21 @@ bool operator!=(const Vector3 lhs, const Vector3 rhs)
 {
     return !(lhs == rhs);
 }
+
+
+UnitVector3::UnitVector3() : Unit(0, 0, 1) {}
+UnitVector3::UnitVector3(Vector3 unit) : Unit(unit) {}
+
+
+double UnitVector3::X() const { return Unit.X; }
+double UnitVector3::Y() const { return Unit.Y; }
+double UnitVector3::Z() const { return Unit.Z; }
+UnitVector3::operator const Vector3&() const { return Unit; }
+
+
+UnitVector3 UnitVector3::Right() { return UnitVector3(Vector3(1, 0, 0)); }
+UnitVector3 UnitVector3::Left() { return UnitVector3(Vector3(-1, 0, 0)); }
+UnitVector3 UnitVector3::Up() { return UnitVector3(Vector3(0, 1, 0)); }
+UnitVector3 UnitVector3::Down() { return UnitVector3(Vector3(0, -1, 0)); }
+UnitVector3 UnitVector3::Forward() { return UnitVector3(Vector3(0, 0, 1)); }
+UnitVector3 UnitVector3::Backward() { return UnitVector3(Vector3(0, 0, -1)); }
@@ -0,0 +1,176 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file implements a structure of arrays container for 3D vectors,
+ *  which keeps each component in its own contiguous array for batch kernels.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+#include "Vector3.hpp"
+
+
+struct Vector3Array
+{
+    std::vector<double> X;
+    std::vector<double> Y;
+    std::vector<double> Z;
+
+
+    /**
+     * Constructors.
+     */
+    inline Vector3Array();
+    inline explicit Vector3Array(size_t count);
+    inline Vector3Array(const Vector3 *vectors, size_t count);
+
+
+    /**
+     * Returns the vector stored at an index.
+     * @param array: The array to read from.
+     * @param index: The index of the vector.
+     * @return: A new vector.
+     */
+    static inline Vector3 Get(const Vector3Array &array, size_t index);
+
+    /**
+     * Copies the last, partial block of a component array into a buffer of
+     * "size" values, padded with zeroes, so that a batch kernel can always
+     * work on whole blocks. The results of the padding lanes are never
+     * written out.
+     * @param values: The start of the partial block.
+     * @param count: The number of values left, less than size.
+     * @param size: The number of values in a whole block.
+     * @param padded: The buffer, which must hold size values.
+     * @return: The padded buffer.
+     */
+    static inline const double *PadBlock(const double *values, size_t count,
+                                         size_t size, double *padded);
+
+    /**
+     * Appends a vector to the end of an array.
+     * @param array: The array to append to.
+     * @param value: The vector to append.
+     */
+    static inline void PushBack(Vector3Array &array, Vector3 value);
+
+    /**
+     * Changes the number of vectors in an array. New vectors are zero.
+     * @param array: The array to resize.
+     * @param count: The new number of vectors.
+     */
+    static inline void Resize(Vector3Array &array, size_t count);
+
+    /**
+     * Stores a vector at an index.
+     * @param array: The array to write to.
+     * @param index: The index of the vector.
+     * @param value: The vector to store.
+     */
+    static inline void Set(Vector3Array &array, size_t index, Vector3 value);
+
+    /**
+     * Returns the number of vectors in an array.
+     * @param array: The array in question.
+     * @return: A count.
+     */
+    static inline size_t Size(const Vector3Array &array);
+
+    /**
+     * Copies every vector in an array out to an array of Vector3.
+     * @param array: The array to copy from.
+     * @param vectors: The output vectors, which must hold Size(array).
+     */
+    static inline void ToVectors(const Vector3Array &array, Vector3 *vectors);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+Vector3Array::Vector3Array() {}
+Vector3Array::Vector3Array(size_t count) : X(count), Y(count), Z(count) {}
+Vector3Array::Vector3Array(const Vector3 *vectors, size_t count) :
+    X(count), Y(count), Z(count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        X[i] = vectors[i].X;
+        Y[i] = vectors[i].Y;
+        Z[i] = vectors[i].Z;
+    }
+}
+
+
+Vector3 Vector3Array::Get(const Vector3Array &array, size_t index)
+{
+    return Vector3(array.X[index], array.Y[index], array.Z[index]);
+}
+
+const double *Vector3Array::PadBlock(const double *values, size_t count,
+                                    size_t size, double *padded)
+{
+    std::copy(values, values + count, padded);
+    std::fill(padded + count, padded + size, 0.0);
+    return padded;
+}
+
+void Vector3Array::PushBack(Vector3Array &array, Vector3 value)
+{
+    array.X.push_back(value.X);
+    array.Y.push_back(value.Y);
+    array.Z.push_back(value.Z);
+}
+
+void Vector3Array::Resize(Vector3Array &array, size_t count)
+{
+    array.X.resize(count);
+    array.Y.resize(count);
+    array.Z.resize(count);
+}
+
+void Vector3Array::Set(Vector3Array &array, size_t index, Vector3 value)
+{
+    array.X[index] = value.X;
+    array.Y[index] = value.Y;
+    array.Z[index] = value.Z;
+}
+
+size_t Vector3Array::Size(const Vector3Array &array)
+{
+    return array.X.size();
+}
+
+void Vector3Array::ToVectors(const Vector3Array &array, Vector3 *vectors)
+{
+    for (size_t i = 0; i < array.X.size(); i++)
+        vectors[i] = Vector3(array.X[i], array.Y[i], array.Z[i]);
+}
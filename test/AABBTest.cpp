@@ -0,0 +1,194 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the AABB functions.
+ */
+
+#include "catch.hpp"
+#include "AABB.hpp"
+
+
+TEST_CASE("AABB empty", "[AABB]")
+{
+    // Case 1
+    AABB box;
+    CHECK(AABB::IsEmpty(box));
+    box = AABB::Expand(box, Vector3(1, 2, 3));
+    CHECK_FALSE(AABB::IsEmpty(box));
+    CHECK(box.Min == Vector3(1, 2, 3));
+    CHECK(box.Max == Vector3(1, 2, 3));
+    // Case 2
+    CHECK(AABB::Union(AABB::Empty(), box) == box);
+}
+
+TEST_CASE("AABB from points", "[AABB]")
+{
+    // Case 1
+    Vector3 points[] = { Vector3(1, -2, 0), Vector3(-3, 4, 2),
+        Vector3(0, 0, -5) };
+    AABB box = AABB::FromPoints(points, 3);
+    CHECK(box.Min == Vector3(-3, -2, -5));
+    CHECK(box.Max == Vector3(1, 4, 2));
+    CHECK(AABB::Center(box) == Vector3(-1, 1, -1.5));
+    CHECK(AABB::Size(box) == Vector3(4, 6, 7));
+    CHECK(AABB::Extents(box) == Vector3(2, 3, 3.5));
+    CHECK(AABB::SurfaceArea(box) == Approx(2 * (24 + 42 + 28)));
+}
+
+TEST_CASE("AABB union and expand", "[AABB]")
+{
+    // Case 1
+    AABB a = AABB(Vector3(0, 0, 0), Vector3(1, 1, 1));
+    AABB b = AABB(Vector3(-1, 0.5, 2), Vector3(0.5, 3, 4));
+    AABB u = AABB::Union(a, b);
+    CHECK(u.Min == Vector3(-1, 0, 0));
+    CHECK(u.Max == Vector3(1, 3, 4));
+    // Case 2
+    AABB e = AABB::Expand(a, 0.5);
+    CHECK(e.Min == Vector3(-0.5, -0.5, -0.5));
+    CHECK(e.Max == Vector3(1.5, 1.5, 1.5));
+}
+
+TEST_CASE("AABB contains and overlaps", "[AABB]")
+{
+    AABB a = AABB(Vector3(0, 0, 0), Vector3(2, 2, 2));
+    // Case 1
+    CHECK(AABB::Contains(a, Vector3(1, 1, 1)));
+    CHECK(AABB::Contains(a, Vector3(2, 0, 2)));
+    CHECK_FALSE(AABB::Contains(a, Vector3(1, 3, 1)));
+    // Case 2
+    CHECK(AABB::Contains(a, AABB(Vector3(0.5, 0.5, 0.5), Vector3(1, 1, 1))));
+    CHECK_FALSE(AABB::Contains(a, AABB(Vector3(1, 1, 1), Vector3(3, 1, 1))));
+    // Case 3
+    CHECK(AABB::Overlaps(a, AABB(Vector3(1, 1, 1), Vector3(3, 3, 3))));
+    CHECK(AABB::Overlaps(a, AABB(Vector3(2, 2, 2), Vector3(3, 3, 3))));
+    CHECK_FALSE(AABB::Overlaps(a, AABB(Vector3(1, 3, 1), Vector3(2, 4, 2))));
+}
+
+TEST_CASE("AABB transform", "[AABB]")
+{
+    // Case 1
+    AABB box = AABB(Vector3(-1, -2, -3), Vector3(1, 2, 3));
+    Matrix3x3 m = Matrix3x3(0.5, -1.2, 0.3, 2, 0.1, -0.7, -0.4, 0.9, 1.5);
+    Vector3 t = Vector3(5, -1, 2);
+    AABB result = AABB::Transform(box, m, t);
+    AABB corners;
+    for (int i = 0; i < 8; i++)
+    {
+        Vector3 c = Vector3(i & 1 ? box.Max.X : box.Min.X,
+                            i & 2 ? box.Max.Y : box.Min.Y,
+                            i & 4 ? box.Max.Z : box.Min.Z);
+        corners = AABB::Expand(corners, m * c + t);
+    }
+    CHECK(result.Min.X == Approx(corners.Min.X));
+    CHECK(result.Min.Y == Approx(corners.Min.Y));
+    CHECK(result.Min.Z == Approx(corners.Min.Z));
+    CHECK(result.Max.X == Approx(corners.Max.X));
+    CHECK(result.Max.Y == Approx(corners.Max.Y));
+    CHECK(result.Max.Z == Approx(corners.Max.Z));
+    // Case 2
+    result = AABB::Transform(box, Matrix3x3::Identity(), Vector3(1, 1, 1));
+    CHECK(result.Min == Vector3(0, -1, -2));
+    CHECK(result.Max == Vector3(2, 3, 4));
+}
+
+TEST_CASE("AABB raycast", "[AABB]")
+{
+    AABB box = AABB(Vector3(1, -1, -1), Vector3(3, 1, 1));
+    double distance;
+    // Case 1
+    CHECK(AABB::Raycast(box, Vector3(0, 0, 0), Vector3(1, 0, 0), 10,
+                        distance));
+    CHECK(distance == Approx(1));
+    // Case 2
+    CHECK(AABB::Raycast(box, Vector3(2, 0, 0), Vector3(0, 1, 0), 10,
+                        distance));
+    CHECK(distance == 0);
+    // Case 3
+    CHECK_FALSE(AABB::Raycast(box, Vector3(0, 0, 0), Vector3(-1, 0, 0), 10,
+                              distance));
+    CHECK_FALSE(AABB::Raycast(box, Vector3(0, 0, 0), Vector3(1, 0, 0), 0.5,
+                              distance));
+    CHECK_FALSE(AABB::Raycast(box, Vector3(0, 2, 0), Vector3(1, 0, 0), 10,
+                              distance));
+    // Case 4
+    CHECK(AABB::Raycast(box, Vector3(0, 2, 0), Vector3(1, -1, 0), 10,
+                        distance));
+    CHECK(distance == Approx(1));
+    // Case 5: rays grazing a face, parallel to the planes they lie in
+    Vector3 corner = box.Min;
+    CHECK(AABB::Contains(box, corner));
+    CHECK(AABB::Raycast(box, Vector3(0, corner.Y, 0), Vector3(1, 0, 0), 10,
+                        distance));
+    CHECK(distance == Approx(corner.X));
+    CHECK(AABB::Raycast(box, Vector3(0, box.Max.Y, box.Max.Z),
+                        Vector3(1, 0, 0), 10, distance));
+    CHECK(AABB::Raycast(box, Vector3(0, corner.Y, corner.Z),
+                        Vector3(1, -0.0, 0), 10, distance));
+    CHECK(AABB::Raycast(box, Vector3(5, corner.Y, 0), Vector3(-1, 0, 0), 10,
+                        distance));
+    CHECK(distance == Approx(5 - box.Max.X));
+    CHECK_FALSE(AABB::Raycast(box, Vector3(0, corner.Y - 1e-9, 0),
+                              Vector3(1, 0, 0), 10, distance));
+    // Case 6: a flat box, with the ray in its plane
+    AABB flat(Vector3(1, -1, 0), Vector3(2, 1, 0));
+    CHECK(AABB::Raycast(flat, Vector3::Zero(), Vector3(1, 0, 0), 10,
+                        distance));
+    CHECK(distance == Approx(1));
+}
+
+TEST_CASE("AABB batch raycast", "[AABB]")
+{
+    // Case 1
+    AABB boxes[] = {
+        AABB(Vector3(1, -1, -1), Vector3(2, 1, 1)),
+        AABB(Vector3(1, 2, -1), Vector3(2, 3, 1)),
+        AABB(Vector3(-3, -1, -1), Vector3(-2, 1, 1)),
+        AABB(Vector3(5, -0.5, -0.5), Vector3(6, 0.5, 0.5)),
+        AABB(Vector3(-1, -1, -1), Vector3(1, 1, 1)),
+    };
+    bool hits[5];
+    double distances[5];
+    AABB::Raycast(boxes, 5, Vector3::Zero(), Vector3(2, 0, 0), 2.75, hits,
+                  distances);
+    CHECK(hits[0]);
+    CHECK(distances[0] == Approx(0.5));
+    CHECK_FALSE(hits[1]);
+    CHECK_FALSE(hits[2]);
+    CHECK(hits[3]);
+    CHECK(distances[3] == Approx(2.5));
+    CHECK(hits[4]);
+    CHECK(distances[4] == 0);
+    // Case 2
+    for (int i = 0; i < 5; i++)
+    {
+        bool hit;
+        double distance;
+        hit = AABB::Raycast(boxes[i], Vector3::Zero(), Vector3(2, 0, 0), 2.75,
+                            distance);
+        CHECK(hit == hits[i]);
+    }
+}
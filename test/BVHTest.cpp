@@ -0,0 +1,249 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the BVH functions.
+ */
+
+#include <vector>
+#include "catch.hpp"
+#include "BVH.hpp"
+#include "Random.hpp"
+
+
+static std::vector<Vector3> RandomTriangles(size_t count, unsigned int seed)
+{
+    std::vector<Vector3> vertices(3 * count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3 center;
+        for (int axis = 0; axis < 3; axis++)
+            center.data[axis] = Random::Value(seed) * 20 - 10;
+        for (int j = 0; j < 3; j++)
+        {
+            Vector3 offset;
+            for (int axis = 0; axis < 3; axis++)
+                offset.data[axis] = Random::Value(seed) - 0.5;
+            vertices[3 * i + j] = center + offset;
+        }
+    }
+    return vertices;
+}
+
+
+TEST_CASE("BVH node layout", "[BVH]")
+{
+    CHECK(sizeof(BVHNode) == 32);
+}
+
+TEST_CASE("BVH empty", "[BVH]")
+{
+    // Case 1
+    BVH bvh = BVH::FromTriangles(nullptr, 0);
+    size_t triangle;
+    double distance;
+    Vector3 closest;
+    std::vector<size_t> found;
+    CHECK(bvh.Nodes.empty());
+    CHECK_FALSE(BVH::Raycast(bvh, nullptr, Vector3::Zero(), Vector3::Right(),
+                             INFINITY, triangle, distance));
+    CHECK_FALSE(BVH::Nearest(bvh, nullptr, Vector3::Zero(), INFINITY,
+                             triangle, closest));
+    BVH::Overlap(bvh, nullptr, AABB(Vector3::Zero(), Vector3::One()), found);
+    CHECK(found.empty());
+}
+
+TEST_CASE("BVH structure", "[BVH]")
+{
+    // Case 1
+    std::vector<Vector3> vertices = RandomTriangles(3000, 7);
+    BVH bvh = BVH::FromTriangles(vertices.data(), 3000);
+    std::vector<int> seen(3000, 0);
+    bool contained = true;
+    for (size_t i = 0; i < bvh.Nodes.size(); i++)
+    {
+        const BVHNode &node = bvh.Nodes[i];
+        if (i == 0 || node.Count > 0)
+            continue;
+        for (size_t c = node.Offset; c <= node.Offset + 1; c++)
+            for (int axis = 0; axis < 3; axis++)
+                contained = contained &&
+                    bvh.Nodes[c].Min[axis] >= node.Min[axis] &&
+                    bvh.Nodes[c].Max[axis] <= node.Max[axis];
+    }
+    for (size_t i = 1; i < bvh.Nodes.size(); i++)
+    {
+        const BVHNode &node = bvh.Nodes[i];
+        CHECK(node.Count <= (size_t)BVH::MaxLeafSize);
+        for (size_t j = node.Offset; node.Count > 0 &&
+             j < node.Offset + node.Count; j++)
+            seen[bvh.Indices[j]]++;
+    }
+    CHECK(contained);
+    bool once = true;
+    for (size_t i = 0; i < seen.size(); i++)
+        once = once && seen[i] == 1;
+    CHECK(once);
+}
+
+TEST_CASE("BVH raycast", "[BVH]")
+{
+    std::vector<Vector3> vertices = RandomTriangles(2000, 11);
+    BVH bvh = BVH::FromTriangles(vertices.data(), 2000);
+    // Case 1
+    unsigned int seed = 3;
+    int hits = 0;
+    for (int r = 0; r < 200; r++)
+    {
+        Vector3 origin, direction;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            origin.data[axis] = Random::Value(seed) * 30 - 15;
+            direction.data[axis] = Random::Value(seed) * 2 - 1;
+        }
+        size_t expectedTriangle = 0;
+        double expectedDistance = 40;
+        bool expected = false;
+        for (size_t t = 0; t < 2000; t++)
+        {
+            double d;
+            if (BVH::RaycastTriangle(origin, direction, vertices[3 * t],
+                                     vertices[3 * t + 1],
+                                     vertices[3 * t + 2], d) &&
+                d <= expectedDistance)
+            {
+                expected = true;
+                expectedDistance = d;
+                expectedTriangle = t;
+            }
+        }
+        size_t triangle;
+        double distance;
+        bool hit = BVH::Raycast(bvh, vertices.data(), origin, direction, 40,
+                                triangle, distance);
+        CHECK(hit == expected);
+        if (hit && expected)
+        {
+            hits++;
+            CHECK(triangle == expectedTriangle);
+            CHECK(distance == Approx(expectedDistance));
+        }
+    }
+    CHECK(hits > 0);
+    // Case 2
+    Vector3 tri[] = { Vector3(0, 0, 5), Vector3(1, 0, 5), Vector3(0, 1, 5) };
+    BVH single = BVH::FromTriangles(tri, 1);
+    size_t triangle;
+    double distance;
+    CHECK(BVH::Raycast(single, tri, Vector3(0.25, 0.25, 0), Vector3::Forward(),
+                       10, triangle, distance));
+    CHECK(distance == Approx(5));
+    CHECK_FALSE(BVH::Raycast(single, tri, Vector3(0.25, 0.25, 0),
+                             Vector3::Forward(), 4, triangle, distance));
+    CHECK_FALSE(BVH::Raycast(single, tri, Vector3(0.75, 0.75, 0),
+                             Vector3::Forward(), 10, triangle, distance));
+    // Case 3: rays grazing the bounds, parallel to the planes they lie in
+    Vector3 edge[] = { Vector3(2, 0, -1), Vector3(2, 2, -1), Vector3(2, 0, 1) };
+    BVH grazed = BVH::FromTriangles(edge, 1);
+    CHECK(BVH::Raycast(grazed, edge, Vector3::Zero(), Vector3(1, 0, 0), 10,
+                       triangle, distance));
+    CHECK(distance == Approx(2));
+    CHECK(BVH::Raycast(grazed, edge, Vector3::Zero(), Vector3(1, -0.0, 0), 10,
+                       triangle, distance));
+    CHECK(distance == Approx(2));
+    CHECK(BVH::Raycast(grazed, edge, Vector3(0, 2, -1), Vector3(1, 0, 0), 10,
+                       triangle, distance));
+    CHECK_FALSE(BVH::Raycast(grazed, edge, Vector3(0, -1e-9, 0),
+                             Vector3(1, -0.0, 0), 10, triangle, distance));
+}
+
+TEST_CASE("BVH overlap", "[BVH]")
+{
+    std::vector<Vector3> vertices = RandomTriangles(2000, 5);
+    BVH bvh = BVH::FromTriangles(vertices.data(), 2000);
+    // Case 1
+    AABB box = AABB(Vector3(-3, -2, -4), Vector3(1, 2, 0));
+    std::vector<size_t> found;
+    BVH::Overlap(bvh, vertices.data(), box, found);
+    std::vector<int> flags(2000, 0);
+    for (size_t i = 0; i < found.size(); i++)
+        flags[found[i]]++;
+    bool correct = true;
+    size_t expected = 0;
+    for (size_t t = 0; t < 2000; t++)
+    {
+        AABB bounds = AABB::Expand(AABB::Expand(AABB(vertices[3 * t],
+            vertices[3 * t]), vertices[3 * t + 1]), vertices[3 * t + 2]);
+        bool overlaps = AABB::Overlaps(bounds, box);
+        expected += overlaps;
+        correct = correct && flags[t] == (overlaps ? 1 : 0);
+    }
+    CHECK(correct);
+    CHECK(found.size() == expected);
+    CHECK(expected > 0);
+}
+
+TEST_CASE("BVH nearest", "[BVH]")
+{
+    std::vector<Vector3> vertices = RandomTriangles(2000, 13);
+    BVH bvh = BVH::FromTriangles(vertices.data(), 2000);
+    // Case 1
+    unsigned int seed = 17;
+    for (int q = 0; q < 100; q++)
+    {
+        Vector3 point;
+        for (int axis = 0; axis < 3; axis++)
+            point.data[axis] = Random::Value(seed) * 30 - 15;
+        double expected = INFINITY;
+        for (size_t t = 0; t < 2000; t++)
+        {
+            Vector3 c = BVH::ClosestPointOnTriangle(point, vertices[3 * t],
+                vertices[3 * t + 1], vertices[3 * t + 2]);
+            double d = Vector3::Distance(c, point);
+            if (d < expected)
+                expected = d;
+        }
+        size_t triangle;
+        Vector3 closest;
+        REQUIRE(BVH::Nearest(bvh, vertices.data(), point, INFINITY, triangle,
+                             closest));
+        CHECK(Vector3::Distance(closest, point) == Approx(expected));
+    }
+    // Case 2
+    Vector3 tri[] = { Vector3(0, 0, 0), Vector3(2, 0, 0), Vector3(0, 2, 0) };
+    BVH single = BVH::FromTriangles(tri, 1);
+    size_t triangle;
+    Vector3 closest;
+    CHECK(BVH::Nearest(single, tri, Vector3(0.5, 0.5, 3), 10, triangle,
+                       closest));
+    CHECK(closest == Vector3(0.5, 0.5, 0));
+    CHECK(BVH::Nearest(single, tri, Vector3(3, 3, 0), 10, triangle, closest));
+    CHECK(closest == Vector3(1, 1, 0));
+    CHECK(BVH::Nearest(single, tri, Vector3(-1, -1, 0), 10, triangle,
+                       closest));
+    CHECK(closest == Vector3(0, 0, 0));
+    CHECK_FALSE(BVH::Nearest(single, tri, Vector3(0.5, 0.5, 3), 2, triangle,
+                             closest));
+}
@@ -0,0 +1,109 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the DenormalGuard functions.
+ */
+
+#include "catch.hpp"
+#include "DenormalGuard.hpp"
+
+
+TEST_CASE("Denormal guard flushes to zero", "[DenormalGuard]")
+{
+    volatile double small = DBL_MIN;
+    volatile double half = 0.5;
+    CHECK(small * half != 0);
+    {
+        DenormalGuard guard;
+        CHECK(DenormalGuard::IsFlushing());
+        CHECK(small * half == 0);
+    }
+    CHECK_FALSE(DenormalGuard::IsFlushing());
+    CHECK(small * half != 0);
+}
+
+TEST_CASE("Disabled denormal guard", "[DenormalGuard]")
+{
+    volatile double small = DBL_MIN;
+    volatile double half = 0.5;
+    DenormalGuard guard(false);
+    CHECK_FALSE(DenormalGuard::IsFlushing());
+    CHECK(small * half != 0);
+}
+
+TEST_CASE("Nested denormal guards", "[DenormalGuard]")
+{
+    {
+        DenormalGuard outer;
+        {
+            DenormalGuard inner;
+            CHECK(DenormalGuard::IsFlushing());
+        }
+        CHECK(DenormalGuard::IsFlushing());
+    }
+    CHECK_FALSE(DenormalGuard::IsFlushing());
+}
+
+TEST_CASE("Is subnormal", "[DenormalGuard]")
+{
+    CHECK(DenormalGuard::IsSubnormal(DBL_MIN / 4));
+    CHECK(DenormalGuard::IsSubnormal(-DBL_MIN / 4));
+    CHECK_FALSE(DenormalGuard::IsSubnormal(0));
+    CHECK_FALSE(DenormalGuard::IsSubnormal(DBL_MIN));
+    CHECK_FALSE(DenormalGuard::IsSubnormal(1.5));
+}
+
+TEST_CASE("Count and record subnormals", "[DenormalGuard]")
+{
+    double values[] = { 1, DBL_MIN / 2, 0, -DBL_MIN / 8, 3e-300, 2e-310 };
+    CHECK(DenormalGuard::CountSubnormals(values, 6) == 3);
+    DenormalGuard::ResetSubnormalCount();
+    DenormalGuard::Inspect(values, 6);
+    CHECK(DenormalGuard::SubnormalCount() == 0);
+    DenormalGuard::SetRecording(true);
+    DenormalGuard::Inspect(values, 6);
+    DenormalGuard::Inspect(values, 2);
+    DenormalGuard::SetRecording(false);
+    CHECK(DenormalGuard::SubnormalCount() == 4);
+    DenormalGuard::ResetSubnormalCount();
+    CHECK(DenormalGuard::SubnormalCount() == 0);
+}
+
+TEST_CASE("Record subnormals under a guard", "[DenormalGuard]")
+{
+    double values[] = { 1, DBL_MIN / 2, 0, -DBL_MIN / 8 };
+    DenormalGuard::ResetSubnormalCount();
+    DenormalGuard::SetRecording(true);
+    {
+        DenormalGuard guard;
+        CHECK(DenormalGuard::IsSubnormal(values[1]));
+        CHECK(DenormalGuard::CountSubnormals(values, 4) == 2);
+        DenormalGuard::Inspect(values, 4);
+    }
+    DenormalGuard::SetRecording(false);
+    CHECK(DenormalGuard::SubnormalCount() == 2);
+    DenormalGuard::ResetSubnormalCount();
+}
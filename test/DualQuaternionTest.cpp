@@ -0,0 +1,94 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the DualQuaternion functions.
+ */
+
+#include "catch.hpp"
+#include "DualQuaternion.hpp"
+
+
+#define CHECK_VECTOR(a, b) \
+    CHECK(a.X == Approx(b.X)); \
+    CHECK(a.Y == Approx(b.Y)); \
+    CHECK(a.Z == Approx(b.Z));
+
+
+TEST_CASE("DualQuaternion transforms", "[DualQuaternion]")
+{
+    // Case 1
+    double s = sqrt(0.5);
+    Quaternion q = Quaternion(0, 0, s, s);
+    DualQuaternion a = DualQuaternion(q, Vector3(4, -3, 2));
+    CHECK_VECTOR(DualQuaternion::TransformPoint(a, Vector3(1, 0, 1)),
+                 Vector3(4, -2, 3));
+    CHECK_VECTOR(DualQuaternion::TransformVector(a, Vector3(1, 0, 1)),
+                 Vector3(0, 1, 1));
+    CHECK_VECTOR(DualQuaternion::ToTranslation(a), Vector3(4, -3, 2));
+    CHECK(DualQuaternion::ToRotation(a) == q);
+    // Case 2
+    DualQuaternion b = DualQuaternion(
+        Quaternion::Normalized(Quaternion(0.1, 0.7, -0.3, 0.6)),
+        Vector3(-1, 5, 0.5));
+    Vector3 p = Vector3(2, -1, 3);
+    CHECK_VECTOR(DualQuaternion::TransformPoint(a * b, p),
+                 DualQuaternion::TransformPoint(a,
+                     DualQuaternion::TransformPoint(b, p)));
+    // Case 3
+    CHECK_VECTOR(DualQuaternion::TransformPoint(
+                     DualQuaternion::Inverse(b) * b, p), p);
+    CHECK_VECTOR(DualQuaternion::TransformPoint(
+                     DualQuaternion::Conjugate(b),
+                     DualQuaternion::TransformPoint(b, p)), p);
+    // Case 4
+    CHECK(DualQuaternion::Identity() == DualQuaternion());
+    CHECK_VECTOR(DualQuaternion::TransformPoint(DualQuaternion(), p), p);
+    CHECK(-(-b) == b);
+    CHECK((b - b) != b);
+}
+
+TEST_CASE("DualQuaternion normalization", "[DualQuaternion]")
+{
+    // Case 1
+    DualQuaternion a = DualQuaternion(
+        Quaternion::Normalized(Quaternion(-0.4, 0.2, 0.8, 0.3)),
+        Vector3(3, 1, -2));
+    DualQuaternion scaled = a * 2.5;
+    DualQuaternion n = DualQuaternion::Normalized(scaled);
+    CHECK(Quaternion::Norm(n.Real) == Approx(1));
+    CHECK_VECTOR(DualQuaternion::ToTranslation(n), Vector3(3, 1, -2));
+    // Case 2
+    DualQuaternion skewed = a;
+    skewed.Dual += a.Real * 0.25;
+    n = DualQuaternion::Normalized(skewed);
+    CHECK(Quaternion::Dot(n.Real, n.Dual) == Approx(0));
+    CHECK_VECTOR(DualQuaternion::TransformPoint(n, Vector3(1, 2, 3)),
+                 DualQuaternion::TransformPoint(a, Vector3(1, 2, 3)));
+    // Case 3
+    DualQuaternion blend = DualQuaternion::Normalized(
+        a * 0.5 + DualQuaternion(a.Real, Vector3(5, 1, -2)) * 0.5);
+    CHECK_VECTOR(DualQuaternion::ToTranslation(blend), Vector3(4, 1, -2));
+}
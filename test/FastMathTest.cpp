@@ -0,0 +1,143 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the FastMath functions.
+ */
+
+#include "catch.hpp"
+#include "FastMath.hpp"
+
+
+TEST_CASE("Fast arc cosine", "[FastMath]")
+{
+    double maxError = 0;
+    for (int i = 0; i <= 20000; i++)
+    {
+        double x = -1 + i / 10000.0;
+        maxError = fmax(maxError, fabs(FastMath::Acos(x) - acos(x)));
+    }
+    CHECK(maxError < 1.9e-9);
+    CHECK(FastMath::Acos(1) == Approx(0));
+    CHECK(FastMath::Acos(-1) == Approx(M_PI));
+    CHECK(FastMath::Acos(1.5) == Approx(0));
+    CHECK(FastMath::Acos(-1.5) == Approx(M_PI));
+}
+
+TEST_CASE("Fast arc sine", "[FastMath]")
+{
+    double maxError = 0;
+    for (int i = 0; i <= 20000; i++)
+    {
+        double x = -1 + i / 10000.0;
+        maxError = fmax(maxError, fabs(FastMath::Asin(x) - asin(x)));
+    }
+    CHECK(maxError < 1.9e-9);
+    CHECK(FastMath::Asin(1) == Approx(M_PI_2));
+    CHECK(FastMath::Asin(-1) == Approx(-M_PI_2));
+}
+
+TEST_CASE("Fast arc tangent", "[FastMath]")
+{
+    double maxError = 0;
+    for (int i = -20000; i <= 20000; i++)
+    {
+        double x = i / 1000.0;
+        maxError = fmax(maxError, fabs(FastMath::Atan(x) - atan(x)));
+    }
+    CHECK(maxError < 9.0e-10);
+    CHECK(FastMath::Atan(1e300) == Approx(M_PI_2));
+    CHECK(FastMath::Atan(-1e300) == Approx(-M_PI_2));
+}
+
+TEST_CASE("Fast two argument arc tangent", "[FastMath]")
+{
+    double maxError = 0;
+    for (int i = 0; i < 20000; i++)
+    {
+        double angle = -M_PI + i * M_PI / 10000.0;
+        double y = 3.7 * sin(angle);
+        double x = 3.7 * cos(angle);
+        maxError = fmax(maxError, fabs(FastMath::Atan2(y, x) - atan2(y, x)));
+    }
+    CHECK(maxError < 9.0e-10);
+    CHECK(FastMath::Atan2(0, 0) == 0);
+    CHECK(FastMath::Atan2(0, -2) == Approx(M_PI));
+    CHECK(FastMath::Atan2(2, 0) == Approx(M_PI_2));
+    CHECK(FastMath::Atan2(-2, 0) == Approx(-M_PI_2));
+}
+
+TEST_CASE("Fused sine and cosine", "[FastMath]")
+{
+    double maxError = 0;
+    for (int i = -20000; i <= 20000; i++)
+    {
+        double angle = i * 0.05;
+        double s, c;
+        FastMath::SinCos(angle, s, c);
+        maxError = fmax(maxError, fabs(s - sin(angle)));
+        maxError = fmax(maxError, fabs(c - cos(angle)));
+    }
+    CHECK(maxError < 1e-15);
+    // Case 1
+    double s, c;
+    FastMath::SinCos(M_PI_2, s, c);
+    CHECK(s == Approx(1));
+    CHECK(c == Approx(0));
+    // Case 2
+    FastMath::SinCos(-2.5, s, c);
+    CHECK(s == Approx(-0.5984721441));
+    CHECK(c == Approx(-0.8011436155));
+    // Case 3
+    FastMath::SinCos(1e7, s, c);
+    CHECK(s == Approx(sin(1e7)));
+    CHECK(c == Approx(cos(1e7)));
+}
+
+TEST_CASE("Fused sine and cosine of arrays", "[FastMath]")
+{
+    double angles[] = { 0, 0.3, -1.2, 3.5, 100, -1e6, 7.25 };
+    double sines[7];
+    double cosines[7];
+    FastMath::SinCos(angles, sines, cosines, 7);
+    for (int i = 0; i < 7; i++)
+    {
+        CHECK(sines[i] == Approx(sin(angles[i])));
+        CHECK(cosines[i] == Approx(cos(angles[i])));
+    }
+    // Case 2: angles outside the range of the reduction
+    double large[] = { 1e300, -1e20, INFINITY, NAN };
+    FastMath::SinCos(large, sines, cosines, 4);
+    for (int i = 0; i < 2; i++)
+    {
+        CHECK(sines[i] == sin(large[i]));
+        CHECK(cosines[i] == cos(large[i]));
+    }
+    for (int i = 2; i < 4; i++)
+    {
+        CHECK(isnan(sines[i]));
+        CHECK(isnan(cosines[i]));
+    }
+}
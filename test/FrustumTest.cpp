@@ -0,0 +1,179 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Frustum functions.
+ */
+
+#include <algorithm>
+#include <vector>
+#include "catch.hpp"
+#include "Frustum.hpp"
+#include "LooseOctree.hpp"
+#include "Random.hpp"
+
+
+static Frustum RotatedFrustum()
+{
+    // 45 degrees about Y after 30 degrees about X
+    double c = sqrt(0.5);
+    double c2 = cos(M_PI / 6);
+    double s2 = sin(M_PI / 6);
+    Matrix3x3 y = Matrix3x3(c, 0, c, 0, 1, 0, -c, 0, c);
+    Matrix3x3 x = Matrix3x3(1, 0, 0, 0, c2, -s2, 0, s2, c2);
+    return Frustum(y * x, Vector3(1, 2, 3), M_PI / 2, 1.5, 1, 10);
+}
+
+
+TEST_CASE("Frustum construction", "[Frustum]")
+{
+    // Case 1
+    Frustum f = Frustum(Matrix3x3::Identity(), Vector3::Zero(), M_PI / 2, 2,
+                        1, 10);
+    CHECK(f.Corners[0].X == Approx(-2));
+    CHECK(f.Corners[0].Y == Approx(-1));
+    CHECK(f.Corners[0].Z == Approx(1));
+    CHECK(f.Corners[7].X == Approx(20));
+    CHECK(f.Corners[7].Y == Approx(10));
+    CHECK(f.Corners[7].Z == Approx(10));
+    CHECK(Frustum::Contains(f, Vector3(0, 0, 5)));
+    CHECK(Frustum::Contains(f, Vector3(19, -9, 9.99)));
+    CHECK(!Frustum::Contains(f, Vector3(0, 0, 0.5)));
+    CHECK(!Frustum::Contains(f, Vector3(0, 0, 11)));
+    CHECK(!Frustum::Contains(f, Vector3(11, 0, 5)));
+    CHECK(!Frustum::Contains(f, Vector3(0, -6, 5)));
+    // Case 2
+    Vector3 normals[] = { Vector3(2, 0, 0), Vector3(-1, 0, 0),
+        Vector3(0, 3, 0), Vector3(0, -1, 0), Vector3(0, 0, 1),
+        Vector3(0, 0, -0.5) };
+    double offsets[] = { 2, 1, 3, 1, 1, 0.5 };
+    f = Frustum(normals, offsets);
+    CHECK(Vector3::Magnitude(f.Normals[0]) == Approx(1));
+    CHECK(f.Offsets[0] == Approx(1));
+    CHECK(f.Offsets[5] == Approx(1));
+    for (int i = 0; i < 8; i++)
+    {
+        CHECK(f.Corners[i].X == Approx(i & 1 ? 1 : -1));
+        CHECK(f.Corners[i].Y == Approx(i & 2 ? 1 : -1));
+        CHECK(f.Corners[i].Z == Approx(i & 4 ? 1 : -1));
+    }
+    CHECK(Frustum::Contains(f, Vector3(0.9, -0.9, 0.9)));
+    CHECK(!Frustum::Contains(f, Vector3(0.9, -1.1, 0.9)));
+}
+
+TEST_CASE("Frustum intersection", "[Frustum]")
+{
+    // Case 1
+    Frustum f = Frustum(Matrix3x3::Identity(), Vector3::Zero(), M_PI / 2, 2,
+                        1, 10);
+    CHECK(Frustum::Distance(f, Vector3(0, 0, 5)) == 0);
+    CHECK(Frustum::Distance(f, Vector3(0, 0, 13)) == Approx(3));
+    CHECK(Frustum::Distance(f, Vector3(21, 11, 11)) == Approx(sqrt(3.0)));
+    // Case 2
+    CHECK(Frustum::Intersects(f, Vector3(21, 11, 11), 1.2, FastMath()));
+    CHECK(!Frustum::Intersects(f, Vector3(21, 11, 11), 1.2));
+    CHECK(Frustum::Intersects(f, Vector3(21, 11, 11), 1.8));
+    CHECK(!Frustum::Intersects(f, Vector3(0, 0, 12), 1.8, FastMath()));
+    // Case 3
+    f = RotatedFrustum();
+    Vector3 center = Vector3(20.345, -0.569, -0.452);
+    Vector3 extents = Vector3(0.915, 0.915, 0.915);
+    AABB box = AABB(center - extents, center + extents);
+    CHECK(Frustum::Intersects(f, box, FastMath()));
+    CHECK(!Frustum::Intersects(f, box));
+    box = AABB::Expand(box, 0.5);
+    CHECK(Frustum::Intersects(f, box));
+    CHECK(Frustum::Intersects(f, AABB(Vector3(-100, -100, -100),
+                                      Vector3(100, 100, 100))));
+}
+
+TEST_CASE("Frustum batch culling", "[Frustum]")
+{
+    Frustum f = RotatedFrustum();
+    const size_t count = 20000;
+    unsigned int seed = 7;
+    Vector3Array centers = Vector3Array(count);
+    std::vector<double> radii(count);
+    std::vector<AABB> boxes(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3 p = Vector3(Random::Value(seed) * 40 - 15,
+                            Random::Value(seed) * 30 - 20,
+                            Random::Value(seed) * 40 - 12);
+        radii[i] = Random::Value(seed) * 2;
+        Vector3Array::Set(centers, i, p);
+        Vector3 e = Vector3(Random::Value(seed), Random::Value(seed),
+                            Random::Value(seed)) * 2;
+        boxes[i] = AABB(p - e, p + e);
+    }
+    std::vector<unsigned int> visible(count);
+
+    // Case 1
+    size_t n = Frustum::Cull(f, centers, radii.data(), visible.data());
+    std::vector<unsigned int> expected;
+    for (size_t i = 0; i < count; i++)
+        if (Frustum::Intersects(f, Vector3Array::Get(centers, i), radii[i]))
+            expected.push_back((unsigned int)i);
+    REQUIRE(n == expected.size());
+    CHECK(std::equal(expected.begin(), expected.end(), visible.begin()));
+    // Case 2
+    size_t exact = n;
+    n = Frustum::Cull(f, centers, radii.data(), visible.data(), FastMath());
+    expected.clear();
+    for (size_t i = 0; i < count; i++)
+        if (Frustum::Intersects(f, Vector3Array::Get(centers, i), radii[i],
+                                FastMath()))
+            expected.push_back((unsigned int)i);
+    REQUIRE(n == expected.size());
+    CHECK(std::equal(expected.begin(), expected.end(), visible.begin()));
+    CHECK(n > exact);
+    // Case 3
+    LooseOctree tree = LooseOctree(Vector3::Zero(), 64, 6);
+    for (size_t i = 0; i < count; i++)
+        LooseOctree::Insert(tree, Vector3Array::Get(centers, i), radii[i]);
+    std::vector<size_t> objects;
+    LooseOctree::Cull(tree, f, objects);
+    std::sort(objects.begin(), objects.end());
+    REQUIRE(objects.size() == expected.size());
+    CHECK(std::equal(expected.begin(), expected.end(), objects.begin()));
+    // Case 4
+    n = Frustum::Cull(f, boxes.data(), count, visible.data());
+    expected.clear();
+    for (size_t i = 0; i < count; i++)
+        if (Frustum::Intersects(f, boxes[i]))
+            expected.push_back((unsigned int)i);
+    REQUIRE(n == expected.size());
+    CHECK(std::equal(expected.begin(), expected.end(), visible.begin()));
+    // Case 5
+    exact = n;
+    n = Frustum::Cull(f, boxes.data(), count, visible.data(), FastMath());
+    expected.clear();
+    for (size_t i = 0; i < count; i++)
+        if (Frustum::Intersects(f, boxes[i], FastMath()))
+            expected.push_back((unsigned int)i);
+    REQUIRE(n == expected.size());
+    CHECK(std::equal(expected.begin(), expected.end(), visible.begin()));
+    CHECK(n > exact);
+}
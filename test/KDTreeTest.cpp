@@ -0,0 +1,179 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the KDTree functions.
+ */
+
+#include <algorithm>
+#include <vector>
+#include "catch.hpp"
+#include "KDTree.hpp"
+#include "Random.hpp"
+
+
+TEST_CASE("KDTree empty", "[KDTree]")
+{
+    // Case 1
+    KDTree tree = KDTree::Build(nullptr, 0);
+    size_t index;
+    double distance;
+    std::vector<size_t> found;
+    CHECK(KDTree::Nearest(tree, Vector3::Zero(), 1, &index, &distance) == 0);
+    KDTree::Radius(tree, Vector3::Zero(), 10, found);
+    CHECK(found.empty());
+}
+
+TEST_CASE("KDTree structure", "[KDTree]")
+{
+    // Case 1
+    std::vector<Vector3> points = Random::Points(1000, 10, 3);
+    KDTree tree = KDTree::Build(points.data(), 1000);
+    CHECK(tree.Levels == 6);
+    CHECK(tree.Data.size() == 63 + 3 * 1000);
+    std::vector<unsigned int> sorted = tree.Indices;
+    std::sort(sorted.begin(), sorted.end());
+    bool permutation = true;
+    for (size_t i = 0; i < sorted.size(); i++)
+        permutation = permutation && sorted[i] == i;
+    CHECK(permutation);
+    // Case 2
+    KDTree small = KDTree::Build(points.data(), 16);
+    CHECK(small.Levels == 0);
+    CHECK(small.Data.size() == 3 * 16);
+}
+
+TEST_CASE("KDTree nearest", "[KDTree]")
+{
+    std::vector<Vector3> points = Random::Points(2000, 10, 5);
+    Vector3Array array = Vector3Array(points.data(), points.size());
+    KDTree tree = KDTree::Build(array);
+    std::vector<Vector3> queries = Random::Points(50, 10, 9);
+    // Case 1
+    for (size_t q = 0; q < queries.size(); q++)
+    {
+        std::vector<double> expected(points.size());
+        for (size_t i = 0; i < points.size(); i++)
+            expected[i] = Vector3::Distance(points[i], queries[q]);
+        std::sort(expected.begin(), expected.end());
+        size_t indices[8];
+        double distances[8];
+        REQUIRE(KDTree::Nearest(tree, queries[q], 8, indices, distances) == 8);
+        for (int j = 0; j < 8; j++)
+        {
+            CHECK(distances[j] == Approx(expected[j]));
+            CHECK(Vector3::Distance(points[indices[j]], queries[q]) ==
+                  Approx(distances[j]));
+        }
+    }
+    // Case 2
+    size_t indices[4];
+    double distances[4];
+    KDTree tiny = KDTree::Build(points.data(), 3);
+    CHECK(KDTree::Nearest(tiny, points[1], 4, indices, distances) == 3);
+    CHECK(indices[0] == 1);
+    CHECK(distances[0] == 0);
+}
+
+TEST_CASE("KDTree batch nearest", "[KDTree]")
+{
+    // Case 1
+    std::vector<Vector3> points = Random::Points(1500, 10, 7);
+    KDTree tree = KDTree::Build(points.data(), points.size());
+    std::vector<Vector3> queries = Random::Points(300, 10, 11);
+    std::vector<size_t> indices(300 * 3);
+    std::vector<double> distances(300 * 3);
+    KDTree::Nearest(tree, queries.data(), 300, 3, indices.data(),
+                    distances.data());
+    bool same = true;
+    for (size_t q = 0; q < queries.size(); q++)
+    {
+        size_t single[3];
+        double singleDistances[3];
+        KDTree::Nearest(tree, queries[q], 3, single, singleDistances);
+        for (int j = 0; j < 3; j++)
+            same = same && single[j] == indices[3 * q + j] &&
+                singleDistances[j] == distances[3 * q + j];
+    }
+    CHECK(same);
+    // Case 2
+    KDTree tiny = KDTree::Build(points.data(), 2);
+    KDTree::Nearest(tiny, queries.data(), 1, 3, indices.data(),
+                    distances.data());
+    CHECK(indices[2] == SIZE_MAX);
+    CHECK(distances[2] == INFINITY);
+}
+
+TEST_CASE("KDTree radius", "[KDTree]")
+{
+    std::vector<Vector3> points = Random::Points(2000, 10, 13);
+    KDTree tree = KDTree::Build(points.data(), points.size());
+    std::vector<Vector3> queries = Random::Points(40, 10, 17);
+    // Case 1
+    for (size_t q = 0; q < queries.size(); q++)
+    {
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < points.size(); i++)
+            if (Vector3::Distance(points[i], queries[q]) <= 1.5)
+                expected.push_back(i);
+        std::vector<size_t> found;
+        KDTree::Radius(tree, queries[q], 1.5, found);
+        std::sort(found.begin(), found.end());
+        CHECK(found == expected);
+    }
+    // Case 2
+    std::vector<size_t> offsets;
+    std::vector<size_t> indices;
+    KDTree::Radius(tree, queries.data(), queries.size(), 1.5, offsets,
+                   indices);
+    REQUIRE(offsets.size() == queries.size() + 1);
+    CHECK(offsets.back() == indices.size());
+    bool same = true;
+    for (size_t q = 0; q < queries.size(); q++)
+    {
+        std::vector<size_t> found;
+        KDTree::Radius(tree, queries[q], 1.5, found);
+        same = same && std::equal(found.begin(), found.end(),
+                                  indices.begin() + offsets[q]) &&
+            offsets[q + 1] - offsets[q] == found.size();
+    }
+    CHECK(same);
+}
+
+TEST_CASE("KDTree duplicate points", "[KDTree]")
+{
+    // Case 1
+    std::vector<Vector3> points(100, Vector3(1, 2, 3));
+    points[57] = Vector3(1, 2, 4);
+    KDTree tree = KDTree::Build(points.data(), points.size());
+    std::vector<size_t> found;
+    KDTree::Radius(tree, Vector3(1, 2, 3), 0, found);
+    CHECK(found.size() == 99);
+    size_t index;
+    double distance;
+    KDTree::Nearest(tree, Vector3(1, 2, 5), 1, &index, &distance);
+    CHECK(index == 57);
+    CHECK(distance == 1);
+}
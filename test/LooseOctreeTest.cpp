@@ -0,0 +1,182 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the LooseOctree functions.
+ */
+
+#include <algorithm>
+#include <vector>
+#include "catch.hpp"
+#include "LooseOctree.hpp"
+#include "Random.hpp"
+
+
+static Vector3 RandomPoint(unsigned int &seed, double size)
+{
+    Vector3 point;
+    for (int axis = 0; axis < 3; axis++)
+        point.data[axis] = (Random::Value(seed) - 0.5) * size;
+    return point;
+}
+
+static double RandomRadius(unsigned int &seed)
+{
+    return Random::Value(seed) * 2;
+}
+
+
+TEST_CASE("LooseOctree insert and remove", "[LooseOctree]")
+{
+    // Case 1
+    LooseOctree tree = LooseOctree(Vector3::Zero(), 64, 6);
+    size_t a = LooseOctree::Insert(tree, Vector3(1, 2, 3), 0.5);
+    size_t b = LooseOctree::Insert(tree, Vector3(-10, 20, 5), 40);
+    size_t c = LooseOctree::Insert(tree, Vector3(100, 0, 0), 0.5);
+    CHECK(tree.Count == 3);
+    CHECK(tree.Nodes[tree.ObjectNode[a]].Depth == 6);
+    CHECK(tree.ObjectNode[b] == 0);
+    CHECK(tree.ObjectNode[c] == 0);
+    size_t nodes = tree.Nodes.size();
+    CHECK(nodes == 7);
+    // Case 2
+    LooseOctree::Remove(tree, a);
+    CHECK(tree.Count == 2);
+    for (int i = 0; i < 8; i++)
+        CHECK(tree.Nodes[0].Children[i] == (unsigned int)LooseOctree::None);
+    size_t d = LooseOctree::Insert(tree, Vector3(-1, -2, -3), 0.5);
+    CHECK(d == a);
+    CHECK(tree.Nodes.size() == nodes);
+}
+
+TEST_CASE("LooseOctree move", "[LooseOctree]")
+{
+    LooseOctree tree = LooseOctree(Vector3::Zero(), 64, 6);
+    size_t a = LooseOctree::Insert(tree, Vector3(1, 1, 1), 0.75);
+    unsigned int node = tree.ObjectNode[a];
+    // Case 1
+    LooseOctree::Move(tree, a, Vector3(1.5, 1.2, 1.9), 0.75);
+    CHECK(tree.ObjectNode[a] == node);
+    CHECK(tree.Centers[a] == Vector3(1.5, 1.2, 1.9));
+    // Case 2
+    LooseOctree::Move(tree, a, Vector3(-5, 1, 1), 0.75);
+    CHECK(tree.Nodes[tree.ObjectNode[a]].Center.X < 0);
+    CHECK(LooseOctree::InCube(tree.Nodes[tree.ObjectNode[a]],
+                              Vector3(-5, 1, 1)));
+    // Case 3
+    LooseOctree::Move(tree, a, Vector3(-5, 1, 1), 10);
+    CHECK(tree.Nodes[tree.ObjectNode[a]].Depth == 2);
+    LooseOctree::Move(tree, a, Vector3(500, 1, 1), 10);
+    CHECK(tree.ObjectNode[a] == 0);
+    CHECK(tree.Nodes.size() > 1);
+    for (int i = 0; i < 8; i++)
+        CHECK(tree.Nodes[0].Children[i] == (unsigned int)LooseOctree::None);
+}
+
+TEST_CASE("LooseOctree queries", "[LooseOctree]")
+{
+    LooseOctree tree = LooseOctree(Vector3::Zero(), 32, 5);
+    std::vector<size_t> handles;
+    unsigned int seed = 1;
+    for (int i = 0; i < 600; i++)
+        handles.push_back(LooseOctree::Insert(tree, RandomPoint(seed, 70),
+                                              RandomRadius(seed)));
+    // Move and remove some objects so the queries see a modified tree
+    for (int i = 0; i < 600; i += 3)
+        LooseOctree::Move(tree, handles[i], tree.Centers[handles[i]] +
+                          RandomPoint(seed, 4), tree.Radii[handles[i]]);
+    std::vector<bool> alive(600, true);
+    for (int i = 1; i < 600; i += 7)
+    {
+        LooseOctree::Remove(tree, handles[i]);
+        alive[handles[i]] = false;
+    }
+
+    // Case 1
+    for (int q = 0; q < 30; q++)
+    {
+        Vector3 center = RandomPoint(seed, 70);
+        double radius = RandomRadius(seed) * 4;
+        std::vector<size_t> expected;
+        for (size_t o = 0; o < 600; o++)
+            if (alive[o] && Vector3::Distance(tree.Centers[o], center) <=
+                radius + tree.Radii[o])
+                expected.push_back(o);
+        std::vector<size_t> found;
+        LooseOctree::Overlap(tree, center, radius, found);
+        std::sort(found.begin(), found.end());
+        CHECK(found == expected);
+    }
+
+    // Case 2
+    for (int q = 0; q < 30; q++)
+    {
+        Vector3 origin = RandomPoint(seed, 70);
+        Vector3 direction = RandomPoint(seed, 2);
+        double expected = 100;
+        for (size_t o = 0; o < 600; o++)
+        {
+            if (!alive[o])
+                continue;
+            // March along the ray to find the first entry into the sphere
+            Vector3 m = origin - tree.Centers[o];
+            double a = Vector3::Dot(direction, direction);
+            double b = Vector3::Dot(m, direction);
+            double c = Vector3::Dot(m, m) - tree.Radii[o] * tree.Radii[o];
+            double disc = b * b - a * c;
+            if (c <= 0)
+                expected = 0;
+            else if (disc >= 0 && b <= 0)
+                expected = fmin(expected, (-b - sqrt(disc)) / a);
+        }
+        size_t object;
+        double distance;
+        bool hit = LooseOctree::Raycast(tree, origin, direction, 100, object,
+                                        distance);
+        CHECK(hit == (expected < 100));
+        if (hit)
+            CHECK(distance == Approx(expected));
+    }
+
+    // Case 3
+    Vector3 normals[] = { Vector3(1, 0, 0), Vector3(-1, 0, 0),
+        Vector3(0, 0.6, 0.8), Vector3(0, -0.6, 0.8) };
+    double offsets[] = { 10, 5, 2, 3 };
+    std::vector<size_t> expected;
+    for (size_t o = 0; o < 600; o++)
+    {
+        bool visible = alive[o];
+        for (int p = 0; p < 4; p++)
+            visible = visible && Vector3::Dot(normals[p], tree.Centers[o]) +
+                offsets[p] >= -tree.Radii[o];
+        if (visible)
+            expected.push_back(o);
+    }
+    std::vector<size_t> found;
+    LooseOctree::Cull(tree, normals, offsets, 4, found);
+    std::sort(found.begin(), found.end());
+    CHECK(found == expected);
+    CHECK(found.size() > 0);
+}
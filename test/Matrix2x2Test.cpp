@@ -0,0 +1,96 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Matrix2x2 functions.
+ */
+
+#include "catch.hpp"
+#include "Matrix2x2.hpp"
+
+
+#define CHECK_MATRIX(a, b) \
+    CHECK(a.D00 == Approx(b.D00)); \
+    CHECK(a.D01 == Approx(b.D01)); \
+    CHECK(a.D10 == Approx(b.D10)); \
+    CHECK(a.D11 == Approx(b.D11));
+
+
+TEST_CASE("Matrix2x2 arithmetic", "[Matrix2x2]")
+{
+    // Case 1
+    Matrix2x2 m1 = Matrix2x2(2, -5, 3, 7);
+    Matrix2x2 m2 = Matrix2x2(-1, 4, 6, 0.5);
+    CHECK_MATRIX((m1 + 3), Matrix2x2(5, -2, 6, 10));
+    CHECK_MATRIX((m1 * 2), Matrix2x2(4, -10, 6, 14));
+    CHECK_MATRIX((m1 - m2), Matrix2x2(3, -9, -3, 6.5));
+    CHECK_MATRIX((m1 * m2), Matrix2x2(-32, 5.5, 39, 15.5));
+    CHECK_MATRIX(Matrix2x2::Scale(m1, m2), Matrix2x2(-2, -20, 18, 3.5));
+    // Case 2
+    Vector2 v = m1 * Vector2(1, -2);
+    CHECK(v.X == Approx(12));
+    CHECK(v.Y == Approx(-11));
+    CHECK(Matrix2x2::Transpose(m1) == Matrix2x2(2, 3, -5, 7));
+    CHECK(Matrix2x2::Identity() == Matrix2x2());
+    CHECK(-(-m1) == m1);
+    CHECK(m1 != m2);
+}
+
+TEST_CASE("Matrix2x2 inverse and determinate", "[Matrix2x2]")
+{
+    // Case 1
+    Matrix2x2 m = Matrix2x2(2, -5, 3, 7);
+    CHECK(Matrix2x2::Determinate(m) == Approx(29));
+    CHECK(Matrix2x2::IsInvertible(m));
+    CHECK_MATRIX((Matrix2x2::Inverse(m) * m), Matrix2x2::Identity());
+    // Case 2
+    m = Matrix2x2(1, 2, 2, 4);
+    CHECK(Matrix2x2::Determinate(m) == Approx(0));
+    CHECK(!Matrix2x2::IsInvertible(m));
+}
+
+TEST_CASE("Matrix2x2 rotations and batch multiply", "[Matrix2x2]")
+{
+    // Case 1
+    Rotation2D r = Rotation2D::FromAngle(0.3);
+    Matrix2x2 m = Matrix2x2::FromRotation2D(r);
+    CHECK(Matrix2x2::Determinate(m) == Approx(1));
+    CHECK_MATRIX((Matrix2x2::Transpose(m) * m), Matrix2x2::Identity());
+    Rotation2D back = Matrix2x2::ToRotation2D(m);
+    CHECK(back.Cos == Approx(r.Cos));
+    CHECK(back.Sin == Approx(r.Sin));
+    // Case 2
+    m = Matrix2x2::FromRotation2D(r) * Matrix2x2::FromScale(Vector2(2, 3));
+    Vector2 vectors[5] = { Vector2(1, 0), Vector2(0, 1), Vector2(-2, 5),
+        Vector2(0.5, 0.25), Vector2(7, -3) };
+    Vector2 output[5];
+    Matrix2x2::MultiplyVectors(m, vectors, 5, output);
+    for (int i = 0; i < 5; i++)
+    {
+        Vector2 expected = m * vectors[i];
+        CHECK(output[i].X == Approx(expected.X));
+        CHECK(output[i].Y == Approx(expected.Y));
+    }
+}
@@ -29,8 +29,10 @@
  *  Created by Eric Phillips on November 8, 2016.
  */
 
+#include <vector>
 #include "catch.hpp"
 #include "Matrix3x3.hpp"
+#include "Random.hpp"
 
 
 #define CHECK_MATRIX(a, b) \
@@ -45,6 +47,41 @@
     CHECK(a.D22 == Approx(b.D22));
 
 
+static Matrix3x3 RandomSymmetric(unsigned int &seed)
+{
+    Matrix3x3 m;
+    for (int i = 0; i < 3; i++)
+        for (int j = i; j < 3; j++)
+            m.data[i][j] = m.data[j][i] = Random::Value(seed) * 20 - 10;
+    return m;
+}
+
+static void CheckEigen(Matrix3x3 m, Vector3 values, Matrix3x3 vectors)
+{
+    // V must be a rotation that reassembles the matrix
+    Matrix3x3 d = Matrix3x3(values.X, 0, 0, 0, values.Y, 0, 0, 0, values.Z);
+    Matrix3x3 a = vectors * d * Matrix3x3::Transpose(vectors);
+    CHECK_MATRIX(a, m);
+    a = Matrix3x3::Transpose(vectors) * vectors;
+    CHECK_MATRIX(a, Matrix3x3::Identity());
+    CHECK(Matrix3x3::Determinate(vectors) == Approx(1));
+    CHECK(values.X <= values.Y);
+    CHECK(values.Y <= values.Z);
+}
+
+static void CheckSVD(Matrix3x3 m, Matrix3x3 u, Vector3 sigma, Matrix3x3 v)
+{
+    // U and V must be rotations that reassemble the matrix
+    Matrix3x3 d = Matrix3x3(sigma.X, 0, 0, 0, sigma.Y, 0, 0, 0, sigma.Z);
+    Matrix3x3 a = u * d * Matrix3x3::Transpose(v);
+    CHECK_MATRIX(a, m);
+    CHECK(Matrix3x3::Determinate(u) == Approx(1));
+    CHECK(Matrix3x3::Determinate(v) == Approx(1));
+    CHECK(sigma.X >= fabs(sigma.Y));
+    CHECK(fabs(sigma.Y) >= fabs(sigma.Z));
+}
+
+
 TEST_CASE("Matrix3x3 plus scalar", "[Matrix3x3]")
 {
     // Case 1
@@ -375,6 +412,23 @@ TEST_CASE("Matrix3x3 from Quaternion", "[Matrix3x3]")
     CHECK_MATRIX(m1, m2);
 }
 
+TEST_CASE("Matrix3x3 from UnitQuaternion", "[Matrix3x3]")
+{
+    // Case 1
+    UnitQuaternion q = UnitQuaternion::Normalized(
+        Quaternion(0.3535534, -0.1464466, 0.3535534, 0.8535535));
+    Matrix3x3 m1 = Matrix3x3::FromQuaternion(q);
+    Matrix3x3 m2 = Matrix3x3(0.707107, -0.707107, 0, 0.5, 0.5, -0.707107, 0.5,
+        0.5, 0.707107);
+    CHECK_MATRIX(m1, m2);
+    // Case 2
+    q = UnitQuaternion::Normalized(Quaternion(-27, 83, 32, -153));
+    m1 = Matrix3x3::FromQuaternion(q);
+    m2 = Matrix3x3(0.506224, 0.165673, -0.846339, -0.445353, 0.890612,
+        -0.0920408, 0.73851, 0.423513, 0.524633);
+    CHECK_MATRIX(m1, m2);
+}
+
 TEST_CASE("Matrix3x3 to Quaternion", "[Matrix3x3]")
 {
     // Case 1
@@ -409,3 +463,216 @@ TEST_CASE("Matrix3x3 to Quaternion", "[Matrix3x3]")
     CHECK(q.Z == Approx(-0.178743));
     CHECK(q.W == Approx(0.854615));
 }
+
+TEST_CASE("Matrix3x3 symmetric eigen decomposition", "[Matrix3x3]")
+{
+    // Case 1
+    Matrix3x3 m = Matrix3x3(3, 0, 0, 0, 1, 0, 0, 0, 2);
+    Vector3 values;
+    Matrix3x3 vectors;
+    Matrix3x3::EigenSymmetric(m, values, vectors);
+    CHECK(values == Vector3(1, 2, 3));
+    CheckEigen(m, values, vectors);
+    // Case 2
+    m = Matrix3x3(2, 1, 0, 1, 2, 0, 0, 0, 5);
+    Matrix3x3::EigenSymmetric(m, values, vectors);
+    CHECK(values.X == Approx(1));
+    CHECK(values.Y == Approx(3));
+    CHECK(values.Z == Approx(5));
+    CheckEigen(m, values, vectors);
+    CHECK(fabs(vectors.D00) == Approx(0.7071068));
+    CHECK(fabs(vectors.D10) == Approx(0.7071068));
+    CHECK(vectors.D20 == Approx(0));
+    // Case 3
+    Matrix3x3 r = Matrix3x3::FromQuaternion(
+        Quaternion::FromAngleAxis(0.7, Vector3(1, 2, 3)));
+    m = r * Matrix3x3(2, 0, 0, 0, 2, 0, 0, 0, 7) * Matrix3x3::Transpose(r);
+    Matrix3x3::EigenSymmetric(m, values, vectors);
+    CHECK(values.X == Approx(2));
+    CHECK(values.Y == Approx(2));
+    CHECK(values.Z == Approx(7));
+    CheckEigen(m, values, vectors);
+    // Case 4
+    Matrix3x3 upper = m;
+    upper.D10 = upper.D20 = upper.D21 = 100;
+    Vector3 upperValues;
+    Matrix3x3 upperVectors;
+    Matrix3x3::EigenSymmetric(upper, upperValues, upperVectors);
+    CHECK(upperValues == values);
+    CHECK(upperVectors == vectors);
+    // Case 5
+    Quaternion q;
+    Matrix3x3::EigenSymmetric(m, values, q);
+    Matrix3x3 fromQ = Matrix3x3::FromQuaternion(q);
+    CHECK_MATRIX(fromQ, vectors);
+    // Case 6
+    unsigned int seed = 7;
+    for (int i = 0; i < 100; i++)
+    {
+        m = RandomSymmetric(seed);
+        Matrix3x3::EigenSymmetric(m, values, vectors);
+        CheckEigen(m, values, vectors);
+    }
+}
+
+TEST_CASE("Matrix3x3 batch symmetric eigen decomposition", "[Matrix3x3]")
+{
+    // Case 1
+    const size_t count = 2 * Matrix3x3::BlockSize + 9;
+    std::vector<Matrix3x3> matrices(count);
+    unsigned int seed = 11;
+    for (size_t i = 0; i < count; i++)
+        matrices[i] = RandomSymmetric(seed);
+    matrices[3] = Matrix3x3(4, 0, 0, 0, 4, 0, 0, 0, 4);
+    matrices[5] = Matrix3x3::Zero();
+    std::vector<Vector3> values(count);
+    std::vector<Matrix3x3> vectors(count);
+    Matrix3x3::EigenSymmetric(matrices.data(), count, values.data(),
+                              vectors.data());
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3 v;
+        Matrix3x3 e;
+        Matrix3x3::EigenSymmetric(matrices[i], v, e);
+        CHECK(values[i].X == Approx(v.X));
+        CHECK(values[i].Y == Approx(v.Y));
+        CHECK(values[i].Z == Approx(v.Z));
+        CHECK_MATRIX(vectors[i], e);
+        CheckEigen(matrices[i], values[i], vectors[i]);
+    }
+    // Case 2
+    Matrix3x3::EigenSymmetric(matrices.data(), 0, values.data(),
+                              vectors.data());
+}
+
+TEST_CASE("Matrix3x3 singular value decomposition", "[Matrix3x3]")
+{
+    // Case 1
+    Matrix3x3 m = Matrix3x3(1, 0, 0, 0, 3, 0, 0, 0, 2);
+    Matrix3x3 u, v;
+    Vector3 sigma;
+    Matrix3x3::SVD(m, u, sigma, v);
+    CHECK(sigma.X == Approx(3));
+    CHECK(sigma.Y == Approx(2));
+    CHECK(sigma.Z == Approx(1));
+    CheckSVD(m, u, sigma, v);
+    // Case 2
+    m = Matrix3x3(2, 0, 0, 0, 1, 0, 0, 0, -3);
+    Matrix3x3::SVD(m, u, sigma, v);
+    CHECK(sigma.X == Approx(3));
+    CHECK(sigma.Y == Approx(2));
+    CHECK(sigma.Z == Approx(-1));
+    CheckSVD(m, u, sigma, v);
+    // Case 3
+    m = Matrix3x3::Zero();
+    Matrix3x3::SVD(m, u, sigma, v);
+    CHECK(sigma == Vector3(0, 0, 0));
+    CheckSVD(m, u, sigma, v);
+    // Case 4
+    m = Matrix3x3(1, 2, 3, 2, 4, 6, -1, -2, -3);
+    Matrix3x3::SVD(m, u, sigma, v);
+    CHECK(sigma.X == Approx(sqrt(84.0)));
+    CHECK(sigma.Y == Approx(0));
+    CHECK(sigma.Z == Approx(0));
+    CheckSVD(m, u, sigma, v);
+    // Case 5
+    Quaternion qu, qv;
+    Vector3 qSigma;
+    m = Matrix3x3(0.5, -2, 1, 3, 0.25, -1, 2, 1, 4);
+    Matrix3x3::SVD(m, u, sigma, v);
+    Matrix3x3::SVD(m, qu, qSigma, qv);
+    CHECK(qSigma == sigma);
+    Matrix3x3 fromQ = Matrix3x3::FromQuaternion(qu);
+    CHECK_MATRIX(fromQ, u);
+    fromQ = Matrix3x3::FromQuaternion(qv);
+    CHECK_MATRIX(fromQ, v);
+    CHECK(sigma.X * sigma.Y * sigma.Z ==
+          Approx(Matrix3x3::Determinate(m)));
+    // Case 6
+    unsigned int seed = 5;
+    for (int i = 0; i < 100; i++)
+    {
+        for (int k = 0; k < 9; k++)
+            m.data[k / 3][k % 3] = Random::Value(seed) * 20 - 10;
+        Matrix3x3::SVD(m, u, sigma, v);
+        CheckSVD(m, u, sigma, v);
+        Matrix3x3::SVD(m * 1e-200, u, qSigma, v);
+        CHECK(qSigma.X * 1e200 == Approx(sigma.X));
+        CHECK(qSigma.Y * 1e200 == Approx(sigma.Y));
+        CHECK(qSigma.Z * 1e200 == Approx(sigma.Z));
+    }
+}
+
+TEST_CASE("Matrix3x3 polar decomposition", "[Matrix3x3]")
+{
+    // Case 1
+    Matrix3x3 r = Matrix3x3::FromQuaternion(
+        Quaternion::FromAngleAxis(1.2, Vector3(-1, 2, 0.5)));
+    Matrix3x3 s = Matrix3x3(3, 0.5, -1, 0.5, 2, 0.25, -1, 0.25, 1.5);
+    Matrix3x3 rotation, stretch;
+    Matrix3x3::PolarDecomposition(r * s, rotation, stretch);
+    CHECK_MATRIX(rotation, r);
+    CHECK_MATRIX(stretch, s);
+    // Case 2
+    Matrix3x3 drifted = r;
+    drifted.D01 += 0.001;
+    drifted.D20 -= 0.002;
+    Matrix3x3::PolarDecomposition(drifted, rotation, stretch);
+    CHECK(Matrix3x3::Determinate(rotation) == Approx(1));
+    Matrix3x3 a = Matrix3x3::Transpose(rotation) * rotation;
+    CHECK_MATRIX(a, Matrix3x3::Identity());
+    a = rotation * stretch;
+    CHECK_MATRIX(a, drifted);
+    CHECK(stretch.D01 == Approx(stretch.D10));
+    // Case 3
+    Quaternion q;
+    Matrix3x3 qStretch;
+    Matrix3x3::PolarDecomposition(r * s, q, qStretch);
+    Matrix3x3 fromQ = Matrix3x3::FromQuaternion(q);
+    CHECK_MATRIX(fromQ, r);
+    CHECK_MATRIX(qStretch, s);
+    // Case 4
+    Matrix3x3 reflect = Matrix3x3(1, 0, 0, 0, 1, 0, 0, 0, -1);
+    Matrix3x3::PolarDecomposition(r * reflect, rotation, stretch);
+    CHECK(Matrix3x3::Determinate(rotation) == Approx(1));
+    a = rotation * stretch;
+    a -= r * reflect;
+    CHECK_MATRIX(a, Matrix3x3::Zero());
+}
+
+TEST_CASE("Matrix3x3 batch SVD and polar decomposition", "[Matrix3x3]")
+{
+    // Case 1
+    const size_t count = Matrix3x3::BlockSize + 13;
+    std::vector<Matrix3x3> matrices(count);
+    unsigned int seed = 13;
+    for (size_t i = 0; i < count; i++)
+        for (int k = 0; k < 9; k++)
+            matrices[i].data[k / 3][k % 3] = Random::Value(seed) * 2 - 1;
+    matrices[1] = Matrix3x3::Zero();
+    matrices[2] = Matrix3x3::Identity() * 1e150;
+    std::vector<Matrix3x3> u(count), v(count);
+    std::vector<Vector3> sigma(count);
+    Matrix3x3::SVD(matrices.data(), count, u.data(), sigma.data(), v.data());
+    for (size_t i = 0; i < count; i++)
+    {
+        Matrix3x3 su, sv;
+        Vector3 ss;
+        Matrix3x3::SVD(matrices[i], su, ss, sv);
+        CHECK(sigma[i].X == Approx(ss.X));
+        CHECK(sigma[i].Y == Approx(ss.Y));
+        CHECK(sigma[i].Z == Approx(ss.Z));
+        CHECK_MATRIX(u[i], su);
+        CHECK_MATRIX(v[i], sv);
+    }
+    // Case 2
+    Matrix3x3::PolarDecomposition(matrices.data(), count, u.data(),
+                                  v.data());
+    for (size_t i = 0; i < count; i++)
+    {
+        Matrix3x3 rotation, stretch;
+        Matrix3x3::PolarDecomposition(matrices[i], rotation, stretch);
+        CHECK_MATRIX(u[i], rotation);
+        CHECK_MATRIX(v[i], stretch);
+    }
+}
@@ -0,0 +1,176 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Matrix4x4 functions.
+ */
+
+#include "catch.hpp"
+#include "Matrix4x4.hpp"
+
+
+#define CHECK_MATRIX4(a, b) \
+    for (int i = 0; i < 4; i++) \
+        for (int j = 0; j < 4; j++) \
+            CHECK(a.data[i][j] == Approx(b.data[i][j]));
+
+#define CHECK_VECTOR(a, b) \
+    CHECK(a.X == Approx(b.X)); \
+    CHECK(a.Y == Approx(b.Y)); \
+    CHECK(a.Z == Approx(b.Z));
+
+
+TEST_CASE("Matrix4x4 times Matrix4x4", "[Matrix4x4]")
+{
+    // Case 1
+    Matrix4x4 m1 = Matrix4x4(2, -5, 3, 1, 7, 1, -6, 4, -9, 4, 8, 2, 1, 0, 3,
+                             5);
+    Matrix4x4 m2 = Matrix4x4(1, 0, 2, -1, 3, 1, 0, 2, -2, 4, 1, 0, 0, 1, -3,
+                             2);
+    Matrix4x4 m3 = Matrix4x4(-19, 8, 4, -10, 22, -19, -4, 3, -13, 38, -16, 21,
+                             -5, 17, -10, 9);
+    CHECK_MATRIX4((m1 * m2), m3);
+    // Case 2
+    m1 = Matrix4x4(Matrix3x3(0.5, -1.2, 0.3, 2, 0.1, -0.7, -0.4, 0.9, 1.5),
+                   Vector3(4, -3, 2));
+    m2 = Matrix4x4(Matrix3x3(1, 2, 0, 0, 1, -1, 3, 0, 2), Vector3(1, 1, 1));
+    CHECK_MATRIX4(Matrix4x4::MultiplyAffine(m1, m2), (m1 * m2));
+    CHECK(Matrix4x4::IsAffine(m1 * m2));
+}
+
+TEST_CASE("Matrix4x4 transpose", "[Matrix4x4]")
+{
+    // Case 1
+    Matrix4x4 m1 = Matrix4x4(2, -5, 3, 1, 7, 1, -6, 4, -9, 4, 8, 2, 1, 0, 3,
+                             5);
+    Matrix4x4 m2 = Matrix4x4(2, 7, -9, 1, -5, 1, 4, 0, 3, -6, 8, 3, 1, 4, 2,
+                             5);
+    CHECK(Matrix4x4::Transpose(m1) == m2);
+    CHECK(Matrix4x4::Transpose(m2) == m1);
+    CHECK(m1 != m2);
+}
+
+TEST_CASE("Matrix4x4 determinate", "[Matrix4x4]")
+{
+    // Case 1
+    Matrix4x4 m = Matrix4x4(2, -5, 3, 1, 7, 1, -6, 4, -9, 4, 8, 2, 1, 0, 3,
+                            5);
+    CHECK(Matrix4x4::Determinate(m) == Approx(-146));
+    CHECK(Matrix4x4::IsInvertible(m));
+    // Case 2
+    m = Matrix4x4(Matrix3x3(0.5, -1.2, 0.3, 2, 0.1, -0.7, -0.4, 0.9, 1.5),
+                  Vector3(4, -3, 2));
+    CHECK(Matrix4x4::Determinate(m) == Approx(4.206));
+    // Case 3
+    m = Matrix4x4(1, 2, 3, 4, 2, 4, 6, 8, 0, 1, 0, 1, 1, 0, 0, 1);
+    CHECK(Matrix4x4::Determinate(m) == Approx(0));
+    CHECK(!Matrix4x4::IsInvertible(m));
+}
+
+TEST_CASE("Matrix4x4 inverse", "[Matrix4x4]")
+{
+    // Case 1
+    Matrix4x4 m1 = Matrix4x4(2, -5, 3, 1, 7, 1, -6, 4, -9, 4, 8, 2, 1, 0, 3,
+                             5);
+    Matrix4x4 m2 = Matrix4x4(-101 / 73.0, -109 / 73.0, -99 / 73.0, 147 / 73.0,
+        -92 / 73.0, -87 / 73.0, -75 / 73.0, 118 / 73.0, -171 / 146.0,
+        -199 / 146.0, -82 / 73.0, 259 / 146.0, 143 / 146.0, 163 / 146.0,
+        69 / 73.0, -185 / 146.0);
+    CHECK_MATRIX4(Matrix4x4::Inverse(m1), m2);
+    // Case 2
+    m1 = Matrix4x4::FromTRS(Vector3(4, -3, 2), Quaternion(0.1, 0.7, -0.3, 0.6),
+                            Vector3(2, 0.5, 3));
+    m2 = Matrix4x4::InverseAffine(m1);
+    CHECK(Matrix4x4::IsAffine(m2));
+    CHECK_MATRIX4((m1 * m2), Matrix4x4::Identity());
+    CHECK_MATRIX4(Matrix4x4::Inverse(m1), m2);
+    // Case 3
+    m1 = Matrix4x4::Perspective(M_PI / 3, 1.5, 0.5, 100);
+    CHECK_MATRIX4((Matrix4x4::Inverse(m1) * m1), Matrix4x4::Identity());
+}
+
+TEST_CASE("Matrix4x4 construction", "[Matrix4x4]")
+{
+    // Case 1
+    Quaternion q = Quaternion(0.1, 0.7, -0.3, 0.6);
+    Matrix4x4 m1 = Matrix4x4::FromTRS(Vector3(4, -3, 2), q, Vector3(2, 0.5,
+                                                                    3));
+    Matrix4x4 m2 = Matrix4x4::FromTranslation(Vector3(4, -3, 2)) *
+        Matrix4x4::FromQuaternion(q) * Matrix4x4::FromScale(Vector3(2, 0.5,
+                                                                    3));
+    CHECK_MATRIX4(m1, m2);
+    CHECK_VECTOR(Matrix4x4::Translation(m1), Vector3(4, -3, 2));
+    // Case 2
+    Matrix3x3 r = Matrix3x3::FromQuaternion(q);
+    Matrix3x3 l = Matrix4x4::ToMatrix3x3(Matrix4x4::FromQuaternion(q));
+    CHECK(l == r);
+    // Case 3
+    double s = sqrt(0.5);
+    UnitQuaternion u = UnitQuaternion(Quaternion(0, 0, s, s));
+    m1 = Matrix4x4::FromQuaternion(u);
+    CHECK_VECTOR(Matrix4x4::MultiplyVector(m1, Vector3(1, 0, 0)),
+                 Vector3(0, 1, 0));
+}
+
+TEST_CASE("Matrix4x4 transform points and vectors", "[Matrix4x4]")
+{
+    // Case 1
+    Matrix4x4 m = Matrix4x4::FromTRS(Vector3(4, -3, 2),
+                                     Quaternion(0, 0, sqrt(0.5), sqrt(0.5)),
+                                     Vector3(2, 2, 2));
+    CHECK_VECTOR(Matrix4x4::MultiplyPoint3x4(m, Vector3(1, 0, 1)),
+                 Vector3(4, -1, 4));
+    CHECK_VECTOR(Matrix4x4::MultiplyPoint(m, Vector3(1, 0, 1)),
+                 Vector3(4, -1, 4));
+    CHECK_VECTOR(Matrix4x4::MultiplyVector(m, Vector3(1, 0, 1)),
+                 Vector3(0, 2, 2));
+    // Case 2
+    m = Matrix4x4::Perspective(M_PI / 2, 2, 1, 10);
+    CHECK_VECTOR(Matrix4x4::MultiplyPoint(m, Vector3(2, 1, 1)),
+                 Vector3(1, 1, -1));
+    CHECK_VECTOR(Matrix4x4::MultiplyPoint(m, Vector3(-20, 5, 10)),
+                 Vector3(-1, 0.5, 1));
+    // Case 3
+    Vector3 points[] = { Vector3(1, 2, 3), Vector3(-4, 0.5, 6),
+        Vector3(0.1, -7, 2) };
+    Vector3 output[3];
+    Matrix4x4::MultiplyPoints(m, points, 3, output);
+    for (int i = 0; i < 3; i++)
+    {
+        CHECK_VECTOR(output[i], Matrix4x4::MultiplyPoint(m, points[i]));
+    }
+    m = Matrix4x4::FromTRS(Vector3(4, -3, 2), Quaternion(0.1, 0.7, -0.3, 0.6),
+                           Vector3(2, 0.5, 3));
+    Matrix4x4::MultiplyPoints(m, points, 3, output);
+    for (int i = 0; i < 3; i++)
+    {
+        CHECK_VECTOR(output[i], Matrix4x4::MultiplyPoint3x4(m, points[i]));
+    }
+    Matrix4x4::MultiplyVectors(m, points, 3, output);
+    for (int i = 0; i < 3; i++)
+    {
+        CHECK_VECTOR(output[i], Matrix4x4::MultiplyVector(m, points[i]));
+    }
+}
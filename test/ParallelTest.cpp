@@ -0,0 +1,84 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Parallel functions.
+ */
+
+#include <atomic>
+#include "catch.hpp"
+#include "Parallel.hpp"
+
+
+TEST_CASE("Parallel chunks", "[Parallel]")
+{
+    // Case 1
+    CHECK(Parallel::Chunks(0, 16) == 1);
+    CHECK(Parallel::Chunks(10, 16) == 1);
+    CHECK(Parallel::Chunks(10, 0) >= 1);
+    // Case 2
+    size_t chunks = Parallel::Chunks(1 << 20, 1);
+    CHECK(chunks == Parallel::ThreadCount());
+}
+
+TEST_CASE("Parallel for", "[Parallel]")
+{
+    // Case 1
+    std::vector<int> values(10000, 0);
+    Parallel::For(values.size(), 100,
+                  [&](size_t, size_t begin, size_t end)
+                  {
+                      for (size_t i = begin; i < end; i++)
+                          values[i] += (int)i;
+                  });
+    bool correct = true;
+    for (size_t i = 0; i < values.size(); i++)
+        correct = correct && values[i] == (int)i;
+    CHECK(correct);
+    // Case 2
+    std::atomic<size_t> total(0);
+    std::vector<size_t> sums(Parallel::Chunks(5000, 10), 0);
+    Parallel::For(5000, 10,
+                  [&](size_t chunk, size_t begin, size_t end)
+                  {
+                      sums[chunk] = end - begin;
+                      total += end - begin;
+                  });
+    size_t sum = 0;
+    for (size_t i = 0; i < sums.size(); i++)
+        sum += sums[i];
+    CHECK(sum == 5000);
+    CHECK(total == 5000);
+}
+
+TEST_CASE("Parallel invoke", "[Parallel]")
+{
+    // Case 1
+    int a = 0;
+    int b = 0;
+    Parallel::Invoke([&]() { a = 1; }, [&]() { b = 2; });
+    CHECK(a == 1);
+    CHECK(b == 2);
+}
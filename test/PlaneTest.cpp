@@ -0,0 +1,153 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Plane functions.
+ */
+
+#include <math.h>
+#include <vector>
+#include "catch.hpp"
+#include "Plane.hpp"
+#include "Random.hpp"
+
+
+TEST_CASE("Plane construction and distance", "[Plane]")
+{
+    // Case 1
+    Plane plane = Plane::FromPointNormal(Vector3(0, 0, 2), Vector3(0, 0, 3));
+    CHECK(plane == Plane(Vector3(0, 0, 1), -2));
+    CHECK(Plane::SignedDistance(plane, Vector3(4, 1, 5)) == Approx(3));
+    CHECK(Plane::SignedDistance(plane, Vector3(4, 1, -1)) == Approx(-3));
+    CHECK(Plane::ClosestPoint(plane, Vector3(4, 1, 5)) == Vector3(4, 1, 2));
+    // Case 2
+    Vector3 a = Vector3(1, 0, 0), b = Vector3(0, 1, 0), c = Vector3(0, 0, 1);
+    plane = Plane::FromPoints(a, b, c);
+    double s = 1 / sqrt(3.0);
+    CHECK(plane.Normal.X == Approx(s));
+    CHECK(plane.Normal.Y == Approx(s));
+    CHECK(plane.Normal.Z == Approx(s));
+    CHECK(Plane::SignedDistance(plane, a) == Approx(0));
+    CHECK(Plane::SignedDistance(plane, Vector3(0, 0, 0)) == Approx(-s));
+    // Case 3
+    Vector3 points[] = { Vector3(1, 2, 3), Vector3(-4, 0.5, 6),
+        Vector3(0.1, -7, 2) };
+    Vector3Array array = Vector3Array(points, 3);
+    double distances[3];
+    Plane::SignedDistances(plane, array, distances);
+    for (int i = 0; i < 3; i++)
+    {
+        CHECK(distances[i] == Approx(Plane::SignedDistance(plane, points[i])));
+    }
+}
+
+TEST_CASE("Plane raycast", "[Plane]")
+{
+    Plane plane = Plane(Vector3(0, 1, 0), -2);
+    double distance;
+    // Case 1
+    CHECK(Plane::Raycast(plane, Ray(Vector3(0, 0, 0), Vector3(0, 0.5, 0)),
+                         10, distance));
+    CHECK(distance == Approx(4));
+    CHECK(Plane::Raycast(plane, Ray(Vector3(1, 5, 1), Vector3(1, -1, 0)),
+                         10, distance));
+    CHECK(distance == Approx(3));
+    // Case 2
+    CHECK_FALSE(Plane::Raycast(plane,
+                               Ray(Vector3(0, 0, 0), Vector3(0, -1, 0)), 10,
+                               distance));
+    CHECK_FALSE(Plane::Raycast(plane,
+                               Ray(Vector3(0, 0, 0), Vector3(0, 1, 0)), 1.5,
+                               distance));
+    // Case 3
+    CHECK_FALSE(Plane::Raycast(plane,
+                               Ray(Vector3(0, 0, 0), Vector3(1, 0, 0)),
+                               INFINITY, distance));
+    CHECK_FALSE(Plane::Raycast(plane,
+                               Ray(Vector3(0, 2, 0), Vector3(1, 0, 0)),
+                               INFINITY, distance));
+}
+
+TEST_CASE("Plane batch raycast", "[Plane]")
+{
+    const size_t count = 700;
+    unsigned int seed = 11;
+    Vector3Array normals = Vector3Array(count);
+    std::vector<double> offsets(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3 n = Vector3(Random::Value(seed) - 0.5,
+                            Random::Value(seed) - 0.5,
+                            Random::Value(seed) - 0.5);
+        Vector3Array::Set(normals, i, Vector3::Normalized(n));
+        offsets[i] = Random::Value(seed) * 10 - 5;
+    }
+    Vector3Array::Set(normals, 3, Vector3(1, 0, 0));
+    bool hits[count];
+    double distances[count];
+    // Case 1
+    Ray ray = Ray(Vector3(0.5, -1, 2), Vector3(0, 1, 0));
+    Plane::Raycast(normals, offsets.data(), ray, 6, hits, distances);
+    size_t mismatches = 0, hitCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        double distance;
+        Plane plane = Plane(Vector3Array::Get(normals, i), offsets[i]);
+        bool hit = Plane::Raycast(plane, ray, 6, distance);
+        mismatches += hit != hits[i] || (hit && distance != distances[i]);
+        hitCount += hit;
+    }
+    CHECK(mismatches == 0);
+    CHECK(hitCount > 0);
+    CHECK(hitCount < count);
+    CHECK_FALSE(hits[3]);
+    // Case 2
+    Vector3Array origins = Vector3Array(count);
+    Vector3Array directions = Vector3Array(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3Array::Set(origins, i, Vector3(Random::Value(seed) * 10 - 5,
+                                               Random::Value(seed) * 10 - 5,
+                                               Random::Value(seed) * 10 - 5));
+        Vector3Array::Set(directions, i, Vector3(Random::Value(seed) - 0.5,
+                                                  Random::Value(seed) - 0.5,
+                                                  Random::Value(seed) - 0.5));
+    }
+    Plane plane = Plane::FromPointNormal(Vector3(1, 1, 1), Vector3(1, 2, 3));
+    Plane::Raycast(plane, origins, directions, 8, hits, distances);
+    mismatches = hitCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        double distance;
+        ray = Ray(Vector3Array::Get(origins, i),
+                  Vector3Array::Get(directions, i));
+        bool hit = Plane::Raycast(plane, ray, 8, distance);
+        mismatches += hit != hits[i] || (hit && distance != distances[i]);
+        hitCount += hit;
+    }
+    CHECK(mismatches == 0);
+    CHECK(hitCount > 0);
+    CHECK(hitCount < count);
+}
@@ -0,0 +1,209 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Quadtree functions.
+ */
+
+#include <algorithm>
+#include <vector>
+#include "catch.hpp"
+#include "Quadtree.hpp"
+#include "Random.hpp"
+
+
+static std::vector<Vector2> RandomPoints(size_t count, unsigned int seed)
+{
+    std::vector<Vector2> points(count);
+    for (size_t i = 0; i < count; i++)
+        for (int axis = 0; axis < 2; axis++)
+            points[i].data[axis] = Random::Value(seed) * 10 - 5;
+    return points;
+}
+
+
+TEST_CASE("Quadtree empty", "[Quadtree]")
+{
+    // Case 1
+    Quadtree tree = Quadtree::Build(nullptr, 0);
+    size_t index;
+    double distance;
+    std::vector<size_t> found;
+    CHECK(Quadtree::Nearest(tree, Vector2::Zero(), 1, &index, &distance) == 0);
+    Quadtree::Radius(tree, Vector2::Zero(), 10, found);
+    Quadtree::Range(tree, Vector2(-1, -1), Vector2(1, 1), found);
+    CHECK(found.empty());
+}
+
+TEST_CASE("Quadtree build", "[Quadtree]")
+{
+    // Case 1
+    std::vector<Vector2> points = RandomPoints(1000, 3);
+    Quadtree tree = Quadtree::Build(points.data(), points.size());
+    bool sorted = true;
+    for (size_t i = 0; i < 1000; i++)
+    {
+        sorted = sorted && tree.X[i] == points[tree.Indices[i]].X &&
+            tree.Y[i] == points[tree.Indices[i]].Y;
+        if (i > 0)
+            sorted = sorted && tree.Codes[i - 1] <= tree.Codes[i];
+    }
+    CHECK(sorted);
+    // Case 2
+    std::vector<Vector2> same(50, Vector2(2, 3));
+    Quadtree duplicates = Quadtree::Build(same.data(), same.size());
+    std::vector<size_t> found;
+    Quadtree::Radius(duplicates, Vector2(2, 3), 0, found);
+    CHECK(found.size() == 50);
+}
+
+TEST_CASE("Quadtree range", "[Quadtree]")
+{
+    std::vector<Vector2> points = RandomPoints(3000, 5);
+    Quadtree tree = Quadtree::Build(points.data(), points.size());
+    std::vector<Vector2> corners = RandomPoints(60, 7);
+    // Case 1
+    std::vector<Vector2> mins, maxs;
+    for (size_t q = 0; q < corners.size(); q += 2)
+    {
+        Vector2 min = Vector2::Min(corners[q], corners[q + 1]);
+        Vector2 max = Vector2::Max(corners[q], corners[q + 1]);
+        mins.push_back(min);
+        maxs.push_back(max);
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < points.size(); i++)
+            if (points[i].X >= min.X && points[i].X <= max.X &&
+                points[i].Y >= min.Y && points[i].Y <= max.Y)
+                expected.push_back(i);
+        std::vector<size_t> found;
+        Quadtree::Range(tree, min, max, found);
+        std::sort(found.begin(), found.end());
+        CHECK(found == expected);
+    }
+    // Case 2
+    std::vector<size_t> offsets;
+    std::vector<size_t> indices;
+    Quadtree::Range(tree, mins.data(), maxs.data(), mins.size(), offsets,
+                    indices);
+    REQUIRE(offsets.size() == mins.size() + 1);
+    bool same = true;
+    for (size_t q = 0; q < mins.size(); q++)
+    {
+        std::vector<size_t> found;
+        Quadtree::Range(tree, mins[q], maxs[q], found);
+        same = same && offsets[q + 1] - offsets[q] == found.size() &&
+            std::equal(found.begin(), found.end(),
+                       indices.begin() + offsets[q]);
+    }
+    CHECK(same);
+}
+
+TEST_CASE("Quadtree radius", "[Quadtree]")
+{
+    std::vector<Vector2> points = RandomPoints(3000, 11);
+    Quadtree tree = Quadtree::Build(points.data(), points.size());
+    std::vector<Vector2> queries = RandomPoints(40, 13);
+    // Case 1
+    for (size_t q = 0; q < queries.size(); q++)
+    {
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < points.size(); i++)
+            if (Vector2::Distance(points[i], queries[q]) <= 0.8)
+                expected.push_back(i);
+        std::vector<size_t> found;
+        Quadtree::Radius(tree, queries[q], 0.8, found);
+        std::sort(found.begin(), found.end());
+        CHECK(found == expected);
+    }
+    // Case 2
+    std::vector<size_t> offsets;
+    std::vector<size_t> indices;
+    Quadtree::Radius(tree, queries.data(), queries.size(), 0.8, offsets,
+                     indices);
+    REQUIRE(offsets.size() == queries.size() + 1);
+    CHECK(offsets.back() == indices.size());
+}
+
+TEST_CASE("Quadtree nearest", "[Quadtree]")
+{
+    std::vector<Vector2> points = RandomPoints(3000, 17);
+    Quadtree tree = Quadtree::Build(points.data(), points.size());
+    std::vector<Vector2> queries = RandomPoints(50, 19);
+    // Case 1
+    for (size_t q = 0; q < queries.size(); q++)
+    {
+        std::vector<double> expected(points.size());
+        for (size_t i = 0; i < points.size(); i++)
+            expected[i] = Vector2::Distance(points[i], queries[q]);
+        std::sort(expected.begin(), expected.end());
+        size_t indices[5];
+        double distances[5];
+        REQUIRE(Quadtree::Nearest(tree, queries[q], 5, indices, distances) ==
+                5);
+        for (int j = 0; j < 5; j++)
+        {
+            CHECK(distances[j] == Approx(expected[j]));
+            CHECK(Vector2::Distance(points[indices[j]], queries[q]) ==
+                  Approx(distances[j]));
+        }
+    }
+    // Case 2
+    std::vector<size_t> indices(queries.size() * 2);
+    std::vector<double> distances(queries.size() * 2);
+    Quadtree::Nearest(tree, queries.data(), queries.size(), 2,
+                      indices.data(), distances.data());
+    bool same = true;
+    for (size_t q = 0; q < queries.size(); q++)
+    {
+        size_t single[2];
+        double singleDistances[2];
+        Quadtree::Nearest(tree, queries[q], 2, single, singleDistances);
+        same = same && single[0] == indices[2 * q] &&
+            single[1] == indices[2 * q + 1];
+    }
+    CHECK(same);
+}
+
+TEST_CASE("Quadtree serialize", "[Quadtree]")
+{
+    // Case 1
+    std::vector<Vector2> points = RandomPoints(500, 23);
+    Quadtree tree = Quadtree::Build(points.data(), points.size());
+    std::vector<unsigned char> buffer = Quadtree::Serialize(tree);
+    Quadtree loaded;
+    REQUIRE(Quadtree::Deserialize(buffer.data(), buffer.size(), loaded));
+    CHECK(loaded.Origin == tree.Origin);
+    CHECK(loaded.Size == tree.Size);
+    CHECK(loaded.Codes == tree.Codes);
+    CHECK(loaded.X == tree.X);
+    CHECK(loaded.Y == tree.Y);
+    CHECK(loaded.Indices == tree.Indices);
+    // Case 2
+    CHECK_FALSE(Quadtree::Deserialize(buffer.data(), buffer.size() - 1,
+                                      loaded));
+    CHECK_FALSE(Quadtree::Deserialize(buffer.data(), 8, loaded));
+    buffer[0] ^= 1;
+    CHECK_FALSE(Quadtree::Deserialize(buffer.data(), buffer.size(), loaded));
+}
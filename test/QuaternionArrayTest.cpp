@@ -0,0 +1,70 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the QuaternionArray functions.
+ */
+
+#include "catch.hpp"
+#include "QuaternionArray.hpp"
+
+
+TEST_CASE("QuaternionArray construction", "[QuaternionArray]")
+{
+    // Case 1
+    QuaternionArray empty;
+    CHECK(QuaternionArray::Size(empty) == 0);
+    // Case 2
+    QuaternionArray identities = QuaternionArray(4);
+    CHECK(QuaternionArray::Size(identities) == 4);
+    CHECK(QuaternionArray::Get(identities, 3) == Quaternion::Identity());
+    // Case 3
+    Quaternion quaternions[] = { Quaternion(1, 2, 3, 4),
+        Quaternion(-4, 5, -6, 7) };
+    QuaternionArray array = QuaternionArray(quaternions, 2);
+    CHECK(array.X[1] == -4);
+    CHECK(array.Y[0] == 2);
+    CHECK(array.Z[1] == -6);
+    CHECK(array.W[1] == 7);
+    CHECK(QuaternionArray::Get(array, 0) == Quaternion(1, 2, 3, 4));
+}
+
+TEST_CASE("QuaternionArray modification", "[QuaternionArray]")
+{
+    // Case 1
+    QuaternionArray array;
+    QuaternionArray::PushBack(array, Quaternion(1, 1, 1, 1));
+    QuaternionArray::PushBack(array, Quaternion(2, 3, 4, 5));
+    CHECK(QuaternionArray::Size(array) == 2);
+    QuaternionArray::Set(array, 0, Quaternion(7, 8, 9, 10));
+    CHECK(QuaternionArray::Get(array, 0) == Quaternion(7, 8, 9, 10));
+    // Case 2
+    QuaternionArray::Resize(array, 3);
+    CHECK(QuaternionArray::Get(array, 2) == Quaternion::Identity());
+    Quaternion out[3];
+    QuaternionArray::ToQuaternions(array, out);
+    CHECK(out[0] == Quaternion(7, 8, 9, 10));
+    CHECK(out[1] == Quaternion(2, 3, 4, 5));
+}
@@ -29,10 +29,27 @@
  *  Created by Eric Phillips on October 21, 2016.
  */
 
+#include <type_traits>
+#include <utility>
 #include "catch.hpp"
 #include "Quaternion.hpp"
 
 
+template <typename T, typename = void>
+struct HasScaleAssign : std::false_type {};
+
+template <typename T>
+struct HasScaleAssign<T, decltype(void(std::declval<T&>() *= 2.0))>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct HasWritableX : std::false_type {};
+
+template <typename T>
+struct HasWritableX<T, decltype(void(std::declval<T&>().X = 2.0))>
+    : std::true_type {};
+
+
 TEST_CASE("Quaternion plus scalar", "[Quaternion]")
 {
     // Case 1
@@ -299,6 +316,23 @@ TEST_CASE("Angle between quaternions", "[Quaternion]")
     CHECK(a == Approx(2.399531));
 }
 
+TEST_CASE("Fast angle between quaternions", "[Quaternion]")
+{
+    // Case 1
+    Quaternion q1 = Quaternion(0.3919183, 0.3196269, -0.8430416, -0.1830837);
+    Quaternion q2 = Quaternion(0, 0.7071068, 0, 0.7071068);
+    double a = Quaternion::Angle(q1, q2, FastMath());
+    CHECK(a == Approx(2.94819));
+    // Case 2
+    q1 = Quaternion(0.3535534, -0.1464466, 0.3535534, 0.8535535);
+    q2 = Quaternion(0.3919183, 0.3196269, -0.8430416, -0.1830837);
+    a = Quaternion::Angle(q1, q2, FastMath());
+    CHECK(a == Approx(2.399531));
+    // Case 3
+    a = Quaternion::Angle(q1, q1, FastMath());
+    CHECK(a == Approx(0));
+}
+
 TEST_CASE("Quaternion conjugate", "[Quaternion]")
 {
     // Case 1
@@ -346,6 +380,60 @@ TEST_CASE("Dot product of quaternions", "[Quaternion]")
     CHECK(a == Approx(1.0));
 }
 
+TEST_CASE("Quaternion fast slerp", "[Quaternion]")
+{
+    // Case 1
+    Quaternion a = Quaternion(0.3535534, -0.1464466, 0.3535534, 0.8535535);
+    Quaternion b = Quaternion(0.3919183, 0.3196269, -0.8430416, -0.1830837);
+    double maxError = 0;
+    for (int i = 0; i <= 100; i++)
+    {
+        Quaternion q1 = Quaternion::FastSlerp(a, b, i / 100.0);
+        Quaternion q2 = Quaternion::SlerpUnclamped(a, b, i / 100.0);
+        maxError = fmax(maxError, Quaternion::Angle(q1, q2));
+    }
+    CHECK(maxError < 1e-4);
+    // Case 2
+    Quaternion q1 = Quaternion::Normalized(Quaternion(-27, 83, 32, -153));
+    Quaternion q2 = Quaternion::Normalized(Quaternion(36, -64, 12, 24));
+    Quaternion q = Quaternion::FastSlerp(q1, q2, 0.25);
+    Quaternion expected = Quaternion::SlerpUnclamped(q1, q2, 0.25);
+    CHECK(q.X == Approx(expected.X).epsilon(1e-4));
+    CHECK(q.Y == Approx(expected.Y).epsilon(1e-4));
+    CHECK(q.Z == Approx(expected.Z).epsilon(1e-4));
+    CHECK(q.W == Approx(expected.W).epsilon(1e-4));
+    // Case 3
+    q = Quaternion::FastSlerp(a, b, -1);
+    CHECK(q == Quaternion::Normalized(a));
+    q = Quaternion::FastSlerp(a, b, 2);
+    CHECK(Quaternion::Angle(q, b) == Approx(0));
+    // Case 4
+    a = Quaternion::FromAngleAxis(0.2, Vector3(1, 2, 3));
+    b = -Quaternion::FromAngleAxis(1.4, Vector3(-3, 1, 0.5));
+    q = Quaternion::FastSlerp(a, b, 0.6);
+    expected = Quaternion::SlerpUnclamped(a, b, 0.6);
+    CHECK(Quaternion::Dot(q, expected) == Approx(1));
+}
+
+TEST_CASE("Quaternion fast slerp of arrays", "[Quaternion]")
+{
+    Quaternion a[3];
+    Quaternion b[3];
+    double t[3] = { 0.1, 0.5, 0.9 };
+    Quaternion result[3];
+    for (int i = 0; i < 3; i++)
+    {
+        a[i] = Quaternion::FromEuler(0.3 * i, -0.2, 0.5);
+        b[i] = Quaternion::FromEuler(-1.1, 0.7 * i, 2.1);
+    }
+    Quaternion::FastSlerp(a, b, t, result, 3);
+    for (int i = 0; i < 3; i++)
+    {
+        Quaternion expected = Quaternion::FastSlerp(a[i], b[i], t[i]);
+        CHECK(result[i] == expected);
+    }
+}
+
 TEST_CASE("Quaternion from angle axis", "[Quaternion]")
 {
     // Case 1
@@ -467,6 +555,72 @@ TEST_CASE("Quaternion inverse", "[Quaternion]")
     CHECK(q.W == Approx(0.8535535));
 }
 
+TEST_CASE("UnitQuaternion inverse", "[Quaternion]")
+{
+    // Case 1
+    UnitQuaternion q = UnitQuaternion::Normalized(
+        Quaternion(-27, 83, 32, -153));
+    Quaternion expected = Quaternion::Inverse(q);
+    UnitQuaternion inverse = UnitQuaternion::Inverse(q);
+    CHECK(inverse.X() == Approx(expected.X));
+    CHECK(inverse.Y() == Approx(expected.Y));
+    CHECK(inverse.Z() == Approx(expected.Z));
+    CHECK(inverse.W() == Approx(expected.W));
+    // Case 2
+    Quaternion identity = q * inverse;
+    CHECK(identity.X == Approx(0));
+    CHECK(identity.Y == Approx(0));
+    CHECK(identity.Z == Approx(0));
+    CHECK(identity.W == Approx(1));
+}
+
+TEST_CASE("UnitQuaternion multiplication", "[Quaternion]")
+{
+    // Case 1
+    UnitQuaternion a = UnitQuaternion::FromAngleAxis(0.3, Vector3(1, 2, 3));
+    UnitQuaternion b = UnitQuaternion::FromEuler(Vector3(0.2, -1.4, 0.9));
+    UnitQuaternion q = a * b;
+    Quaternion expected = Quaternion(a) * Quaternion(b);
+    CHECK(q.X() == Approx(expected.X));
+    CHECK(q.Y() == Approx(expected.Y));
+    CHECK(q.Z() == Approx(expected.Z));
+    CHECK(q.W() == Approx(expected.W));
+    // Case 2
+    q = UnitQuaternion::Identity();
+    for (int i = 0; i < 100000; i++)
+        q = q * a;
+    CHECK(fabs(Quaternion::Norm(q) - 1) < 1e-9);
+    // Case 3
+    UnitQuaternion drifted = UnitQuaternion(Quaternion(0, 0, 0, 1.001));
+    CHECK(UnitQuaternion::Renormalized(drifted).W() == Approx(1));
+    CHECK(UnitQuaternion::Renormalized(a) == a);
+#ifndef NDEBUG
+    // Case 4: debug builds catch the drift in a product
+    UnitQuaternion product = drifted * UnitQuaternion::Identity();
+    CHECK(Quaternion::Norm(product) == Approx(1).epsilon(1e-12));
+#endif
+}
+
+TEST_CASE("UnitQuaternion is read only", "[Quaternion]")
+{
+    // Case 1
+    CHECK(HasScaleAssign<Quaternion>::value);
+    CHECK(HasWritableX<Quaternion>::value);
+    CHECK_FALSE(HasScaleAssign<UnitQuaternion>::value);
+    CHECK_FALSE(HasWritableX<UnitQuaternion>::value);
+    // Case 2
+    UnitQuaternion q = UnitQuaternion::FromAngleAxis(1, Vector3(0, 1, 0));
+    Quaternion scaled = q * 2.0;
+    CHECK(Quaternion::Norm(scaled) == Approx(2));
+    CHECK(Quaternion::Norm(q) == Approx(1));
+    CHECK(q.W() == Approx(cos(0.5)));
+    // Case 3: normalizing a general quaternion keeps it general
+    Quaternion n = Quaternion::Normalized(Quaternion(0, 0, 0, 2));
+    CHECK(Quaternion::Normalized(Quaternion(0, 3, 0, 0)).Y == 1);
+    n *= 2;
+    CHECK(n.W == 2);
+}
+
 TEST_CASE("Quaternion lerp", "[Quaternion]")
 {
     // Case 1
@@ -829,6 +983,32 @@ TEST_CASE("Quaternion slerp unclamped", "[Quaternion]")
     CHECK(q.W == Approx(0.7281857));
 }
 
+TEST_CASE("UnitQuaternion slerp", "[Quaternion]")
+{
+    // Case 1
+    UnitQuaternion a = UnitQuaternion::Normalized(
+        Quaternion(0.3535534, -0.1464466, 0.3535534, 0.8535535));
+    UnitQuaternion b = UnitQuaternion::Normalized(
+        Quaternion(0.3919183, 0.3196269, -0.8430416, -0.1830837));
+    for (int i = -2; i <= 12; i++)
+    {
+        double t = i / 10.0;
+        UnitQuaternion q = UnitQuaternion::Slerp(a, b, t);
+        Quaternion expected = Quaternion::Slerp(a, b, t);
+        CHECK(q.X() == Approx(expected.X));
+        CHECK(q.Y() == Approx(expected.Y));
+        CHECK(q.Z() == Approx(expected.Z));
+        CHECK(q.W() == Approx(expected.W));
+        CHECK(Quaternion::Norm(q) == Approx(1));
+    }
+    // Case 2
+    UnitQuaternion q = UnitQuaternion::SlerpUnclamped(a, a, 0.4);
+    CHECK(q.X() == Approx(a.X()));
+    CHECK(q.Y() == Approx(a.Y()));
+    CHECK(q.Z() == Approx(a.Z()));
+    CHECK(q.W() == Approx(a.W()));
+}
+
 TEST_CASE("Quaternion to angle axis", "[Quaternion]")
 {
     // Case 1
@@ -856,6 +1036,26 @@ TEST_CASE("Quaternion to angle axis", "[Quaternion]")
     CHECK(axis.Z == Approx(0.8653352));
 }
 
+TEST_CASE("Fast quaternion to angle axis", "[Quaternion]")
+{
+    // Case 1
+    Quaternion q = Quaternion(0.6514133, -0.1282655, 0.6116868, 0.430172);
+    double angle;
+    Vector3 axis;
+    Quaternion::ToAngleAxis(q, angle, axis, FastMath());
+    CHECK(angle == Approx(2.25223));
+    CHECK(axis.X == Approx(0.7215902));
+    CHECK(axis.Y == Approx(-0.1420836));
+    CHECK(axis.Z == Approx(0.6775839));
+    // Case 2
+    q = Quaternion(0, 0, 0, 1);
+    Quaternion::ToAngleAxis(q, angle, axis, FastMath());
+    CHECK(angle == Approx(0));
+    CHECK(axis.X == Approx(1));
+    CHECK(axis.Y == Approx(0));
+    CHECK(axis.Z == Approx(0));
+}
+
 TEST_CASE("Quaternion to euler angles", "[Quaternion]")
 {
     // Case 1
@@ -877,3 +1077,25 @@ TEST_CASE("Quaternion to euler angles", "[Quaternion]")
     CHECK(v.Y == Approx(0.4));
     CHECK(v.Z == Approx(2.9));
 }
+
+TEST_CASE("Fast quaternion to euler angles", "[Quaternion]")
+{
+    // Case 1
+    Quaternion q = Quaternion(0.6514133, -0.1282655, 0.6116868, 0.430172);
+    Vector3 v = Quaternion::ToEuler(q, FastMath());
+    CHECK(v.X == Approx(0.8));
+    CHECK(v.Y == Approx(1.4));
+    CHECK(v.Z == Approx(2.6));
+    // Case 2
+    q = Quaternion(0, 0, 1.2, 0);
+    v = Quaternion::ToEuler(q, FastMath());
+    CHECK(v.X == Approx(0));
+    CHECK(v.Y == Approx(0));
+    CHECK(v.Z == Approx(3.14159265));
+    // Case 3
+    q = Quaternion(0.1164578, 0.4874545, 0.8652994, 0.009090029);
+    v = Quaternion::ToEuler(q, FastMath());
+    CHECK(v.X == Approx(-1));
+    CHECK(v.Y == Approx(0.4));
+    CHECK(v.Z == Approx(2.9));
+}
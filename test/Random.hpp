@@ -0,0 +1,79 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains the pseudo-random inputs shared by the tests and the
+ *  benchmarks. A fixed linear congruential generator keeps every run the
+ *  same.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+#include "Vector3.hpp"
+
+
+struct Random
+{
+    /**
+     * Returns an array of pseudo-random points inside a cube.
+     * @param count: The number of points.
+     * @param size: The side length of the cube, which is centered on zero.
+     * @param seed: The random seed.
+     * @return: A new array.
+     */
+    static inline std::vector<Vector3> Points(size_t count, double size,
+                                              unsigned int seed);
+
+    /**
+     * Advances a seed and returns a pseudo-random value in [0, 1).
+     * @param seed: The random seed, which is updated.
+     * @return: A scalar value.
+     */
+    static inline double Value(unsigned int &seed);
+};
+
+
+
+/*******************************************************************************
+ * Implementation
+ */
+
+std::vector<Vector3> Random::Points(size_t count, double size,
+                                    unsigned int seed)
+{
+    std::vector<Vector3> points(count);
+    for (size_t i = 0; i < count; i++)
+        for (int axis = 0; axis < 3; axis++)
+            points[i].data[axis] = (Value(seed) - 0.5) * size;
+    return points;
+}
+
+double Random::Value(unsigned int &seed)
+{
+    seed = seed * 1664525 + 1013904223;
+    return (seed >> 8) / 16777216.0;
+}
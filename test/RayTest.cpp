@@ -0,0 +1,53 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Ray functions.
+ */
+
+#include "catch.hpp"
+#include "Ray.hpp"
+
+
+TEST_CASE("Ray closest point and distance", "[Ray]")
+{
+    // Case 1
+    Ray ray = Ray(Vector3(1, 2, 3), Vector3(0, 0, 2));
+    Vector3 p = Ray::GetPoint(ray, 1.5);
+    CHECK(p == Vector3(1, 2, 6));
+    // Case 2
+    p = Ray::ClosestPoint(ray, Vector3(4, 6, 7));
+    CHECK(p.X == Approx(1));
+    CHECK(p.Y == Approx(2));
+    CHECK(p.Z == Approx(7));
+    CHECK(Ray::Distance(ray, Vector3(4, 6, 7)) == Approx(5));
+    // Case 3
+    p = Ray::ClosestPoint(ray, Vector3(1, 5, -1));
+    CHECK(p == ray.Origin);
+    CHECK(Ray::Distance(ray, Vector3(1, 5, -1)) == Approx(5));
+    // Case 4
+    CHECK(Ray() == Ray(Vector3(0, 0, 0), Vector3(0, 0, 1)));
+    CHECK(Ray() != ray);
+}
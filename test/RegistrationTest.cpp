@@ -0,0 +1,191 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Registration functions.
+ */
+
+#include <vector>
+#include "catch.hpp"
+#include "KDTree.hpp"
+#include "Random.hpp"
+#include "Registration.hpp"
+
+
+static void CheckRegistration(Registration a, Registration b, double error)
+{
+    // Compare the quaternions directly, since acos loses precision near zero
+    double sign = Quaternion::Dot(a.Rotation, b.Rotation) < 0 ? -1 : 1;
+    CHECK(Quaternion::Norm(a.Rotation - b.Rotation * sign) <= error);
+    CHECK(Vector3::Distance(a.Translation, b.Translation) <= error);
+}
+
+
+TEST_CASE("Registration Horn and Kabsch", "[Registration]")
+{
+    Registration motion(Quaternion::FromAngleAxis(2.1, Vector3(1, -2, 3)),
+                        Vector3(5, -3, 2));
+    std::vector<Vector3> source = Random::Points(100, 4, 1);
+    std::vector<Vector3> target(source.size());
+    for (size_t i = 0; i < source.size(); i++)
+        target[i] = Registration::Apply(motion, source[i]);
+
+    // Case 1: exact pairs
+    Registration horn = Registration::Horn(source.data(), target.data(),
+                                           nullptr, source.size());
+    Registration kabsch = Registration::Kabsch(source.data(), target.data(),
+                                               nullptr, source.size());
+    CheckRegistration(horn, motion, 1e-9);
+    CheckRegistration(kabsch, motion, 1e-9);
+    // Case 2: outliers with no weight are ignored
+    std::vector<double> weights(source.size(), 2);
+    for (size_t i = 0; i < source.size(); i += 7)
+    {
+        target[i] = target[i] + Vector3(3, 1, -2);
+        weights[i] = 0;
+    }
+    horn = Registration::Horn(source.data(), target.data(), weights.data(),
+                              source.size());
+    kabsch = Registration::Kabsch(source.data(), target.data(),
+                                  weights.data(), source.size());
+    CheckRegistration(horn, motion, 1e-9);
+    CheckRegistration(kabsch, motion, 1e-9);
+    // Case 3: noisy pairs give the same least squares answer either way
+    std::vector<Vector3> noise = Random::Points(source.size(), 0.2, 2);
+    for (size_t i = 0; i < source.size(); i++)
+        target[i] = Registration::Apply(motion, source[i]) + noise[i];
+    horn = Registration::Horn(source.data(), target.data(), nullptr,
+                              source.size());
+    kabsch = Registration::Kabsch(source.data(), target.data(), nullptr,
+                                  source.size());
+    CheckRegistration(horn, kabsch, 1e-9);
+    CheckRegistration(horn, motion, 0.05);
+    // Case 4: coplanar points still give a proper rotation
+    for (size_t i = 0; i < source.size(); i++)
+    {
+        source[i].Z = 0;
+        target[i] = Registration::Apply(motion, source[i]);
+    }
+    horn = Registration::Horn(source.data(), target.data(), nullptr,
+                              source.size());
+    kabsch = Registration::Kabsch(source.data(), target.data(), nullptr,
+                                  source.size());
+    CheckRegistration(horn, motion, 1e-9);
+    CheckRegistration(kabsch, motion, 1e-9);
+    // Case 5: no weight at all
+    std::vector<double> zeros(source.size(), 0);
+    horn = Registration::Horn(source.data(), target.data(), zeros.data(),
+                              source.size());
+    CheckRegistration(horn, Registration(), 0);
+}
+
+TEST_CASE("Registration cross-covariance", "[Registration]")
+{
+    // Enough pairs to run on several threads, far from the origin
+    const size_t count = 5 * Registration::ParallelGrain + 3;
+    std::vector<Vector3> source = Random::Points(count, 10, 3);
+    std::vector<Vector3> target = Random::Points(count, 10, 4);
+    std::vector<double> weights(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        source[i] = source[i] + Vector3(1e6, -2e6, 5e5);
+        weights[i] = (double)(i % 5);
+    }
+
+    Matrix3x3 h;
+    Vector3 p, q;
+    double total = Registration::CrossCovariance(source.data(), target.data(),
+                                                 weights.data(), count, h, p,
+                                                 q);
+    double expected = 0;
+    Vector3 ep, eq;
+    for (size_t i = 0; i < count; i++)
+    {
+        expected += weights[i];
+        ep = ep + source[i] * weights[i];
+        eq = eq + target[i] * weights[i];
+    }
+    ep = ep / expected;
+    eq = eq / expected;
+    Matrix3x3 eh(0, 0, 0, 0, 0, 0, 0, 0, 0);
+    for (size_t i = 0; i < count; i++)
+        for (int j = 0; j < 3; j++)
+            for (int k = 0; k < 3; k++)
+                eh.data[j][k] += weights[i] * (source[i].data[j] -
+                    ep.data[j]) * (target[i].data[k] - eq.data[k]);
+    CHECK(total == Approx(expected));
+    CHECK(Vector3::Distance(p, ep) < 1e-6);
+    CHECK(Vector3::Distance(q, eq) < 1e-6);
+    for (int j = 0; j < 3; j++)
+        for (int k = 0; k < 3; k++)
+            CHECK(fabs(h.data[j][k] - eh.data[j][k]) <
+                  1e-9 * fabs(eh.D00));
+    // Case 2: no weights
+    total = Registration::CrossCovariance(source.data(), target.data(),
+                                          nullptr, count, h, p, q);
+    CHECK(total == count);
+    total = Registration::CrossCovariance(source.data(), target.data(),
+                                          nullptr, 0, h, p, q);
+    CHECK(total == 0);
+    CHECK(p == Vector3(0, 0, 0));
+}
+
+TEST_CASE("Registration ICP", "[Registration]")
+{
+    std::vector<Vector3> targets = Random::Points(20000, 10, 5);
+    KDTree tree = KDTree::Build(targets.data(), targets.size());
+    Registration motion(Quaternion::FromAngleAxis(0.15, Vector3(1, 1, 0)),
+                        Vector3(0.3, -0.2, 0.1));
+
+    // Scan part of the targets from a moved viewpoint
+    std::vector<Vector3> source(targets.begin(), targets.begin() + 5000);
+    Registration::Apply(Registration::Inverse(motion), source.data(),
+                        source.size(), source.data());
+    std::vector<ICPIteration> iterations;
+    Registration result = Registration::ICP(tree, targets.data(),
+                                            source.data(), source.size(),
+                                            Registration(), 50, 2, 1e-12,
+                                            &iterations);
+    CheckRegistration(result, motion, 1e-6);
+    REQUIRE(iterations.size() > 1);
+    CHECK(iterations.size() <= 50);
+    CHECK(iterations.back().Error < 1e-6);
+    CHECK(iterations.back().Error < iterations.front().Error);
+    CHECK(iterations.back().Pairs == source.size());
+    CHECK(iterations.front().MatchSeconds >= 0);
+    CHECK(iterations.front().AccumulateSeconds >= 0);
+    CHECK(iterations.front().SolveSeconds >= 0);
+    // Case 2: starting from the answer converges at once
+    iterations.clear();
+    result = Registration::ICP(tree, targets.data(), source.data(),
+                               source.size(), motion, 50, 2, 1e-12,
+                               &iterations);
+    CheckRegistration(result, motion, 1e-9);
+    CHECK(iterations.size() == 2);
+    // Case 3: no pairs within range
+    result = Registration::ICP(tree, targets.data(), source.data(),
+                               source.size(), Registration(), 50, -1, 0);
+    CheckRegistration(result, Registration(), 0);
+}
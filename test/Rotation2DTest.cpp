@@ -0,0 +1,109 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Rotation2D functions.
+ */
+
+#include <vector>
+#include "catch.hpp"
+#include "Rotation2D.hpp"
+
+
+#define CHECK_VECTOR(a, b) \
+    CHECK(a.X == Approx(b.X)); \
+    CHECK(a.Y == Approx(b.Y));
+
+
+TEST_CASE("Rotation2D angles", "[Rotation2D]")
+{
+    // Case 1
+    Rotation2D r = Rotation2D::FromAngle(M_PI / 2);
+    CHECK_VECTOR((r * Vector2(1, 0)), Vector2(0, 1));
+    CHECK(Rotation2D::ToAngle(r) == Approx(M_PI / 2));
+    CHECK(Rotation2D::ToAngle(r, FastMath()) == Approx(M_PI / 2));
+    // Case 2
+    Rotation2D a = Rotation2D::FromAngle(2.5);
+    Rotation2D b = Rotation2D::FromAngle(-2.8);
+    CHECK(Rotation2D::ToAngle(a * b) == Approx(-0.3));
+    CHECK(Rotation2D::Angle(a, b) == Approx(2 * M_PI - 5.3));
+    CHECK(Rotation2D::ToAngle(Rotation2D::Inverse(a)) == Approx(-2.5));
+    CHECK(Rotation2D::Identity() == Rotation2D());
+    CHECK(a != b);
+    // Case 3
+    Rotation2D f = Rotation2D::FromToRotation(Vector2(3, 0), Vector2(-2, 2));
+    CHECK(Rotation2D::ToAngle(f) == Approx(3 * M_PI / 4));
+    Rotation2D n = Rotation2D::Normalized(Rotation2D(3, 4));
+    CHECK(n.Cos == Approx(0.6));
+    CHECK(n.Sin == Approx(0.8));
+}
+
+TEST_CASE("Rotation2D slerp", "[Rotation2D]")
+{
+    // Case 1
+    Rotation2D a = Rotation2D::FromAngle(0.5);
+    Rotation2D b = Rotation2D::FromAngle(1.5);
+    CHECK(Rotation2D::ToAngle(Rotation2D::Slerp(a, b, 0.25)) ==
+          Approx(0.75));
+    CHECK(Rotation2D::Slerp(a, b, -1) == a);
+    CHECK(Rotation2D::Slerp(a, b, 2) == b);
+    CHECK(Rotation2D::ToAngle(Rotation2D::SlerpUnclamped(a, b, 2)) ==
+          Approx(2.5));
+    // Case 2
+    a = Rotation2D::FromAngle(3);
+    b = Rotation2D::FromAngle(-3);
+    double angle = Rotation2D::ToAngle(Rotation2D::Slerp(a, b, 0.5));
+    CHECK(fabs(angle) == Approx(M_PI));
+}
+
+TEST_CASE("Rotation2D batch rotate", "[Rotation2D]")
+{
+    // Case 1
+    Rotation2D r = Rotation2D::FromAngle(-1.1);
+    const size_t count = 600;
+    std::vector<Vector2> vectors(count);
+    std::vector<double> x(count), y(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        vectors[i] = Vector2(i * 0.5 - 70, 30 - i * 0.25);
+        x[i] = vectors[i].X;
+        y[i] = vectors[i].Y;
+    }
+    std::vector<Vector2> output(count);
+    Rotation2D::Rotate(r, vectors.data(), count, output.data());
+    size_t bad = 0;
+    for (size_t i = 0; i < count; i++)
+        bad += Vector2::Distance(output[i], r * vectors[i]) > 1e-12;
+    CHECK(bad == 0);
+    // Case 2
+    Rotation2D::Rotate(r, x.data(), y.data(), count, x.data(), y.data());
+    bad = 0;
+    for (size_t i = 0; i < count; i++)
+        bad += Vector2::Distance(Vector2(x[i], y[i]), output[i]) > 1e-12;
+    CHECK(bad == 0);
+    // Case 3
+    Rotation2D::Rotate(r, vectors.data(), count, vectors.data());
+    CHECK(vectors[count - 1] == output[count - 1]);
+}
@@ -0,0 +1,221 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Skinning functions.
+ */
+
+#include <vector>
+#include "catch.hpp"
+#include "Random.hpp"
+#include "Skinning.hpp"
+
+
+static Vector3 RandomVector(unsigned int &seed)
+{
+    double x = Random::Value(seed) * 2 - 1;
+    double y = Random::Value(seed) * 2 - 1;
+    return Vector3(x, y, Random::Value(seed) * 2 - 1);
+}
+
+static DualQuaternion RandomBone(unsigned int &seed)
+{
+    Vector3 axis = RandomVector(seed);
+    Quaternion q = Quaternion::Normalized(Quaternion(axis,
+        Random::Value(seed) * 2 - 1));
+    return DualQuaternion(q, RandomVector(seed) * 10);
+}
+
+
+TEST_CASE("Skinning dual quaternion blend", "[Skinning]")
+{
+    const size_t bones = 40;
+    const size_t count = 1000;
+    unsigned int seed = 11;
+    std::vector<DualQuaternion> palette(bones);
+    for (size_t i = 0; i < bones; i++)
+        palette[i] = RandomBone(seed);
+    std::vector<unsigned int> indices(count * Skinning::Influences);
+    std::vector<double> weights(count * Skinning::Influences);
+    Vector3Array positions, normals;
+    for (size_t i = 0; i < count; i++)
+    {
+        double total = 0;
+        for (size_t k = 0; k < Skinning::Influences; k++)
+        {
+            size_t j = i * Skinning::Influences + k;
+            indices[j] = (unsigned int)(Random::Value(seed) * bones);
+            weights[j] = k == 3 && i % 2 == 0 ? 0 : Random::Value(seed);
+            total += weights[j];
+        }
+        for (size_t k = 0; k < Skinning::Influences; k++)
+            weights[i * Skinning::Influences + k] /= total;
+        Vector3Array::PushBack(positions, RandomVector(seed) * 5);
+        Vector3Array::PushBack(normals,
+                               Vector3::Normalized(RandomVector(seed)));
+    }
+
+    // Case 1
+    Vector3Array skinned, skinnedNormals;
+    Skinning::SkinDualQuaternion(palette.data(), indices.data(),
+                                 weights.data(), positions, normals, skinned,
+                                 skinnedNormals);
+    CHECK(Vector3Array::Size(skinned) == count);
+    CHECK(Vector3Array::Size(skinnedNormals) == count);
+    size_t bad = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        DualQuaternion blend = DualQuaternion(Quaternion(0, 0, 0, 0),
+                                              Quaternion(0, 0, 0, 0));
+        for (size_t k = 0; k < Skinning::Influences; k++)
+        {
+            size_t j = i * Skinning::Influences + k;
+            DualQuaternion bone = palette[indices[j]];
+            double w = weights[j];
+            if (Quaternion::Dot(blend.Real, bone.Real) < 0)
+                w = -w;
+            blend += bone * w;
+        }
+        blend = DualQuaternion::Normalized(blend);
+        Vector3 p = DualQuaternion::TransformPoint(blend,
+            Vector3Array::Get(positions, i));
+        Vector3 n = DualQuaternion::TransformVector(blend,
+            Vector3Array::Get(normals, i));
+        bad += Vector3::Distance(p, Vector3Array::Get(skinned, i)) > 1e-9;
+        bad += Vector3::Distance(n, Vector3Array::Get(skinnedNormals, i)) >
+            1e-9;
+    }
+    CHECK(bad == 0);
+
+    // Case 2
+    std::vector<DualQuaternion> flipped(palette);
+    for (size_t i = 0; i < bones; i += 3)
+        flipped[i] = -flipped[i];
+    Vector3Array other, otherNormals;
+    Skinning::SkinDualQuaternion(flipped.data(), indices.data(),
+                                 weights.data(), positions, normals, other,
+                                 otherNormals);
+    bad = 0;
+    for (size_t i = 0; i < count; i++)
+        bad += Vector3::Distance(Vector3Array::Get(other, i),
+                                 Vector3Array::Get(skinned, i)) > 1e-9;
+    CHECK(bad == 0);
+
+    // Case 3
+    for (size_t k = 0; k < Skinning::Influences; k++)
+    {
+        indices[k] = 7;
+        weights[k] = k == 0 ? 1 : 0;
+    }
+    Skinning::SkinDualQuaternion(palette.data(), indices.data(),
+                                 weights.data(), positions, normals, skinned,
+                                 skinnedNormals);
+    Vector3 expected = DualQuaternion::TransformPoint(palette[7],
+        Vector3Array::Get(positions, 0));
+    CHECK(Vector3Array::Get(skinned, 0).X == Approx(expected.X));
+    CHECK(Vector3Array::Get(skinned, 0).Y == Approx(expected.Y));
+    CHECK(Vector3Array::Get(skinned, 0).Z == Approx(expected.Z));
+
+    // Case 4
+    Vector3Array empty;
+    Skinning::SkinDualQuaternion(palette.data(), indices.data(),
+                                 weights.data(), empty, empty, skinned,
+                                 skinnedNormals);
+    CHECK(Vector3Array::Size(skinned) == 0);
+}
+
+TEST_CASE("Skinning linear blend", "[Skinning]")
+{
+    const size_t bones = 40;
+    const size_t count = 1000;
+    unsigned int seed = 5;
+    std::vector<Matrix3x3> matrices(bones);
+    std::vector<Vector3> translations(bones);
+    for (size_t i = 0; i < bones; i++)
+    {
+        DualQuaternion bone = RandomBone(seed);
+        matrices[i] = Matrix3x3::FromQuaternion(bone.Real) *
+            (0.5 + Random::Value(seed));
+        translations[i] = DualQuaternion::ToTranslation(bone);
+    }
+    std::vector<unsigned int> indices(count * Skinning::Influences);
+    std::vector<double> weights(count * Skinning::Influences);
+    Vector3Array positions, normals;
+    for (size_t i = 0; i < count; i++)
+    {
+        for (size_t k = 0; k < Skinning::Influences; k++)
+        {
+            size_t j = i * Skinning::Influences + k;
+            indices[j] = (unsigned int)(Random::Value(seed) * bones);
+            weights[j] = k == 3 && i % 2 == 0 ? 0 : 0.25;
+        }
+        Vector3Array::PushBack(positions, RandomVector(seed) * 5);
+        Vector3Array::PushBack(normals,
+                               Vector3::Normalized(RandomVector(seed)));
+    }
+
+    // Case 1
+    Vector3Array skinned, skinnedNormals;
+    Skinning::SkinLinear(matrices.data(), translations.data(),
+                         indices.data(), weights.data(), positions, normals,
+                         skinned, skinnedNormals);
+    CHECK(Vector3Array::Size(skinned) == count);
+    CHECK(Vector3Array::Size(skinnedNormals) == count);
+    size_t bad = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        Matrix3x3 m = Matrix3x3::Zero();
+        Vector3 t = Vector3::Zero();
+        for (size_t k = 0; k < Skinning::Influences; k++)
+        {
+            size_t j = i * Skinning::Influences + k;
+            m += matrices[indices[j]] * weights[j];
+            t += translations[indices[j]] * weights[j];
+        }
+        Vector3 p = m * Vector3Array::Get(positions, i) + t;
+        Vector3 n = Vector3::Normalized(m * Vector3Array::Get(normals, i));
+        bad += Vector3::Distance(p, Vector3Array::Get(skinned, i)) > 1e-9;
+        bad += Vector3::Distance(n, Vector3Array::Get(skinnedNormals, i)) >
+            1e-9;
+    }
+    CHECK(bad == 0);
+
+    // Case 2
+    for (size_t k = 0; k < Skinning::Influences; k++)
+    {
+        indices[k] = 7;
+        weights[k] = k == 0 ? 1 : 0;
+    }
+    Skinning::SkinLinear(matrices.data(), translations.data(),
+                         indices.data(), weights.data(), positions, normals,
+                         skinned, skinnedNormals);
+    Vector3 expected = matrices[7] * Vector3Array::Get(positions, 0) +
+        translations[7];
+    CHECK(Vector3Array::Get(skinned, 0).X == Approx(expected.X));
+    CHECK(Vector3Array::Get(skinned, 0).Y == Approx(expected.Y));
+    CHECK(Vector3Array::Get(skinned, 0).Z == Approx(expected.Z));
+    CHECK(Vector3::Magnitude(Vector3Array::Get(skinnedNormals, 0)) ==
+          Approx(1));
+}
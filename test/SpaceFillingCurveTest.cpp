@@ -0,0 +1,192 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the SpaceFillingCurve functions.
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include "catch.hpp"
+#include "SpaceFillingCurve.hpp"
+
+
+TEST_CASE("Morton codes", "[SpaceFillingCurve]")
+{
+    // Case 1
+    CHECK(SpaceFillingCurve::Morton(0, 0) == 0);
+    CHECK(SpaceFillingCurve::Morton(1, 0) == 1);
+    CHECK(SpaceFillingCurve::Morton(0, 1) == 2);
+    CHECK(SpaceFillingCurve::Morton(5, 3) == 0x1B);
+    CHECK(SpaceFillingCurve::Morton(0xFFFFFFFF, 0xFFFFFFFF) == ~0ULL);
+    // Case 2
+    CHECK(SpaceFillingCurve::Morton(1, 0, 0) == 1);
+    CHECK(SpaceFillingCurve::Morton(0, 1, 0) == 2);
+    CHECK(SpaceFillingCurve::Morton(0, 0, 1) == 4);
+    CHECK(SpaceFillingCurve::Morton(3, 1, 2) == 0x2B);
+    CHECK(SpaceFillingCurve::Morton(0x1FFFFF, 0x1FFFFF, 0x1FFFFF) ==
+          0x7FFFFFFFFFFFFFFFULL);
+    CHECK(SpaceFillingCurve::Morton(0xFFFFFFFF, 0, 0) ==
+          SpaceFillingCurve::Morton(0x1FFFFF, 0, 0));
+}
+
+TEST_CASE("Morton codes of points", "[SpaceFillingCurve]")
+{
+    // Case 1
+    Vector3 points[] = { Vector3(-1, -1, -1), Vector3(1, 1, 1),
+        Vector3(0, 0, 0), Vector3(5, -3, 0) };
+    uint64_t codes[4];
+    SpaceFillingCurve::MortonCodes(points, 4,
+        AABB(Vector3(-1, -1, -1), Vector3(1, 1, 1)), codes);
+    CHECK(codes[0] == 0);
+    CHECK(codes[1] == 0x7FFFFFFFFFFFFFFFULL);
+    CHECK(codes[2] == SpaceFillingCurve::Morton(1 << 20, 1 << 20, 1 << 20));
+    CHECK(codes[3] == SpaceFillingCurve::Morton(0x1FFFFF, 0, 1 << 20));
+    // Case 2
+    Vector2 flat[] = { Vector2(0, 2), Vector2(4, 4), Vector2(2, 3) };
+    SpaceFillingCurve::MortonCodes(flat, 3, Vector2(0, 2), Vector2(4, 4),
+                                   codes);
+    CHECK(codes[0] == 0);
+    CHECK(codes[1] == ~0ULL);
+    CHECK(codes[2] == SpaceFillingCurve::Morton(1U << 31, 1U << 31));
+}
+
+TEST_CASE("Hilbert codes", "[SpaceFillingCurve]")
+{
+    // Case 1
+    std::vector<std::pair<uint64_t, int> > cells;
+    for (int x = 0; x < 16; x++)
+        for (int y = 0; y < 16; y++)
+            cells.push_back(std::make_pair(SpaceFillingCurve::Hilbert(
+                (uint32_t)x << 28, (uint32_t)y << 28), x * 16 + y));
+    std::sort(cells.begin(), cells.end());
+    bool adjacent = true;
+    for (size_t i = 1; i < cells.size(); i++)
+    {
+        int a = cells[i - 1].second;
+        int b = cells[i].second;
+        adjacent = adjacent && abs(a / 16 - b / 16) + abs(a % 16 - b % 16) == 1;
+    }
+    CHECK(adjacent);
+    CHECK(cells[0].first == 0);
+    // Case 2
+    cells.clear();
+    for (int x = 0; x < 8; x++)
+        for (int y = 0; y < 8; y++)
+            for (int z = 0; z < 8; z++)
+                cells.push_back(std::make_pair(SpaceFillingCurve::Hilbert(
+                    (uint32_t)x << 18, (uint32_t)y << 18, (uint32_t)z << 18),
+                    x * 64 + y * 8 + z));
+    std::sort(cells.begin(), cells.end());
+    adjacent = true;
+    for (size_t i = 1; i < cells.size(); i++)
+    {
+        int a = cells[i - 1].second;
+        int b = cells[i].second;
+        adjacent = adjacent && abs(a / 64 - b / 64) +
+            abs(a / 8 % 8 - b / 8 % 8) + abs(a % 8 - b % 8) == 1;
+    }
+    CHECK(adjacent);
+    CHECK(SpaceFillingCurve::Hilbert(0x1FFFFF, 0x1FFFFF, 0x1FFFFF) <
+          (1ULL << 63));
+    // Case 3
+    Vector3 points[] = { Vector3(0, 0, 0), Vector3(1, 1, 1) };
+    uint64_t codes[2];
+    SpaceFillingCurve::HilbertCodes(points, 2,
+        AABB(Vector3(0, 0, 0), Vector3(1, 1, 1)), codes);
+    CHECK(codes[0] == SpaceFillingCurve::Hilbert(0, 0, 0));
+    CHECK(codes[1] == SpaceFillingCurve::Hilbert(0x1FFFFF, 0x1FFFFF,
+                                                 0x1FFFFF));
+    Vector2 flat[] = { Vector2(0, 0), Vector2(1, 1) };
+    SpaceFillingCurve::HilbertCodes(flat, 2, Vector2(0, 0), Vector2(1, 1),
+                                    codes);
+    CHECK(codes[0] == 0);
+    CHECK(codes[1] == SpaceFillingCurve::Hilbert(0xFFFFFFFF, 0xFFFFFFFF));
+}
+
+TEST_CASE("Radix sort", "[SpaceFillingCurve]")
+{
+    // Case 1
+    std::vector<uint64_t> keys(5000);
+    std::vector<unsigned int> values(5000);
+    uint64_t seed = 7;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        keys[i] = seed >> (i % 3 == 0 ? 40 : 1);
+        values[i] = (unsigned int)i;
+    }
+    keys[10] = keys[20];
+    std::vector<uint64_t> original = keys;
+    SpaceFillingCurve::Sort(keys.data(), values.data(), keys.size());
+    bool sorted = true;
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        sorted = sorted && original[values[i]] == keys[i];
+        if (i > 0)
+            sorted = sorted && (keys[i - 1] < keys[i] ||
+                (keys[i - 1] == keys[i] && values[i - 1] < values[i]));
+    }
+    CHECK(sorted);
+    // Case 2
+    uint64_t same[] = { 9, 9, 9 };
+    unsigned int order[] = { 2, 0, 1 };
+    SpaceFillingCurve::Sort(same, order, 3);
+    CHECK(order[0] == 2);
+    CHECK(order[1] == 0);
+    CHECK(order[2] == 1);
+}
+
+TEST_CASE("Order and permute", "[SpaceFillingCurve]")
+{
+    // Case 1
+    uint64_t keys[] = { 30, 10, 20, 10 };
+    unsigned int permutation[4];
+    SpaceFillingCurve::Order(keys, 4, permutation);
+    CHECK(permutation[0] == 1);
+    CHECK(permutation[1] == 3);
+    CHECK(permutation[2] == 2);
+    CHECK(permutation[3] == 0);
+    CHECK(keys[0] == 30);
+    // Case 2
+    double values[] = { 3, 1, 2, 1.5 };
+    double output[4];
+    SpaceFillingCurve::Permute(values, permutation, 4, output);
+    CHECK(output[0] == 1);
+    CHECK(output[1] == 1.5);
+    CHECK(output[2] == 2);
+    CHECK(output[3] == 3);
+    // Case 3
+    std::vector<int> ints = { 30, 10, 20, 11 };
+    SpaceFillingCurve::Permute(ints, permutation);
+    CHECK(ints == std::vector<int>({ 10, 11, 20, 30 }));
+    Vector3 vectors[] = { Vector3(3, 3, 3), Vector3(1, 1, 1),
+        Vector3(2, 2, 2), Vector3(1.5, 1.5, 1.5) };
+    Vector3Array array = Vector3Array(vectors, 4);
+    SpaceFillingCurve::Permute(array, permutation);
+    CHECK(Vector3Array::Get(array, 1) == Vector3(1.5, 1.5, 1.5));
+    CHECK(Vector3Array::Get(array, 3) == Vector3(3, 3, 3));
+}
@@ -0,0 +1,165 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the SpatialGrid functions.
+ */
+
+#include <algorithm>
+#include <vector>
+#include "catch.hpp"
+#include "Random.hpp"
+#include "SpatialGrid.hpp"
+
+
+static void CheckSorted(const SpatialGrid &grid,
+                        const std::vector<Vector3> &points)
+{
+    CHECK(grid.CellStart.front() == 0);
+    CHECK(grid.CellStart.back() == points.size());
+    bool sorted = true;
+    for (size_t b = 0; b < grid.TableSize; b++)
+        for (size_t i = grid.CellStart[b]; i < grid.CellStart[b + 1]; i++)
+        {
+            Vector3 p = points[grid.Indices[i]];
+            sorted = sorted && Vector3Array::Get(grid.Points, i) == p &&
+                SpatialGrid::Bucket(grid, SpatialGrid::Cell(grid, p.X),
+                    SpatialGrid::Cell(grid, p.Y),
+                    SpatialGrid::Cell(grid, p.Z)) == b;
+            if (i > grid.CellStart[b])
+                sorted = sorted && grid.Indices[i] > grid.Indices[i - 1];
+        }
+    CHECK(sorted);
+}
+
+
+TEST_CASE("SpatialGrid empty", "[SpatialGrid]")
+{
+    // Case 1
+    SpatialGrid grid = SpatialGrid(0.5);
+    std::vector<size_t> found;
+    SpatialGrid::Radius(grid, Vector3::Zero(), 10, found);
+    CHECK(found.empty());
+    // Case 2
+    SpatialGrid::Rebuild(grid, nullptr, 0);
+    SpatialGrid::Radius(grid, Vector3::Zero(), 10, found);
+    CHECK(found.empty());
+}
+
+TEST_CASE("SpatialGrid rebuild", "[SpatialGrid]")
+{
+    // Case 1
+    std::vector<Vector3> points = Random::Points(1000, 10, 3);
+    SpatialGrid grid = SpatialGrid(0.75);
+    SpatialGrid::Rebuild(grid, points.data(), points.size());
+    CHECK(grid.TableSize == 1024);
+    CheckSorted(grid, points);
+    // Case 2
+    SpatialGrid::Rebuild(grid, points.data(), 10);
+    CHECK(grid.TableSize == 16);
+    CHECK(grid.CellStart.back() == 10);
+    // Case 3: enough points for several threads and groups of buckets
+    points = Random::Points(3 * SpatialGrid::ParallelGrain + 5, 10, 4);
+    SpatialGrid::Rebuild(grid, points.data(), points.size());
+    CHECK(grid.TableSize == 131072);
+    CheckSorted(grid, points);
+}
+
+TEST_CASE("SpatialGrid cells", "[SpatialGrid]")
+{
+    // Case 1
+    SpatialGrid grid = SpatialGrid(2);
+    CHECK(SpatialGrid::Cell(grid, 0) == 0);
+    CHECK(SpatialGrid::Cell(grid, 3.9) == 1);
+    CHECK(SpatialGrid::Cell(grid, -0.1) == -1);
+    CHECK(SpatialGrid::Cell(grid, -4) == -2);
+}
+
+TEST_CASE("SpatialGrid neighbours", "[SpatialGrid]")
+{
+    // Case 1
+    std::vector<Vector3> points = Random::Points(2000, 10, 5);
+    SpatialGrid grid = SpatialGrid(0.5);
+    SpatialGrid::Rebuild(grid, points.data(), points.size());
+    std::vector<Vector3> queries = Random::Points(30, 10, 7);
+    for (size_t q = 0; q < queries.size(); q++)
+    {
+        std::vector<int> visits(points.size(), 0);
+        bool positions = true;
+        SpatialGrid::ForEachNeighbour(grid, queries[q],
+            [&](size_t index, Vector3 position)
+            {
+                visits[index]++;
+                positions = positions && position == points[index];
+            });
+        bool covered = true;
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            covered = covered && visits[i] <= 1;
+            if (Vector3::Distance(points[i], queries[q]) <= 0.5)
+                covered = covered && visits[i] == 1;
+        }
+        CHECK(positions);
+        CHECK(covered);
+    }
+}
+
+TEST_CASE("SpatialGrid radius", "[SpatialGrid]")
+{
+    std::vector<Vector3> points = Random::Points(2000, 10, 11);
+    SpatialGrid grid = SpatialGrid(0.4);
+    SpatialGrid::Rebuild(grid, points.data(), points.size());
+    std::vector<Vector3> queries = Random::Points(40, 10, 13);
+    // Case 1
+    for (double radius = 0.2; radius < 3; radius *= 2.5)
+        for (size_t q = 0; q < queries.size(); q++)
+        {
+            std::vector<size_t> expected;
+            for (size_t i = 0; i < points.size(); i++)
+                if (Vector3::Distance(points[i], queries[q]) <= radius)
+                    expected.push_back(i);
+            std::vector<size_t> found;
+            SpatialGrid::Radius(grid, queries[q], radius, found);
+            std::sort(found.begin(), found.end());
+            CHECK(found == expected);
+        }
+    // Case 2
+    std::vector<size_t> offsets;
+    std::vector<size_t> indices;
+    SpatialGrid::Radius(grid, queries.data(), queries.size(), 0.7, offsets,
+                        indices);
+    REQUIRE(offsets.size() == queries.size() + 1);
+    CHECK(offsets.back() == indices.size());
+    bool same = true;
+    for (size_t q = 0; q < queries.size(); q++)
+    {
+        std::vector<size_t> found;
+        SpatialGrid::Radius(grid, queries[q], 0.7, found);
+        same = same && offsets[q + 1] - offsets[q] == found.size() &&
+            std::equal(found.begin(), found.end(),
+                       indices.begin() + offsets[q]);
+    }
+    CHECK(same);
+}
@@ -0,0 +1,140 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Sphere functions.
+ */
+
+#include <math.h>
+#include <vector>
+#include "catch.hpp"
+#include "Random.hpp"
+#include "Sphere.hpp"
+
+
+TEST_CASE("Sphere containment and distance", "[Sphere]")
+{
+    Sphere sphere = Sphere(Vector3(1, 2, 3), 2);
+    // Case 1
+    CHECK(Sphere::Contains(sphere, Vector3(1, 2, 3)));
+    CHECK(Sphere::Contains(sphere, Vector3(1, 4, 3)));
+    CHECK_FALSE(Sphere::Contains(sphere, Vector3(3, 4, 3)));
+    // Case 2
+    CHECK(Sphere::Distance(sphere, Vector3(1, 2, 8)) == Approx(3));
+    CHECK(Sphere::Distance(sphere, Vector3(1, 2, 2)) == Approx(-1));
+    // Case 3
+    CHECK(Sphere::Overlaps(sphere, Sphere(Vector3(1, 2, 6), 1)));
+    CHECK_FALSE(Sphere::Overlaps(sphere, Sphere(Vector3(1, 2, 6.5), 1)));
+}
+
+TEST_CASE("Sphere raycast", "[Sphere]")
+{
+    Sphere sphere = Sphere(Vector3(5, 0, 0), 1);
+    double distance;
+    // Case 1
+    CHECK(Sphere::Raycast(sphere, Ray(Vector3(0, 0, 0), Vector3(2, 0, 0)),
+                          10, distance));
+    CHECK(distance == Approx(2));
+    // Case 2
+    CHECK(Sphere::Raycast(sphere, Ray(Vector3(5, 0.5, 0), Vector3(0, 1, 0)),
+                          10, distance));
+    CHECK(distance == 0);
+    // Case 3
+    CHECK_FALSE(Sphere::Raycast(sphere,
+                                Ray(Vector3(0, 0, 0), Vector3(-1, 0, 0)), 10,
+                                distance));
+    CHECK_FALSE(Sphere::Raycast(sphere,
+                                Ray(Vector3(0, 0, 0), Vector3(1, 0, 0)), 3.5,
+                                distance));
+    CHECK_FALSE(Sphere::Raycast(sphere,
+                                Ray(Vector3(0, 1.5, 0), Vector3(1, 0, 0)), 10,
+                                distance));
+    // Case 4
+    CHECK(Sphere::Raycast(sphere, Ray(Vector3(0, 1, 0), Vector3(1, 0, 0)),
+                          10, distance));
+    CHECK(distance == Approx(5));
+    // Case 5
+    sphere = Sphere(Vector3(0, 0.999, 1e6), 1);
+    Ray ray = Ray(Vector3(0, 0, 0), Vector3(0, 0, 1));
+    CHECK(Sphere::Raycast(sphere, ray, INFINITY, distance));
+    Vector3 p = Ray::GetPoint(ray, distance);
+    CHECK(fabs(Sphere::Distance(sphere, p)) < 1e-6);
+}
+
+TEST_CASE("Sphere batch raycast", "[Sphere]")
+{
+    const size_t count = 1000;
+    unsigned int seed = 7;
+    Vector3Array centers = Vector3Array(count);
+    std::vector<double> radii(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3Array::Set(centers, i, Vector3(Random::Value(seed) * 20 - 10,
+                                               Random::Value(seed) * 20 - 10,
+                                               Random::Value(seed) * 20 - 10));
+        radii[i] = Random::Value(seed) * 3;
+    }
+    bool hits[count];
+    double distances[count];
+    // Case 1
+    Ray ray = Ray(Vector3(-1, 0.5, 2), Vector3(1, 0.2, -0.4));
+    Sphere::Raycast(centers, radii.data(), ray, 12, hits, distances);
+    size_t mismatches = 0, hitCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        double distance;
+        Sphere sphere = Sphere(Vector3Array::Get(centers, i), radii[i]);
+        bool hit = Sphere::Raycast(sphere, ray, 12, distance);
+        mismatches += hit != hits[i] || (hit && distance != distances[i]);
+        hitCount += hit;
+    }
+    CHECK(mismatches == 0);
+    CHECK(hitCount > 0);
+    CHECK(hitCount < count);
+    // Case 2
+    Vector3Array origins = centers;
+    Vector3Array directions = Vector3Array(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3Array::Set(directions, i, Vector3(Random::Value(seed) - 0.5,
+                                                  Random::Value(seed) - 0.5,
+                                                  Random::Value(seed) - 0.5));
+    }
+    Sphere sphere = Sphere(Vector3(1, -2, 0.5), 4);
+    Sphere::Raycast(sphere, origins, directions, 30, hits, distances);
+    mismatches = hitCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        double distance;
+        ray = Ray(Vector3Array::Get(origins, i),
+                  Vector3Array::Get(directions, i));
+        bool hit = Sphere::Raycast(sphere, ray, 30, distance);
+        mismatches += hit != hits[i] || (hit && distance != distances[i]);
+        hitCount += hit;
+    }
+    CHECK(mismatches == 0);
+    CHECK(hitCount > 0);
+    CHECK(hitCount < count);
+}
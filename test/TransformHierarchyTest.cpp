@@ -0,0 +1,157 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the TransformHierarchy functions.
+ */
+
+#include <vector>
+#include "catch.hpp"
+#include "Random.hpp"
+#include "TransformHierarchy.hpp"
+
+
+static void ReferenceWorld(const std::vector<unsigned int> &parents,
+                           const std::vector<Quaternion> &rotations,
+                           const std::vector<Vector3> &positions,
+                           std::vector<Quaternion> &worldRotations,
+                           std::vector<Vector3> &worldPositions)
+{
+    // Parents are numbered after their children, so walk backward
+    size_t count = parents.size();
+    worldRotations.resize(count);
+    worldPositions.resize(count);
+    for (size_t n = count; n-- > 0;)
+    {
+        unsigned int p = parents[n];
+        if (p == TransformHierarchy::None)
+        {
+            worldRotations[n] = rotations[n];
+            worldPositions[n] = positions[n];
+        }
+        else
+        {
+            worldRotations[n] = worldRotations[p] * rotations[n];
+            worldPositions[n] = worldPositions[p] +
+                worldRotations[p] * positions[n];
+        }
+    }
+}
+
+
+TEST_CASE("TransformHierarchy build", "[TransformHierarchy]")
+{
+    // Case 1
+    unsigned int parents[] = { 2, TransformHierarchy::None, 1, 1, 0 };
+    double s = sqrt(0.5);
+    Quaternion rotations[] = { Quaternion(), Quaternion(0, 0, s, s),
+        Quaternion(), Quaternion(), Quaternion() };
+    Vector3 positions[] = { Vector3(0, 1, 0), Vector3(5, 0, 0),
+        Vector3(1, 0, 0), Vector3(0, 0, 1), Vector3(2, 0, 0) };
+    TransformHierarchy h = TransformHierarchy::Build(parents, 5, rotations,
+                                                     positions);
+    CHECK(TransformHierarchy::Levels(h) == 4);
+    CHECK(h.Order[0] == 1);
+    CHECK(h.Order[1] == 2);
+    CHECK(h.Order[2] == 3);
+    CHECK(h.Parents[3] == 1);
+    CHECK(h.ChildStart[1] == 3);
+    Vector3 p = TransformHierarchy::GetWorldPosition(h, 4);
+    CHECK(p.X == Approx(4));
+    CHECK(p.Y == Approx(3));
+    CHECK(p.Z == Approx(0));
+    // Case 2
+    h = TransformHierarchy::Build(parents, 0, rotations, positions);
+    CHECK(TransformHierarchy::Levels(h) == 0);
+    CHECK(TransformHierarchy::Update(h) == 0);
+}
+
+TEST_CASE("TransformHierarchy update", "[TransformHierarchy]")
+{
+    // Case 1
+    const size_t count = 5000;
+    unsigned int seed = 3;
+    std::vector<unsigned int> parents(count);
+    std::vector<Quaternion> rotations(count);
+    std::vector<Vector3> positions(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t range = count - i - 1;
+        parents[i] = range == 0 || Random::Value(seed) < 0.01 ?
+            TransformHierarchy::None :
+            (unsigned int)(i + 1 + Random::Value(seed) * std::min(range,
+                                                                 (size_t)40));
+        Vector3 axis = Vector3(Random::Value(seed) - 0.5,
+                               Random::Value(seed) - 0.5, 1);
+        rotations[i] = Quaternion::FromAngleAxis(Random::Value(seed), axis);
+        positions[i] = Vector3(Random::Value(seed), Random::Value(seed),
+                               Random::Value(seed));
+    }
+    TransformHierarchy h = TransformHierarchy::Build(parents.data(), count,
+        rotations.data(), positions.data());
+    std::vector<Quaternion> worldRotations;
+    std::vector<Vector3> worldPositions;
+    ReferenceWorld(parents, rotations, positions, worldRotations,
+                   worldPositions);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        Quaternion q = TransformHierarchy::GetWorldRotation(h, i);
+        Vector3 p = TransformHierarchy::GetWorldPosition(h, i);
+        mismatches += Quaternion::Dot(q, worldRotations[i]) < 1 - 1e-9 ||
+            Vector3::Distance(p, worldPositions[i]) > 1e-9;
+    }
+    CHECK(mismatches == 0);
+    // Case 2
+    std::vector<unsigned char> moved(count, 0);
+    for (int k = 0; k < 20; k++)
+    {
+        size_t n = (size_t)(Random::Value(seed) * count);
+        rotations[n] = Quaternion::FromAngleAxis(1, Vector3(0, 1, 0));
+        positions[n] = Vector3(k, 0, 0);
+        TransformHierarchy::SetLocal(h, n, rotations[n], positions[n]);
+        moved[n] = 1;
+    }
+    size_t expected = 0;
+    for (size_t n = count; n-- > 0;)
+    {
+        if (parents[n] != TransformHierarchy::None && moved[parents[n]])
+            moved[n] = 1;
+        expected += moved[n];
+    }
+    CHECK(TransformHierarchy::Update(h) == expected);
+    CHECK(TransformHierarchy::Update(h) == 0);
+    ReferenceWorld(parents, rotations, positions, worldRotations,
+                   worldPositions);
+    mismatches = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        Quaternion q = TransformHierarchy::GetWorldRotation(h, i);
+        Vector3 p = TransformHierarchy::GetWorldPosition(h, i);
+        mismatches += Quaternion::Dot(q, worldRotations[i]) < 1 - 1e-9 ||
+            Vector3::Distance(p, worldPositions[i]) > 1e-9;
+    }
+    CHECK(mismatches == 0);
+}
@@ -0,0 +1,176 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Transform functions.
+ */
+
+#include <type_traits>
+#include <utility>
+#include "catch.hpp"
+#include "Transform.hpp"
+
+
+template <typename T, typename = void>
+struct HasWritableRotation : std::false_type {};
+
+template <typename T>
+struct HasWritableRotation<T, decltype(void(std::declval<T&>().Rotation =
+    Quaternion()))> : std::true_type {};
+
+template <typename T, typename = void>
+struct HasWritableScale : std::false_type {};
+
+template <typename T>
+struct HasWritableScale<T, decltype(void(std::declval<T&>().Scale =
+    Vector3()))> : std::true_type {};
+
+template <typename T, typename = void>
+struct HasReadableDirty : std::false_type {};
+
+template <typename T>
+struct HasReadableDirty<T, decltype(void(std::declval<T&>().Dirty))>
+    : std::true_type {};
+
+
+#define CHECK_VECTOR(a, b) \
+    CHECK(a.X == Approx(b.X)); \
+    CHECK(a.Y == Approx(b.Y)); \
+    CHECK(a.Z == Approx(b.Z));
+
+
+TEST_CASE("Transform cached matrices", "[Transform]")
+{
+    // Case 1
+    Quaternion q = Quaternion(0.1, 0.7, -0.3, 0.6);
+    Transform t = Transform(Vector3(4, -3, 2), q, Vector3(2, 0.5, 3));
+    CHECK(Transform::GetPosition(t) == Vector3(4, -3, 2));
+    CHECK(Transform::GetRotation(t) == q);
+    CHECK(Transform::GetScale(t) == Vector3(2, 0.5, 3));
+    Matrix4x4 expected = Matrix4x4::FromTRS(Transform::GetPosition(t), q,
+                                            Transform::GetScale(t));
+    Matrix3x3 linear = Transform::GetLinear(t);
+    CHECK(linear == Matrix4x4::ToMatrix3x3(expected));
+    CHECK(Transform::ToMatrix4x4(t) == expected);
+    // Case 2
+    Transform::Update(t);
+    Matrix3x3 identity = Transform::GetInverse(t) * linear;
+    CHECK(identity.D00 == Approx(1));
+    CHECK(identity.D11 == Approx(1));
+    CHECK(identity.D22 == Approx(1));
+    CHECK(identity.D01 == Approx(0));
+    CHECK(identity.D12 == Approx(0));
+    Matrix3x3 normal = Matrix3x3::Transpose(Matrix3x3::Inverse(linear));
+    CHECK(Transform::GetNormal(t).D02 == Approx(normal.D02));
+    CHECK(Transform::GetNormal(t).D21 == Approx(normal.D21));
+    // Case 3: every cache follows the setters
+    Transform::SetPosition(t, Vector3(1, 1, 1));
+    CHECK(Transform::GetLinear(t) == linear);
+    Transform::SetScale(t, Vector3(1, 1, 1));
+    CHECK(Transform::GetLinear(t) == Transform::GetRotationMatrix(t));
+    CHECK(Transform::GetInverse(t) ==
+          Matrix3x3::Transpose(Transform::GetRotationMatrix(t)));
+    Transform::SetRotation(t, Quaternion());
+    CHECK(Transform::GetRotationMatrix(t) == Matrix3x3::Identity());
+    CHECK(Transform::GetLinear(t) == Matrix3x3::Identity());
+    CHECK(Transform::GetNormal(t) == Matrix3x3::Identity());
+    CHECK_VECTOR(Transform::TransformPoint(t, Vector3(1, 2, 3)),
+                 Vector3(2, 3, 4));
+}
+
+TEST_CASE("Transform is only written through its setters", "[Transform]")
+{
+    // Case 1
+    CHECK_FALSE(HasWritableRotation<Transform>::value);
+    CHECK_FALSE(HasWritableScale<Transform>::value);
+    CHECK_FALSE(HasReadableDirty<Transform>::value);
+}
+
+TEST_CASE("Transform points, directions and normals", "[Transform]")
+{
+    // Case 1
+    double s = sqrt(0.5);
+    Transform t = Transform(Vector3(4, -3, 2), Quaternion(0, 0, s, s),
+                            Vector3(2, 2, 2));
+    CHECK_VECTOR(Transform::TransformPoint(t, Vector3(1, 0, 1)),
+                 Vector3(4, -1, 4));
+    CHECK_VECTOR(Transform::TransformDirection(t, Vector3(1, 0, 1)),
+                 Vector3(0, 2, 2));
+    CHECK_VECTOR(Transform::InverseTransformPoint(t, Vector3(4, -1, 4)),
+                 Vector3(1, 0, 1));
+    // Case 2
+    t = Transform(Vector3(1, 2, 3), Quaternion(0.1, 0.7, -0.3, 0.6),
+                  Vector3(3, 0.25, 1.5));
+    Vector3 tangent = Vector3(1, 2, 0);
+    Vector3 normal = Vector3(-2, 1, 5);
+    double dot = Vector3::Dot(Transform::TransformDirection(t, tangent),
+                              Transform::TransformNormal(t, normal));
+    CHECK(dot == Approx(0));
+    // Case 3
+    Vector3 points[] = { Vector3(1, 2, 3), Vector3(-4, 0.5, 6),
+        Vector3(0.1, -7, 2) };
+    Vector3 output[3];
+    Transform::TransformPoints(t, points, 3, output);
+    for (int i = 0; i < 3; i++)
+    {
+        CHECK_VECTOR(output[i], Transform::TransformPoint(t, points[i]));
+    }
+    Transform::TransformDirections(t, points, 3, output);
+    for (int i = 0; i < 3; i++)
+    {
+        CHECK_VECTOR(output[i], Transform::TransformDirection(t, points[i]));
+    }
+    Transform::TransformNormals(t, points, 3, output);
+    for (int i = 0; i < 3; i++)
+    {
+        CHECK_VECTOR(output[i], Transform::TransformNormal(t, points[i]));
+    }
+}
+
+TEST_CASE("Transform compose and inverse", "[Transform]")
+{
+    // Case 1
+    Transform a = Transform(Vector3(1, 2, 3), Quaternion(0.1, 0.7, -0.3, 0.6),
+                            Vector3(2, 2, 2));
+    Transform b = Transform(Vector3(-4, 0, 1), Quaternion(0.5, -0.2, 0.1, 0.8),
+                            Vector3(1, 3, 0.5));
+    Transform c = Transform::Compose(a, b);
+    Vector3 p = Vector3(0.3, -2, 7);
+    CHECK_VECTOR(Transform::TransformPoint(c, p),
+                 Transform::TransformPoint(a, Transform::TransformPoint(b, p)));
+    // Case 2
+    Transform inverse = Transform::Inverse(a);
+    CHECK_VECTOR(Transform::TransformPoint(inverse,
+                                           Transform::TransformPoint(a, p)),
+                 p);
+    CHECK_VECTOR(Transform::TransformPoint(inverse, p),
+                 Transform::InverseTransformPoint(a, p));
+    // Case 3
+    a = Transform(Vector3(1, 2, 3), Quaternion(), Vector3(2, 0.5, 4));
+    inverse = Transform::Inverse(a);
+    CHECK_VECTOR(Transform::TransformPoint(inverse,
+                                           Transform::TransformPoint(a, p)),
+                 p);
+}
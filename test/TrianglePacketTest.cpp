@@ -0,0 +1,246 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the TrianglePacket and RayPacket
+ *  functions.
+ */
+
+#include <math.h>
+#include <vector>
+#include "catch.hpp"
+#include "BVH.hpp"
+#include "Random.hpp"
+#include "TrianglePacket.hpp"
+
+
+static Vector3 RandomVector(unsigned int &seed, double size)
+{
+    double x = Random::Value(seed) - 0.5;
+    double y = Random::Value(seed) - 0.5;
+    double z = Random::Value(seed) - 0.5;
+    return Vector3(x, y, z) * size;
+}
+
+template <size_t Width>
+static size_t PacketMismatches(const std::vector<Vector3> &vertices,
+                               const std::vector<Ray> &rays)
+{
+    // Compares both packets with the scalar test the BVH uses
+    size_t triangleCount = vertices.size() / 3;
+    std::vector<TrianglePacket<Width>> triangles =
+        TrianglePacket<Width>::FromTriangles(vertices.data(), triangleCount);
+    size_t mismatches = 0;
+    double distances[Width];
+    for (size_t r = 0; r < rays.size(); r++)
+    {
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            if (t % Width == 0)
+            {
+                unsigned int mask = TrianglePacket<Width>::Raycast(
+                    triangles[t / Width], rays[r], 50, distances);
+                for (size_t i = 0; i < Width; i++)
+                {
+                    double expected;
+                    size_t n = t + i;
+                    bool hit = n < triangleCount && BVH::RaycastTriangle(
+                        rays[r].Origin, rays[r].Direction, vertices[3 * n],
+                        vertices[3 * n + 1], vertices[3 * n + 2],
+                        expected) && expected <= 50;
+                    bool packetHit = (mask >> i & 1) != 0;
+                    mismatches += hit != packetHit || (hit &&
+                        fabs(distances[i] - expected) > 1e-9);
+                }
+            }
+        }
+    }
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        for (size_t r = 0; r < rays.size(); r += Width)
+        {
+            size_t count = std::min(Width, rays.size() - r);
+            RayPacket<Width> packet = RayPacket<Width>::Load(&rays[r],
+                                                             count);
+            unsigned int mask = RayPacket<Width>::Raycast(
+                packet, vertices[3 * t], vertices[3 * t + 1],
+                vertices[3 * t + 2], 50, distances);
+            for (size_t i = 0; i < Width; i++)
+            {
+                double expected;
+                bool hit = i < count && BVH::RaycastTriangle(
+                    rays[r + i].Origin, rays[r + i].Direction,
+                    vertices[3 * t], vertices[3 * t + 1],
+                    vertices[3 * t + 2], expected) && expected <= 50;
+                bool packetHit = (mask >> i & 1) != 0;
+                mismatches += hit != packetHit || (hit &&
+                    fabs(distances[i] - expected) > 1e-9);
+            }
+        }
+    }
+    return mismatches;
+}
+
+
+TEST_CASE("TrianglePacket raycast", "[TrianglePacket]")
+{
+    Vector3 vertices[] = {
+        Vector3(0, 0, 5), Vector3(1, 0, 5), Vector3(0, 1, 5),
+        Vector3(0, 0, 2), Vector3(0, 1, 2), Vector3(1, 0, 2),
+        Vector3(5, 0, 3), Vector3(6, 0, 3), Vector3(5, 1, 3),
+        Vector3(0, 0, 1), Vector3(1, 1, 1), Vector3(2, 2, 1),
+        Vector3(0, 0, -1), Vector3(1, 0, -1), Vector3(0, 1, -1),
+    };
+    TrianglePacket<8> packet = TrianglePacket<8>::Load(vertices, 5);
+    double distances[8];
+    // Case 1
+    Ray ray = Ray(Vector3(0.25, 0.25, 0), Vector3(0, 0, 2));
+    unsigned int mask = TrianglePacket<8>::Raycast(packet, ray, 10,
+                                                   distances);
+    CHECK(mask == 3);
+    CHECK(distances[0] == Approx(2.5));
+    CHECK(distances[1] == Approx(1));
+    // Case 2
+    mask = TrianglePacket<8>::Raycast(packet, ray, 2, distances);
+    CHECK(mask == 2);
+    // Case 3
+    ray = Ray(Vector3(0.5, 0.5, 0), Vector3(0, 0, 1));
+    mask = TrianglePacket<8>::Raycast(packet, ray, 10, distances);
+    CHECK(mask == 3);
+    CHECK(distances[0] == Approx(5));
+    // Case 4
+    ray = Ray(Vector3(0, 0, 0), Vector3(0, 0, 0));
+    CHECK(TrianglePacket<8>::Raycast(packet, ray, 10, distances) == 0);
+}
+
+TEST_CASE("TrianglePacket matches scalar raycast", "[TrianglePacket]")
+{
+    unsigned int seed = 5;
+    std::vector<Vector3> vertices(3 * 37);
+    for (size_t t = 0; t < 37; t++)
+    {
+        Vector3 center = RandomVector(seed, 10);
+        for (int k = 0; k < 3; k++)
+            vertices[3 * t + k] = center + RandomVector(seed, 6);
+    }
+    std::vector<Ray> rays(29);
+    for (size_t r = 0; r < rays.size(); r++)
+    {
+        rays[r] = Ray(RandomVector(seed, 30) + Vector3(0, 0, -20),
+                      Vector3(0, 0, 1) + RandomVector(seed, 1));
+    }
+    // Case 1
+    CHECK(PacketMismatches<4>(vertices, rays) == 0);
+    // Case 2
+    CHECK(PacketMismatches<8>(vertices, rays) == 0);
+    // Case 3
+    CHECK(PacketMismatches<16>(vertices, rays) == 0);
+}
+
+TEST_CASE("TrianglePacket is watertight", "[TrianglePacket]")
+{
+    // A closed fan of triangles around a center, with rays aimed at points
+    // on the shared edges. BVH::RaycastTriangle lets a few percent of them
+    // through.
+    const size_t count = 16;
+    unsigned int seed = 9;
+    Vector3 center = Vector3(0.1, -0.2, 3);
+    std::vector<Vector3> rim(count);
+    for (size_t k = 0; k < count; k++)
+    {
+        double angle = 2 * M_PI * k / count;
+        rim[k] = Vector3(cos(angle), sin(angle), 3) +
+            RandomVector(seed, 0.1);
+    }
+    std::vector<Vector3> vertices;
+    for (size_t k = 0; k < count; k++)
+    {
+        vertices.push_back(center);
+        vertices.push_back(rim[k]);
+        vertices.push_back(rim[(k + 1) % count]);
+    }
+    std::vector<TrianglePacket<16>> packets =
+        TrianglePacket<16>::FromTriangles(vertices.data(), count);
+    REQUIRE(packets.size() == 1);
+    // Case 1
+    size_t misses = 0;
+    double distances[16];
+    for (size_t k = 0; k < count; k++)
+    {
+        for (int step = 0; step < 64; step++)
+        {
+            Vector3 target = center + (rim[k] - center) * (step / 64.0);
+            Vector3 origin = Vector3(0.3, 0.7, -1) + RandomVector(seed, 2);
+            Ray ray = Ray(origin, target - origin);
+            misses += TrianglePacket<16>::Raycast(packets[0], ray, 10,
+                                                  distances) == 0;
+        }
+    }
+    CHECK(misses == 0);
+    // Case 2
+    RayPacket<4> rays = RayPacket<4>::Load(nullptr, 0);
+    CHECK(RayPacket<4>::Raycast(rays, vertices[0], vertices[1], vertices[2],
+                                10, distances) == 0);
+}
+
+TEST_CASE("TrianglePacket shared edge does not leak", "[TrianglePacket]")
+{
+    // Two triangles on either side of one edge, each listing it in the
+    // opposite direction, with rays aimed at points along it. Every ray must
+    // hit at least one of them
+    Vector3 a = Vector3(-0.731, 0.377, 2.113);
+    Vector3 b = Vector3(0.829, -0.461, 1.937);
+    Vector3 vertices[] = { a, b, Vector3(0.3, 0.9, 2.4),
+                           b, a, Vector3(-0.2, -1.1, 1.6) };
+    TrianglePacket<4> triangles = TrianglePacket<4>::Load(vertices, 2);
+    unsigned int seed = 11;
+    size_t leaks = 0;
+    size_t packetLeaks = 0;
+    double distances[4];
+    Ray rays[4];
+    for (int i = 0; i < 100000; i++)
+    {
+        Vector3 target = a + (b - a) * (0.01 + 0.98 * Random::Value(seed));
+        Vector3 origin = RandomVector(seed, 4) - Vector3(0, 0, 3);
+        rays[i % 4] = Ray(origin, target - origin);
+        leaks += TrianglePacket<4>::Raycast(triangles, rays[i % 4], 10,
+                                            distances) == 0;
+        if (i % 4 == 3)
+        {
+            RayPacket<4> packet = RayPacket<4>::Load(rays, 4);
+            unsigned int first = RayPacket<4>::Raycast(
+                packet, vertices[0], vertices[1], vertices[2], 10,
+                distances);
+            unsigned int second = RayPacket<4>::Raycast(
+                packet, vertices[3], vertices[4], vertices[5], 10,
+                distances);
+            for (int lane = 0; lane < 4; lane++)
+                packetLeaks += ((first | second) >> lane & 1) == 0;
+        }
+    }
+    CHECK(leaks == 0);
+    CHECK(packetLeaks == 0);
+}
+
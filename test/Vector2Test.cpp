@@ -201,6 +201,22 @@ TEST_CASE("Angle between Vector2s", "[Vector2]")
     CHECK(Vector2::Angle(v1, v2) == Approx(2.9437072677));
 }
 
+TEST_CASE("Fast angle between Vector2s", "[Vector2]")
+{
+    // Case 1
+    Vector2 v1 = Vector2(2, -5);
+    Vector2 v2 = Vector2(6, 2);
+    CHECK(Vector2::Angle(v1, v2, FastMath()) == Approx(1.5120404684));
+    // Case 2
+    v1 = Vector2(0.24, 0.0082);
+    v2 = Vector2(0.53, -0.0532);
+    CHECK(Vector2::Angle(v1, v2, FastMath()) == Approx(0.1341958967));
+    // Case 3
+    v1 = Vector2(-27, 83);
+    v2 = Vector2(36, -64);
+    CHECK(Vector2::Angle(v1, v2, FastMath()) == Approx(2.9437072677));
+}
+
 TEST_CASE("Clamp magnitude of Vector2", "[Vector2]")
 {
     // Case 1
@@ -692,3 +708,23 @@ TEST_CASE("To Polar coordinate space", "[Vector2]")
     CHECK(rad == Approx(87.2811548961));
     CHECK(theta == Approx(1.8853006312));
 }
+
+TEST_CASE("Fast to Polar coordinate space", "[Vector2]")
+{
+    // Case 1
+    Vector2 v = Vector2(2, -5);
+    double rad, theta;
+    Vector2::ToPolar(v, rad, theta, FastMath());
+    CHECK(rad == Approx(5.3851648071));
+    CHECK(theta == Approx(-1.1902899497));
+    // Case 2
+    v = Vector2(0.24, 0.0082);
+    Vector2::ToPolar(v, rad, theta, FastMath());
+    CHECK(rad == Approx(0.2401400425));
+    CHECK(theta == Approx(0.034153381));
+    // Case 3
+    v = Vector2(-27, 83);
+    Vector2::ToPolar(v, rad, theta, FastMath());
+    CHECK(rad == Approx(87.2811548961));
+    CHECK(theta == Approx(1.8853006312));
+}
@@ -0,0 +1,68 @@
+/**
+ *  ============================================================================
+ *  MIT License
+ *
+ *  Copyright (c) 2016 Eric Phillips
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a
+ *  copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *  DEALINGS IN THE SOFTWARE.
+ *  ============================================================================
+ *
+ *
+ *  This file contains test cases for the Vector3Array functions.
+ */
+
+#include "catch.hpp"
+#include "Vector3Array.hpp"
+
+
+TEST_CASE("Vector3Array construction", "[Vector3Array]")
+{
+    // Case 1
+    Vector3Array empty;
+    CHECK(Vector3Array::Size(empty) == 0);
+    // Case 2
+    Vector3Array zeros = Vector3Array(4);
+    CHECK(Vector3Array::Size(zeros) == 4);
+    CHECK(Vector3Array::Get(zeros, 3) == Vector3::Zero());
+    // Case 3
+    Vector3 vectors[] = { Vector3(1, 2, 3), Vector3(-4, 5, -6) };
+    Vector3Array array = Vector3Array(vectors, 2);
+    CHECK(array.X[1] == -4);
+    CHECK(array.Y[0] == 2);
+    CHECK(array.Z[1] == -6);
+    CHECK(Vector3Array::Get(array, 0) == Vector3(1, 2, 3));
+}
+
+TEST_CASE("Vector3Array modification", "[Vector3Array]")
+{
+    // Case 1
+    Vector3Array array;
+    Vector3Array::PushBack(array, Vector3(1, 1, 1));
+    Vector3Array::PushBack(array, Vector3(2, 3, 4));
+    CHECK(Vector3Array::Size(array) == 2);
+    Vector3Array::Set(array, 0, Vector3(7, 8, 9));
+    CHECK(Vector3Array::Get(array, 0) == Vector3(7, 8, 9));
+    // Case 2
+    Vector3Array::Resize(array, 3);
+    CHECK(Vector3Array::Get(array, 2) == Vector3::Zero());
+    Vector3 out[3];
+    Vector3Array::ToVectors(array, out);
+    CHECK(out[0] == Vector3(7, 8, 9));
+    CHECK(out[1] == Vector3(2, 3, 4));
+}
@@ -29,6 +29,8 @@
  *  Created by Eric Phillips on October 8, 2016.
  */
 
+#include <math.h>
+#include <type_traits>
 #include "catch.hpp"
 #include "Vector3.hpp"
 
@@ -219,6 +221,26 @@ TEST_CASE("Angle between Vector3s", "[Vector3]")
     CHECK(Vector3::Angle(v1, v2) == Approx(2.91024));
 }
 
+TEST_CASE("Fast angle between Vector3s", "[Vector3]")
+{
+    // Case 1
+    Vector3 v1 = Vector3(2, -5, 4);
+    Vector3 v2 = Vector3(6, 2, -8);
+    CHECK(Vector3::Angle(v1, v2, FastMath()) == Approx(2.02476));
+    // Case 2
+    v1 = Vector3(0.24, 0.0082, -0.03);
+    v2 = Vector3(0.53, -0.0532, -1.53);
+    CHECK(Vector3::Angle(v1, v2, FastMath()) == Approx(1.11476));
+    // Case 3
+    v1 = Vector3(-27, 83, -163);
+    v2 = Vector3(36, -64, 264);
+    CHECK(Vector3::Angle(v1, v2, FastMath()) == Approx(2.91024));
+    // Case 4
+    v1 = Vector3(1, 0, 0);
+    v2 = Vector3(1, 1e-7, 0);
+    CHECK(Vector3::Angle(v1, v2, FastMath()) == Approx(1e-7));
+}
+
 TEST_CASE("Clamp magnitude of Vector3", "[Vector3]")
 {
     // Case 1
@@ -507,6 +529,52 @@ TEST_CASE("Normalized Vector3", "[Vector3]")
     CHECK(n.Z == Approx(-0.881571));
 }
 
+TEST_CASE("Vector3 functions of unit vectors", "[Vector3]")
+{
+    Vector3 v1 = Vector3(2, -5, 4);
+    UnitVector3 u1, u2;
+    REQUIRE(Vector3::TryNormalize(v1, u1));
+    REQUIRE(Vector3::TryNormalize(Vector3(6, 2, -8), u2));
+    CHECK(Vector3::Magnitude(u2) == Approx(1));
+    // Angle
+    CHECK(Vector3::Angle(u1, u2) == Approx(2.02476));
+    // Component
+    CHECK(Vector3::Component(v1, u2) == Approx(-2.9417420271));
+    // Project
+    Vector3 v = Vector3::Project(v1, u2);
+    CHECK(v.X == Approx(-1.7307692308));
+    CHECK(v.Y == Approx(-0.5769230769));
+    CHECK(v.Z == Approx(2.3076923077));
+    // Reflect
+    v = Vector3::Reflect(v1, u2);
+    CHECK(v.X == Approx(5.4615384615));
+    CHECK(v.Y == Approx(-3.8461538462));
+    CHECK(v.Z == Approx(-0.6153846154));
+    v = Vector3::Reflect(Vector3(1, 2, 3), UnitVector3::Up());
+    CHECK(v.X == Approx(1));
+    CHECK(v.Y == Approx(-2));
+    CHECK(v.Z == Approx(3));
+    // Reject and ProjectOnPlane
+    Vector3 expected = Vector3::Reject(v1, Vector3(6, 2, -8));
+    v = Vector3::Reject(v1, u2);
+    CHECK(v.X == Approx(expected.X));
+    CHECK(v.Y == Approx(expected.Y));
+    CHECK(v.Z == Approx(expected.Z));
+    v = Vector3::ProjectOnPlane(v1, u2);
+    CHECK(v.X == Approx(expected.X));
+    CHECK(v.Y == Approx(expected.Y));
+    CHECK(v.Z == Approx(expected.Z));
+    // Zero vector
+    UnitVector3 unit = UnitVector3::Up();
+    CHECK_FALSE(Vector3::TryNormalize(Vector3::Zero(), unit));
+    CHECK(unit == Vector3::Up());
+    CHECK(Vector3::Normalized(Vector3::Zero()) == Vector3::Zero());
+    // Read only components
+    CHECK_FALSE((std::is_base_of<Vector3, UnitVector3>::value));
+    CHECK((std::is_convertible<UnitVector3, Vector3>::value));
+    CHECK(u2.X() == Approx(6 / sqrt(104.0)));
+}
+
 TEST_CASE("Orthogonal Vector3", "[Vector3]")
 {
     // Case 1
@@ -850,3 +918,26 @@ TEST_CASE("To Spherical coordinate space", "[Vector3]")
     CHECK(theta == Approx(2.6499755));
     CHECK(phi == Approx(1.8853006));
 }
+
+TEST_CASE("Fast to Spherical coordinate space", "[Vector3]")
+{
+    // Case 1
+    Vector3 v = Vector3(2, -5, 4);
+    double rad, theta, phi;
+    Vector3::ToSpherical(v, rad, theta, phi, FastMath());
+    CHECK(rad == Approx(6.7082));
+    CHECK(theta == Approx(0.931931));
+    CHECK(phi == Approx(-1.19029));
+    // Case 2
+    v = Vector3(0.24, 0.0082, -0.03);
+    Vector3::ToSpherical(v, rad, theta, phi, FastMath());
+    CHECK(rad == Approx(0.242007));
+    CHECK(theta == Approx(1.69508));
+    CHECK(phi == Approx(0.0341533));
+    // Case 3
+    v = Vector3(-27, 83, -163);
+    Vector3::ToSpherical(v, rad, theta, phi, FastMath());
+    CHECK(rad == Approx(184.8972));
+    CHECK(theta == Approx(2.6499755));
+    CHECK(phi == Approx(1.8853006));
+}